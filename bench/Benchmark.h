@@ -0,0 +1,169 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_BENCH_BENCHMARK_H
+#define BPP_SEQ_BENCH_BENCHMARK_H
+
+// From the STL:
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A set of named benchmarks, run and reported together.
+ *
+ * Each benchmark is a function processing a fixed input, and returning the
+ * number of items it processed (bytes, states, sites or cells), so that
+ * throughputs can be compared across scales. Benchmarks are run once to warm
+ * caches up, and then a fixed number of times; the minimum, median and mean
+ * times are reported. Results are written as a JSON object, to be compared
+ * across commits, or as a table.
+ */
+class BenchmarkSuite
+{
+public:
+  struct Result
+  {
+    std::string name;
+    std::string unit;
+    uint64_t items;
+    size_t repetitions;
+    double minSeconds;
+    double medianSeconds;
+    double meanSeconds;
+
+    Result() : name(), unit(), items(0), repetitions(0), minSeconds(0), medianSeconds(0), meanSeconds(0) {}
+
+    double getThroughput() const { return medianSeconds > 0 ? static_cast<double>(items) / medianSeconds : 0; }
+  };
+
+private:
+  struct Benchmark_
+  {
+    std::string name;
+    std::string unit;
+    std::function<uint64_t()> function;
+  };
+
+  std::vector<Benchmark_> benchmarks_;
+  std::vector<Result> results_;
+
+public:
+  BenchmarkSuite() : benchmarks_(), results_() {}
+
+public:
+  /**
+   * @param name     The name of the benchmark, as 'group.name'.
+   * @param unit     The unit of the items processed.
+   * @param function The benchmark, returning the number of items processed.
+   */
+  void add(const std::string& name, const std::string& unit, std::function<uint64_t()> function)
+  {
+    benchmarks_.push_back(Benchmark_{ name, unit, function });
+  }
+
+  /**
+   * @brief Run all benchmarks whose name contains a filter.
+   *
+   * @param repetitions The number of timed runs of each benchmark.
+   * @param filter      Only run benchmarks whose name contains this string.
+   * @param progress    Where to display the name of each benchmark when it starts, or null.
+   */
+  void run(size_t repetitions, const std::string& filter, std::ostream* progress)
+  {
+    repetitions = std::max(repetitions, static_cast<size_t>(1));
+    for (const auto& benchmark : benchmarks_)
+    {
+      if (benchmark.name.find(filter) == std::string::npos)
+        continue;
+      if (progress)
+        *progress << benchmark.name << "..." << std::endl;
+      Result result;
+      result.name = benchmark.name;
+      result.unit = benchmark.unit;
+      result.repetitions = repetitions;
+      result.items = benchmark.function(); // Warm up.
+      std::vector<double> times(repetitions);
+      for (auto& time : times)
+      {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t items = benchmark.function();
+        time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (items != result.items)
+          throw std::runtime_error("Benchmark " + benchmark.name + " is not deterministic.");
+      }
+      std::sort(times.begin(), times.end());
+      result.minSeconds = times.front();
+      result.medianSeconds = repetitions % 2 == 1 ? times[repetitions / 2] : (times[repetitions / 2 - 1] + times[repetitions / 2]) / 2;
+      double sum = 0;
+      for (double time : times)
+      {
+        sum += time;
+      }
+      result.meanSeconds = sum / static_cast<double>(repetitions);
+      results_.push_back(result);
+    }
+  }
+
+  const std::vector<Result>& getResults() const { return results_; }
+
+  /**
+   * @brief Write the results as a table.
+   */
+  void print(std::ostream& out) const
+  {
+    out << std::left << std::setw(32) << "Benchmark" << std::right << std::setw(14) << "Median (s)" << std::setw(14) << "Min (s)";
+    out << std::setw(16) << "Items/s" << "  Unit" << std::endl;
+    for (const auto& result : results_)
+    {
+      out << std::left << std::setw(32) << result.name << std::right << std::fixed << std::setprecision(6);
+      out << std::setw(14) << result.medianSeconds << std::setw(14) << result.minSeconds;
+      out << std::setw(16) << std::setprecision(0) << result.getThroughput() << "  " << result.unit << std::endl;
+    }
+    out << std::defaultfloat << std::setprecision(6);
+  }
+
+  /**
+   * @brief Write the results and the configuration as a JSON object.
+   *
+   * @param out    The output stream.
+   * @param config The parameters of the run (scale, seed...), written as strings.
+   */
+  void writeJson(std::ostream& out, const std::map<std::string, std::string>& config) const
+  {
+    out << std::setprecision(9);
+    out << "{" << std::endl;
+    out << "  \"suite\": \"bpp-seq-bench\"," << std::endl;
+    out << "  \"config\": {";
+    bool first = true;
+    for (const auto& param : config)
+    {
+      out << (first ? "" : ",") << std::endl << "    \"" << param.first << "\": \"" << param.second << "\"";
+      first = false;
+    }
+    out << std::endl << "  }," << std::endl;
+    out << "  \"results\": [";
+    first = true;
+    for (const auto& result : results_)
+    {
+      out << (first ? "" : ",") << std::endl;
+      out << "    { \"name\": \"" << result.name << "\", \"unit\": \"" << result.unit << "\", \"items\": " << result.items;
+      out << ", \"repetitions\": " << result.repetitions;
+      out << ", \"min_seconds\": " << result.minSeconds << ", \"median_seconds\": " << result.medianSeconds;
+      out << ", \"mean_seconds\": " << result.meanSeconds << ", \"items_per_second\": " << result.getThroughput() << " }";
+      first = false;
+    }
+    out << std::endl << "  ]" << std::endl;
+    out << "}" << std::endl;
+    out << std::setprecision(6);
+  }
+};
+#endif // BPP_SEQ_BENCH_BENCHMARK_H
@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_BENCH_SYNTHETICALIGNMENT_H
+#define BPP_SEQ_BENCH_SYNTHETICALIGNMENT_H
+
+#include <Bpp/Seq/Container/VectorSiteContainer.h>
+#include <Bpp/Seq/GeneticCode/GeneticCode.h>
+
+// From the STL:
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Reproducible random alignments, for benchmarks.
+ *
+ * Sequences are derived from a random ancestral sequence, with a fixed
+ * rate of substitutions, gaps and unknown states, so that alignments have
+ * shared site patterns, gapped and complete sites, like real ones.
+ *
+ * Only the raw output of std::mt19937_64 is used (the distributions of the
+ * standard library differ between implementations), so that a seed gives
+ * the same alignment on all platforms.
+ */
+class SyntheticAlignment
+{
+private:
+  std::mt19937_64 engine_;
+  double substitutionRate_;
+  double gapRate_;
+  double unknownRate_;
+
+public:
+  /**
+   * @param seed             The seed of the random generator.
+   * @param substitutionRate The probability that a state differs from the ancestral one.
+   * @param gapRate          The probability of a gap.
+   * @param unknownRate      The probability of an unknown state.
+   */
+  SyntheticAlignment(uint64_t seed, double substitutionRate = 0.1, double gapRate = 0.02, double unknownRate = 0.005) :
+    engine_(seed),
+    substitutionRate_(substitutionRate),
+    gapRate_(gapRate),
+    unknownRate_(unknownRate)
+  {}
+
+public:
+  /**
+   * @return A uniform random number in [0, 1).
+   */
+  double uniform()
+  {
+    return static_cast<double>(engine_() >> 11) / 9007199254740992.;
+  }
+
+  /**
+   * @return A uniform random integer in [0, n).
+   */
+  int uniformInt(unsigned int n)
+  {
+    return static_cast<int>(engine_() % n);
+  }
+
+  /**
+   * @brief Generate an alignment.
+   *
+   * @param alphabet     The alphabet of the alignment.
+   * @param nbSequences  The number of sequences.
+   * @param nbSites      The number of sites.
+   * @param gCode        If not null, stop codons are never generated.
+   * @param missingData  Whether to add gaps and unknown states.
+   */
+  std::unique_ptr<bpp::VectorSiteContainer> generate(
+      std::shared_ptr<const bpp::Alphabet> alphabet,
+      size_t nbSequences,
+      size_t nbSites,
+      std::shared_ptr<const bpp::GeneticCode> gCode = nullptr,
+      bool missingData = true)
+  {
+    std::vector<int> states;
+    for (int state = 0; state < static_cast<int>(alphabet->getSize()); ++state)
+    {
+      if (!gCode || !gCode->isStop(state))
+        states.push_back(state);
+    }
+    unsigned int nbStates = static_cast<unsigned int>(states.size());
+
+    std::vector<int> ancestor(nbSites);
+    for (auto& state : ancestor)
+    {
+      state = states[static_cast<size_t>(uniformInt(nbStates))];
+    }
+
+    auto sites = std::make_unique<bpp::VectorSiteContainer>(alphabet);
+    std::vector<int> content(nbSites);
+    for (size_t i = 0; i < nbSequences; ++i)
+    {
+      for (size_t j = 0; j < nbSites; ++j)
+      {
+        double u = uniform();
+        if (missingData && u < gapRate_)
+          content[j] = alphabet->getGapCharacterCode();
+        else if (missingData && u < gapRate_ + unknownRate_)
+          content[j] = alphabet->getUnknownCharacterCode();
+        else if (u < gapRate_ + unknownRate_ + substitutionRate_)
+          content[j] = states[static_cast<size_t>(uniformInt(nbStates))];
+        else
+          content[j] = ancestor[j];
+      }
+      std::string name = "seq" + std::to_string(i + 1);
+      auto sequence = std::make_unique<bpp::Sequence>(name, content, alphabet);
+      sites->addSequence(name, sequence);
+    }
+    return sites;
+  }
+};
+#endif // BPP_SEQ_BENCH_SYNTHETICALIGNMENT_H
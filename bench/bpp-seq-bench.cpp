@@ -0,0 +1,385 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+// Benchmarks of bpp-seq, on synthetic data of configurable scale.
+//
+// Usage: bpp-seq-bench [key=value ...]
+//   sequences=100       Number of sequences.
+//   length=10000        Number of sites (codons for alphabet=Codon).
+//   alphabet=DNA        DNA, RNA, Protein or Codon.
+//   seed=1              Seed of the generator: a seed gives the same data on all platforms.
+//   repetitions=5       Timed runs of each benchmark, after a warm-up run.
+//   filter=             Only run benchmarks whose name contains this string.
+//   align_length=1000   Length of the sequences aligned by alignNW (quadratic memory).
+//   threads=1           Threads of the global ExecutionContext (0 for one per core).
+//   format=text         text or json.
+//   output=             Output file, standard output by default.
+
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/Alphabet/DNA.h>
+#include <Bpp/Seq/Alphabet/RNA.h>
+#include <Bpp/Seq/AlphabetIndex/BLOSUM50.h>
+#include <Bpp/Seq/AlphabetIndex/CodonFromProteicAlphabetIndex2.h>
+#include <Bpp/Seq/AlphabetIndex/DefaultNucleotideScore.h>
+#include <Bpp/Seq/CodonSiteTools.h>
+#include <Bpp/Seq/Container/CompressedVectorSiteContainer.h>
+#include <Bpp/Seq/Container/SiteContainerTools.h>
+#include <Bpp/Seq/ExecutionContext.h>
+#include <Bpp/Seq/GeneticCode/StandardGeneticCode.h>
+#include <Bpp/Seq/Io/Fasta.h>
+#include <Bpp/Seq/Io/Pasta.h>
+#include <Bpp/Seq/Io/Phylip.h>
+#include <Bpp/Seq/SymbolDecoder.h>
+#include <Bpp/Seq/SymbolEncoder.h>
+
+#include "Benchmark.h"
+#include "SyntheticAlignment.h"
+
+// From the STL:
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+
+using namespace bpp;
+using namespace std;
+
+// Results are stored here, so that the compiler does not remove the benchmarked code:
+static volatile double sink = 0;
+
+static string getOption(const map<string, string>& options, const string& name, const string& defaultValue)
+{
+  auto it = options.find(name);
+  return it == options.end() ? defaultValue : it->second;
+}
+
+static void addIoBenchmarks(BenchmarkSuite& suite, shared_ptr<const Alphabet> alphabet, const VectorSiteContainer& sites, const VectorSiteContainer& completeSites)
+{
+  auto fasta = make_shared<Fasta>();
+  auto fastaText = make_shared<string>();
+  {
+    ostringstream out;
+    fasta->writeAlignment(out, sites);
+    *fastaText = out.str();
+  }
+  suite.add("io.fasta.write", "bytes", [fasta, &sites]()
+  {
+    ostringstream out;
+    fasta->writeAlignment(out, sites);
+    return static_cast<uint64_t>(out.str().size());
+  });
+  suite.add("io.fasta.read", "bytes", [fasta, fastaText, alphabet]()
+  {
+    istringstream in(*fastaText);
+    auto read = fasta->readAlignment(in, alphabet);
+    sink = static_cast<double>(read->getNumberOfSites());
+    return static_cast<uint64_t>(fastaText->size());
+  });
+
+  auto phylip = make_shared<Phylip>(true, false); // Extended, interleaved.
+  auto phylipText = make_shared<string>();
+  {
+    ostringstream out;
+    phylip->writeAlignment(out, sites);
+    *phylipText = out.str();
+  }
+  suite.add("io.phylip.write", "bytes", [phylip, &sites]()
+  {
+    ostringstream out;
+    phylip->writeAlignment(out, sites);
+    return static_cast<uint64_t>(out.str().size());
+  });
+  suite.add("io.phylip.read", "bytes", [phylip, phylipText, alphabet]()
+  {
+    istringstream in(*phylipText);
+    auto read = phylip->readAlignment(in, alphabet);
+    sink = static_cast<double>(read->getNumberOfSites());
+    return static_cast<uint64_t>(phylipText->size());
+  });
+
+  // The Pasta writer only supports resolved states, and not all alphabets:
+  auto pasta = make_shared<Pasta>();
+  auto pastaText = make_shared<string>();
+  try
+  {
+    ostringstream out;
+    pasta->writeAlignment(out, completeSites);
+    *pastaText = out.str();
+  }
+  catch (Exception& e)
+  {
+    cerr << "Pasta benchmarks skipped: " << e.what() << endl;
+    return;
+  }
+  suite.add("io.pasta.write", "bytes", [pasta, &completeSites]()
+  {
+    ostringstream out;
+    pasta->writeAlignment(out, completeSites);
+    return static_cast<uint64_t>(out.str().size());
+  });
+  suite.add("io.pasta.read", "bytes", [pasta, pastaText, alphabet]()
+  {
+    istringstream in(*pastaText);
+    auto read = pasta->readAlignment(in, alphabet);
+    sink = static_cast<double>(read->getNumberOfSites());
+    return static_cast<uint64_t>(pastaText->size());
+  });
+}
+
+static void addAlphabetBenchmarks(BenchmarkSuite& suite, shared_ptr<const Alphabet> alphabet, const VectorSiteContainer& sites)
+{
+  auto text = make_shared<string>();
+  auto content = make_shared<vector<int>>();
+  for (size_t i = 0; i < sites.getNumberOfSequences(); ++i)
+  {
+    *text += sites.sequence(i).toString();
+    const auto& states = sites.sequence(i).getContent();
+    content->insert(content->end(), states.begin(), states.end());
+  }
+
+  auto encoder = make_shared<SymbolEncoder>(alphabet);
+  suite.add("alphabet.encode", "states", [encoder, text]()
+  {
+    vector<int> states;
+    encoder->encode(*text, states);
+    return static_cast<uint64_t>(states.size());
+  });
+  suite.add("alphabet.char_to_int", "states", [alphabet, text]()
+  {
+    unsigned int size = alphabet->getStateCodingSize();
+    uint64_t n = 0;
+    int sum = 0;
+    for (size_t i = 0; i + size <= text->size(); i += size)
+    {
+      sum += alphabet->charToInt(text->substr(i, size));
+      n++;
+    }
+    sink = sum;
+    return n;
+  });
+
+  auto decoder = make_shared<SymbolDecoder>(alphabet);
+  suite.add("alphabet.decode", "states", [decoder, content]()
+  {
+    string out;
+    decoder->decode(content->data(), content->data() + content->size(), out);
+    sink = static_cast<double>(out.size());
+    return static_cast<uint64_t>(content->size());
+  });
+  suite.add("alphabet.int_to_char", "states", [alphabet, content]()
+  {
+    size_t length = 0;
+    for (int state : *content)
+    {
+      length += alphabet->intToChar(state).size();
+    }
+    sink = static_cast<double>(length);
+    return static_cast<uint64_t>(content->size());
+  });
+}
+
+static void addContainerBenchmarks(BenchmarkSuite& suite, const VectorSiteContainer& sites)
+{
+  suite.add("sites.complete", "sites", [&sites]()
+  {
+    auto selected = SiteContainerTools::getCompleteSites(sites);
+    sink = static_cast<double>(selected->getNumberOfSites());
+    return static_cast<uint64_t>(sites.getNumberOfSites());
+  });
+  suite.add("sites.without_gaps", "sites", [&sites]()
+  {
+    auto selected = SiteContainerTools::getSitesWithoutGaps(sites);
+    sink = static_cast<double>(selected->getNumberOfSites());
+    return static_cast<uint64_t>(sites.getNumberOfSites());
+  });
+  suite.add("sites.remove_gap_sites", "sites", [&sites]()
+  {
+    VectorSiteContainer copy(sites);
+    SiteContainerTools::removeGapSites(copy, 0.5);
+    sink = static_cast<double>(copy.getNumberOfSites());
+    return static_cast<uint64_t>(sites.getNumberOfSites());
+  });
+  suite.add("sites.patterns", "sites", [&sites]()
+  {
+    CompressedVectorSiteContainer patterns(sites);
+    sink = static_cast<double>(patterns.getNumberOfUniqueSites());
+    return static_cast<uint64_t>(sites.getNumberOfSites());
+  });
+  suite.add("sites.similarity_matrix", "pairs", [&sites]()
+  {
+    auto matrix = SiteContainerTools::computeSimilarityMatrix(sites);
+    sink = (*matrix)(0, matrix->size() - 1);
+    uint64_t n = sites.getNumberOfSequences();
+    return n * (n - 1) / 2;
+  });
+}
+
+static void addAlignmentBenchmarks(BenchmarkSuite& suite, shared_ptr<const Alphabet> alphabet, const VectorSiteContainer& sites, size_t alignLength, shared_ptr<const GeneticCode> gCode)
+{
+  shared_ptr<const AlphabetIndex2> score;
+  if (AlphabetTools::isDNAAlphabet(alphabet.get()))
+    score = make_shared<DefaultNucleotideScore>(new DNA());
+  else if (AlphabetTools::isRNAAlphabet(alphabet.get()))
+    score = make_shared<DefaultNucleotideScore>(new RNA());
+  else if (AlphabetTools::isProteicAlphabet(alphabet.get()))
+    score = make_shared<BLOSUM50>();
+  else if (AlphabetTools::isCodonAlphabet(alphabet.get()))
+    score = make_shared<CodonFromProteicAlphabetIndex2>(gCode, make_shared<BLOSUM50>());
+  else
+    return;
+
+  // Ungapped sequences, as alignNW ignores gaps:
+  vector<shared_ptr<Sequence>> sequences;
+  for (size_t i = 0; i < 2 && i < sites.getNumberOfSequences(); ++i)
+  {
+    vector<int> content;
+    for (int state : sites.sequence(i).getContent())
+    {
+      if (content.size() < alignLength && !alphabet->isGap(state) && !alphabet->isUnresolved(state))
+        content.push_back(state);
+    }
+    sequences.push_back(make_shared<Sequence>(sites.sequence(i).getName(), content, alphabet));
+  }
+  if (sequences.size() < 2)
+    return;
+  suite.add("align.nw", "cells", [sequences, score]()
+  {
+    auto aln = SiteContainerTools::alignNW(*sequences[0], *sequences[1], *score, -5.);
+    sink = static_cast<double>(aln->getNumberOfSites());
+    return static_cast<uint64_t>(sequences[0]->size() * sequences[1]->size());
+  });
+}
+
+static void addCodonBenchmarks(BenchmarkSuite& suite, const VectorSiteContainer& codonSites, shared_ptr<const GeneticCode> gCode)
+{
+  suite.add("codon.pi_synonymous", "sites", [&codonSites, gCode]()
+  {
+    double pi = 0;
+    for (size_t i = 0; i < codonSites.getNumberOfSites(); ++i)
+    {
+      pi += CodonSiteTools::piSynonymous(codonSites.site(i), *gCode);
+    }
+    sink = pi;
+    return static_cast<uint64_t>(codonSites.getNumberOfSites());
+  });
+  suite.add("codon.pi_non_synonymous", "sites", [&codonSites, gCode]()
+  {
+    double pi = 0;
+    for (size_t i = 0; i < codonSites.getNumberOfSites(); ++i)
+    {
+      pi += CodonSiteTools::piNonSynonymous(codonSites.site(i), *gCode);
+    }
+    sink = pi;
+    return static_cast<uint64_t>(codonSites.getNumberOfSites());
+  });
+  suite.add("codon.synonymous_positions", "sites", [&codonSites, gCode]()
+  {
+    double n = 0;
+    for (size_t i = 0; i < codonSites.getNumberOfSites(); ++i)
+    {
+      n += CodonSiteTools::meanNumberOfSynonymousPositions(codonSites.site(i), *gCode);
+    }
+    sink = n;
+    return static_cast<uint64_t>(codonSites.getNumberOfSites());
+  });
+  suite.add("codon.substitutions", "sites", [&codonSites, gCode]()
+  {
+    size_t n = 0;
+    for (size_t i = 0; i < codonSites.getNumberOfSites(); ++i)
+    {
+      n += CodonSiteTools::numberOfSubstitutions(codonSites.site(i), *gCode);
+    }
+    sink = static_cast<double>(n);
+    return static_cast<uint64_t>(codonSites.getNumberOfSites());
+  });
+}
+
+int main(int argc, char* argv[])
+{
+  map<string, string> options;
+  for (int i = 1; i < argc; ++i)
+  {
+    string arg = argv[i];
+    size_t pos = arg.find('=');
+    if (pos == string::npos)
+    {
+      cerr << "Invalid argument '" << arg << "', arguments are given as key=value." << endl;
+      return 1;
+    }
+    options[arg.substr(0, pos)] = arg.substr(pos + 1);
+  }
+
+  try
+  {
+    size_t nbSequences = stoul(getOption(options, "sequences", "100"));
+    size_t length = stoul(getOption(options, "length", "10000"));
+    string alphabetName = getOption(options, "alphabet", "DNA");
+    uint64_t seed = stoull(getOption(options, "seed", "1"));
+    size_t repetitions = stoul(getOption(options, "repetitions", "5"));
+    string filter = getOption(options, "filter", "");
+    size_t alignLength = stoul(getOption(options, "align_length", "1000"));
+    unsigned int threads = static_cast<unsigned int>(stoul(getOption(options, "threads", "1")));
+    string format = getOption(options, "format", "text");
+    string outputPath = getOption(options, "output", "");
+    if (format != "text" && format != "json")
+      throw Exception("Unknown format '" + format + "', should be text or json.");
+
+    shared_ptr<const Alphabet> alphabet;
+    if (alphabetName == "DNA")
+      alphabet = AlphabetTools::DNA_ALPHABET;
+    else if (alphabetName == "RNA")
+      alphabet = AlphabetTools::RNA_ALPHABET;
+    else if (alphabetName == "Protein")
+      alphabet = AlphabetTools::PROTEIN_ALPHABET;
+    else if (alphabetName == "Codon")
+      alphabet = AlphabetTools::DNA_CODON_ALPHABET;
+    else
+      throw Exception("Unknown alphabet '" + alphabetName + "', should be DNA, RNA, Protein or Codon.");
+    ExecutionContext::global().setNumberOfThreads(threads);
+
+    // Codon statistics use their own alignment, without gaps nor stop codons:
+    shared_ptr<const GeneticCode> gCode = make_shared<StandardGeneticCode>(AlphabetTools::DNA_ALPHABET);
+    SyntheticAlignment generator(seed);
+    auto sites = generator.generate(alphabet, nbSequences, length, alphabetName == "Codon" ? gCode : nullptr);
+    auto completeSites = generator.generate(alphabet, nbSequences, length, alphabetName == "Codon" ? gCode : nullptr, false);
+    auto codonSites = generator.generate(AlphabetTools::DNA_CODON_ALPHABET, nbSequences, alphabetName == "Codon" ? length : length / 3, gCode, false);
+
+    BenchmarkSuite suite;
+    addIoBenchmarks(suite, alphabet, *sites, *completeSites);
+    addAlphabetBenchmarks(suite, alphabet, *sites);
+    addContainerBenchmarks(suite, *sites);
+    addAlignmentBenchmarks(suite, alphabet, *sites, alignLength, gCode);
+    addCodonBenchmarks(suite, *codonSites, gCode);
+    suite.run(repetitions, filter, &cerr);
+
+    map<string, string> config;
+    config["sequences"] = to_string(nbSequences);
+    config["length"] = to_string(length);
+    config["alphabet"] = alphabetName;
+    config["seed"] = to_string(seed);
+    config["repetitions"] = to_string(repetitions);
+    config["align_length"] = to_string(alignLength);
+    config["threads"] = to_string(ExecutionContext::global().getNumberOfWorkers());
+
+    ofstream file;
+    if (!outputPath.empty())
+    {
+      file.open(outputPath.c_str(), ios::out | ios::trunc);
+      if (!file)
+        throw IOException("Can't write file " + outputPath + ".");
+    }
+    ostream& out = outputPath.empty() ? cout : file;
+    if (format == "json")
+      suite.writeJson(out, config);
+    else
+      suite.print(out);
+  }
+  catch (exception& e)
+  {
+    cerr << "Error: " << e.what() << endl;
+    return 1;
+  }
+  return 0;
+}
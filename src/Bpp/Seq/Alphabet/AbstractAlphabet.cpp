@@ -39,6 +39,7 @@ void AbstractAlphabet::registerState(AlphabetState* st)
   alphabet_.push_back(st);
   // Update the maps
   updateMaps_(alphabet_.size() - 1, *st);
+  resetLists_();
 }
 
 /******************************************************************************/
@@ -54,6 +55,7 @@ void AbstractAlphabet::setState(size_t pos, AlphabetState* st)
   alphabet_[pos] = st;
   // Update the maps
   updateMaps_(pos, *st);
+  resetLists_();
 }
 
 /******************************************************************************/
@@ -292,14 +294,19 @@ std::string AbstractAlphabet::getGeneric(const std::vector<std::string>& states)
 
 const std::vector<int>& AbstractAlphabet::getSupportedInts() const
 {
-  if (intList_.size() != alphabet_.size())
+  if (!supportedReady_.load(std::memory_order_acquire))
   {
-    intList_.resize(alphabet_.size());
-    charList_.resize(alphabet_.size());
-    for (size_t i = 0; i < alphabet_.size(); ++i)
+    lock_guard<mutex> lock(listsMutex_);
+    if (!supportedReady_.load(std::memory_order_relaxed))
     {
-      intList_[i]  = alphabet_[i]->getNum();
-      charList_[i] = alphabet_[i]->getLetter();
+      intList_.resize(alphabet_.size());
+      charList_.resize(alphabet_.size());
+      for (size_t i = 0; i < alphabet_.size(); ++i)
+      {
+        intList_[i]  = alphabet_[i]->getNum();
+        charList_[i] = alphabet_[i]->getLetter();
+      }
+      supportedReady_.store(true, std::memory_order_release);
     }
   }
   return intList_;
@@ -309,16 +316,7 @@ const std::vector<int>& AbstractAlphabet::getSupportedInts() const
 
 const std::vector<std::string>& AbstractAlphabet::getSupportedChars() const
 {
-  if (charList_.size() != alphabet_.size())
-  {
-    intList_.resize(alphabet_.size());
-    charList_.resize(alphabet_.size());
-    for (size_t i = 0; i < alphabet_.size(); ++i)
-    {
-      intList_[i]  = alphabet_[i]->getNum();
-      charList_[i] = alphabet_[i]->getLetter();
-    }
-  }
+  getSupportedInts(); // Both lists are computed together.
   return charList_;
 }
 
@@ -326,13 +324,20 @@ const std::vector<std::string>& AbstractAlphabet::getSupportedChars() const
 
 const std::vector<std::string>& AbstractAlphabet::getResolvedChars() const
 {
-  charList_.clear();
-  for (size_t i = 0; i < alphabet_.size(); ++i)
+  if (!resolvedReady_.load(std::memory_order_acquire))
   {
-    // well, non-gap chars also
-    if (!isGap(alphabet_[i]->getLetter()) and !isUnresolved(alphabet_[i]->getLetter()))
-      charList_.push_back(alphabet_[i]->getLetter());
+    lock_guard<mutex> lock(listsMutex_);
+    if (!resolvedReady_.load(std::memory_order_relaxed))
+    {
+      resolvedCharList_.clear();
+      for (size_t i = 0; i < alphabet_.size(); ++i)
+      {
+        // well, non-gap chars also
+        if (!isGap(alphabet_[i]->getLetter()) and !isUnresolved(alphabet_[i]->getLetter()))
+          resolvedCharList_.push_back(alphabet_[i]->getLetter());
+      }
+      resolvedReady_.store(true, std::memory_order_release);
+    }
   }
-
-  return charList_;
+  return resolvedCharList_;
 }
@@ -11,6 +11,8 @@
 #include "AlphabetState.h"
 
 // From the STL:
+#include <atomic>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <map>
@@ -25,6 +27,9 @@ namespace bpp
  * but do not provide any method to initialize it.
  * This is up to each constructor of the derived classes.
  *
+ * All const methods can be called concurrently from several threads, once
+ * the alphabet is constructed.
+ *
  * @see Alphabet
  */
 class AbstractAlphabet :
@@ -52,22 +57,42 @@ private:
    */
   void updateMaps_(size_t pos, const AlphabetState& st);
 
+  /**
+   * @name Guards of the lists of available codes.
+   *
+   * The flags are reset whenever the alphabet is modified, and the lists are
+   * computed under the lock the first time they are requested.
+   *
+   * @{
+   */
+  mutable std::atomic<bool> supportedReady_;
+  mutable std::atomic<bool> resolvedReady_;
+  mutable std::mutex listsMutex_;
+  /** @} */
+
 protected:
   /**
    * @name Available codes
    *
-   * These vectors will be computed the first time you call the getAvailableInts or getAvailableChars method.
+   * These vectors will be computed the first time you call the getSupportedInts, getSupportedChars or getResolvedChars method.
    *
    * @{
    */
   mutable std::vector<std::string> charList_;
   mutable std::vector<int> intList_;
+  mutable std::vector<std::string> resolvedCharList_;
   /** @} */
 
 public:
-  AbstractAlphabet() : alphabet_(), letters_(), nums_(), charList_(), intList_() {}
-
-  AbstractAlphabet(const AbstractAlphabet& alph) : alphabet_(), letters_(alph.letters_), nums_(alph.nums_), charList_(alph.charList_), intList_(alph.intList_)
+  AbstractAlphabet() :
+    alphabet_(), letters_(), nums_(),
+    supportedReady_(false), resolvedReady_(false), listsMutex_(),
+    charList_(), intList_(), resolvedCharList_() {}
+
+  AbstractAlphabet(const AbstractAlphabet& alph) :
+    alphabet_(), letters_(alph.letters_), nums_(alph.nums_),
+    supportedReady_(false), resolvedReady_(false), listsMutex_(),
+    charList_(), intList_(), resolvedCharList_()
   {
     for (size_t i = 0; i < alph.alphabet_.size(); ++i)
     {
@@ -89,8 +114,7 @@ public:
 
     letters_  = alph.letters_;
     nums_     = alph.nums_;
-    charList_ = alph.charList_;
-    intList_  = alph.intList_;
+    resetLists_();
 
     return *this;
   }
@@ -223,7 +247,11 @@ protected:
    *
    * @param size The new size of the Alphabet.
    */
-  void resize(size_t size) { alphabet_.resize(size); }
+  void resize(size_t size)
+  {
+    alphabet_.resize(size);
+    resetLists_();
+  }
 
   /**
    * @brief Re-update the maps using the alphabet_ vector content.
@@ -236,6 +264,18 @@ protected:
     {
       updateMaps_(i, *alphabet_[i]);
     }
+    resetLists_();
+  }
+
+  /**
+   * @brief Invalidate the lists of available codes, after the alphabet has been modified.
+   *
+   * Modifications are not thread-safe, and should only happen during construction.
+   */
+  void resetLists_()
+  {
+    supportedReady_.store(false);
+    resolvedReady_.store(false);
   }
 
   unsigned int getStateCodingSize() const { return 1; }
@@ -0,0 +1,428 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Text/TextTools.h>
+
+#include "../Alphabet/AlphabetExceptions.h"
+#include "../Alphabet/AlphabetTools.h"
+#include "../Container/SequenceContainerTools.h"
+#include "AAIndexDatabase.h"
+
+// From the STL:
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+using namespace bpp;
+using namespace std;
+
+namespace
+{
+// Amino acids are in the same order in the AAindex databases and in the ProteicAlphabet class:
+const string AMINO_ACIDS = "ARNDCQEGHILKMFPSTWYV";
+
+/**
+ * @brief Parse all the numbers of a line, "NA" and "-" being missing values.
+ */
+void parseNumbers(const string& line, vector<double>& values)
+{
+  values.clear();
+  const char* p = line.c_str();
+  while (true)
+  {
+    while (*p == ' ' || *p == '\t' || *p == '\r')
+    {
+      ++p;
+    }
+    if (*p == '\0')
+      break;
+    if ((p[0] == 'N' && p[1] == 'A') || (p[0] == '-' && (p[1] == ' ' || p[1] == '\0')))
+    {
+      values.push_back(numeric_limits<double>::quiet_NaN());
+      p += p[0] == 'N' ? 2 : 1;
+      continue;
+    }
+    char* end;
+    double value = strtod(p, &end);
+    if (end == p)
+      throw IOException("AAIndexDatabase. Invalid number in line: " + line);
+    values.push_back(value);
+    p = end;
+  }
+}
+
+bool getLine(istream& input, string& line)
+{
+  while (getline(input, line))
+  {
+    if (!TextTools::isEmpty(line))
+      return true;
+  }
+  return false;
+}
+}
+
+/******************************************************************************/
+
+AAIndexDatabase::AAIndexDatabase(std::istream& input, bool sym) :
+  type_(INDEX1),
+  accessions_(),
+  descriptions_(),
+  values_(),
+  accessionIndex_(),
+  hasMissingValues_(false)
+{
+  string line;
+  while (getLine(input, line))
+  {
+    if (line[0] == 'H')
+      readEntry_(input, line, sym);
+    else if (line.compare(0, 2, "//") != 0)
+      throw IOException("AAIndexDatabase. Entry does not start with an H line: " + line);
+  }
+  for (double v : values_)
+  {
+    if (std::isnan(v))
+    {
+      hasMissingValues_ = true;
+      break;
+    }
+  }
+}
+
+/******************************************************************************/
+
+void AAIndexDatabase::readEntry_(std::istream& input, const std::string& firstLine, bool sym)
+{
+  string accession = TextTools::removeSurroundingWhiteSpaces(firstLine.substr(1));
+  string description;
+  char field = 'H';
+  bool found = false;
+  string line;
+  vector<double> numbers;
+  while (getLine(input, line))
+  {
+    if (line.compare(0, 2, "//") == 0)
+      break;
+    if (line[0] != ' ')
+      field = line[0];
+    if (field == 'D')
+    {
+      if (!description.empty())
+        description += " ";
+      description += TextTools::removeSurroundingWhiteSpaces(line.substr(1));
+    }
+    else if (line[0] == 'I' || line[0] == 'M')
+    {
+      Type type = line[0] == 'I' ? INDEX1 : INDEX2;
+      if (accessions_.empty())
+        type_ = type;
+      else if (type != type_)
+        throw IOException("AAIndexDatabase. Entry " + accession + " is not of the same type as the previous ones.");
+      size_t offset = values_.size();
+      values_.resize(offset + getNumberOfValues(), numeric_limits<double>::quiet_NaN());
+      double* values = &values_[offset];
+      if (type == INDEX1)
+      {
+        for (size_t i = 0; i < 2; ++i)
+        {
+          if (!getLine(input, line))
+            throw IOException("AAIndexDatabase. Unexpected end of file in entry " + accession + ".");
+          parseNumbers(line, numbers);
+          if (numbers.size() != 10)
+            throw IOException("AAIndexDatabase. Entry " + accession + " does not have 20 values.");
+          copy(numbers.begin(), numbers.end(), values + 10 * i);
+        }
+      }
+      else
+      {
+        // M rows = ARNDCQEGHILKMFPSTWYV, cols = ARNDCQEGHILKMFPSTWYV
+        size_t rowsPos = line.find("rows = ");
+        size_t colsPos = line.find("cols = ");
+        if (rowsPos == string::npos || colsPos == string::npos)
+          throw IOException("AAIndexDatabase. Invalid M line in entry " + accession + ": " + line);
+        string rows = line.substr(rowsPos + 7, line.find(',', rowsPos) - rowsPos - 7);
+        string cols = TextTools::removeSurroundingWhiteSpaces(line.substr(colsPos + 7));
+        bool triangle = false;
+        for (size_t i = 0; i < rows.size(); ++i)
+        {
+          if (!getLine(input, line))
+            throw IOException("AAIndexDatabase. Unexpected end of file in entry " + accession + ".");
+          parseNumbers(line, numbers);
+          if (i == 0 && numbers.size() == 1 && cols.size() > 1)
+            triangle = true;
+          if (numbers.size() != (triangle ? i + 1 : cols.size()))
+            throw IOException("AAIndexDatabase. Invalid number of values in matrix " + accession + ".");
+          size_t a = AMINO_ACIDS.find(rows[i]);
+          if (a == string::npos)
+            continue; // Not one of the 20 amino acids.
+          for (size_t j = 0; j < numbers.size(); ++j)
+          {
+            size_t b = AMINO_ACIDS.find(cols[j]);
+            if (b == string::npos)
+              continue;
+            values[a * 20 + b] = numbers[j];
+            if (triangle && a != b)
+              values[b * 20 + a] = sym ? numbers[j] : -numbers[j];
+          }
+        }
+      }
+      found = true;
+    }
+  }
+  if (!found)
+    throw IOException("AAIndexDatabase. No values in entry " + accession + ".");
+  accessionIndex_[accession] = accessions_.size();
+  accessions_.push_back(accession);
+  descriptions_.push_back(description);
+}
+
+/******************************************************************************/
+
+size_t AAIndexDatabase::getEntryIndex(const std::string& accession) const
+{
+  auto it = accessionIndex_.find(accession);
+  if (it == accessionIndex_.end())
+    throw Exception("AAIndexDatabase::getEntryIndex. No entry " + accession + ".");
+  return it->second;
+}
+
+/******************************************************************************/
+
+unique_ptr<UserAlphabetIndex1> AAIndexDatabase::getIndex1(size_t i) const
+{
+  if (type_ != INDEX1)
+    throw Exception("AAIndexDatabase::getIndex1. Not an AAindex1 database.");
+  shared_ptr<const Alphabet> alphabet = AlphabetTools::PROTEIN_ALPHABET;
+  auto index = make_unique<UserAlphabetIndex1>(alphabet);
+  const double* values = getValues(i);
+  for (int a = 0; a < 20; ++a)
+  {
+    index->setIndex(a, values[a]);
+  }
+  return index;
+}
+
+/******************************************************************************/
+
+RowMatrix<double> AAIndexDatabase::getMatrix(size_t i) const
+{
+  if (type_ != INDEX2)
+    throw Exception("AAIndexDatabase::getMatrix. Not an AAindex2 or AAindex3 database.");
+  RowMatrix<double> matrix(20, 20);
+  const double* values = getValues(i);
+  for (size_t a = 0; a < 20; ++a)
+  {
+    for (size_t b = 0; b < 20; ++b)
+    {
+      matrix(a, b) = values[a * 20 + b];
+    }
+  }
+  return matrix;
+}
+
+/******************************************************************************/
+
+void AAIndexDatabase::checkScoring_(const Alphabet& alphabet) const
+{
+  if (type_ != INDEX1)
+    throw Exception("AAIndexDatabase. Only AAindex1 databases can be used to score sequences.");
+  if (!AlphabetTools::isProteicAlphabet(&alphabet))
+    throw AlphabetException("AAIndexDatabase. Sequences must be proteins.", &alphabet);
+}
+
+/******************************************************************************/
+
+void AAIndexDatabase::getScoringTables_(std::vector<double>& values, std::vector<double>& available) const
+{
+  size_t n = size();
+  values.resize(20 * n);
+  available.clear();
+  if (hasMissingValues_)
+    available.resize(20 * n);
+  for (size_t e = 0; e < n; ++e)
+  {
+    for (size_t a = 0; a < 20; ++a)
+    {
+      double v = values_[e * 20 + a];
+      bool ok = !std::isnan(v);
+      values[a * n + e] = ok ? v : 0.;
+      if (hasMissingValues_)
+        available[a * n + e] = ok ? 1. : 0.;
+    }
+  }
+}
+
+/******************************************************************************/
+
+void AAIndexDatabase::computeMeans_(
+    const std::vector<double>& values,
+    const std::vector<double>& available,
+    const std::vector<double>& counts,
+    double* means) const
+{
+  size_t n = size();
+  vector<double> sums(n, 0.);
+  vector<double> totals(n, 0.);
+  double total = 0;
+  for (size_t a = 0; a < 20; ++a)
+  {
+    double c = counts[a];
+    if (c == 0)
+      continue;
+    total += c;
+    const double* v = &values[a * n];
+    for (size_t e = 0; e < n; ++e)
+    {
+      sums[e] += c * v[e];
+    }
+    if (!available.empty())
+    {
+      const double* ok = &available[a * n];
+      for (size_t e = 0; e < n; ++e)
+      {
+        totals[e] += c * ok[e];
+      }
+    }
+  }
+  for (size_t e = 0; e < n; ++e)
+  {
+    double t = available.empty() ? total : totals[e];
+    means[e] = t > 0 ? sums[e] / t : numeric_limits<double>::quiet_NaN();
+  }
+}
+
+/******************************************************************************/
+
+RowMatrix<double> AAIndexDatabase::getMeans(
+    const SequenceContainerInterface& sequences,
+    const ExecutionContext& context) const
+{
+  checkScoring_(*sequences.getAlphabet());
+  vector<double> values, available;
+  getScoringTables_(values, available);
+  size_t nbSequences = sequences.getNumberOfSequences();
+  size_t n = size();
+  RowMatrix<double> means(nbSequences, n);
+  SequenceContainerTools::prepareSequenceAccess(sequences, context);
+  context.forEachBlock(nbSequences, [&](size_t begin, size_t end)
+  {
+    vector<double> counts(20);
+    vector<double> row(n);
+    for (size_t i = begin; i < end; ++i)
+    {
+      fill(counts.begin(), counts.end(), 0.);
+      for (int state : sequences.sequence(i).getContent())
+      {
+        if (static_cast<unsigned int>(state) < 20)
+          counts[static_cast<size_t>(state)]++;
+      }
+      if (n > 0)
+        computeMeans_(values, available, counts, &row[0]);
+      for (size_t e = 0; e < n; ++e)
+      {
+        means(i, e) = row[e];
+      }
+    }
+  }, SequenceContainerTools::SEQUENCES_PER_BLOCK);
+  return means;
+}
+
+/******************************************************************************/
+
+RowMatrix<double> AAIndexDatabase::getSlidingMeans(const IntSymbolListInterface& sequence, size_t window) const
+{
+  checkScoring_(*sequence.getAlphabet());
+  if (window == 0 || window > sequence.size())
+    throw BadIntegerException("AAIndexDatabase::getSlidingMeans. Window size must be between 1 and the length of the sequence.", static_cast<int>(window));
+  vector<double> values, available;
+  getScoringTables_(values, available);
+  return getSlidingMeans_(values, available, sequence.getContent(), window);
+}
+
+/******************************************************************************/
+
+RowMatrix<double> AAIndexDatabase::getSlidingMeans_(
+    const std::vector<double>& values,
+    const std::vector<double>& available,
+    const std::vector<int>& states,
+    size_t window) const
+{
+  size_t n = size();
+  size_t nbWindows = states.size() - window + 1;
+  RowMatrix<double> means(nbWindows, n);
+
+  // Sums are updated with the amino acids entering and leaving the window:
+  vector<double> sums(n, 0.);
+  vector<double> totals(n, 0.);
+  double total = 0;
+  auto update = [&](int state, double sign)
+  {
+    if (static_cast<unsigned int>(state) >= 20)
+      return;
+    size_t a = static_cast<size_t>(state);
+    total += sign;
+    const double* v = &values[a * n];
+    for (size_t e = 0; e < n; ++e)
+    {
+      sums[e] += sign * v[e];
+    }
+    if (!available.empty())
+    {
+      const double* ok = &available[a * n];
+      for (size_t e = 0; e < n; ++e)
+      {
+        totals[e] += sign * ok[e];
+      }
+    }
+  };
+  for (size_t l = 0; l < window; ++l)
+  {
+    update(states[l], 1.);
+  }
+  for (size_t k = 0; k < nbWindows; ++k)
+  {
+    if (k > 0)
+    {
+      update(states[k - 1], -1.);
+      update(states[k + window - 1], 1.);
+    }
+    for (size_t e = 0; e < n; ++e)
+    {
+      double t = available.empty() ? total : totals[e];
+      means(k, e) = t > 0 ? sums[e] / t : numeric_limits<double>::quiet_NaN();
+    }
+  }
+  return means;
+}
+
+/******************************************************************************/
+
+vector< RowMatrix<double>> AAIndexDatabase::getSlidingMeans(
+    const SequenceContainerInterface& sequences,
+    size_t window,
+    const ExecutionContext& context) const
+{
+  checkScoring_(*sequences.getAlphabet());
+  size_t nbSequences = sequences.getNumberOfSequences();
+  SequenceContainerTools::prepareSequenceAccess(sequences, context);
+  for (size_t i = 0; i < nbSequences; ++i)
+  {
+    if (window == 0 || window > sequences.sequence(i).size())
+      throw BadIntegerException("AAIndexDatabase::getSlidingMeans. Window size must be between 1 and the length of the sequences.", static_cast<int>(window));
+  }
+  vector<double> values, available;
+  getScoringTables_(values, available);
+  vector< RowMatrix<double>> means(nbSequences);
+  context.forEachBlock(nbSequences, [&](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      means[i] = getSlidingMeans_(values, available, sequences.sequence(i).getContent(), window);
+    }
+  }, SequenceContainerTools::SEQUENCES_PER_BLOCK);
+  return means;
+}
+
+/******************************************************************************/
@@ -0,0 +1,188 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_ALPHABETINDEX_AAINDEXDATABASE_H
+#define BPP_SEQ_ALPHABETINDEX_AAINDEXDATABASE_H
+
+#include <Bpp/Exceptions.h>
+#include <Bpp/Numeric/Matrix/Matrix.h>
+
+#include "../Container/SequenceContainer.h"
+#include "../ExecutionContext.h"
+#include "../IntSymbolList.h"
+#include "UserAlphabetIndex1.h"
+
+// From the STL:
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief A whole AAindex database, loaded in a compact table.
+ *
+ * The AAindex1 database (amino acid properties) is stored as one row of 20
+ * values per index, and the AAindex2 and AAindex3 databases (substitution
+ * and contact matrices) as one row of 20 x 20 values per matrix, amino acids
+ * being in the order of the ProteicAlphabet. Missing values ("NA") are NaN.
+ *
+ * Properties of the AAindex1 database can be applied to many sequences at
+ * once: sequences are reduced to their amino acid composition (globally, or
+ * over sliding windows), which is then multiplied by the table, giving the
+ * values of all indices in a single pass over each sequence.
+ *
+ * @see AAIndex1Entry, AAIndex2Entry to parse a single entry.
+ */
+class AAIndexDatabase
+{
+public:
+  enum Type
+  {
+    INDEX1, ///< One value per amino acid.
+    INDEX2  ///< One value per pair of amino acids.
+  };
+
+private:
+  Type type_;
+  std::vector<std::string> accessions_;
+  std::vector<std::string> descriptions_;
+  std::vector<double> values_; // One row of 20 or 400 values per entry.
+  std::unordered_map<std::string, size_t> accessionIndex_;
+  bool hasMissingValues_;
+
+public:
+  /**
+   * @brief Read a whole database file.
+   *
+   * The type of the database is given by its first entry (I or M field),
+   * all entries must then be of the same type.
+   *
+   * @param input The input stream to use.
+   * @param sym   For matrices given as a lower triangle, tell if the upper triangle is built
+   * by symmetry (true), or set to the opposite of the lower triangle (false), as in AAIndex2Entry.
+   * @throw IOException If the stream content does not follow the AAindex format.
+   */
+  AAIndexDatabase(std::istream& input, bool sym = true);
+
+  virtual ~AAIndexDatabase() {}
+
+public:
+  Type getType() const { return type_; }
+
+  /**
+   * @return The number of entries.
+   */
+  size_t size() const { return accessions_.size(); }
+
+  /**
+   * @return The number of values per entry, 20 or 400.
+   */
+  size_t getNumberOfValues() const { return type_ == INDEX1 ? 20 : 400; }
+
+  const std::string& getAccession(size_t i) const { return accessions_[i]; }
+
+  const std::vector<std::string>& getAccessions() const { return accessions_; }
+
+  const std::string& getDescription(size_t i) const { return descriptions_[i]; }
+
+  /**
+   * @return The position of an entry in the database.
+   * @throw Exception If there is no entry with this accession number.
+   */
+  size_t getEntryIndex(const std::string& accession) const;
+
+  /**
+   * @return True if at least one value is missing.
+   */
+  bool hasMissingValues() const { return hasMissingValues_; }
+
+  /**
+   * @return The values of an entry: 20 values, or 400 values row by row.
+   */
+  const double* getValues(size_t i) const { return &values_[i * getNumberOfValues()]; }
+
+  /**
+   * @return An index of the AAindex1 database, as an AlphabetIndex1 object.
+   * @throw Exception If the database is not of type INDEX1.
+   */
+  std::unique_ptr<UserAlphabetIndex1> getIndex1(size_t i) const;
+
+  /**
+   * @return A matrix of the AAindex2 or AAindex3 database.
+   * @throw Exception If the database is not of type INDEX2.
+   */
+  RowMatrix<double> getMatrix(size_t i) const;
+
+  /**
+   * @brief Average all indices over whole sequences.
+   *
+   * Gaps and unresolved states are not counted, nor are amino acids with
+   * a missing value for a given index.
+   *
+   * @param sequences The protein sequences.
+   * @param context   The execution context to be used, sequences being processed in parallel.
+   * @return A matrix with one row per sequence and one column per index.
+   * @throw Exception If the database is not of type INDEX1.
+   * @throw AlphabetException If the sequences are not proteins.
+   */
+  RowMatrix<double> getMeans(
+      const SequenceContainerInterface& sequences,
+      const ExecutionContext& context = ExecutionContext::global()) const;
+
+  /**
+   * @brief Average all indices over sliding windows along a sequence.
+   *
+   * @param sequence The protein sequence.
+   * @param window   The size of the windows.
+   * @return A matrix with one row per window (the kth one starting at position k) and one column per index.
+   * @throw Exception If the database is not of type INDEX1.
+   * @throw AlphabetException If the sequence is not a protein.
+   * @throw BadIntegerException If the window is empty or longer than the sequence.
+   */
+  RowMatrix<double> getSlidingMeans(const IntSymbolListInterface& sequence, size_t window) const;
+
+  /**
+   * @brief Average all indices over sliding windows along several sequences.
+   *
+   * @param sequences The protein sequences.
+   * @param window    The size of the windows.
+   * @param context   The execution context to be used, sequences being processed in parallel.
+   * @return One matrix per sequence, as given by getSlidingMeans(const IntSymbolListInterface&, size_t).
+   */
+  std::vector< RowMatrix<double>> getSlidingMeans(
+      const SequenceContainerInterface& sequences,
+      size_t window,
+      const ExecutionContext& context = ExecutionContext::global()) const;
+
+private:
+  void readEntry_(std::istream& input, const std::string& firstLine, bool sym);
+
+  void checkScoring_(const Alphabet& alphabet) const;
+
+  /**
+   * @brief Get the table of values, amino acid by amino acid, with 0 for missing values,
+   * and the corresponding 0/1 table of available values if some are missing.
+   */
+  void getScoringTables_(std::vector<double>& values, std::vector<double>& available) const;
+
+  /**
+   * @brief Compute the means of all indices from an amino acid composition.
+   */
+  void computeMeans_(
+      const std::vector<double>& values,
+      const std::vector<double>& available,
+      const std::vector<double>& counts,
+      double* means) const;
+
+  RowMatrix<double> getSlidingMeans_(
+      const std::vector<double>& values,
+      const std::vector<double>& available,
+      const std::vector<int>& states,
+      size_t window) const;
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_ALPHABETINDEX_AAINDEXDATABASE_H
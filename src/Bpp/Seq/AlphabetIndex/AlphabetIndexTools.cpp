@@ -0,0 +1,313 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "../Alphabet/AlphabetExceptions.h"
+#include "../Alphabet/AlphabetTools.h"
+#include "../Container/SequenceContainerTools.h"
+#include "AlphabetIndexTools.h"
+
+// From the STL:
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace bpp;
+using namespace std;
+
+const double AlphabetIndexTools::StateTable::NaN = numeric_limits<double>::quiet_NaN();
+
+/******************************************************************************/
+
+AlphabetIndexTools::StateTable::StateTable(const AlphabetIndex1& index) :
+  values_(),
+  offset_(0)
+{
+  auto alphabet = index.getAlphabet();
+  const vector<int>& states = alphabet->getSupportedInts();
+  const vector<double>& indices = index.indexVector();
+  vector<double> values(states.size(), NaN);
+  for (size_t i = 0; i < states.size(); ++i)
+  {
+    int state = states[i];
+    if (state < 0 || static_cast<unsigned int>(state) >= alphabet->getSize())
+      continue; // Gap or unresolved state.
+    size_t pos = alphabet->getStateIndex(state) - 1;
+    if (pos < indices.size())
+      values[i] = indices[pos];
+  }
+  *this = StateTable(*alphabet, values);
+}
+
+/******************************************************************************/
+
+AlphabetIndexTools::StateTable::StateTable(const Alphabet& alphabet, const std::vector<double>& values) :
+  values_(),
+  offset_(0)
+{
+  const vector<int>& states = alphabet.getSupportedInts();
+  if (values.size() != states.size())
+    throw DimensionException("AlphabetIndexTools::StateTable. There must be one value per state.", values.size(), states.size());
+  if (states.empty())
+    return;
+  int minState = *min_element(states.begin(), states.end());
+  int maxState = *max_element(states.begin(), states.end());
+  offset_ = -minState;
+  values_.assign(static_cast<size_t>(maxState - minState + 1), NaN);
+  for (size_t i = 0; i < states.size(); ++i)
+  {
+    values_[static_cast<size_t>(states[i] + offset_)] = values[i];
+  }
+}
+
+/******************************************************************************/
+
+void AlphabetIndexTools::StateTable::apply(const std::vector<int>& states, std::vector<double>& values) const
+{
+  size_t n = states.size();
+  values.resize(n);
+  const int* s = states.data();
+  const double* table = values_.data();
+  size_t tableSize = values_.size();
+  double* v = values.data();
+  // Branch-free gather, which the compiler can vectorize:
+  for (size_t i = 0; i < n; ++i)
+  {
+    size_t k = static_cast<size_t>(s[i] + offset_);
+    v[i] = k < tableSize ? table[k] : NaN;
+  }
+}
+
+/******************************************************************************/
+
+void AlphabetIndexTools::getValues(const AlphabetIndex1& index, const IntSymbolListInterface& list, std::vector<double>& values)
+{
+  if (index.getAlphabet()->getAlphabetType() != list.getAlphabet()->getAlphabetType())
+    throw AlphabetMismatchException("AlphabetIndexTools::getValues. Index and list do not have the same alphabet.", index.getAlphabet(), list.getAlphabet());
+  StateTable(index).apply(list.getContent(), values);
+}
+
+/******************************************************************************/
+
+vector< vector<double>> AlphabetIndexTools::getValues(
+    const AlphabetIndex1& index,
+    const SequenceContainerInterface& sequences,
+    const ExecutionContext& context)
+{
+  if (index.getAlphabet()->getAlphabetType() != sequences.getAlphabet()->getAlphabetType())
+    throw AlphabetMismatchException("AlphabetIndexTools::getValues. Index and sequences do not have the same alphabet.", index.getAlphabet(), sequences.getAlphabet());
+  StateTable table(index);
+  size_t n = sequences.getNumberOfSequences();
+  vector< vector<double>> values(n);
+  SequenceContainerTools::prepareSequenceAccess(sequences, context);
+  context.forEachBlock(n, [&](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      table.apply(sequences.sequence(i).getContent(), values[i]);
+    }
+  }, SequenceContainerTools::SEQUENCES_PER_BLOCK);
+  return values;
+}
+
+/******************************************************************************/
+
+void AlphabetIndexTools::checkWindow_(size_t size, size_t window)
+{
+  if (window == 0 || window > size)
+    throw BadIntegerException("AlphabetIndexTools. Window size must be between 1 and the length of the list.", static_cast<int>(window));
+}
+
+/******************************************************************************/
+
+void AlphabetIndexTools::getSlidingSums(
+    const std::vector<double>& values,
+    size_t window,
+    std::vector<double>& sums,
+    std::vector<double>* counts)
+{
+  size_t n = values.size();
+  checkWindow_(n, window);
+  // Cumulated sums, skipping NaN:
+  vector<double> cumSums(n + 1);
+  vector<double> cumCounts(n + 1);
+  cumSums[0] = 0;
+  cumCounts[0] = 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    bool ok = !std::isnan(values[i]);
+    cumSums[i + 1] = cumSums[i] + (ok ? values[i] : 0.);
+    cumCounts[i + 1] = cumCounts[i] + (ok ? 1. : 0.);
+  }
+  size_t nbWindows = n - window + 1;
+  sums.resize(nbWindows);
+  for (size_t k = 0; k < nbWindows; ++k)
+  {
+    sums[k] = cumSums[k + window] - cumSums[k];
+  }
+  if (counts)
+  {
+    counts->resize(nbWindows);
+    for (size_t k = 0; k < nbWindows; ++k)
+    {
+      (*counts)[k] = cumCounts[k + window] - cumCounts[k];
+    }
+  }
+}
+
+/******************************************************************************/
+
+void AlphabetIndexTools::getSlidingMeans(
+    const std::vector<double>& values,
+    size_t window,
+    std::vector<double>& means)
+{
+  vector<double> counts;
+  getSlidingSums(values, window, means, &counts);
+  for (size_t k = 0; k < means.size(); ++k)
+  {
+    means[k] = counts[k] > 0 ? means[k] / counts[k] : StateTable::NaN;
+  }
+}
+
+/******************************************************************************/
+
+vector<double> AlphabetIndexTools::getSlidingMeans(const AlphabetIndex1& index, const IntSymbolListInterface& list, size_t window)
+{
+  vector<double> values;
+  getValues(index, list, values);
+  vector<double> means;
+  getSlidingMeans(values, window, means);
+  return means;
+}
+
+/******************************************************************************/
+
+vector< vector<double>> AlphabetIndexTools::getSlidingMeans(
+    const AlphabetIndex1& index,
+    const SequenceContainerInterface& sequences,
+    size_t window,
+    const ExecutionContext& context)
+{
+  if (index.getAlphabet()->getAlphabetType() != sequences.getAlphabet()->getAlphabetType())
+    throw AlphabetMismatchException("AlphabetIndexTools::getSlidingMeans. Index and sequences do not have the same alphabet.", index.getAlphabet(), sequences.getAlphabet());
+  StateTable table(index);
+  size_t n = sequences.getNumberOfSequences();
+  SequenceContainerTools::prepareSequenceAccess(sequences, context);
+  for (size_t i = 0; i < n; ++i)
+  {
+    checkWindow_(sequences.sequence(i).size(), window);
+  }
+  vector< vector<double>> means(n);
+  context.forEachBlock(n, [&](size_t begin, size_t end)
+  {
+    vector<double> values;
+    for (size_t i = begin; i < end; ++i)
+    {
+      table.apply(sequences.sequence(i).getContent(), values);
+      getSlidingMeans(values, window, means[i]);
+    }
+  }, SequenceContainerTools::SEQUENCES_PER_BLOCK);
+  return means;
+}
+
+/******************************************************************************/
+
+void AlphabetIndexTools::getGCTables_(const Alphabet& alphabet, bool ignoreUnresolved, bool ignoreGap, std::vector<double>& gc, std::vector<double>& total)
+{
+  if (!AlphabetTools::isNucleicAlphabet(&alphabet))
+    throw AlphabetException("AlphabetIndexTools::getGCProfile. Method only works on nucleotides.", &alphabet);
+  const vector<int>& states = alphabet.getSupportedInts();
+  gc.assign(states.size(), 0);
+  total.assign(states.size(), 0);
+  for (size_t i = 0; i < states.size(); ++i)
+  {
+    int state = states[i];
+    if (alphabet.isGap(state))
+    {
+      total[i] = ignoreGap ? 0 : 1;
+    }
+    else if (state >= 0 && state < 4)
+    {
+      gc[i] = (state == 1 || state == 2) ? 1 : 0;
+      total[i] = 1;
+    }
+    else if (!ignoreUnresolved)
+    {
+      vector<int> alias = alphabet.getAlias(state);
+      for (int a : alias)
+      {
+        if (a == 1 || a == 2)
+          gc[i]++;
+      }
+      gc[i] /= static_cast<double>(alias.size());
+      total[i] = 1;
+    }
+  }
+}
+
+/******************************************************************************/
+
+void AlphabetIndexTools::getGCProfile_(const StateTable& gc, const StateTable& total, const std::vector<int>& states, size_t window, std::vector<double>& profile)
+{
+  vector<double> values, totals;
+  gc.apply(states, values);
+  total.apply(states, totals);
+  getSlidingSums(values, window, profile);
+  vector<double> windowTotals;
+  getSlidingSums(totals, window, windowTotals);
+  for (size_t k = 0; k < profile.size(); ++k)
+  {
+    profile[k] = windowTotals[k] > 0 ? profile[k] / windowTotals[k] : 0;
+  }
+}
+
+/******************************************************************************/
+
+vector<double> AlphabetIndexTools::getGCProfile(
+    const IntSymbolListInterface& list,
+    size_t window,
+    bool ignoreUnresolved,
+    bool ignoreGap)
+{
+  auto alphabet = list.getAlphabet();
+  vector<double> gc, total;
+  getGCTables_(*alphabet, ignoreUnresolved, ignoreGap, gc, total);
+  checkWindow_(list.size(), window);
+  vector<double> profile;
+  getGCProfile_(StateTable(*alphabet, gc), StateTable(*alphabet, total), list.getContent(), window, profile);
+  return profile;
+}
+
+/******************************************************************************/
+
+vector< vector<double>> AlphabetIndexTools::getGCProfiles(
+    const SequenceContainerInterface& sequences,
+    size_t window,
+    bool ignoreUnresolved,
+    bool ignoreGap,
+    const ExecutionContext& context)
+{
+  auto alphabet = sequences.getAlphabet();
+  vector<double> gc, total;
+  getGCTables_(*alphabet, ignoreUnresolved, ignoreGap, gc, total);
+  StateTable gcTable(*alphabet, gc);
+  StateTable totalTable(*alphabet, total);
+  size_t n = sequences.getNumberOfSequences();
+  SequenceContainerTools::prepareSequenceAccess(sequences, context);
+  for (size_t i = 0; i < n; ++i)
+  {
+    checkWindow_(sequences.sequence(i).size(), window);
+  }
+  vector< vector<double>> profiles(n);
+  context.forEachBlock(n, [&](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      getGCProfile_(gcTable, totalTable, sequences.sequence(i).getContent(), window, profiles[i]);
+    }
+  }, SequenceContainerTools::SEQUENCES_PER_BLOCK);
+  return profiles;
+}
+
+/******************************************************************************/
@@ -0,0 +1,193 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_ALPHABETINDEX_ALPHABETINDEXTOOLS_H
+#define BPP_SEQ_ALPHABETINDEX_ALPHABETINDEXTOOLS_H
+
+#include <Bpp/Exceptions.h>
+
+#include "../Container/SequenceContainer.h"
+#include "../ExecutionContext.h"
+#include "../IntSymbolList.h"
+#include "AlphabetIndex1.h"
+
+// From the STL:
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Apply alphabet indices to whole sequences, alignment columns and sliding windows.
+ *
+ * Indices are first turned into a lookup table over all the int codes of the
+ * alphabet, built from AlphabetIndex1::indexVector(), so that profiles are
+ * computed without any virtual call per position. Gaps and unresolved states
+ * have no index value, and are given NaN.
+ *
+ * Sliding windows are computed from cumulated sums in linear time, whatever
+ * the size of the window. A profile over a list of size n with windows of
+ * size w has n - w + 1 values, the kth value being computed over positions
+ * k to k + w - 1.
+ */
+class AlphabetIndexTools
+{
+public:
+  /**
+   * @brief A lookup table of the values of an index, for all states of an alphabet.
+   */
+  class StateTable
+  {
+private:
+    std::vector<double> values_;
+    int offset_;
+
+public:
+    /**
+     * @brief Build the table of an index, with NaN for gaps and unresolved states.
+     */
+    StateTable(const AlphabetIndex1& index);
+
+    /**
+     * @brief Build a table from values given for all supported int codes of an alphabet.
+     *
+     * @param alphabet The alphabet.
+     * @param values   The value for each int code of alphabet->getSupportedInts(), in the same order.
+     */
+    StateTable(const Alphabet& alphabet, const std::vector<double>& values);
+
+public:
+    double operator()(int state) const
+    {
+      size_t i = static_cast<size_t>(state + offset_);
+      return i < values_.size() ? values_[i] : NaN;
+    }
+
+    /**
+     * @brief Get the values of all positions of a list of states.
+     *
+     * @param states The states.
+     * @param values [out] The value of each state.
+     */
+    void apply(const std::vector<int>& states, std::vector<double>& values) const;
+
+    static const double NaN;
+  };
+
+public:
+  /**
+   * @brief Get the index values of all positions of a sequence or a site.
+   *
+   * @param index  The index to apply.
+   * @param list   The sequence or site.
+   * @param values [out] The value at each position, NaN for gaps and unresolved states.
+   * @throw AlphabetMismatchException If the index and the list do not share the same alphabet.
+   */
+  static void getValues(const AlphabetIndex1& index, const IntSymbolListInterface& list, std::vector<double>& values);
+
+  /**
+   * @return The index values of all positions of all sequences of a container.
+   *
+   * @param index     The index to apply.
+   * @param sequences The sequences.
+   * @param context   The execution context to be used, sequences being processed in parallel.
+   */
+  static std::vector< std::vector<double>> getValues(
+      const AlphabetIndex1& index,
+      const SequenceContainerInterface& sequences,
+      const ExecutionContext& context = ExecutionContext::global());
+
+  /**
+   * @brief Sum values over sliding windows. NaN values are skipped.
+   *
+   * @param values The values.
+   * @param window The size of the window.
+   * @param sums   [out] The sum of each window.
+   * @param counts [out] If not null, the number of values which are not NaN in each window.
+   * @throw BadIntegerException If the window is empty or larger than the list of values.
+   */
+  static void getSlidingSums(
+      const std::vector<double>& values,
+      size_t window,
+      std::vector<double>& sums,
+      std::vector<double>* counts = nullptr);
+
+  /**
+   * @brief Average values over sliding windows. NaN values are skipped,
+   * and windows with NaN values only have a NaN mean.
+   *
+   * @param values The values.
+   * @param window The size of the window.
+   * @param means  [out] The mean of each window.
+   * @throw BadIntegerException If the window is empty or larger than the list of values.
+   */
+  static void getSlidingMeans(
+      const std::vector<double>& values,
+      size_t window,
+      std::vector<double>& means);
+
+  /**
+   * @return The mean index value over sliding windows along a sequence.
+   *
+   * @param index  The index to apply, for instance KD_AAHydropathyIndex for a hydropathy profile.
+   * @param list   The sequence.
+   * @param window The size of the window.
+   * @throw BadIntegerException If the window is empty or larger than the sequence.
+   */
+  static std::vector<double> getSlidingMeans(const AlphabetIndex1& index, const IntSymbolListInterface& list, size_t window);
+
+  /**
+   * @return The mean index value over sliding windows along all sequences of a container.
+   *
+   * @param index     The index to apply.
+   * @param sequences The sequences.
+   * @param window    The size of the window.
+   * @param context   The execution context to be used, sequences being processed in parallel.
+   * @throw BadIntegerException If the window is empty or larger than one of the sequences.
+   */
+  static std::vector< std::vector<double>> getSlidingMeans(
+      const AlphabetIndex1& index,
+      const SequenceContainerInterface& sequences,
+      size_t window,
+      const ExecutionContext& context = ExecutionContext::global());
+
+  /**
+   * @return The GC content over sliding windows along a nucleotide sequence.
+   *
+   * Each window gives the same value as SymbolListTools::getGCContent on the
+   * corresponding part of the sequence.
+   *
+   * @param list             The sequence.
+   * @param window           The size of the window.
+   * @param ignoreUnresolved Do not count unresolved states. Otherwise, weight by each state probability (e.g. the R state counts for 0.5).
+   * @param ignoreGap        Do not count gaps in total.
+   * @throw AlphabetException If the sequence is not made of nucleotides.
+   * @throw BadIntegerException If the window is empty or larger than the sequence.
+   */
+  static std::vector<double> getGCProfile(
+      const IntSymbolListInterface& list,
+      size_t window,
+      bool ignoreUnresolved = true,
+      bool ignoreGap = true);
+
+  /**
+   * @return The GC content over sliding windows along all sequences of a container.
+   *
+   * @see getGCProfile(const IntSymbolListInterface&, size_t, bool, bool)
+   */
+  static std::vector< std::vector<double>> getGCProfiles(
+      const SequenceContainerInterface& sequences,
+      size_t window,
+      bool ignoreUnresolved = true,
+      bool ignoreGap = true,
+      const ExecutionContext& context = ExecutionContext::global());
+
+private:
+  static void checkWindow_(size_t size, size_t window);
+
+  static void getGCTables_(const Alphabet& alphabet, bool ignoreUnresolved, bool ignoreGap, std::vector<double>& gc, std::vector<double>& total);
+
+  static void getGCProfile_(const StateTable& gc, const StateTable& total, const std::vector<int>& states, size_t window, std::vector<double>& profile);
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_ALPHABETINDEX_ALPHABETINDEXTOOLS_H
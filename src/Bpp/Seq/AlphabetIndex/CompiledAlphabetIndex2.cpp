@@ -0,0 +1,167 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "CompiledAlphabetIndex2.h"
+#include "DefaultNucleotideScore.h"
+
+// From the STL:
+#include <cmath>
+#include <limits>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+CompiledAlphabetIndex2::CompiledAlphabetIndex2(const AlphabetIndex2& index, double gapScore) :
+  alphabet_(index.getAlphabet()),
+  symmetric_(index.isSymmetric()),
+  offset_(0),
+  nbRows_(0),
+  stride_(0),
+  values_(),
+  floatValues_(),
+  int16Values_(),
+  int8Values_(),
+  hasInt16_(false),
+  hasInt8_(false)
+{
+  const vector<int>& states = alphabet_->getSupportedInts();
+  int minState = *min_element(states.begin(), states.end());
+  int maxState = *max_element(states.begin(), states.end());
+  offset_ = -minState;
+  nbRows_ = static_cast<size_t>(maxState - minState + 1);
+  stride_ = (nbRows_ + 63) / 64 * 64;
+  values_.assign(nbRows_ * nbRows_, gapScore);
+
+  // Resolved states each state stands for, none for gaps and other special states:
+  bool ownAmbiguities = dynamic_cast<const DefaultNucleotideScore*>(&index) != nullptr;
+  int size = static_cast<int>(alphabet_->getSize());
+  vector< vector<int>> aliases(nbRows_);
+  vector<bool> resolved(nbRows_, false);
+  for (int state : states)
+  {
+    size_t row = static_cast<size_t>(state + offset_);
+    resolved[row] = state >= 0 && state < size;
+    if (resolved[row])
+      aliases[row].assign(1, state);
+    else if (alphabet_->isUnresolved(state) && !alphabet_->isGap(state))
+    {
+      if (ownAmbiguities)
+        aliases[row].assign(1, state);
+      else
+      {
+        aliases[row].clear();
+        for (int alias : alphabet_->getAlias(state))
+        {
+          if (alias >= 0 && alias < size)
+            aliases[row].push_back(alias);
+        }
+      }
+    }
+  }
+
+  for (size_t r1 = 0; r1 < nbRows_; ++r1)
+  {
+    for (size_t r2 = 0; r2 < nbRows_; ++r2)
+    {
+      if (aliases[r1].empty() || aliases[r2].empty())
+        continue; // Gap, or special state.
+      double sum = 0;
+      for (int a1 : aliases[r1])
+      {
+        for (int a2 : aliases[r2])
+        {
+          sum += index.getIndex(a1, a2);
+        }
+      }
+      values_[r1 * nbRows_ + r2] = sum / static_cast<double>(aliases[r1].size() * aliases[r2].size());
+    }
+  }
+
+  // Aligned copies. Integer tables are available if scores of resolved states
+  // are integers, means over ambiguities being rounded:
+  hasInt16_ = true;
+  hasInt8_ = true;
+  for (size_t r1 = 0; r1 < nbRows_; ++r1)
+  {
+    for (size_t r2 = 0; r2 < nbRows_; ++r2)
+    {
+      double v = values_[r1 * nbRows_ + r2];
+      bool exact = resolved[r1] && resolved[r2];
+      if ((exact && v != floor(v)) || v < numeric_limits<int16_t>::min() || v > numeric_limits<int16_t>::max())
+        hasInt16_ = false;
+      if ((exact && v != floor(v)) || v < numeric_limits<int8_t>::min() || v > numeric_limits<int8_t>::max())
+        hasInt8_ = false;
+    }
+  }
+  floatValues_.assign(nbRows_ * stride_, 0.f);
+  if (hasInt16_)
+    int16Values_.assign(nbRows_ * stride_, 0);
+  if (hasInt8_)
+    int8Values_.assign(nbRows_ * stride_, 0);
+  for (size_t r1 = 0; r1 < nbRows_; ++r1)
+  {
+    for (size_t r2 = 0; r2 < nbRows_; ++r2)
+    {
+      double v = values_[r1 * nbRows_ + r2];
+      floatValues_.data()[r1 * stride_ + r2] = static_cast<float>(v);
+      if (hasInt16_)
+        int16Values_.data()[r1 * stride_ + r2] = static_cast<int16_t>(lround(v));
+      if (hasInt8_)
+        int8Values_.data()[r1 * stride_ + r2] = static_cast<int8_t>(lround(v));
+    }
+  }
+}
+
+/******************************************************************************/
+
+template<class T>
+void CompiledAlphabetIndex2::fillQueryProfile_(const std::vector<int>& query, const AlignedArray<T>& table, QueryProfile<T>& profile) const
+{
+  size_t length = query.size();
+  size_t block = AlignedArray<T>::SIMD_ALIGNMENT / sizeof(T);
+  profile.init(nbRows_, length, (length + block - 1) / block * block);
+  vector<size_t> queryRows(length);
+  for (size_t i = 0; i < length; ++i)
+  {
+    queryRows[i] = getRowIndex(query[i]);
+  }
+  for (size_t r = 0; r < nbRows_; ++r)
+  {
+    const T* scores = table.data() + r * stride_;
+    T* row = profile.row(r);
+    for (size_t i = 0; i < length; ++i)
+    {
+      row[i] = scores[queryRows[i]];
+    }
+  }
+}
+
+/******************************************************************************/
+
+void CompiledAlphabetIndex2::getQueryProfile(const std::vector<int>& query, QueryProfile<float>& profile) const
+{
+  fillQueryProfile_(query, floatValues_, profile);
+}
+
+/******************************************************************************/
+
+void CompiledAlphabetIndex2::getQueryProfile(const std::vector<int>& query, QueryProfile<int16_t>& profile) const
+{
+  if (!hasInt16_)
+    throw Exception("CompiledAlphabetIndex2::getQueryProfile. Scores are not 16-bit integers.");
+  fillQueryProfile_(query, int16Values_, profile);
+}
+
+/******************************************************************************/
+
+void CompiledAlphabetIndex2::getQueryProfile(const std::vector<int>& query, QueryProfile<int8_t>& profile) const
+{
+  if (!hasInt8_)
+    throw Exception("CompiledAlphabetIndex2::getQueryProfile. Scores are not 8-bit integers.");
+  fillQueryProfile_(query, int8Values_, profile);
+}
+
+/******************************************************************************/
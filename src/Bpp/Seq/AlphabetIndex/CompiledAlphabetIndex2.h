@@ -0,0 +1,279 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_ALPHABETINDEX_COMPILEDALPHABETINDEX2_H
+#define BPP_SEQ_ALPHABETINDEX_COMPILEDALPHABETINDEX2_H
+
+#include <Bpp/Exceptions.h>
+
+#include "../Alphabet/AlphabetExceptions.h"
+#include "AlphabetIndex2.h"
+
+// From the STL:
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief A fixed-size array whose data start on a SIMD_ALIGNMENT-byte boundary.
+ */
+template<class T>
+class AlignedArray
+{
+public:
+  static const size_t SIMD_ALIGNMENT = 64;
+
+private:
+  std::vector<T> storage_;
+  size_t size_;
+  size_t shift_;
+
+public:
+  AlignedArray() : storage_(), size_(0), shift_(0) {}
+
+  AlignedArray(const AlignedArray& array) :
+    storage_(),
+    size_(0),
+    shift_(0)
+  {
+    assign(array.size_, T());
+    std::copy(array.data(), array.data() + size_, data());
+  }
+
+  AlignedArray& operator=(const AlignedArray& array)
+  {
+    if (this != &array)
+    {
+      assign(array.size_, T());
+      std::copy(array.data(), array.data() + size_, data());
+    }
+    return *this;
+  }
+
+public:
+  /**
+   * @brief Resize the array, and set all its elements to a value.
+   */
+  void assign(size_t size, T value)
+  {
+    storage_.assign(size + SIMD_ALIGNMENT / sizeof(T), value);
+    size_ = size;
+    size_t address = reinterpret_cast<size_t>(storage_.data());
+    shift_ = ((SIMD_ALIGNMENT - address % SIMD_ALIGNMENT) % SIMD_ALIGNMENT) / sizeof(T);
+  }
+
+  size_t size() const { return size_; }
+
+  T* data() { return storage_.data() + shift_; }
+
+  const T* data() const { return storage_.data() + shift_; }
+};
+
+/**
+ * @brief A score profile of a query sequence against all states.
+ *
+ * Row r holds the scores of all positions of the query against the state of
+ * row r (see CompiledAlphabetIndex2::getRowIndex), so that an alignment
+ * kernel reads the scores of consecutive query positions in a single vector
+ * load. Rows are aligned and padded with zeros to a multiple of the stride.
+ */
+template<class T>
+class QueryProfile
+{
+private:
+  size_t nbRows_;
+  size_t length_;
+  size_t stride_;
+  AlignedArray<T> values_;
+
+public:
+  QueryProfile() : nbRows_(0), length_(0), stride_(0), values_() {}
+
+public:
+  /**
+   * @brief Allocate the profile. Used by CompiledAlphabetIndex2.
+   */
+  void init(size_t nbRows, size_t length, size_t stride)
+  {
+    nbRows_ = nbRows;
+    length_ = length;
+    stride_ = stride;
+    values_.assign(nbRows * stride, T());
+  }
+
+  size_t getNumberOfRows() const { return nbRows_; }
+
+  /**
+   * @return The length of the query.
+   */
+  size_t getLength() const { return length_; }
+
+  /**
+   * @return The number of elements between the beginning of two rows.
+   */
+  size_t getStride() const { return stride_; }
+
+  T* row(size_t rowIndex) { return values_.data() + rowIndex * stride_; }
+
+  const T* row(size_t rowIndex) const { return values_.data() + rowIndex * stride_; }
+};
+
+/**
+ * @brief A dense, precomputed form of an AlphabetIndex2.
+ *
+ * Scores for all pairs of int codes of the alphabet, gaps and unresolved
+ * states included, are computed once and stored in a square table, which
+ * can be read without any virtual call nor map lookup. Row r (and column r)
+ * corresponds to state r - getRowOffset(), so that the gap state is row 0.
+ *
+ * The table is stored in double precision, and in aligned single precision
+ * rows padded to a multiple of getStride() elements, for vectorized kernels.
+ * If all scores of resolved states are integers, it is also stored as 16-bit
+ * integers and, if they fit, as 8-bit integers, scores of unresolved states
+ * being rounded.
+ *
+ * Scores between resolved states are given by AlphabetIndex2::getIndex.
+ * Scores involving a gap (or another special state, like the stop '*'
+ * in proteins) are set to a fixed value. Scores involving
+ * an unresolved state are the mean of the scores of the resolved states
+ * it stands for, except with a DefaultNucleotideScore, which defines
+ * them itself.
+ *
+ * The table is filled in the constructor and never modified afterwards, so
+ * that it can be shared between threads.
+ */
+class CompiledAlphabetIndex2
+{
+private:
+  std::shared_ptr<const Alphabet> alphabet_;
+  bool symmetric_;
+  int offset_;
+  size_t nbRows_;
+  size_t stride_;
+  std::vector<double> values_;
+  AlignedArray<float> floatValues_;
+  AlignedArray<int16_t> int16Values_;
+  AlignedArray<int8_t> int8Values_;
+  bool hasInt16_;
+  bool hasInt8_;
+
+public:
+  /**
+   * @param index    The index to compile.
+   * @param gapScore The score of any pair involving a gap.
+   */
+  CompiledAlphabetIndex2(const AlphabetIndex2& index, double gapScore = 0.);
+
+  virtual ~CompiledAlphabetIndex2() {}
+
+public:
+  std::shared_ptr<const Alphabet> getAlphabet() const { return alphabet_; }
+
+  bool isSymmetric() const { return symmetric_; }
+
+  /**
+   * @return The number of rows (and columns) of the table.
+   */
+  size_t getNumberOfRows() const { return nbRows_; }
+
+  /**
+   * @return The number of elements between the beginning of two rows of the aligned tables,
+   * a multiple of 64 bytes for all types.
+   */
+  size_t getStride() const { return stride_; }
+
+  /**
+   * @return The value to add to a state to get its row.
+   */
+  int getRowOffset() const { return offset_; }
+
+  /**
+   * @return The row of a state.
+   * @throw BadIntException If the state is not part of the alphabet.
+   */
+  size_t getRowIndex(int state) const
+  {
+    size_t row = static_cast<size_t>(state + offset_);
+    if (row >= nbRows_)
+      throw BadIntException(state, "CompiledAlphabetIndex2::getRowIndex. State not in alphabet.", alphabet_.get());
+    return row;
+  }
+
+  /**
+   * @return The score of a pair of states. States are not checked.
+   */
+  double operator()(int state1, int state2) const
+  {
+    return values_[static_cast<size_t>(state1 + offset_) * nbRows_ + static_cast<size_t>(state2 + offset_)];
+  }
+
+  /**
+   * @return The score of a pair of states.
+   * @throw BadIntException If one of the states is not part of the alphabet.
+   */
+  double getIndex(int state1, int state2) const
+  {
+    return values_[getRowIndex(state1) * nbRows_ + getRowIndex(state2)];
+  }
+
+  /**
+   * @return The single precision scores of a row, against all rows.
+   */
+  const float* getFloatRow(size_t row) const { return floatValues_.data() + row * stride_; }
+
+  /**
+   * @return True if scores are integers, stored in 16 bits.
+   */
+  bool hasInt16() const { return hasInt16_; }
+
+  /**
+   * @return True if scores are integers between -128 and 127, stored in 8 bits.
+   */
+  bool hasInt8() const { return hasInt8_; }
+
+  /**
+   * @return The 16-bit scores of a row.
+   * @throw Exception If scores are not stored in 16 bits.
+   */
+  const int16_t* getInt16Row(size_t row) const
+  {
+    if (!hasInt16_)
+      throw Exception("CompiledAlphabetIndex2::getInt16Row. Scores are not 16-bit integers.");
+    return int16Values_.data() + row * stride_;
+  }
+
+  /**
+   * @return The 8-bit scores of a row.
+   * @throw Exception If scores are not stored in 8 bits.
+   */
+  const int8_t* getInt8Row(size_t row) const
+  {
+    if (!hasInt8_)
+      throw Exception("CompiledAlphabetIndex2::getInt8Row. Scores are not 8-bit integers.");
+    return int8Values_.data() + row * stride_;
+  }
+
+  /**
+   * @brief Build the score profile of a query sequence.
+   *
+   * @param query   The states of the query.
+   * @param profile [out] Row r holds the scores of query[i] against state r, for all i.
+   * @throw BadIntException If a state of the query is not part of the alphabet.
+   * @throw Exception If scores are not available with the requested type.
+   */
+  void getQueryProfile(const std::vector<int>& query, QueryProfile<float>& profile) const;
+
+  void getQueryProfile(const std::vector<int>& query, QueryProfile<int16_t>& profile) const;
+
+  void getQueryProfile(const std::vector<int>& query, QueryProfile<int8_t>& profile) const;
+
+private:
+  template<class T>
+  void fillQueryProfile_(const std::vector<int>& query, const AlignedArray<T>& table, QueryProfile<T>& profile) const;
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_ALPHABETINDEX_COMPILEDALPHABETINDEX2_H
@@ -3,20 +3,75 @@
 // SPDX-License-Identifier: CECILL-2.1
 
 // From the STL:
+#include <fstream>
 #include <iostream>
 #include <iomanip>
 #include <limits>
+#include <sstream>
 
 #include "BppSequenceApplication.h"
 
 #include "../Alphabet/AlphabetTools.h"
 #include "../Container/SiteContainerTools.h"
+#include "../ExecutionContext.h"
 
 using namespace std;
 using namespace bpp;
 
 /******************************************************************************/
 
+void BppSequenceApplication::configureExecutionContext_()
+{
+  unsigned int nbThreads = ApplicationTools::getParameter<unsigned int>("number_of_threads", params_, 1, "", true, warn_);
+  ExecutionContext::global().setNumberOfThreads(nbThreads);
+  if (verbose_ && ExecutionContext::global().isParallel())
+    ApplicationTools::displayResult("Number of threads", ExecutionContext::global().getNumberOfWorkers());
+}
+
+/******************************************************************************/
+
+void BppSequenceApplication::configureProfiler_()
+{
+  profileFormat_ = ApplicationTools::getStringParameter("profile", params_, "none", "", true, warn_ + 1);
+  if (profileFormat_ == "none")
+    return;
+  if (profileFormat_ != "text" && profileFormat_ != "json")
+    throw Exception("BppSequenceApplication. Unknown profile format '" + profileFormat_ + "', should be none, text or json.");
+  profilePath_ = ApplicationTools::getStringParameter("profile.file", params_, "none", "", true, warn_ + 1);
+  Profiler::global().reset();
+  Profiler::global().setEnabled(true);
+}
+
+/******************************************************************************/
+
+void BppSequenceApplication::reportProfile()
+{
+  if (profileFormat_ == "none")
+    return;
+  ostringstream profile;
+  if (profileFormat_ == "json")
+    Profiler::global().writeJson(profile);
+  else
+    Profiler::global().print(profile);
+  profileFormat_ = "none"; // Only written once.
+
+  if (profilePath_ == "none")
+  {
+    ApplicationTools::displayMessage("");
+    ApplicationTools::displayMessage(profile.str());
+  }
+  else
+  {
+    ofstream output(profilePath_.c_str(), ios::out | ios::trunc);
+    output << profile.str();
+    output.close();
+    if (!output)
+      throw IOException("BppSequenceApplication::reportProfile. Can't write file " + profilePath_ + ".");
+  }
+}
+
+/******************************************************************************/
+
 shared_ptr<Alphabet> BppSequenceApplication::getAlphabet(
     const string& suffix,
     bool suffixIsOptional,
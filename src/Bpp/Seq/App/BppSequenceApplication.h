@@ -20,6 +20,7 @@ using namespace std;
 #include "../Alphabet/CodonAlphabet.h"
 #include "../Container/AlignmentData.h"
 #include "../Container/SiteContainer.h"
+#include "../Profiler.h"
 #include "SequenceApplicationTools.h"
 
 namespace bpp
@@ -28,9 +29,35 @@ class BppSequenceApplication :
   public virtual BppApplication
 {
 public:
+  /**
+   * @brief Build a new application.
+   *
+   * The 'number_of_threads' option (default 1, 0 for one thread per core) sets the
+   * number of threads of the global ExecutionContext, used by the container tools
+   * and by the parallel readers and writers (Pasta, Phylip, Clustal, PhredBatchReader).
+   *
+   * The 'profile' option (none, text or json, default none) enables the global
+   * Profiler. The profile is written when the application is destroyed, or by
+   * reportProfile(), to the file given by the 'profile.file' option, or
+   * displayed as a message if this option is not set.
+   */
   BppSequenceApplication(int argc, char* argv[], const std::string& name) :
-    BppApplication(argc, argv, name)
-  {}
+    BppApplication(argc, argv, name),
+    profileFormat_("none"),
+    profilePath_("none")
+  {
+    configureExecutionContext_();
+    configureProfiler_();
+  }
+
+  virtual ~BppSequenceApplication()
+  {
+    try
+    {
+      reportProfile();
+    }
+    catch (Exception& e) {} // Call reportProfile() explicitly to get errors.
+  }
 
 public:
   /***************************************
@@ -80,6 +107,21 @@ public:
       const std::string& prefix = "input.",
       const std::string& suffix = "",
       bool suffixIsOptional = true) const;
+
+  /**
+   * @brief Write the profile as set by the 'profile' options, if it was not written yet.
+   *
+   * @throw IOException If the profile file cannot be written.
+   */
+  void reportProfile();
+
+private:
+  std::string profileFormat_;
+  std::string profilePath_;
+
+  void configureExecutionContext_();
+
+  void configureProfiler_();
 };
 } // end of namespace bpp;
 #endif // BPP_SEQ_APP_BPPSEQUENCEAPPLICATION_H
@@ -8,6 +8,7 @@
 #include <Bpp/Text/KeyvalTools.h>
 #include <Bpp/Text/TextTools.h>
 #include <algorithm>
+#include <exception>
 
 #include "../Alphabet/AlphabetTools.h"
 #include "../Alphabet/AllelicAlphabet.h"
@@ -31,6 +32,7 @@
 #include "../Io/BppOSequenceReaderFormat.h"
 #include "../Io/BppOSequenceWriterFormat.h"
 #include "../Io/MaseTools.h"
+#include "../Profiler.h"
 #include "../SequenceTools.h"
 #include "../SymbolListTools.h"
 #include "SequenceApplicationTools.h"
@@ -277,6 +279,7 @@ std::unique_ptr<SequenceContainerInterface> SequenceApplicationTools::getSequenc
     bool verbose,
     int warn)
 {
+  ScopedTimer timer("app.get_sequence_container");
   string sequenceFilePath = ApplicationTools::getAFilePath("input.sequence.file", params, true, true, suffix, suffixIsOptional, "none", warn);
   string sequenceFormat = ApplicationTools::getStringParameter("input.sequence.format", params, "Fasta()", suffix, suffixIsOptional, warn);
   BppOSequenceReaderFormat bppoReader(warn);
@@ -297,19 +300,16 @@ std::unique_ptr<SequenceContainerInterface> SequenceApplicationTools::getSequenc
 
 /******************************************************************************/
 
-map<size_t, unique_ptr<VectorSiteContainer>>
-SequenceApplicationTools::getSiteContainers(
-    std::shared_ptr<const Alphabet> alpha,
+vector< pair<size_t, map<string, string>>> SequenceApplicationTools::getAlignmentDescriptions_(
+    shared_ptr<const Alphabet> alpha,
     const map<string, string>& params,
     const string& prefix,
     const string& suffix,
-    bool suffixIsOptional,
-    bool verbose,
-    int warn)
+    bool suffixIsOptional)
 {
   vector<string> vContName = ApplicationTools::matchingParameters(prefix + "data*", params);
 
-  map<size_t, unique_ptr<VectorSiteContainer>> mCont;
+  vector< pair<size_t, map<string, string>>> descriptions;
 
   for (size_t nT = 0; nT < vContName.size(); nT++)
   {
@@ -336,8 +336,6 @@ SequenceApplicationTools::getSiteContainers(
 
     if (contName == "alignment")
     {
-      string format;
-
       if (args.find("file") != args.end())
         args2["input.sequence.file"] = args["file"];
       else
@@ -361,21 +359,118 @@ SequenceApplicationTools::getSiteContainers(
       if (args.find("remove_stop_codons") != args.end())
         args2["input.sequence.remove_stop_codons"] = args["remove_stop_codons"];
 
+      if (args.find("cache") != args.end())
+        args2["input.sequence.cache"] = args["cache"];
+      else
+        args2["input.sequence.cache"] = ApplicationTools::getStringParameter("input.sequence.cache", params, "none", suffix, true, 2);
+
       args2["genetic_code"] = ApplicationTools::getStringParameter("genetic_code", params, "", "", true, (AlphabetTools::isCodonAlphabet(alpha.get()) ? 0 : 1));
 
-      auto vsC = getSiteContainer(alpha, args2, "", true, verbose, warn);
+      descriptions.push_back(make_pair(num, args2));
+    }
+  }
+
+  return descriptions;
+}
 
-      ApplicationTools::displayMessage("");
-      ApplicationTools::displayMessage("Data " + TextTools::toString(num));
+/******************************************************************************/
 
-      vsC = getSitesToAnalyse(*vsC, args2, "", true, false);
+map<size_t, unique_ptr<VectorSiteContainer>>
+SequenceApplicationTools::getSiteContainers(
+    std::shared_ptr<const Alphabet> alpha,
+    const map<string, string>& params,
+    const string& prefix,
+    const string& suffix,
+    bool suffixIsOptional,
+    bool verbose,
+    int warn,
+    const ExecutionContext& context)
+{
+  ScopedTimer timer("app.get_site_containers");
+  // Options are parsed and readers are created sequentially:
+  vector< pair<size_t, map<string, string>>> descriptions = getAlignmentDescriptions_(alpha, params, prefix, suffix, suffixIsOptional);
+  size_t n = descriptions.size();
+  vector<AlignmentFile_> files;
+  for (auto& description : descriptions)
+  {
+    files.push_back(getAlignmentFile_(description.second, "", true, false, warn));
+  }
 
-      if (mCont.find(num) != mCont.end())
+  // Files are read concurrently, by windows of one file per thread. Each window
+  // is then processed in the order of the options, so that messages and random
+  // site samples do not depend on the number of threads, and that at most one
+  // unprocessed alignment per thread is kept in memory:
+  shared_ptr<const Alphabet> fileAlpha = getFileAlphabet_(alpha, false);
+  size_t window = static_cast<size_t>(context.getNumberOfWorkers());
+  vector< unique_ptr<VectorSiteContainer>> sites(n);
+  vector< unique_ptr<ProbabilisticVectorSiteContainer>> psites(n);
+  vector<unsigned char> fromCache(n, false);
+  vector<exception_ptr> errors(n);
+  map<size_t, unique_ptr<VectorSiteContainer>> mCont;
+  shared_ptr<const GeneticCode> gCode; // Shared by all alignments.
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (i % window == 0)
+    {
+      size_t first = i;
+      context.forEachBlock(min(window, n - first), [&](size_t begin, size_t end)
       {
-        ApplicationTools::displayWarning("Alignment " + TextTools::toString(num) + " already assigned, replaced by new one.");
-      }
-      mCont.emplace(num, std::move(vsC));
+        for (size_t j = first + begin; j < first + end; ++j)
+        {
+          try
+          {
+            // Cached alignments are decoded sequentially, files being already read concurrently:
+            sites[j] = loadCachedSiteContainer_(files[j], alpha, ExecutionContext());
+            fromCache[j] = sites[j] != nullptr;
+            if (!fromCache[j])
+              readAlignmentFile_(files[j], fileAlpha, sites[j], psites[j]);
+          }
+          catch (...)
+          {
+            errors[j] = current_exception();
+          }
+        }
+      }, 1);
     }
+    if (errors[i])
+      rethrow_exception(errors[i]);
+    size_t num = descriptions[i].first;
+    const map<string, string>& args2 = descriptions[i].second;
+
+    if (verbose)
+    {
+      ApplicationTools::displayResult("Sequence file ", files[i].path);
+      ApplicationTools::displayResult("Sequence format ", files[i].getFormatName());
+    }
+    unique_ptr<VectorSiteContainer> vsC;
+    if (fromCache[i])
+    {
+      vsC = std::move(sites[i]);
+      if (verbose)
+        ApplicationTools::displayResult("Alignment cache ", files[i].cache->getPath(files[i].cacheKey));
+    }
+    else
+    {
+      vsC = processSiteContainer_(alpha, std::move(sites[i]), files[i], args2, "", true, verbose, warn);
+      storeCachedSiteContainer_(files[i], *vsC);
+    }
+
+    ApplicationTools::displayMessage("");
+    ApplicationTools::displayMessage("Data " + TextTools::toString(num));
+
+    auto stopOption = args2.find("input.sequence.remove_stop_codons");
+    if (!gCode && stopOption != args2.end() && stopOption->second == "yes" && AlphabetTools::isCodonAlphabet(alpha.get()))
+    {
+      auto ca = dynamic_pointer_cast<const CodonAlphabet>(alpha);
+      gCode = getGeneticCode(ca->getNucleicAlphabet(), ApplicationTools::getStringParameter("genetic_code", args2, "Standard", "", true, warn));
+    }
+    vsC = getSitesToAnalyse(*vsC, args2, "", true, false, true, 1, context, gCode);
+
+    if (mCont.find(num) != mCont.end())
+    {
+      ApplicationTools::displayWarning("Alignment " + TextTools::toString(num) + " already assigned, replaced by new one.");
+    }
+    mCont.emplace(num, std::move(vsC));
   }
 
   return mCont;
@@ -391,80 +486,198 @@ SequenceApplicationTools::getProbabilisticSiteContainers(
     const string& suffix,
     bool suffixIsOptional,
     bool verbose,
-    int warn)
+    int warn,
+    const ExecutionContext& context)
 {
-  vector<string> vContName = ApplicationTools::matchingParameters(prefix + "data*", params);
+  ScopedTimer timer("app.get_site_containers");
+  // Options are parsed and readers are created sequentially:
+  vector< pair<size_t, map<string, string>>> descriptions = getAlignmentDescriptions_(alpha, params, prefix, suffix, suffixIsOptional);
+  size_t n = descriptions.size();
+  vector<AlignmentFile_> files;
+  for (auto& description : descriptions)
+  {
+    files.push_back(getAlignmentFile_(description.second, "", true, true, warn));
+    // Probabilistic from Sequence format only possible for Allelic alphabet
+    if (files.back().reader && !AlphabetTools::isAllelicAlphabet(alpha.get()))
+      throw IOException("Bad format");
+  }
 
+  // Files are read concurrently, by windows of one file per thread, as in getSiteContainers:
+  shared_ptr<const Alphabet> fileAlpha = getFileAlphabet_(alpha, true);
+  size_t window = static_cast<size_t>(context.getNumberOfWorkers());
+  vector< unique_ptr<VectorSiteContainer>> sites(n);
+  vector< unique_ptr<ProbabilisticVectorSiteContainer>> psites(n);
+  vector<exception_ptr> errors(n);
   map<size_t, unique_ptr<ProbabilisticVectorSiteContainer>> mCont;
-
-  for (size_t nT = 0; nT < vContName.size(); nT++)
+  shared_ptr<const GeneticCode> gCode; // Shared by all alignments.
+  for (size_t i = 0; i < n; ++i)
   {
-    size_t poseq = vContName[nT].find("=");
-    size_t num = 0;
-    size_t len = (prefix + "data").size();
+    if (i % window == 0)
+    {
+      size_t first = i;
+      context.forEachBlock(min(window, n - first), [&](size_t begin, size_t end)
+      {
+        for (size_t j = first + begin; j < first + end; ++j)
+        {
+          try
+          {
+            readAlignmentFile_(files[j], fileAlpha, sites[j], psites[j]);
+          }
+          catch (...)
+          {
+            errors[j] = current_exception();
+          }
+        }
+      }, 1);
+    }
+    if (errors[i])
+      rethrow_exception(errors[i]);
+    size_t num = descriptions[i].first;
+    const map<string, string>& args2 = descriptions[i].second;
 
-    string suff = vContName[nT].substr(len, poseq - len);
+    if (verbose)
+    {
+      ApplicationTools::displayResult("Sequence file ", files[i].path);
+      ApplicationTools::displayResult("Sequence format ", files[i].getFormatName());
+    }
+    auto vsC = processProbabilisticSiteContainer_(alpha, std::move(sites[i]), std::move(psites[i]), files[i], args2, "", true, verbose, warn);
 
-    if (TextTools::isDecimalInteger(suff, '$'))
-      num = TextTools::to<size_t>(suff);
-    else
-      num = 1;
+    ApplicationTools::displayMessage("");
+    ApplicationTools::displayMessage("Data " + TextTools::toString(num));
 
-    string contDesc = ApplicationTools::getStringParameter(vContName[nT], params, "", suffix, suffixIsOptional);
+    auto stopOption = args2.find("input.sequence.remove_stop_codons");
+    if (!gCode && stopOption != args2.end() && stopOption->second == "yes" && AlphabetTools::isCodonAlphabet(alpha.get()))
+    {
+      auto ca = dynamic_pointer_cast<const CodonAlphabet>(alpha);
+      gCode = getGeneticCode(ca->getNucleicAlphabet(), ApplicationTools::getStringParameter("genetic_code", args2, "Standard", "", true, warn));
+    }
+    vsC = getSitesToAnalyse(*vsC, args2, "", true, false, true, 1, context, gCode);
 
-    string contName;
+    if (mCont.find(num) != mCont.end())
+    {
+      ApplicationTools::displayWarning("Alignment " + TextTools::toString(num) + " already assigned, replaced by new one.");
+    }
+    mCont.emplace(num, std::move(vsC));
+  }
 
-    map<string, string> args;
+  return mCont;
+}
 
-    KeyvalTools::parseProcedure(contDesc, contName, args);
+/******************************************************************************/
 
-    map<string, string> args2;
+SequenceApplicationTools::AlignmentFile_ SequenceApplicationTools::getAlignmentFile_(
+    const map<string, string>& params,
+    const string& suffix,
+    bool suffixIsOptional,
+    bool probabilistic,
+    int warn)
+{
+  AlignmentFile_ file;
+  file.path = ApplicationTools::getAFilePath("input.sequence.file", params, true, true, suffix, suffixIsOptional, "none", warn);
+  string sequenceFormat = ApplicationTools::getStringParameter("input.sequence.format", params, "Fasta()", suffix, suffixIsOptional, warn);
+  BppOAlignmentReaderFormat bppoReader(warn);
 
-    if (contName == "alignment")
+  if (probabilistic)
+  {
+    try
     {
-      string format;
-
-      if (args.find("file") != args.end())
-        args2["input.sequence.file"] = args["file"];
-      else
-        args2["input.sequence.file"] = "";
-
-      if (args.find("format") != args.end())
-        args2["input.sequence.format"] = args["format"];
+      file.reader = bppoReader.read(sequenceFormat);
+    }
+    catch (Exception& e)
+    {
+      file.probabilisticReader = bppoReader.readProbabilistic(sequenceFormat);
+    }
+  }
+  else
+    file.reader = bppoReader.read(sequenceFormat);
 
-      if (args.find("selection") != args.end())
-        args2["input.site.selection"] = args["selection"];
+  file.args = bppoReader.getUnparsedArguments();
 
-      if (args.find("sites_to_use") != args.end())
-        args2["input.sequence.sites_to_use"] = args["sites_to_use"];
+  // Processed alignments are only cached if they do not depend on random numbers:
+  string cacheDir = ApplicationTools::getStringParameter("input.sequence.cache", params, "none", suffix, suffixIsOptional, warn + 1);
+  if (probabilistic || cacheDir == "none")
+    return file;
+  string siteSet = ApplicationTools::getStringParameter("input.site.selection", params, "none", suffix, suffixIsOptional, warn + 1);
+  if (siteSet.find("Sample") == string::npos)
+  {
+    file.cache = make_shared<AlignmentCache>(cacheDir);
+    // Only the options used by processSiteContainer_, as resolved for this suffix.
+    // Filters applied after loading (sites_to_use, max_gap_allowed...) are not part of the key:
+    file.cacheOptions["input.sequence.format"] = sequenceFormat;
+    file.cacheOptions["input.site.selection"] = siteSet;
+    file.cacheOptions["input.sequence.keep_names"] = ApplicationTools::getStringParameter("input.sequence.keep_names", params, "all", suffix, suffixIsOptional, warn + 1);
+    file.cacheOptions["input.sequence.remove_names"] = ApplicationTools::getStringParameter("input.sequence.remove_names", params, "none", suffix, suffixIsOptional, warn + 1);
+  }
+  return file;
+}
 
-      if (args.find("max_gap_allowed") != args.end())
-        args2["input.sequence.max_gap_allowed"] = args["max_gap_allowed"];
+/******************************************************************************/
 
-      if (args.find("max_unresolved_allowed") != args.end())
-        args2["input.sequence.max_unresolved_allowed"] = args["max_unresolved_allowed"];
+shared_ptr<const Alphabet> SequenceApplicationTools::getFileAlphabet_(
+    shared_ptr<const Alphabet> alpha,
+    bool probabilistic)
+{
+  if (AlphabetTools::isRNYAlphabet(alpha.get()))
+    return dynamic_pointer_cast<const RNY>(alpha)->getLetterAlphabet();
+  if (probabilistic && AlphabetTools::isAllelicAlphabet(alpha.get()))
+    return dynamic_pointer_cast<const AllelicAlphabet>(alpha)->getStateAlphabet();
+  return alpha;
+}
 
-      if (args.find("remove_stop_codons") != args.end())
-        args2["input.sequence.remove_stop_codons"] = args["remove_stop_codons"];
+/******************************************************************************/
 
-      args2["genetic_code"] = ApplicationTools::getStringParameter("genetic_code", params, "", "", true, (AlphabetTools::isCodonAlphabet(alpha.get()) ? 0 : 1));
+void SequenceApplicationTools::readAlignmentFile_(
+    const AlignmentFile_& file,
+    shared_ptr<const Alphabet> alpha,
+    unique_ptr<VectorSiteContainer>& sites,
+    unique_ptr<ProbabilisticVectorSiteContainer>& psites)
+{
+  if (file.reader)
+  {
+    auto alignment = file.reader->readAlignment(file.path, alpha);
+    ScopedTimer timer("app.convert_alignment");
+    sites = make_unique<VectorSiteContainer>(*alignment); // We copy into a VectorSiteContainer, as most readers will generate an AlignedSequenceContainer)
+  }
+  else
+  {
+    auto alignment = file.probabilisticReader->readAlignment(file.path, alpha);
+    ScopedTimer timer("app.convert_alignment");
+    psites = make_unique<ProbabilisticVectorSiteContainer>(*alignment);
+  }
+}
 
-      auto vsC = getProbabilisticSiteContainer(alpha, args2, "", true, verbose, warn);
+/******************************************************************************/
 
-      ApplicationTools::displayMessage("");
-      ApplicationTools::displayMessage("Data " + TextTools::toString(num));
+unique_ptr<VectorSiteContainer> SequenceApplicationTools::loadCachedSiteContainer_(
+    AlignmentFile_& file,
+    shared_ptr<const Alphabet> alpha,
+    const ExecutionContext& context)
+{
+  if (!file.cache)
+    return nullptr;
+  file.cacheKey = AlignmentCache::getKey(file.path, file.cacheOptions, *alpha);
+  auto sites = file.cache->load(file.cacheKey, alpha, context);
+  Profiler::global().count(sites ? "app.alignment_cache.hits" : "app.alignment_cache.misses");
+  return sites;
+}
 
-      vsC = getSitesToAnalyse(*vsC, args2, "", true, false);
+/******************************************************************************/
 
-      if (mCont.find(num) != mCont.end())
-      {
-        ApplicationTools::displayWarning("Alignment " + TextTools::toString(num) + " already assigned, replaced by new one.");
-      }
-      mCont.emplace(num, std::move(vsC));
-    }
+void SequenceApplicationTools::storeCachedSiteContainer_(
+    const AlignmentFile_& file,
+    const SiteContainerInterface& sites)
+{
+  if (!file.cache)
+    return;
+  // The alignment is loaded anyway, failing to cache it is not an error:
+  try
+  {
+    file.cache->store(file.cacheKey, sites);
+  }
+  catch (Exception& e)
+  {
+    ApplicationTools::displayWarning("Alignment not cached: " + string(e.what()));
   }
-
-  return mCont;
 }
 
 /******************************************************************************/
@@ -477,26 +690,45 @@ std::unique_ptr<VectorSiteContainer> SequenceApplicationTools::getSiteContainer(
     bool verbose,
     int warn)
 {
-  string sequenceFilePath = ApplicationTools::getAFilePath("input.sequence.file", params, true, true, suffix, suffixIsOptional, "none", warn);
-  string sequenceFormat = ApplicationTools::getStringParameter("input.sequence.format", params, "Fasta()", suffix, suffixIsOptional, warn);
-  BppOAlignmentReaderFormat bppoReader(warn);
-
-  unique_ptr<IAlignment> iAln(bppoReader.read(sequenceFormat));
-  map<string, string> args(bppoReader.getUnparsedArguments());
+  ScopedTimer timer("app.get_site_container");
+  AlignmentFile_ file = getAlignmentFile_(params, suffix, suffixIsOptional, false, warn);
 
   if (verbose)
   {
-    ApplicationTools::displayResult("Sequence file " + suffix, sequenceFilePath);
-    ApplicationTools::displayResult("Sequence format " + suffix, iAln->getFormatName());
+    ApplicationTools::displayResult("Sequence file " + suffix, file.path);
+    ApplicationTools::displayResult("Sequence format " + suffix, file.getFormatName());
   }
 
-  shared_ptr<const Alphabet> alpha2;
-  if (AlphabetTools::isRNYAlphabet(alpha.get()))
-    alpha2 = dynamic_pointer_cast<const RNY>(alpha)->getLetterAlphabet();
-  else
-    alpha2 = alpha;
+  unique_ptr<VectorSiteContainer> sites = loadCachedSiteContainer_(file, alpha, ExecutionContext::global());
+  if (sites)
+  {
+    if (verbose)
+      ApplicationTools::displayResult("Alignment cache " + suffix, file.cache->getPath(file.cacheKey));
+    return sites;
+  }
+
+  unique_ptr<ProbabilisticVectorSiteContainer> psites;
+  readAlignmentFile_(file, getFileAlphabet_(alpha, false), sites, psites);
 
-  auto sites2 = make_unique<VectorSiteContainer>(*(iAln->readAlignment(sequenceFilePath, alpha2))); // We copy into a VectorSiteContainer, as most readers will generate an AlignedSequenceContainer)
+  sites = processSiteContainer_(alpha, std::move(sites), file, params, suffix, suffixIsOptional, verbose, warn);
+  storeCachedSiteContainer_(file, *sites);
+  return sites;
+}
+
+/******************************************************************************/
+
+unique_ptr<VectorSiteContainer> SequenceApplicationTools::processSiteContainer_(
+    shared_ptr<const Alphabet> alpha,
+    unique_ptr<VectorSiteContainer> sites2,
+    const AlignmentFile_& file,
+    const map<string, string>& params,
+    const string& suffix,
+    bool suffixIsOptional,
+    bool verbose,
+    int warn)
+{
+  ScopedTimer timer("app.process_alignment");
+  const map<string, string>& args = file.args;
 
   auto sites = unique_ptr<VectorSiteContainer>();
 
@@ -514,7 +746,7 @@ std::unique_ptr<VectorSiteContainer> SequenceApplicationTools::getSiteContainer(
     sites = std::move(sites2);
 
   // Look for site selection:
-  if (iAln->getFormatName() == "MASE file")
+  if (file.getFormatName() == "MASE file")
   {
     // getting site set:
     string siteSet = ApplicationTools::getStringParameter("siteSelection", args, "none", suffix, suffixIsOptional, warn + 1);
@@ -621,6 +853,7 @@ std::unique_ptr<VectorSiteContainer> SequenceApplicationTools::getSiteContainer(
   return sites;
 }
 
+
 /******************************************************************************/
 
 unique_ptr<ProbabilisticVectorSiteContainer> SequenceApplicationTools::getProbabilisticSiteContainer(
@@ -631,52 +864,42 @@ unique_ptr<ProbabilisticVectorSiteContainer> SequenceApplicationTools::getProbab
     bool verbose,
     int warn)
 {
-  string sequenceFilePath = ApplicationTools::getAFilePath("input.sequence.file", params, true, true, suffix, suffixIsOptional, "none", warn);
-  string sequenceFormat = ApplicationTools::getStringParameter("input.sequence.format", params, "Fasta()", suffix, suffixIsOptional, warn);
-  BppOAlignmentReaderFormat bppoReader(warn);
-
-  unique_ptr<IAlignment> iAln;
-  unique_ptr<IProbabilisticAlignment> iProbAln;
-
-  try
-  {
-    iAln.reset(bppoReader.read(sequenceFormat).release());
-  }
-  catch (Exception& e)
-  {
-    iProbAln.reset(bppoReader.readProbabilistic(sequenceFormat).release());
-  }
+  ScopedTimer timer("app.get_site_container");
+  AlignmentFile_ file = getAlignmentFile_(params, suffix, suffixIsOptional, true, warn);
 
   // Probabilistic from Sequence format only possible for Allelic alphabet
-  if (iAln && !AlphabetTools::isAllelicAlphabet(alpha.get()))
+  if (file.reader && !AlphabetTools::isAllelicAlphabet(alpha.get()))
     throw IOException("Bad format");
 
-
-  map<string, string> args(bppoReader.getUnparsedArguments());
   if (verbose)
   {
-    ApplicationTools::displayResult("Sequence file " + suffix, sequenceFilePath);
-    ApplicationTools::displayResult("Sequence format " + suffix, iAln ? iAln->getFormatName() : iProbAln->getFormatName());
-  }
-
-  shared_ptr<const Alphabet> alpha2;
-  if (AlphabetTools::isRNYAlphabet(alpha.get()))
-    alpha2 = dynamic_pointer_cast<const RNY>(alpha)->getLetterAlphabet();
-  else
-  {
-    if (AlphabetTools::isAllelicAlphabet(alpha.get()))
-      alpha2 = dynamic_pointer_cast<const AllelicAlphabet>(alpha)->getStateAlphabet();
-    else
-      alpha2 = alpha;
+    ApplicationTools::displayResult("Sequence file " + suffix, file.path);
+    ApplicationTools::displayResult("Sequence format " + suffix, file.getFormatName());
   }
 
   unique_ptr<VectorSiteContainer> sites;
   unique_ptr<ProbabilisticVectorSiteContainer> psites;
+  readAlignmentFile_(file, getFileAlphabet_(alpha, true), sites, psites);
 
-  if (iAln)
-    sites = make_unique<VectorSiteContainer>(*(iAln->readAlignment(sequenceFilePath, alpha2)));
-  else
-    psites = make_unique<ProbabilisticVectorSiteContainer>(*iProbAln->readAlignment(sequenceFilePath, alpha2));
+  return processProbabilisticSiteContainer_(alpha, std::move(sites), std::move(psites), file, params, suffix, suffixIsOptional, verbose, warn);
+}
+
+/******************************************************************************/
+
+unique_ptr<ProbabilisticVectorSiteContainer> SequenceApplicationTools::processProbabilisticSiteContainer_(
+    shared_ptr<const Alphabet> alpha,
+    unique_ptr<VectorSiteContainer> sites,
+    unique_ptr<ProbabilisticVectorSiteContainer> psites,
+    const AlignmentFile_& file,
+    const map<string, string>& params,
+    const string& suffix,
+    bool suffixIsOptional,
+    bool verbose,
+    int warn)
+{
+  ScopedTimer timer("app.process_alignment");
+  const map<string, string>& args = file.args;
+  shared_ptr<const Alphabet> alpha2 = getFileAlphabet_(alpha, true);
 
   if (sites)
   {
@@ -696,7 +919,7 @@ unique_ptr<ProbabilisticVectorSiteContainer> SequenceApplicationTools::getProbab
 
     // Look for site selection:
 
-    if (iAln->getFormatName() == "MASE file")
+    if (file.getFormatName() == "MASE file")
     {
       // getting site set:
       string siteSet = ApplicationTools::getStringParameter("siteSelection", args, "none", suffix, suffixIsOptional, warn + 1);
@@ -16,6 +16,10 @@
 #include "../Container/SequenceContainer.h"
 #include "../Container/VectorSiteContainer.h"
 #include "../Container/SiteContainerTools.h"
+#include "../ExecutionContext.h"
+#include "../Io/AlignmentCache.h"
+#include "../Io/ISequence.h"
+#include "../Profiler.h"
 #include "../SiteTools.h"
 
 namespace bpp
@@ -173,6 +177,14 @@ public:
    *
    * See the Bio++ program suite manual for a full description of the syntax.
    *
+   * If the 'input.sequence.cache' option gives a directory, the processed
+   * alignment (after translation, site and sequence selections) is stored in
+   * this directory, and loaded from it by later calls with the same file
+   * content, alphabet, format, site selection and sequence selection
+   * ('input.sequence.keep_names' and 'input.sequence.remove_names').
+   * Random site samples are never cached. Sequence comments are not cached.
+   * If the alignment cannot be stored, a warning is displayed.
+   *
    * @param alpha   The alphabet to use in the container.
    * @param params  The attribute map where options may be found.
    * @param suffix  A suffix to be applied to each attribute name.
@@ -180,6 +192,7 @@ public:
    * @param verbose Print some info to the 'message' output stream.
    * @param warn Set the warning level (0: always display warnings, >0 display warnings on demand).
    * @return A new VectorSiteContainer object according to the description.
+   * @see AlignmentCache
    */
   static std::unique_ptr<VectorSiteContainer> getSiteContainer(
       std::shared_ptr<const Alphabet> alpha,
@@ -220,6 +233,8 @@ public:
    * The supported sequence formats are Fasta, DCSE, Clustal, Mase and Phylip.
    *
    * See the Bio++ program suite manual for a full description of the syntax.
+   * Alignments are cached as in getSiteContainer, in the directory given by
+   * the 'cache' argument of each alignment, or by the 'input.sequence.cache' option.
    *
    * @param alpha   The alphabet to use in the container.
    * @param params  The attribute map where options may be found.
@@ -228,6 +243,8 @@ public:
    * @param suffixIsOptional Tell if the suffix is absolutely required.
    * @param verbose Print some info to the 'message' output stream.
    * @param warn Set the warning level (0: always display warnings, >0 display warnings on demand).
+   * @param context The execution context to be used. Files are read concurrently, by windows of one file per thread,
+   * and then processed in the order of the options.
    * @return A map of VectorSiteContainer objects according to the description.
    */
   static std::map<size_t, std::unique_ptr<VectorSiteContainer>>
@@ -238,7 +255,8 @@ public:
       const std::string& suffix = "",
       bool suffixIsOptional = true,
       bool verbose = true,
-      int warn = 1);
+      int warn = 1,
+      const ExecutionContext& context = ExecutionContext::global());
 
   /**
    * @brief Build multiple ProbabilisticSiteContainer objects according to the BppO syntax.
@@ -255,6 +273,8 @@ public:
    * @param suffixIsOptional Tell if the suffix is absolutely required.
    * @param verbose Print some info to the 'message' output stream.
    * @param warn Set the warning level (0: always display warnings, >0 display warnings on demand).
+   * @param context The execution context to be used. Files are read concurrently, by windows of one file per thread,
+   * and then processed in the order of the options.
    * @return A map of ProbabilisticVectorSiteContainer objects according to the description.
    */
   static std::map<size_t, std::unique_ptr<ProbabilisticVectorSiteContainer>>
@@ -265,7 +285,8 @@ public:
       const std::string& suffix = "",
       bool suffixIsOptional = true,
       bool verbose = true,
-      int warn = 1);
+      int warn = 1,
+      const ExecutionContext& context = ExecutionContext::global());
 
 
   /**
@@ -319,6 +340,8 @@ public:
    * @param gapAsUnknown Convert gaps to unknown characters.
    * @param verbose Print some info to the 'message' output stream.
    * @param warn Set the warning level (0: always display warnings, >0 display warnings on demand).
+   * @param context The execution context to be used, sites being evaluated in parallel.
+   * @param gCode The genetic code used to remove stop codons. If null, it is built from the 'genetic_code' option.
    * @return A new VectorSiteContainer object containing sites of interest.
    */
   template<class SiteType, class SequenceType>
@@ -330,8 +353,11 @@ public:
       bool suffixIsOptional = true,
       bool gapAsUnknown = true,
       bool verbose = true,
-      int warn = 1)
+      int warn = 1,
+      const ExecutionContext& context = ExecutionContext::global(),
+      std::shared_ptr<const GeneticCode> gCode = nullptr)
   {
+    ScopedTimer timer("app.get_sites_to_analyse");
     // Fully resolved sites, i.e. without jokers and gaps:
     std::unique_ptr< TemplateVectorSiteContainer<SiteType, SequenceType>> sitesToAnalyse;
 
@@ -343,8 +369,7 @@ public:
 
     if (option == "all")
     {
-      sitesToAnalyse = std::make_unique< TemplateVectorSiteContainer<SiteType, SequenceType>>(allSites);
-      size_t nbSites = sitesToAnalyse->getNumberOfSites();
+      size_t nbSites = allSites.getNumberOfSites();
 
       std::string maxGapOption = ApplicationTools::getStringParameter("input.sequence.max_gap_allowed", params, "100%", suffix, suffixIsOptional, warn);
 
@@ -358,22 +383,6 @@ public:
       else
         gapCount = TextTools::to<int>(maxGapOption) - NumConstants::TINY();
 
-      if (gapCount < static_cast<double>(numSeq) - NumConstants::TINY())
-      {
-        if (verbose)
-          ApplicationTools::displayTask("Remove sites with gaps", true);
-        for (size_t i = nbSites; i > 0; i--)
-        {
-          if (verbose)
-            ApplicationTools::displayGauge(nbSites - i, nbSites - 1, '=');
-
-          if (static_cast<double>(SiteTools::numberOfGaps(sitesToAnalyse->site(i - 1))) > gapCount)
-            sitesToAnalyse->deleteSites(i - 1, 1);
-        }
-        if (verbose)
-          ApplicationTools::displayTaskDone();
-      }
-
       std::string maxUnresolvedOption = ApplicationTools::getStringParameter("input.sequence.max_unresolved_allowed", params, "100%", suffix, suffixIsOptional, warn);
 
       double unresCount = 0;
@@ -386,34 +395,41 @@ public:
       else
         unresCount = TextTools::to<double>(maxUnresolvedOption) - NumConstants::TINY();
 
-      nbSites = sitesToAnalyse->getNumberOfSites();
+      bool filterGaps = gapCount < static_cast<double>(numSeq) - NumConstants::TINY();
+      bool filterUnresolved = unresCount < static_cast<double>(numSeq) - NumConstants::TINY();
 
-      if (unresCount < static_cast<double>(numSeq) - NumConstants::TINY())
+      if (filterGaps || filterUnresolved)
       {
         if (verbose)
-          ApplicationTools::displayTask("Remove unresolved sites", true);
-        for (size_t i = nbSites; i > 0; i--)
-        {
-          if (verbose)
-            ApplicationTools::displayGauge(nbSites - i, nbSites - 1, '=');
-
-          if (static_cast<double>(SiteTools::numberOfUnresolved(sitesToAnalyse->site(i - 1))) > unresCount)
-            sitesToAnalyse->deleteSites(i - 1, 1);
-        }
+          ApplicationTools::displayTask("Remove sites with gaps or unresolved states", true);
+        // Both thresholds are checked in a single pass over the sites,
+        // and selected sites are copied once:
+        SiteSelection selection = SiteContainerTools::selectSites(allSites,
+            [&](const SiteType& site)
+            {
+              return !(filterGaps && static_cast<double>(SiteTools::numberOfGaps(site)) > gapCount)
+                     && !(filterUnresolved && static_cast<double>(SiteTools::numberOfUnresolved(site)) > unresCount);
+            }, context);
+        sitesToAnalyse = SiteContainerTools::getSelectedSites(allSites, selection, context);
         if (verbose)
+        {
           ApplicationTools::displayTaskDone();
+          ApplicationTools::displayResult("Sites removed", TextTools::toString(nbSites - selection.size()));
+        }
       }
+      else
+        sitesToAnalyse = std::make_unique< TemplateVectorSiteContainer<SiteType, SequenceType>>(allSites);
     }
     else if (option == "complete")
     {
-      sitesToAnalyse = SiteContainerTools::getCompleteSites(allSites);
+      sitesToAnalyse = SiteContainerTools::getCompleteSites(allSites, context);
       size_t nbSites = sitesToAnalyse->getNumberOfSites();
       if (verbose)
         ApplicationTools::displayResult("Complete sites", TextTools::toString(nbSites));
     }
     else if (option == "nogap")
     {
-      sitesToAnalyse = SiteContainerTools::getSitesWithoutGaps(allSites);
+      sitesToAnalyse = SiteContainerTools::getSitesWithoutGaps(allSites, context);
       size_t nbSites = sitesToAnalyse->getNumberOfSites();
       if (verbose)
         ApplicationTools::displayResult("Sites without gap", TextTools::toString(nbSites));
@@ -432,10 +448,13 @@ public:
 
       if (option == "yes")
       {
-        std::string codeDesc = ApplicationTools::getStringParameter("genetic_code", params, "Standard", "", true, warn);
-        auto nucAlph = ca->getNucleicAlphabet();
-        auto gCode = getGeneticCode(nucAlph, codeDesc);
-        SiteContainerTools::removeSitesWithStopCodon(*sitesToAnalyse, *gCode);
+        if (!gCode)
+        {
+          std::string codeDesc = ApplicationTools::getStringParameter("genetic_code", params, "Standard", "", true, warn);
+          auto nucAlph = ca->getNucleicAlphabet();
+          gCode = getGeneticCode(nucAlph, codeDesc);
+        }
+        SiteContainerTools::removeSitesWithStopCodon(*sitesToAnalyse, *gCode, context);
       }
     }
 
@@ -487,6 +506,115 @@ public:
       const std::string& suffix = "",
       bool verbose = true,
       int warn = 1);
+
+private:
+  /**
+   * @brief An alignment file and its reader, as given by the input.sequence.* options.
+   */
+  struct AlignmentFile_
+  {
+    std::string path;
+    std::unique_ptr<IAlignment> reader;
+    std::unique_ptr<IProbabilisticAlignment> probabilisticReader;
+    std::map<std::string, std::string> args; // Unparsed arguments of the format.
+    std::shared_ptr<AlignmentCache> cache; // Null if the alignment is not cached.
+    std::map<std::string, std::string> cacheOptions; // Options the processed alignment depends on.
+    std::string cacheKey; // Computed when the file is read.
+
+    AlignmentFile_() :
+      path(),
+      reader(),
+      probabilisticReader(),
+      args(),
+      cache(),
+      cacheOptions(),
+      cacheKey()
+    {}
+
+    std::string getFormatName() const
+    {
+      return reader ? reader->getFormatName() : probabilisticReader->getFormatName();
+    }
+  };
+
+  /**
+   * @return The number and the options of all alignments described by the 'data' options.
+   */
+  static std::vector< std::pair<size_t, std::map<std::string, std::string>>> getAlignmentDescriptions_(
+      std::shared_ptr<const Alphabet> alpha,
+      const std::map<std::string, std::string>& params,
+      const std::string& prefix,
+      const std::string& suffix,
+      bool suffixIsOptional);
+
+  static AlignmentFile_ getAlignmentFile_(
+      const std::map<std::string, std::string>& params,
+      const std::string& suffix,
+      bool suffixIsOptional,
+      bool probabilistic,
+      int warn);
+
+  /**
+   * @return The alphabet in which sequences are stored in files.
+   */
+  static std::shared_ptr<const Alphabet> getFileAlphabet_(
+      std::shared_ptr<const Alphabet> alpha,
+      bool probabilistic);
+
+  /**
+   * @brief Read an alignment file. Does not use any shared state, and can be called concurrently.
+   */
+  static void readAlignmentFile_(
+      const AlignmentFile_& file,
+      std::shared_ptr<const Alphabet> alpha,
+      std::unique_ptr<VectorSiteContainer>& sites,
+      std::unique_ptr<ProbabilisticVectorSiteContainer>& psites);
+
+  /**
+   * @brief Load a processed alignment from the cache, if any. Can be called concurrently.
+   *
+   * @return The alignment, or a null pointer if the file is not cached yet or not cached at all.
+   */
+  static std::unique_ptr<VectorSiteContainer> loadCachedSiteContainer_(
+      AlignmentFile_& file,
+      std::shared_ptr<const Alphabet> alpha,
+      const ExecutionContext& context);
+
+  /**
+   * @brief Store a processed alignment in the cache of its file, if any.
+   *
+   * Errors are reported as warnings, as the alignment is loaded anyway.
+   */
+  static void storeCachedSiteContainer_(
+      const AlignmentFile_& file,
+      const SiteContainerInterface& sites);
+
+  /**
+   * @brief Translation, site and sequence selections of an alignment read by getSiteContainer.
+   */
+  static std::unique_ptr<VectorSiteContainer> processSiteContainer_(
+      std::shared_ptr<const Alphabet> alpha,
+      std::unique_ptr<VectorSiteContainer> sites2,
+      const AlignmentFile_& file,
+      const std::map<std::string, std::string>& params,
+      const std::string& suffix,
+      bool suffixIsOptional,
+      bool verbose,
+      int warn);
+
+  /**
+   * @brief Conversion and site selection of an alignment read by getProbabilisticSiteContainer.
+   */
+  static std::unique_ptr<ProbabilisticVectorSiteContainer> processProbabilisticSiteContainer_(
+      std::shared_ptr<const Alphabet> alpha,
+      std::unique_ptr<VectorSiteContainer> sites,
+      std::unique_ptr<ProbabilisticVectorSiteContainer> psites,
+      const AlignmentFile_& file,
+      const std::map<std::string, std::string>& params,
+      const std::string& suffix,
+      bool suffixIsOptional,
+      bool verbose,
+      int warn);
 };
 } // end of namespace bpp.
 #endif // BPP_SEQ_APP_SEQUENCEAPPLICATIONTOOLS_H
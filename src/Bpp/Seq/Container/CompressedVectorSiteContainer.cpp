@@ -453,6 +453,18 @@ Vint CompressedVectorSiteContainer::getSiteCoordinates() const
 
 /******************************************************************************/
 
+std::vector<size_t> CompressedVectorSiteContainer::getUniqueSiteCounts() const
+{
+  vector<size_t> counts(getNumberOfUniqueSites(), 0);
+  for (auto i : index_)
+  {
+    counts[i]++;
+  }
+  return counts;
+}
+
+/******************************************************************************/
+
 const Sequence& CompressedVectorSiteContainer::sequence(size_t sequencePosition) const
 {
   if (sequencePosition >= getNumberOfSequences())
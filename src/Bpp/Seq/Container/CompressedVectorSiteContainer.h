@@ -150,6 +150,29 @@ public:
     return siteContainer_.getSize();
   }
 
+  /**
+   * @return The unique site (pattern) at a given position in the compressed set.
+   *
+   * @param uniqueSitePosition The position of the pattern, between 0 and getNumberOfUniqueSites() - 1.
+   */
+  const Site& uniqueSite(size_t uniqueSitePosition) const
+  {
+    return *siteContainer_.getObject(uniqueSitePosition);
+  }
+
+  /**
+   * @return The position in the compressed set of the pattern of a given site.
+   */
+  size_t getUniqueSitePosition(size_t sitePosition) const
+  {
+    return index_[sitePosition];
+  }
+
+  /**
+   * @return For each unique site (pattern), the number of sites it stands for.
+   */
+  std::vector<size_t> getUniqueSiteCounts() const;
+
 
   // These methods are implemented for this class:
 
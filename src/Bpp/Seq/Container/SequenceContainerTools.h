@@ -13,6 +13,7 @@
 #include <memory>
 
 #include <Bpp/Numeric/VectorTools.h>
+#include "../ExecutionContext.h"
 #include "../SymbolListTools.h"
 #include "SequenceContainer.h"
 #include "VectorSequenceContainer.h"
@@ -25,9 +26,19 @@ using SiteSelection = std::vector<size_t>;
 
 /**
  * @brief Utilitary methods dealing with sequence containers.
+ *
+ * Methods working on whole containers take an optional ExecutionContext,
+ * and are run in parallel over blocks of sequences if the context uses
+ * several threads.
  */
 class SequenceContainerTools
 {
+public:
+  /**
+   * @brief Number of sequences per block, for methods run in parallel.
+   */
+  static const size_t SEQUENCES_PER_BLOCK = 8;
+
 public:
   SequenceContainerTools() {}
   virtual ~SequenceContainerTools() {}
@@ -233,27 +244,61 @@ public:
   }
 
 
+  /**
+   * @brief Make sure that the sequences of a container can be read concurrently.
+   *
+   * Vector sequence containers (aligned or not) store their sequences. Other
+   * containers, like site containers, build them on first access, which is not
+   * thread-safe: they are then all built beforehand. Nothing is done if the
+   * context is sequential.
+   *
+   * @param sc      The container to read.
+   * @param context The execution context to be used.
+   */
+  template<class SequenceType, class HashType>
+  static void prepareSequenceAccess(
+      const TemplateSequenceContainerInterface<SequenceType, HashType>& sc,
+      const ExecutionContext& context)
+  {
+    if (!context.isParallel() || dynamic_cast<const TemplateVectorSequenceContainer<SequenceType>*>(&sc))
+      return;
+    for (size_t i = 0; i < sc.getNumberOfSequences(); ++i)
+    {
+      sc.sequence(i);
+    }
+  }
+
+
   /**
    * @brief Check if all sequences in a SequenceContainer have the same length.
    *
    * @param sc The container to check.
+   * @param context The execution context to be used.
    * @return True is all sequence have the same length.
    */
   template<class SequenceType, class HashType>
   static bool sequencesHaveTheSameLength(
       const TemplateSequenceContainerInterface<SequenceType,
-      HashType>& sc)
+      HashType>& sc,
+      const ExecutionContext& context = ExecutionContext::global())
   {
     size_t ns = sc.getNumberOfSequences();
     if (ns <= 1)
       return true;
+    prepareSequenceAccess(sc, context);
     size_t length = sc.sequence(0).size();
-    for (size_t i = 1; i < ns; ++i)
-    {
-      if (sc.sequence(i).size() != length)
-        return false;
-    }
-    return true;
+    return context.mapReduce(ns, true,
+        [&](size_t begin, size_t end)
+        {
+          for (size_t i = begin; i < end; ++i)
+          {
+            if (sc.sequence(i).size() != length)
+              return false;
+          }
+          return true;
+        },
+        [](bool a, bool b) { return a && b; },
+        SEQUENCES_PER_BLOCK);
   }
 
 
@@ -269,16 +314,35 @@ public:
    *
    * States are stored as their int code.
    */
-  static void getCounts(const SequenceContainerInterface& sc, std::map<int, unsigned int>& f)
+  static void getCounts(
+      const SequenceContainerInterface& sc,
+      std::map<int, unsigned int>& f,
+      const ExecutionContext& context = ExecutionContext::global())
   {
-    for (size_t i = 0; i < sc.getNumberOfSequences(); ++i)
-    {
-      const Sequence& seq = sc.sequence(i);
-      for (size_t j = 0; j < seq.size(); ++j)
-      {
-        f[seq[j]]++;
-      }
-    }
+    prepareSequenceAccess(sc, context);
+    f = context.mapReduce(sc.getNumberOfSequences(), std::move(f),
+        [&](size_t begin, size_t end)
+        {
+          std::map<int, unsigned int> counts;
+          for (size_t i = begin; i < end; ++i)
+          {
+            const Sequence& seq = sc.sequence(i);
+            for (size_t j = 0; j < seq.size(); ++j)
+            {
+              counts[seq[j]]++;
+            }
+          }
+          return counts;
+        },
+        [](std::map<int, unsigned int> a, const std::map<int, unsigned int>& b)
+        {
+          for (const auto& it : b)
+          {
+            a[it.first] += it.second;
+          }
+          return a;
+        },
+        SEQUENCES_PER_BLOCK);
   }
 
 
@@ -297,15 +361,10 @@ public:
   static void getFrequencies(
       const SequenceContainerInterface& sc,
       std::map<int, double>& f,
-      double pseudoCount = 0)
+      double pseudoCount = 0,
+      const ExecutionContext& context = ExecutionContext::global())
   {
-    double n = 0;
-    for (size_t i = 0; i < sc.getNumberOfSequences(); ++i)
-    {
-      const Sequence& seq = sc.sequence(i);
-      SymbolListTools::getCounts(seq, f, true);
-      n += static_cast<double>(seq.size());
-    }
+    double n = getCounts_(sc, f, context);
 
     if (pseudoCount != 0)
     {
@@ -339,15 +398,10 @@ public:
   static void getFrequencies(
       const ProbabilisticSequenceContainerInterface& sc,
       std::map<int, double>& f,
-      double pseudoCount = 0)
+      double pseudoCount = 0,
+      const ExecutionContext& context = ExecutionContext::global())
   {
-    double n = 0;
-    for (size_t i = 0; i < sc.getNumberOfSequences(); ++i)
-    {
-      const ProbabilisticSequence& seq = sc.sequence(i);
-      SymbolListTools::getCounts(seq, f, true);
-      n += static_cast<double>(seq.size());
-    }
+    double n = getCounts_(sc, f, context);
 
     if (pseudoCount != 0)
     {
@@ -375,17 +429,18 @@ public:
   static void getFrequencies(
       const SequenceDataInterface& sc,
       std::map<int, double>& f,
-      double pseudoCount = 0)
+      double pseudoCount = 0,
+      const ExecutionContext& context = ExecutionContext::global())
   {
     try
     {
-      getFrequencies(dynamic_cast<const SequenceContainerInterface&>(sc), f, pseudoCount);
+      getFrequencies(dynamic_cast<const SequenceContainerInterface&>(sc), f, pseudoCount, context);
       return;
     }
     catch (std::bad_cast&) {}
     try
     {
-      getFrequencies(dynamic_cast<const ProbabilisticSequenceContainerInterface&>(sc), f, pseudoCount);
+      getFrequencies(dynamic_cast<const ProbabilisticSequenceContainerInterface&>(sc), f, pseudoCount, context);
     }
     catch (std::bad_cast&)
     {
@@ -497,6 +552,47 @@ public:
     }
     return newcont;
   }
+
+private:
+  /**
+   * @brief Add the state counts of all sequences to a map, block by block.
+   *
+   * @return The total number of positions.
+   */
+  template<class SequenceType, class HashType>
+  static double getCounts_(
+      const TemplateSequenceContainerInterface<SequenceType, HashType>& sc,
+      std::map<int, double>& f,
+      const ExecutionContext& context)
+  {
+    using Counts = std::pair<std::map<int, double>, double>;
+    prepareSequenceAccess(sc, context);
+    Counts total = context.mapReduce(sc.getNumberOfSequences(), Counts(std::move(f), 0.),
+        [&](size_t begin, size_t end)
+        {
+          Counts counts;
+          counts.second = 0.;
+          for (size_t i = begin; i < end; ++i)
+          {
+            const SequenceType& seq = sc.sequence(i);
+            SymbolListTools::getCounts(seq, counts.first, true);
+            counts.second += static_cast<double>(seq.size());
+          }
+          return counts;
+        },
+        [](Counts a, const Counts& b)
+        {
+          for (const auto& it : b.first)
+          {
+            a.first[it.first] += it.second;
+          }
+          a.second += b.second;
+          return a;
+        },
+        SEQUENCES_PER_BLOCK);
+    f = std::move(total.first);
+    return total.second;
+  }
 };
 } // end of namespace bpp.
 #endif // BPP_SEQ_CONTAINER_SEQUENCECONTAINERTOOLS_H
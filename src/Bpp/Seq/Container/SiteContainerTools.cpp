@@ -5,6 +5,7 @@
 #include <Bpp/App/ApplicationTools.h>
 
 #include "../Alphabet/AlphabetTools.h"
+#include "../AlphabetIndex/CompiledAlphabetIndex2.h"
 #include "../Site.h"
 #include "../CodonSiteTools.h"
 #include "../SequenceTools.h"
@@ -29,42 +30,30 @@ unique_ptr<Sequence> SiteContainerTools::getConsensus(
     const SiteContainerInterface& sc,
     const std::string& name,
     bool ignoreGap,
-    bool resolveUnknown)
+    bool resolveUnknown,
+    const ExecutionContext& context)
 {
-  Vint consensus;
-  SimpleSiteContainerIterator ssi(sc);
-  const Site* site;
-  while (ssi.hasMoreSites())
+  prepareSiteAccess(sc, context);
+  Vint consensus(sc.getNumberOfSites());
+  context.forEachBlock(consensus.size(), [&](size_t begin, size_t end)
   {
-    site = &ssi.nextSite();
-    map<int, double> freq;
-    SiteTools::getFrequencies(*site, freq, resolveUnknown);
-    double max = 0;
-    int cons = -1; // default result
-    if (ignoreGap)
+    for (size_t i = begin; i < end; ++i)
     {
+      map<int, double> freq;
+      SiteTools::getFrequencies(sc.site(i), freq, resolveUnknown);
+      double max = 0;
+      int cons = -1; // default result
       for (auto& it : freq)
       {
-        if (it.second > max && it.first != -1)
+        if (it.second > max && (!ignoreGap || it.first != -1))
         {
           max = it.second;
           cons = it.first;
         }
       }
+      consensus[i] = cons;
     }
-    else
-    {
-      for (auto& it : freq)
-      {
-        if (it.second > max)
-        {
-          max = it.second;
-          cons = it.first;
-        }
-      }
-    }
-    consensus.push_back(cons);
-  }
+  });
   auto alphaPtr = sc.getAlphabet();
   auto seqConsensus = make_unique<Sequence>(name, consensus, alphaPtr);
   return seqConsensus;
@@ -348,6 +337,9 @@ std::unique_ptr<AlignedSequenceContainer> SiteContainerTools::alignNW(
   unique_ptr<Sequence> s2(seq2.clone());
   SequenceTools::removeGaps(*s2);
 
+  // Scores are looked up in a precomputed table:
+  CompiledAlphabetIndex2 scores(s);
+
   // 1) Initialize matrix:
   RowMatrix<double> m(s1->size() + 1, s2->size() + 1);
   RowMatrix<char>   p(s1->size(), s2->size());
@@ -365,7 +357,7 @@ std::unique_ptr<AlignedSequenceContainer> SiteContainerTools::alignNW(
   {
     for (size_t j = 1; j <= s2->size(); j++)
     {
-      choice1 = m(i - 1, j - 1) + static_cast<double>(s.getIndex((*s1)[i - 1], (*s2)[j - 1]));
+      choice1 = m(i - 1, j - 1) + scores((*s1)[i - 1], (*s2)[j - 1]);
       choice2 = m(i - 1, j) + gap;
       choice3 = m(i, j - 1) + gap;
       mx = choice1; px = 'd'; // Default in case of equality of scores.
@@ -449,6 +441,9 @@ unique_ptr<AlignedSequenceContainer> SiteContainerTools::alignNW(
   unique_ptr<Sequence> s2(seq2.clone());
   SequenceTools::removeGaps(*s2);
 
+  // Scores are looked up in a precomputed table:
+  CompiledAlphabetIndex2 scores(s);
+
   // 1) Initialize matrix:
   RowMatrix<double> m(s1->size() + 1, s2->size() + 1);
   RowMatrix<double> v(s1->size() + 1, s2->size() + 1);
@@ -479,7 +474,7 @@ unique_ptr<AlignedSequenceContainer> SiteContainerTools::alignNW(
   {
     for (size_t j = 1; j <= s2->size(); j++)
     {
-      choice1 = m(i - 1, j - 1) + s.getIndex((*s1)[i - 1], (*s2)[j - 1]);
+      choice1 = m(i - 1, j - 1) + scores((*s1)[i - 1], (*s2)[j - 1]);
       choice2 = h(i - 1, j - 1) + opening + extending;
       choice3 = v(i - 1, j - 1) + opening + extending;
       mx = choice1; // Default in case of equality of scores.
@@ -641,7 +636,8 @@ std::unique_ptr<DistanceMatrix> SiteContainerTools::computeSimilarityMatrix(
     const SiteContainerInterface& sites,
     bool dist,
     const std::string& gapOption,
-    bool unresolvedAsGap)
+    bool unresolvedAsGap,
+    const ExecutionContext& context)
 {
   size_t n = sites.getNumberOfSequences();
   auto mat = make_unique<DistanceMatrix>(sites.getSequenceNames());
@@ -651,12 +647,12 @@ std::unique_ptr<DistanceMatrix> SiteContainerTools::computeSimilarityMatrix(
   {
     if (unresolvedAsGap)
     {
-      auto tmp = removeGapOrUnresolvedOnlySites(sites);
+      auto tmp = removeGapOrUnresolvedOnlySites(sites, context);
       sites2 = make_unique<AlignedSequenceContainer>(*tmp);
     }
     else
     {
-      auto tmp = removeGapOnlySites(sites);
+      auto tmp = removeGapOnlySites(sites, context);
       sites2 = make_unique<AlignedSequenceContainer>(*tmp);
     }
     pairwiseGapOption = SIMILARITY_ALL;
@@ -666,16 +662,20 @@ std::unique_ptr<DistanceMatrix> SiteContainerTools::computeSimilarityMatrix(
     sites2 = make_unique<AlignedSequenceContainer>(sites);
   }
 
-  for (size_t i = 0; i < n; ++i)
+  // One row per task, each pair being computed by a single task:
+  context.forEachBlock(n, [&](size_t begin, size_t end)
   {
-    (*mat)(i, i) = dist ? 0. : 1.;
-    const Sequence& seq1 = sites2->sequence(i);
-    for (size_t j = i + 1; j < n; ++j)
+    for (size_t i = begin; i < end; ++i)
     {
-      const Sequence& seq2 = sites2->sequence(j);
-      (*mat)(i, j) = (*mat)(j, i) = computeSimilarity(seq1, seq2, dist, pairwiseGapOption, unresolvedAsGap);
+      (*mat)(i, i) = dist ? 0. : 1.;
+      const Sequence& seq1 = sites2->sequence(i);
+      for (size_t j = i + 1; j < n; ++j)
+      {
+        const Sequence& seq2 = sites2->sequence(j);
+        (*mat)(i, j) = (*mat)(j, i) = computeSimilarity(seq1, seq2, dist, pairwiseGapOption, unresolvedAsGap);
+      }
     }
-  }
+  }, 1);
   return mat;
 }
 
@@ -9,11 +9,14 @@
 #include "SiteContainer.h"
 #include "VectorSiteContainer.h"
 #include "AlignedSequenceContainer.h"
+#include "CompressedVectorSiteContainer.h"
 #include "SequenceContainerTools.h"
 #include "AlignmentData.h"
 #include "../AlphabetIndex/AlphabetIndex2.h"
 #include "../DistanceMatrix.h"
+#include "../ExecutionContext.h"
 #include "../GeneticCode/GeneticCode.h"
+#include "../Profiler.h"
 #include "../SiteTools.h"
 #include "../CodonSiteTools.h"
 #include "../Site.h"
@@ -31,6 +34,11 @@ using SiteSelection = std::vector<size_t>;
 
 /**
  * @brief Some utililitary methods to deal with site containers.
+ *
+ * Methods working on whole containers (filters, consensus, similarity, sampling,
+ * merging) take an optional ExecutionContext, and are run in parallel over blocks
+ * of sites (or sequences) if the context uses several threads. Results do not
+ * depend on the number of threads.
  */
 class SiteContainerTools
 {
@@ -46,24 +54,22 @@ public:
    * The container passed as input is not modified, all sites are copied.
    *
    * @param sites The container to analyse.
+   * @param context The execution context to be used.
    * @return A pointer toward a new SiteContainer with only sites with no gaps.
    */
   template<class SiteType, class SequenceType>
   static std::unique_ptr<TemplateVectorSiteContainer<SiteType, SequenceType>>
-  getSitesWithoutGaps(const TemplateSiteContainerInterface<SiteType, SequenceType, std::string>& sites)
+  getSitesWithoutGaps(
+      const TemplateSiteContainerInterface<SiteType, SequenceType, std::string>& sites,
+      const ExecutionContext& context = ExecutionContext::global())
   {
     std::vector<std::string> sequenceKeys = sites.getSequenceKeys();
     std::shared_ptr<const Alphabet> alphaPtr = sites.getAlphabet();
     auto selectedSites = std::make_unique< TemplateVectorSiteContainer<SiteType, SequenceType>>(sequenceKeys, alphaPtr);
-    for (size_t i = 0; i < sites.getNumberOfSites(); ++i)
-    {
-      if (!SiteTools::hasGap(sites.site(i)))   // This calls the method dedicated to basic sites
-      {
-        std::unique_ptr<SiteType> sitePtr(sites.site(i).clone());
-        selectedSites->addSite(sitePtr, false);
-      }
-    }
-    selectedSites->setSequenceNames(sites.getSequenceNames(), false);
+    SiteSelection selection = selectSites_(sites, [](const SiteType& site) {
+      return !SiteTools::hasGap(site); // This calls the method dedicated to basic sites
+    }, context);
+    getSelectedSites(sites, selection, *selectedSites, context);
     return selectedSites;
   }
 
@@ -76,24 +82,22 @@ public:
    * The container passed as input is not modified, all sites are copied.
    *
    * @param sites The container to analyse.
+   * @param context The execution context to be used.
    * @return A pointer toward a new SiteContainer with only complete sites.
    */
   template<class SiteType, class SequenceType>
   static std::unique_ptr<TemplateVectorSiteContainer<SiteType, SequenceType>>
-  getCompleteSites(const TemplateSiteContainerInterface<SiteType, SequenceType, std::string>& sites)
+  getCompleteSites(
+      const TemplateSiteContainerInterface<SiteType, SequenceType, std::string>& sites,
+      const ExecutionContext& context = ExecutionContext::global())
   {
     std::vector<std::string> sequenceKeys = sites.getSequenceKeys();
     std::shared_ptr<const Alphabet> alphaPtr = sites.getAlphabet();
     auto selectedSites = std::make_unique< TemplateVectorSiteContainer<SiteType, SequenceType>>(sequenceKeys, alphaPtr);
-    for (size_t i = 0; i < sites.getNumberOfSites(); ++i)
-    {
-      if (SiteTools::isComplete(sites.site(i)))   // This calls the method dedicated to basic sites
-      {
-        std::unique_ptr<SiteType> sitePtr(sites.site(i).clone());
-        selectedSites->addSite(sitePtr, false);
-      }
-    }
-    selectedSites->setSequenceNames(sites.getSequenceNames(), false);
+    SiteSelection selection = selectSites_(sites, [](const SiteType& site) {
+      return SiteTools::isComplete(site); // This calls the method dedicated to basic sites
+    }, context);
+    getSelectedSites(sites, selection, *selectedSites, context);
     return selectedSites;
   }
 
@@ -105,26 +109,24 @@ public:
    * The container passed as input is not modified, all sites are copied.
    *
    * @param sites The container to analyse.
+   * @param context The execution context to be used.
    * @return A pointer toward a new SiteContainer.
    */
   template<class SiteType, class SequenceType>
   static std::unique_ptr<TemplateSiteContainerInterface<SiteType, SequenceType, std::string>>
-  removeGapOnlySites(const TemplateSiteContainerInterface<SiteType, SequenceType, std::string>& sites)
+  removeGapOnlySites(
+      const TemplateSiteContainerInterface<SiteType, SequenceType, std::string>& sites,
+      const ExecutionContext& context = ExecutionContext::global())
   {
     if (sites.getNumberOfSequences() == 0)
       throw Exception("SiteContainerTools::removeGapOnlySites. Container is empty.");
     std::vector<std::string> sequenceKeys = sites.getSequenceKeys();
     auto alphaPtr = sites.getAlphabet();
     auto newContainer = std::make_unique< TemplateVectorSiteContainer<SiteType, SequenceType>>(sequenceKeys, alphaPtr);
-    for (size_t i = 0; i < sites.getNumberOfSites(); ++i)
-    {
-      const Site& site = sites.site(i);
-      if (!SiteTools::isGapOnly(site))
-      {
-        auto site2 = std::unique_ptr<SiteType>(site.clone());
-        newContainer->addSite(site2, false);
-      }
-    }
+    SiteSelection selection = selectSites_(sites, [](const SiteType& site) {
+      return !SiteTools::isGapOnly(site);
+    }, context);
+    getSelectedSites(sites, selection, *newContainer, context);
     return newContainer;
   }
 
@@ -132,39 +134,23 @@ public:
   /**
    * @brief Remove gap-only sites from a SiteContainer.
    *
+   * Sites are checked in parallel, and removed by runs of consecutive positions.
+   *
    * @param sites The container where the sites have to be removed.
+   * @param context The execution context to be used.
    */
   template<class SiteType, class SequenceType, class HashType>
-  static void removeGapOnlySites(TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& sites)
+  static void removeGapOnlySites(
+      TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& sites,
+      const ExecutionContext& context = ExecutionContext::global())
   {
     if (sites.getNumberOfSequences() == 0)
       throw Exception("SiteContainerTools::removeGapOnlySites. Container is empty.");
 
-    size_t n = sites.getNumberOfSites();
-    size_t i = n;
-    while (i > 1)
-    {
-      ApplicationTools::displayGauge(n - i + 1, n);
-      const SiteType* site = &sites.site(i - 1); // Note (jdutheil 18/12/22: for some reason a ref here does not work, resorting to pointer)
-      if (SiteTools::isGapOnly(*site))
-      {
-        size_t end = i;
-        while (SiteTools::isGapOnly(*site) && i > 1)
-        {
-          --i;
-          site = &sites.site(i - 1);
-        }
-        sites.deleteSites(i, end - i);
-      }
-      else
-      {
-        --i;
-      }
-    }
-    ApplicationTools::displayGauge(n, n);
-    const Site& site = sites.site(0);
-    if (SiteTools::isGapOnly(site))
-      sites.deleteSite(0);
+    SiteSelection selection = selectSites_(sites, [](const SiteType& site) {
+      return SiteTools::isGapOnly(site);
+    }, context);
+    deleteSites_(sites, selection);
   }
 
 
@@ -175,11 +161,14 @@ public:
    * The container passed as input is not modified, all sites are copied.
    *
    * @param sites The container to analyse.
+   * @param context The execution context to be used.
    * @return A pointer toward a new SiteContainer.
    */
   template<class SiteType, class SequenceType>
   static std::unique_ptr<TemplateVectorSiteContainer<SiteType, SequenceType>>
-  removeGapOrUnresolvedOnlySites(const TemplateSiteContainerInterface<SiteType, SequenceType, std::string>& sites)
+  removeGapOrUnresolvedOnlySites(
+      const TemplateSiteContainerInterface<SiteType, SequenceType, std::string>& sites,
+      const ExecutionContext& context = ExecutionContext::global())
   {
     if (sites.getNumberOfSequences() == 0)
       throw Exception("SiteContainerTools::removeGapOrUnresolvedOnlySites. Container is empty.");
@@ -187,15 +176,10 @@ public:
     std::vector<std::string> sequenceKeys = sites.getSequenceKeys();
     auto alphaPtr = sites.getAlphabet();
     auto newContainer = std::make_unique<TemplateVectorSiteContainer<SiteType, SequenceType>>(sequenceKeys, alphaPtr);
-    for (size_t i = 0; i < sites.getNumberOfSites(); ++i)
-    {
-      const Site& site = sites.site(i);
-      if (!SiteTools::isGapOrUnresolvedOnly(site))
-      {
-        auto site2 = std::unique_ptr<SiteType>(site.clone());
-        newContainer->addSite(site2, false);
-      }
-    }
+    SiteSelection selection = selectSites_(sites, [](const SiteType& site) {
+      return !SiteTools::isGapOrUnresolvedOnly(site);
+    }, context);
+    getSelectedSites(sites, selection, *newContainer, context);
     return newContainer;
   }
 
@@ -203,39 +187,23 @@ public:
   /**
    * @brief Remove gap/unresolved-only sites from a SiteContainer.
    *
+   * Sites are checked in parallel, and removed by runs of consecutive positions.
+   *
    * @param sites The container where the sites have to be removed.
+   * @param context The execution context to be used.
    */
   template<class SiteType, class SequenceType, class HashType>
-  static void removeGapOrUnresolvedOnlySites(TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& sites)
+  static void removeGapOrUnresolvedOnlySites(
+      TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& sites,
+      const ExecutionContext& context = ExecutionContext::global())
   {
     if (sites.getNumberOfSequences() == 0)
       throw Exception("SiteContainerTools::removeGapOrUnresolvedOnlySites. Container is empty.");
 
-    size_t n = sites.getNumberOfSites();
-    size_t i = n;
-    while (i > 1)
-    {
-      ApplicationTools::displayGauge(n - i + 1, n);
-      const SiteType& site = sites.site(i - 1);
-      if (SiteTools::isGapOnly(site))
-      {
-        size_t end = i;
-        while (SiteTools::isGapOrUnresolvedOnly(site) && i > 1)
-        {
-          --i;
-          site = &sites.site(i - 1);
-        }
-        sites.deleteSites(i, end - i);
-      }
-      else
-      {
-        --i;
-      }
-    }
-    ApplicationTools::displayGauge(n, n);
-    const SiteType& site = sites.site(0);
-    if (SiteTools::isGapOrUnresolvedOnly(site))
-      sites.deleteSite(0);
+    SiteSelection selection = selectSites_(sites, [](const SiteType& site) {
+      return SiteTools::isGapOrUnresolvedOnly(site);
+    }, context);
+    deleteSites_(sites, selection);
   }
 
   /**
@@ -243,31 +211,27 @@ public:
    *
    * @param sites The container from which the sites have to be removed.
    * @param maxFreqGaps The maximum frequency of gaps in each site.
+   * @param context The execution context to be used.
    * @return A pointer toward a new SiteContainer.
    */
   template<class SiteType, class SequenceType>
   static std::unique_ptr< TemplateVectorSiteContainer<SiteType, SequenceType>>
   removeGapSites(
       const TemplateSiteContainerInterface<SiteType, SequenceType, std::string>& sites,
-      double maxFreqGaps)
+      double maxFreqGaps,
+      const ExecutionContext& context = ExecutionContext::global())
   {
     if (sites.getNumberOfSequences() == 0)
       throw Exception("SiteContainerTools::removeGapSites. Container is empty.");
 
     std::vector<std::string> sequenceKeys = sites.getSequenceKeys();
     auto newContainer = std::make_unique< TemplateVectorSiteContainer<SiteType, SequenceType>>(sequenceKeys, sites.getAlphabet());
-    for (size_t i = 0; i < sites.getNumberOfSites(); ++i)
-    {
+    SiteSelection selection = selectSites_(sites, [maxFreqGaps](const SiteType& site) {
       std::map<int, double> freq;
-      const Site& site = sites.site(i);
       SiteTools::getFrequencies(site, freq);
-      if (freq[-1] <= maxFreqGaps)
-      {
-        auto site2 = std::make_unique<SiteType>(site.clone());
-        newContainer->addSite(site2, false);
-      }
-    }
-    newContainer->setSequenceNames(sites.getSequenceNames(), false);
+      return freq[-1] <= maxFreqGaps;
+    }, context);
+    getSelectedSites(sites, selection, *newContainer, context);
     return newContainer;
   }
 
@@ -277,24 +241,23 @@ public:
    *
    * @param sites The container from which the sites have to be removed.
    * @param maxFreqGaps The maximum frequency of gaps in each site.
+   * @param context The execution context to be used.
    */
   template<class SiteType, class SequenceType, class HashType>
   static void removeGapSites(
       TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& sites,
-      double maxFreqGaps)
+      double maxFreqGaps,
+      const ExecutionContext& context = ExecutionContext::global())
   {
     if (sites.getNumberOfSequences() == 0)
       throw Exception("SiteContainerTools::removeGapSites. Container is empty.");
 
-    for (size_t i = sites.getNumberOfSites(); i > 0; --i)
-    {
+    SiteSelection selection = selectSites_(sites, [maxFreqGaps](const SiteType& site) {
       std::map<int, double> freq;
-      SiteTools::getFrequencies(sites.site(i - 1), freq);
-      if (freq[-1] > maxFreqGaps)
-      {
-        sites.deleteSite(i - 1);
-      }
-    }
+      SiteTools::getFrequencies(site, freq);
+      return freq[-1] > maxFreqGaps;
+    }, context);
+    deleteSites_(sites, selection);
   }
 
 
@@ -306,11 +269,13 @@ public:
    *
    * @param sites The container to analyse.
    * @param gCode the genetic code to use to determine stop codons.
+   * @param context The execution context to be used.
    * @return A pointer toward a new SiteContainer.
    */
   static std::unique_ptr<SiteContainerInterface> getSitesWithoutStopCodon(
       const SiteContainerInterface& sites,
-      const GeneticCode& gCode)
+      const GeneticCode& gCode,
+      const ExecutionContext& context = ExecutionContext::global())
   {
     std::shared_ptr<const CodonAlphabet> pca = std::dynamic_pointer_cast<const CodonAlphabet>(sites.getAlphabet());
     if (!pca)
@@ -321,16 +286,10 @@ public:
     std::vector<std::string> sequenceKeys = sites.getSequenceKeys();
     auto alphaP = sites.getAlphabet();
     auto newContainer = std::make_unique<VectorSiteContainer>(sequenceKeys, alphaP);
-    for (size_t i = 0; i < sites.getNumberOfSites(); ++i)
-    {
-      const Site& site = sites.site(i);
-      if (!CodonSiteTools::hasStop(site, gCode))
-      {
-        std::unique_ptr<Site> site2(site.clone());
-        newContainer->addSite(site2, false);
-      }
-    }
-    newContainer->setSequenceNames(sites.getSequenceNames(), false);
+    SiteSelection selection = selectSites_(sites, [&gCode](const Site& site) {
+      return !CodonSiteTools::hasStop(site, gCode);
+    }, context);
+    getSelectedSites(sites, selection, *newContainer, context);
     return newContainer;
   }
 
@@ -339,10 +298,12 @@ public:
    *
    * @param sites The container to analyse.
    * @param gCode the genetic code to use to determine stop codons.
+   * @param context The execution context to be used.
    */
   static void removeSitesWithStopCodon(
       SiteContainerInterface& sites,
-      const GeneticCode& gCode)
+      const GeneticCode& gCode,
+      const ExecutionContext& context = ExecutionContext::global())
   {
     std::shared_ptr<const CodonAlphabet> pca = std::dynamic_pointer_cast<const CodonAlphabet>(sites.getAlphabet());
     if (!pca)
@@ -350,12 +311,10 @@ public:
     if (sites.getNumberOfSequences() == 0)
       throw Exception("SiteContainerTools::removeSitesWithStopCodon. Container is empty.");
 
-    for (size_t i = sites.getNumberOfSites(); i > 0; --i)
-    {
-      const Site& site = sites.site(i - 1);
-      if (CodonSiteTools::hasStop(site, gCode))
-        sites.deleteSite(i - 1);
-    }
+    SiteSelection selection = selectSites_(sites, [&gCode](const Site& site) {
+      return CodonSiteTools::hasStop(site, gCode);
+    }, context);
+    deleteSites_(sites, selection);
   }
 
 /**
@@ -364,12 +323,35 @@ public:
  * Note: this method is currently not implemented for probabilistic objects. An exception is thrown when called.
  * @param sites The container to analyse.
  * @param gCode the genetic code to use to determine stop codons.
+ * @param context The execution context to be used.
  */
-  static void removeSitesWithStopCodon(ProbabilisticSiteContainerInterface& sites, const GeneticCode& gCode)
+  static void removeSitesWithStopCodon(
+      ProbabilisticSiteContainerInterface& sites,
+      const GeneticCode& gCode,
+      const ExecutionContext& context = ExecutionContext::global())
   {
     throw Exception("SiteContainerTools::removeSitesWithStopCodon. Method not supported for probabilistic sequences.");
   }
 
+  /**
+   * @brief Get the positions of all sites satisfying a condition.
+   *
+   * Sites are evaluated in parallel, by blocks of consecutive sites.
+   *
+   * @param sites     The container to analyse.
+   * @param predicate A function returning true for the sites to select. It may be called concurrently.
+   * @param context   The execution context to be used.
+   * @return The positions of the selected sites, in increasing order.
+   */
+  template<class SiteType, class SequenceType, class HashType, class Predicate>
+  static SiteSelection selectSites(
+      const TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& sites,
+      Predicate predicate,
+      const ExecutionContext& context = ExecutionContext::global())
+  {
+    return selectSites_(sites, predicate, context);
+  }
+
   /**
    * @brief Extract a specified set of sites.
    *
@@ -380,16 +362,18 @@ public:
    * @param sites       The container from wich sequences are to be taken.
    * @param selection   The positions of all sites to retrieve.
    * @param outputSites A container where to add the selected sites. The container must have the same alphabet, number of sequences and sequence keys from the input container.
+   * @param context     The execution context to be used.
    */
   template<class SiteType, class SequenceType, class HashType>
   static void getSelectedSites(
       const TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& sites,
       const SiteSelection& selection,
-      TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& outputSites)
+      TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& outputSites,
+      const ExecutionContext& context = ExecutionContext::global())
   {
-    for (auto pos : selection)
+    auto clones = cloneSites_(sites, selection, context);
+    for (auto& sitePtr : clones)
     {
-      auto sitePtr = std::unique_ptr<SiteType>(sites.site(pos).clone());
       outputSites.addSite(sitePtr, false);
     }
     outputSites.setSequenceNames(sites.getSequenceNames(), true);
@@ -403,18 +387,20 @@ public:
    *
    * @param sites       The container from wich sequences are to be taken.
    * @param selection   The positions of all sites to retrieve.
+   * @param context     The execution context to be used.
    * @return A VectorSiteContainer with the selected sites. Comments from the original container will be copied.
    */
   template<class SiteType, class SequenceType>
   static std::unique_ptr< TemplateVectorSiteContainer<SiteType, SequenceType>>
   getSelectedSites(
       const TemplateSiteContainerInterface<SiteType, SequenceType, std::string>& sites,
-      const SiteSelection& selection)
+      const SiteSelection& selection,
+      const ExecutionContext& context = ExecutionContext::global())
   {
     auto alphaPtr = sites.getAlphabet();
     auto outputSites = std::make_unique< TemplateVectorSiteContainer<SiteType, SequenceType>>(sites.getSequenceKeys(), alphaPtr);
     outputSites->setComments(sites.getComments());
-    getSelectedSites<SiteType, SequenceType, std::string>(sites, selection, *outputSites);
+    getSelectedSites<SiteType, SequenceType, std::string>(sites, selection, *outputSites, context);
     return outputSites;
   }
 
@@ -427,17 +413,19 @@ public:
    *
    * @param sites       The container from wich sequences are to be taken.
    * @param selection   The positions of all sites to retrieve.
+   * @param context     The execution context to be used.
    * @return A container of the same type as the input one, with the selected sites. Comments from the original container will be copied.
    */
   static std::unique_ptr<AlignmentDataInterface>
   getSelectedSites(
       const AlignmentDataInterface& sites,
-      const SiteSelection& selection)
+      const SiteSelection& selection,
+      const ExecutionContext& context = ExecutionContext::global())
   {
     try
     {
       auto& sc = dynamic_cast<const SiteContainerInterface&>(sites);
-      auto sel = getSelectedSites<Site, Sequence>(sc, selection);
+      auto sel = getSelectedSites<Site, Sequence>(sc, selection, context);
       return std::move(sel);
     }
     catch (std::bad_cast& e) {}
@@ -445,7 +433,7 @@ public:
     try
     {
       auto& psc = dynamic_cast<const ProbabilisticSiteContainerInterface&>(sites);
-      auto sel = getSelectedSites<ProbabilisticSite, ProbabilisticSequence>(psc, selection);
+      auto sel = getSelectedSites<ProbabilisticSite, ProbabilisticSequence>(psc, selection, context);
       return std::move(sel);
     }
     catch (std::bad_cast& e) {}
@@ -534,13 +522,15 @@ public:
    * @param ignoreGap Tell if gap must be counted or not. If not (true option), only fully gapped sites will result in a gap in the consensus sequence.
    * @param resolveUnknown Tell is unknnown characters must resolved. In a DNA sequence for instance, N will be counted as A=1/4, T=1/4, G=1/4 and C=1/4. Otherwise it will be counted as N=1.
    * If this option is set to true, a consensus sequence will never contain an unknown character.
+   * @param context The execution context to be used.
    * @return A new Sequence object with the consensus sequence.
    */
   static std::unique_ptr<Sequence> getConsensus(
       const SiteContainerInterface& sc,
       const std::string& name = "consensus",
       bool ignoreGap = true,
-      bool resolveUnknown = false);
+      bool resolveUnknown = false,
+      const ExecutionContext& context = ExecutionContext::global());
 
   /**
    * @brief Change all gaps to unknown state in a SiteContainer, according to its alphabet.
@@ -731,23 +721,29 @@ public:
    * @param nbSites The size of the resulting container.
    * @param index [out] If non-null the underlying vector will be appended with the original site indices.
    * @param outSites A container where the sample will be added.
+   * @param context The execution context to be used. Positions are drawn sequentially,
+   * so that the sample only depends on the state of the random generator.
    */
   template<class SiteType, class SequenceType, class HashType>
   static void sampleSites(
       const TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& sites,
       size_t nbSites,
       TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& outSites,
-      std::shared_ptr< std::vector<size_t>> index = nullptr)
+      std::shared_ptr< std::vector<size_t>> index = nullptr,
+      const ExecutionContext& context = ExecutionContext::global())
   {
+    SiteSelection selection(nbSites);
     for (size_t i = 0; i < nbSites; ++i)
     {
-      size_t pos = static_cast<size_t>(RandomTools::giveIntRandomNumberBetweenZeroAndEntry(static_cast<int>(sites.getNumberOfSites())));
-      auto s = std::unique_ptr<SiteType>(sites.site(pos).clone());
+      selection[i] = static_cast<size_t>(RandomTools::giveIntRandomNumberBetweenZeroAndEntry(static_cast<int>(sites.getNumberOfSites())));
+    }
+    auto clones = cloneSites_(sites, selection, context);
+    for (auto& s : clones)
+    {
       outSites.addSite(s, false);
-
-      if (index)
-        index->push_back(pos);
     }
+    if (index)
+      index->insert(index->end(), selection.begin(), selection.end());
   }
 
 
@@ -762,6 +758,7 @@ public:
    * @param sites An input alignment to sample.
    * @param nbSites The size of the resulting container.
    * @param index [out] If non-null the underlying vector will be appended with the original site indices.
+   * @param context The execution context to be used.
    * @return A container with the sampled sites.
    */
   template<class SiteType, class SequenceType>
@@ -769,10 +766,11 @@ public:
   sampleSites(
       const TemplateSiteContainerInterface<SiteType, SequenceType, std::string>& sites,
       size_t nbSites,
-      std::shared_ptr< std::vector<size_t>> index = nullptr)
+      std::shared_ptr< std::vector<size_t>> index = nullptr,
+      const ExecutionContext& context = ExecutionContext::global())
   {
     auto sampledSites = std::make_unique< TemplateVectorSiteContainer<SiteType, SequenceType>>(sites.getAlphabet());
-    sampleSites<SiteType, SequenceType, std::string>(sites, nbSites, *sampledSites, index);
+    sampleSites<SiteType, SequenceType, std::string>(sites, nbSites, *sampledSites, index, context);
     return sampledSites;
   }
 
@@ -787,13 +785,15 @@ public:
    *
    * @param sites An input alignment to sample.
    * @param outputSites A container that will contain the sampled alignment.
+   * @param context The execution context to be used.
    */
   template<class SiteType, class SequenceType, class HashType>
   static void bootstrapSites(
       const TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& sites,
-      TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& outputSites)
+      TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& outputSites,
+      const ExecutionContext& context = ExecutionContext::global())
   {
-    sampleSites(sites, sites.getNumberOfSites(), outputSites, nullptr);
+    sampleSites(sites, sites.getNumberOfSites(), outputSites, nullptr, context);
   }
 
 
@@ -806,14 +806,17 @@ public:
    * Note: This method will be optimal with a container with vertical storage like VectorSiteContainer.
    *
    * @param sites An input alignment to sample.
+   * @param context The execution context to be used.
    * @return A container that contains the sampled alignment.
    */
   template<class SiteType, class SequenceType>
   static std::unique_ptr< TemplateVectorSiteContainer<SiteType, SequenceType>>
-  bootstrapSites(const TemplateSiteContainerInterface<SiteType, SequenceType, std::string>& sites)
+  bootstrapSites(
+      const TemplateSiteContainerInterface<SiteType, SequenceType, std::string>& sites,
+      const ExecutionContext& context = ExecutionContext::global())
   {
     auto outputSites = std::make_unique< TemplateVectorSiteContainer<SiteType, SequenceType>>(sites.getAlphabet());
-    bootstrapSites<SiteType, SequenceType, std::string>(sites, *outputSites);
+    bootstrapSites<SiteType, SequenceType, std::string>(sites, *outputSites, context);
     return outputSites;
   }
 
@@ -866,13 +869,15 @@ public:
    * @param gapOption How to deal with gaps.
    * @param unresolvedAsGap Tell if unresolved characters must be considered as gaps when counting.
    * If set to yes, the gap option will also apply to unresolved characters.
+   * @param context The execution context to be used. Rows of the matrix are computed in parallel.
    * @return All pairwise similarity measures.
    */
   static std::unique_ptr<DistanceMatrix> computeSimilarityMatrix(
       const SiteContainerInterface& sites,
       bool dist = false,
       const std::string& gapOption = SIMILARITY_NOFULLGAP,
-      bool unresolvedAsGap = true);
+      bool unresolvedAsGap = true,
+      const ExecutionContext& context = ExecutionContext::global());
 
   static const std::string SIMILARITY_ALL;
   static const std::string SIMILARITY_NOFULLGAP;
@@ -896,6 +901,7 @@ public:
    * @param seqCont2 Second container. This container must contain sequences with the same names as in seqcont1.
    * Additional sequences will be ignored.
    * @param leavePositionAsIs Tell is site position should be unchanged. Otherwise (the default) is to add the size of container 1 to the positions in container 2.
+   * @param context The execution context to be used.
    * @throw AlphabetMismatchException If the alphabet in the 2 containers do not match.
    * @throw Exception If sequence names do not match.
    */
@@ -903,7 +909,8 @@ public:
   static void merge(
       TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& seqCont1,
       const TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& seqCont2,
-      bool leavePositionAsIs = false)
+      bool leavePositionAsIs = false,
+      const ExecutionContext& context = ExecutionContext::global())
   {
     if (seqCont1.getAlphabet()->getAlphabetType() != seqCont2.getAlphabet()->getAlphabetType())
       throw AlphabetMismatchException("SiteContainerTools::merge.", seqCont1.getAlphabet(), seqCont2.getAlphabet());
@@ -925,23 +932,18 @@ public:
       del = true;
     }
 
-    if (leavePositionAsIs)
+    SiteSelection selection(seqCont2bis->getNumberOfSites());
+    for (size_t i = 0; i < selection.size(); ++i)
     {
-      for (size_t i = 0; i < seqCont2bis->getNumberOfSites(); ++i)
-      {
-        std::unique_ptr<Site> site(seqCont2bis->site(i).clone());
-        seqCont1.addSite(site, false);
-      }
+      selection[i] = i;
     }
-    else
+    auto clones = cloneSites_(*seqCont2bis, selection, context);
+    int offset = static_cast<int>(seqCont1.getNumberOfSites());
+    for (auto& site : clones)
     {
-      int offset = static_cast<int>(seqCont1.getNumberOfSites());
-      for (size_t i = 0; i < seqCont2bis->getNumberOfSites(); ++i)
-      {
-        std::unique_ptr<Site> site(seqCont2bis->site(i).clone());
+      if (!leavePositionAsIs)
         site->setCoordinate(offset + site->getCoordinate());
-        seqCont1.addSite(site, false);
-      }
+      seqCont1.addSite(site, false);
     }
 
     if (del)
@@ -978,6 +980,113 @@ public:
    * @author Julien Dutheil
    */
   static std::vector<double> getSumOfPairsScores(const Matrix<size_t>& positions1, const Matrix<size_t>& positions2, double na = 0);
+
+  /**
+   * @brief Make sure that the sites of a container can be read concurrently.
+   *
+   * Vector site containers (compressed or not) store their sites. Other containers,
+   * like aligned sequence containers, build them on first access, which is not
+   * thread-safe: they are then all built beforehand. Nothing is done if the
+   * context is sequential.
+   *
+   * @param sites   The container to read.
+   * @param context The execution context to be used.
+   */
+  template<class SiteType, class SequenceType, class HashType>
+  static void prepareSiteAccess(
+      const TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& sites,
+      const ExecutionContext& context)
+  {
+    if (!context.isParallel()
+        || dynamic_cast<const TemplateVectorSiteContainer<SiteType, SequenceType>*>(&sites)
+        || dynamic_cast<const CompressedVectorSiteContainer*>(&sites))
+      return;
+    for (size_t i = 0; i < sites.getNumberOfSites(); ++i)
+    {
+      sites.site(i);
+    }
+  }
+
+private:
+  /**
+   * @return The positions of the sites satisfying a condition, in increasing order.
+   */
+  template<class SiteType, class SequenceType, class HashType, class Predicate>
+  static SiteSelection selectSites_(
+      const TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& sites,
+      Predicate predicate,
+      const ExecutionContext& context)
+  {
+    ScopedTimer timer("sites.select");
+    prepareSiteAccess(sites, context);
+    Profiler::global().count("sites.scanned", sites.getNumberOfSites());
+    SiteSelection selected = context.mapReduce(sites.getNumberOfSites(), SiteSelection(),
+        [&](size_t begin, size_t end)
+        {
+          SiteSelection selection;
+          for (size_t i = begin; i < end; ++i)
+          {
+            if (predicate(sites.site(i)))
+              selection.push_back(i);
+          }
+          return selection;
+        },
+        [](SiteSelection a, const SiteSelection& b)
+        {
+          a.insert(a.end(), b.begin(), b.end());
+          return a;
+        });
+    Profiler::global().count("sites.selected", selected.size());
+    return selected;
+  }
+
+  /**
+   * @return Copies of the selected sites, in the order of the selection.
+   */
+  template<class SiteType, class SequenceType, class HashType>
+  static std::vector< std::unique_ptr<SiteType>> cloneSites_(
+      const TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& sites,
+      const SiteSelection& selection,
+      const ExecutionContext& context)
+  {
+    ScopedTimer timer("sites.copy");
+    prepareSiteAccess(sites, context);
+    Profiler::global().count("sites.copied", selection.size());
+    std::vector< std::unique_ptr<SiteType>> clones(selection.size());
+    context.forEachBlock(selection.size(), [&](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        clones[i].reset(sites.site(selection[i]).clone());
+      }
+    });
+    return clones;
+  }
+
+  /**
+   * @brief Delete sites, given their positions in increasing order.
+   *
+   * Runs of consecutive positions are deleted at once, starting from the end.
+   */
+  template<class SiteType, class SequenceType, class HashType>
+  static void deleteSites_(
+      TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& sites,
+      const SiteSelection& positions)
+  {
+    ScopedTimer timer("sites.delete");
+    Profiler::global().count("sites.deleted", positions.size());
+    size_t i = positions.size();
+    while (i > 0)
+    {
+      size_t end = positions[i - 1] + 1;
+      size_t begin = positions[--i];
+      while (i > 0 && positions[i - 1] + 1 == begin)
+      {
+        begin = positions[--i];
+      }
+      sites.deleteSites(begin, end - begin);
+    }
+  }
 };
 } // end of namespace bpp.
 #endif // BPP_SEQ_CONTAINER_SITECONTAINERTOOLS_H
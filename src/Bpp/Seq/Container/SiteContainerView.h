@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_CONTAINER_SITECONTAINERVIEW_H
+#define BPP_SEQ_CONTAINER_SITECONTAINERVIEW_H
+
+#include <Bpp/Exceptions.h>
+
+#include "SiteContainer.h"
+#include "SiteContainerTools.h"
+#include "VectorSiteContainer.h"
+
+// From the STL:
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief A read-only view on a subset of the sites of a container.
+ *
+ * The view only stores the positions of the selected sites, and accesses
+ * the sites of the underlying container, which must outlive the view. This
+ * is typically used to handle the partitions of a supermatrix (for instance
+ * Nexus character sets) without copying the data.
+ *
+ * Use toContainer() to get an independent copy of the selected sites.
+ */
+template<class SiteType, class SequenceType, class HashType>
+class TemplateSiteContainerView
+{
+private:
+  const TemplateSiteContainerInterface<SiteType, SequenceType, HashType>* container_;
+  std::vector<size_t> positions_;
+
+public:
+  /**
+   * @param container The container to look at.
+   * @param positions The positions of the sites in the container, in the order of the view.
+   * @throw IndexOutOfBoundsException If a position is not a valid site of the container.
+   */
+  TemplateSiteContainerView(
+      const TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& container,
+      const std::vector<size_t>& positions) :
+    container_(&container),
+    positions_(positions)
+  {
+    size_t n = container.getNumberOfSites();
+    for (auto pos : positions_)
+    {
+      if (pos >= n)
+        throw IndexOutOfBoundsException("TemplateSiteContainerView: invalid site position.", pos, 0, n > 0 ? n - 1 : 0);
+    }
+  }
+
+  virtual ~TemplateSiteContainerView() {}
+
+public:
+  const TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& container() const { return *container_; }
+
+  std::shared_ptr<const Alphabet> getAlphabet() const { return container_->getAlphabet(); }
+
+  size_t getNumberOfSequences() const { return container_->getNumberOfSequences(); }
+
+  std::vector<std::string> getSequenceNames() const { return container_->getSequenceNames(); }
+
+  size_t getNumberOfSites() const { return positions_.size(); }
+
+  /**
+   * @return The positions of the sites of the view in the underlying container.
+   */
+  const std::vector<size_t>& getPositions() const { return positions_; }
+
+  /**
+   * @return The position in the underlying container of a site of the view.
+   */
+  size_t getSourcePosition(size_t sitePosition) const
+  {
+    if (sitePosition >= positions_.size())
+      throw IndexOutOfBoundsException("TemplateSiteContainerView::getSourcePosition.", sitePosition, 0, positions_.size() - 1);
+    return positions_[sitePosition];
+  }
+
+  const SiteType& site(size_t sitePosition) const
+  {
+    return container_->site(getSourcePosition(sitePosition));
+  }
+
+  const typename SequenceType::ElementType& valueAt(size_t sequencePosition, size_t sitePosition) const
+  {
+    return container_->valueAt(sequencePosition, getSourcePosition(sitePosition));
+  }
+
+  /**
+   * @return A new container with a copy of the sites of the view.
+   */
+  std::unique_ptr< TemplateVectorSiteContainer<SiteType, SequenceType>> toContainer() const
+  {
+    return SiteContainerTools::getSelectedSites<SiteType, SequenceType>(*container_, positions_);
+  }
+};
+
+// Aliases:
+using SiteContainerView = TemplateSiteContainerView<Site, Sequence, std::string>;
+using ProbabilisticSiteContainerView = TemplateSiteContainerView<ProbabilisticSite, ProbabilisticSequence, std::string>;
+} // end of namespace bpp.
+#endif // BPP_SEQ_CONTAINER_SITECONTAINERVIEW_H
@@ -0,0 +1,21 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "SiteMapReduce.h"
+
+using namespace bpp;
+using namespace std;
+
+const size_t SiteMapReduce::CACHE_BLOCK_SIZE = 256 * 1024;
+
+/******************************************************************************/
+
+size_t SiteMapReduce::getGrainSize(size_t siteSize)
+{
+  if (siteSize == 0)
+    return CACHE_BLOCK_SIZE;
+  return siteSize < CACHE_BLOCK_SIZE ? CACHE_BLOCK_SIZE / siteSize : 1;
+}
+
+/******************************************************************************/
@@ -0,0 +1,244 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_CONTAINER_SITEMAPREDUCE_H
+#define BPP_SEQ_CONTAINER_SITEMAPREDUCE_H
+
+#include "../ExecutionContext.h"
+#include "../ProbabilisticSite.h"
+#include "../Site.h"
+#include "CompressedVectorSiteContainer.h"
+#include "SiteContainer.h"
+#include "SiteContainerTools.h"
+
+// From the STL:
+#include <utility>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief A block of consecutive sites, as seen by SiteMapReduce functors.
+ *
+ * For compressed containers, the block contains unique sites (patterns),
+ * together with the number of sites they stand for. Otherwise, all weights
+ * are 1.
+ */
+template<class SiteType>
+class SiteBlock
+{
+private:
+  size_t begin_;
+  std::vector<const SiteType*> sites_;
+  const size_t* weights_;
+
+public:
+  /**
+   * @param begin   The position of the first site of the block.
+   * @param sites   The sites of the block.
+   * @param weights The weights of all sites of the container, or nullptr if all weights are 1.
+   */
+  SiteBlock(size_t begin, std::vector<const SiteType*>&& sites, const size_t* weights) :
+    begin_(begin),
+    sites_(std::move(sites)),
+    weights_(weights)
+  {}
+
+public:
+  /**
+   * @return The number of sites in the block.
+   */
+  size_t size() const { return sites_.size(); }
+
+  /**
+   * @return The position in the container (or in the set of unique sites) of a site of the block.
+   */
+  size_t getPosition(size_t i) const { return begin_ + i; }
+
+  const SiteType& site(size_t i) const { return *sites_[i]; }
+
+  /**
+   * @return The states of a site, one per sequence, stored contiguously.
+   */
+  const auto& column(size_t i) const { return sites_[i]->getContent(); }
+
+  /**
+   * @return The number of sites a site of the block stands for.
+   */
+  size_t weight(size_t i) const { return weights_ ? weights_[begin_ + i] : 1; }
+};
+
+/**
+ * @brief Parallel map/reduce over the sites of a container.
+ *
+ * Sites are split into blocks that fit in cache, and blocks are run on the
+ * threads of an ExecutionContext. A functor computes a result per site (or
+ * per block of sites), and results are combined in site order with a reducer,
+ * so that the result does not depend on the number of threads. The reducer
+ * should be associative, as the way sites are grouped in blocks depends on the
+ * size of the sites.
+ *
+ * Vector site containers, probabilistic or not, are read directly.
+ * For compressed containers, each unique site (pattern) is visited once, with
+ * a weight equal to the number of sites it stands for: functors computing
+ * sums should multiply by the weight. Other containers are visited site by
+ * site, after sites have been built.
+ *
+ * @code
+ * // Number of sites with at least one gap:
+ * size_t n = SiteMapReduce::mapReduceSites(sites, size_t(0),
+ *   [](const Site& site, size_t weight) { return SiteTools::hasGap(site) ? weight : 0; },
+ *   [](size_t a, size_t b) { return a + b; });
+ * @endcode
+ */
+class SiteMapReduce
+{
+public:
+  /**
+   * @brief The target size of a block of sites, in bytes.
+   */
+  static const size_t CACHE_BLOCK_SIZE;
+
+public:
+  /**
+   * @return The number of sites per block, for sites of a given size.
+   *
+   * @param siteSize The size of a site, in bytes.
+   */
+  static size_t getGrainSize(size_t siteSize);
+
+  /**
+   * @brief Compute a result per block of sites, and combine them in site order.
+   *
+   * @param sites     The container to read.
+   * @param init      The initial value of the reduction.
+   * @param map       The function computing the result of a block, given a SiteBlock.
+   * @param reduce    The function combining the current result (first argument) with the next block result.
+   * @param context   The execution context to be used.
+   * @param grainSize The number of sites per block (0 for blocks of about CACHE_BLOCK_SIZE bytes).
+   * @return The reduced result.
+   */
+  template<class T, class SiteType, class SequenceType, class HashType, class MapFunction, class ReduceFunction>
+  static T mapReduceBlocks(
+      const TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& sites,
+      T init,
+      MapFunction map,
+      ReduceFunction reduce,
+      const ExecutionContext& context = ExecutionContext::global(),
+      size_t grainSize = 0)
+  {
+    if (sites.getNumberOfSites() == 0)
+      return init;
+
+    const CompressedVectorSiteContainer* compressed = asCompressed_(sites);
+    std::vector<size_t> weights;
+    size_t n = sites.getNumberOfSites();
+    if (compressed)
+    {
+      weights = compressed->getUniqueSiteCounts();
+      n = weights.size();
+    }
+    else
+    {
+      SiteContainerTools::prepareSiteAccess(sites, context);
+    }
+    if (grainSize == 0)
+      grainSize = getGrainSize(getSiteSize_(sites.site(0)));
+    const size_t* weightsPtr = compressed ? weights.data() : nullptr;
+
+    return context.mapReduce(n, std::move(init),
+        [&](size_t begin, size_t end)
+        {
+          std::vector<const SiteType*> block;
+          block.reserve(end - begin);
+          fillBlock_(sites, compressed, begin, end, block);
+          return map(SiteBlock<SiteType>(begin, std::move(block), weightsPtr));
+        },
+        reduce, grainSize);
+  }
+
+  /**
+   * @brief Compute a result per site, and combine them in site order.
+   *
+   * @param sites     The container to read.
+   * @param init      The initial value of the reduction.
+   * @param map       The function computing the result of a site, given the site and its weight.
+   * @param reduce    The function combining the current result (first argument) with the next site result.
+   * @param context   The execution context to be used.
+   * @param grainSize The number of sites per block (0 for blocks of about CACHE_BLOCK_SIZE bytes).
+   * @return The reduced result.
+   */
+  template<class T, class SiteType, class SequenceType, class HashType, class MapFunction, class ReduceFunction>
+  static T mapReduceSites(
+      const TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& sites,
+      T init,
+      MapFunction map,
+      ReduceFunction reduce,
+      const ExecutionContext& context = ExecutionContext::global(),
+      size_t grainSize = 0)
+  {
+    return mapReduceBlocks(sites, std::move(init),
+        [&](const SiteBlock<SiteType>& block)
+        {
+          T result = map(block.site(0), block.weight(0));
+          for (size_t i = 1; i < block.size(); ++i)
+          {
+            result = reduce(std::move(result), map(block.site(i), block.weight(i)));
+          }
+          return result;
+        },
+        reduce, context, grainSize);
+  }
+
+private:
+  static const CompressedVectorSiteContainer* asCompressed_(const SiteContainerInterface& sites)
+  {
+    return dynamic_cast<const CompressedVectorSiteContainer*>(&sites);
+  }
+
+  template<class SiteType, class SequenceType, class HashType>
+  static const CompressedVectorSiteContainer* asCompressed_(const TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& sites)
+  {
+    return nullptr;
+  }
+
+  static void fillBlock_(
+      const SiteContainerInterface& sites,
+      const CompressedVectorSiteContainer* compressed,
+      size_t begin,
+      size_t end,
+      std::vector<const Site*>& block)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      block.push_back(compressed ? &compressed->uniqueSite(i) : &sites.site(i));
+    }
+  }
+
+  template<class SiteType, class SequenceType, class HashType>
+  static void fillBlock_(
+      const TemplateSiteContainerInterface<SiteType, SequenceType, HashType>& sites,
+      const CompressedVectorSiteContainer* compressed,
+      size_t begin,
+      size_t end,
+      std::vector<const SiteType*>& block)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      block.push_back(&sites.site(i));
+    }
+  }
+
+  static size_t getSiteSize_(const Site& site)
+  {
+    return site.size() * sizeof(int);
+  }
+
+  static size_t getSiteSize_(const ProbabilisticSite& site)
+  {
+    return site.size() * (site.size() > 0 ? site[0].size() : 0) * sizeof(double);
+  }
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_CONTAINER_SITEMAPREDUCE_H
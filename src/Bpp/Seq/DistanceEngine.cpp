@@ -0,0 +1,528 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "Alphabet/AlphabetExceptions.h"
+#include "Alphabet/AlphabetTools.h"
+#include "Container/CompressedVectorSiteContainer.h"
+#include "Container/SiteContainerTools.h"
+#include "DistanceEngine.h"
+#include "Io/DistanceMatrixFile.h"
+
+// From the STL:
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace bpp;
+using namespace std;
+
+const size_t DistanceEngine::DEFAULT_TILE_SIZE = 32;
+
+namespace
+{
+inline uint64_t popCount(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<uint64_t>(__builtin_popcountll(x));
+#else
+  x = x - ((x >> 1) & 0x5555555555555555ULL);
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return (x * 0x0101010101010101ULL) >> 56;
+#endif
+}
+
+/**
+ * @return The logarithm of the determinant of a square matrix (LU decomposition with
+ * partial pivoting), or NaN if the determinant is not strictly positive.
+ */
+double logDeterminant(vector<double> a, size_t k)
+{
+  double logDet = 0;
+  bool positive = true;
+  for (size_t c = 0; c < k; ++c)
+  {
+    size_t pivot = c;
+    for (size_t r = c + 1; r < k; ++r)
+    {
+      if (abs(a[r * k + c]) > abs(a[pivot * k + c]))
+        pivot = r;
+    }
+    if (a[pivot * k + c] == 0)
+      return numeric_limits<double>::quiet_NaN();
+    if (pivot != c)
+    {
+      for (size_t l = 0; l < k; ++l)
+      {
+        swap(a[pivot * k + l], a[c * k + l]);
+      }
+      positive = !positive;
+    }
+    double d = a[c * k + c];
+    if (d < 0)
+      positive = !positive;
+    logDet += log(abs(d));
+    for (size_t r = c + 1; r < k; ++r)
+    {
+      double f = a[r * k + c] / d;
+      for (size_t l = c + 1; l < k; ++l)
+      {
+        a[r * k + l] -= f * a[c * k + l];
+      }
+    }
+  }
+  return positive ? logDet : numeric_limits<double>::quiet_NaN();
+}
+}
+
+/******************************************************************************/
+
+void DistanceEngine::checkAlphabet_(const Alphabet& alphabet) const
+{
+  if ((method_ == K80 || method_ == TN93) && !AlphabetTools::isNucleicAlphabet(&alphabet))
+    throw AlphabetException("DistanceEngine. K80 and TN93 distances need nucleotide sequences.", &alphabet);
+  if (alphabet.getSize() > 64)
+    throw AlphabetException("DistanceEngine. Too many states in alphabet.", &alphabet);
+}
+
+/******************************************************************************/
+
+DistanceEngine::Encoding_ DistanceEngine::encode_(const SiteContainerInterface& sites, const ExecutionContext& context) const
+{
+  checkAlphabet_(*sites.getAlphabet());
+  const CompressedVectorSiteContainer* compressed = dynamic_cast<const CompressedVectorSiteContainer*>(&sites);
+  vector<size_t> weights;
+  size_t nbSites = sites.getNumberOfSites();
+  if (compressed)
+  {
+    weights = compressed->getUniqueSiteCounts();
+    nbSites = weights.size();
+  }
+  else
+  {
+    SiteContainerTools::prepareSiteAccess(sites, context);
+  }
+
+  Encoding_ encoding;
+  size_t n = sites.getNumberOfSequences();
+  size_t k = sites.getAlphabet()->getSize();
+  size_t nbWords = (nbSites + 63) / 64;
+  encoding.nbStates = k;
+  encoding.nbWords = nbWords;
+  encoding.planes.assign(n, vector<uint64_t>(nbWords * k, 0));
+  encoding.valid.assign(n, vector<uint64_t>(nbWords, 0));
+  size_t maxWeight = weights.empty() ? 1 : *max_element(weights.begin(), weights.end());
+  if (maxWeight > 1)
+  {
+    size_t nbBits = 0;
+    while (maxWeight >> nbBits)
+    {
+      ++nbBits;
+    }
+    encoding.weightPlanes.assign(nbBits, vector<uint64_t>(nbWords, 0));
+  }
+
+  // Each block of words is filled by a single task:
+  context.forEachBlock(nbWords, [&](size_t begin, size_t end)
+  {
+    for (size_t w = begin; w < end; ++w)
+    {
+      for (size_t bit = 0; bit < 64 && w * 64 + bit < nbSites; ++bit)
+      {
+        size_t pos = w * 64 + bit;
+        uint64_t mask = static_cast<uint64_t>(1) << bit;
+        const Site& site = compressed ? compressed->uniqueSite(pos) : sites.site(pos);
+        const vector<int>& states = site.getContent();
+        for (size_t s = 0; s < n; ++s)
+        {
+          int state = states[s];
+          if (state >= 0 && static_cast<size_t>(state) < k)
+          {
+            encoding.planes[s][w * k + static_cast<size_t>(state)] |= mask;
+            encoding.valid[s][w] |= mask;
+          }
+        }
+        for (size_t b = 0; b < encoding.weightPlanes.size(); ++b)
+        {
+          if ((weights[pos] >> b) & 1)
+            encoding.weightPlanes[b][w] |= mask;
+        }
+      }
+    }
+  }, 16);
+
+  if (gapTreatment_ == COMPLETE_DELETION && n > 0)
+  {
+    for (size_t w = 0; w < nbWords; ++w)
+    {
+      uint64_t common = encoding.valid[0][w];
+      for (size_t s = 1; s < n; ++s)
+      {
+        common &= encoding.valid[s][w];
+      }
+      for (size_t s = 0; s < n; ++s)
+      {
+        encoding.valid[s][w] = common;
+      }
+    }
+  }
+
+  // State frequencies over all sequences:
+  vector<double> counts(k, 0);
+  for (size_t s = 0; s < n; ++s)
+  {
+    for (size_t w = 0; w < nbWords; ++w)
+    {
+      for (size_t a = 0; a < k; ++a)
+      {
+        uint64_t x = encoding.planes[s][w * k + a] & encoding.valid[s][w];
+        if (encoding.weightPlanes.empty())
+        {
+          counts[a] += static_cast<double>(popCount(x));
+        }
+        else
+        {
+          for (size_t b = 0; b < encoding.weightPlanes.size(); ++b)
+          {
+            counts[a] += static_cast<double>(popCount(x & encoding.weightPlanes[b][w]) << b);
+          }
+        }
+      }
+    }
+  }
+  double total = 0;
+  for (double c : counts)
+  {
+    total += c;
+  }
+  encoding.frequencies.resize(k);
+  for (size_t a = 0; a < k; ++a)
+  {
+    encoding.frequencies[a] = total > 0 ? counts[a] / total : 0.;
+  }
+  return encoding;
+}
+
+/******************************************************************************/
+
+std::shared_ptr<const DistanceEngine::Encoding_> DistanceEngine::getCachedEncoding_(const SiteContainerInterface& sites) const
+{
+  lock_guard<mutex> lock(cacheMutex_);
+  if (!cachedEncoding_
+      || cachedSites_ != &sites
+      || cachedGapTreatment_ != gapTreatment_
+      || cachedNbSequences_ != sites.getNumberOfSequences()
+      || cachedNbSites_ != sites.getNumberOfSites())
+  {
+    cachedEncoding_.reset(); // Release the previous encoding first.
+    cachedEncoding_ = make_shared<const Encoding_>(encode_(sites, ExecutionContext::global()));
+    cachedSites_ = &sites;
+    cachedGapTreatment_ = gapTreatment_;
+    cachedNbSequences_ = sites.getNumberOfSequences();
+    cachedNbSites_ = sites.getNumberOfSites();
+  }
+  return cachedEncoding_;
+}
+
+/******************************************************************************/
+
+double DistanceEngine::countPair_(const Encoding_& encoding, size_t i, size_t j, bool full, std::vector<double>& counts) const
+{
+  size_t k = encoding.nbStates;
+  size_t nbWeightBits = encoding.weightPlanes.empty() ? 1 : encoding.weightPlanes.size();
+  vector<uint64_t> intCounts(k * k, 0);
+  uint64_t total = 0;
+  const uint64_t* planes1 = encoding.planes[i].data();
+  const uint64_t* planes2 = encoding.planes[j].data();
+  const uint64_t* valid1 = encoding.valid[i].data();
+  const uint64_t* valid2 = encoding.valid[j].data();
+  for (size_t w = 0; w < encoding.nbWords; ++w)
+  {
+    uint64_t m = valid1[w] & valid2[w];
+    if (m == 0)
+      continue;
+    const uint64_t* p1 = planes1 + w * k;
+    const uint64_t* p2 = planes2 + w * k;
+    for (size_t b = 0; b < nbWeightBits; ++b)
+    {
+      uint64_t mb = encoding.weightPlanes.empty() ? m : m & encoding.weightPlanes[b][w];
+      if (mb == 0)
+        continue;
+      total += popCount(mb) << b;
+      for (size_t a = 0; a < k; ++a)
+      {
+        uint64_t x = p1[a] & mb;
+        if (x == 0)
+          continue;
+        if (full)
+        {
+          for (size_t c = 0; c < k; ++c)
+          {
+            intCounts[a * k + c] += popCount(x & p2[c]) << b;
+          }
+        }
+        else
+        {
+          intCounts[a * k + a] += popCount(x & p2[a]) << b;
+        }
+      }
+    }
+  }
+  counts.resize(k * k);
+  for (size_t l = 0; l < k * k; ++l)
+  {
+    counts[l] = static_cast<double>(intCounts[l]);
+  }
+  return static_cast<double>(total);
+}
+
+/******************************************************************************/
+
+double DistanceEngine::distance_(const std::vector<double>& counts, double total, size_t k, const std::vector<double>& frequencies) const
+{
+  if (total <= 0)
+    return numeric_limits<double>::quiet_NaN();
+  double inf = numeric_limits<double>::infinity();
+  double same = 0;
+  for (size_t a = 0; a < k; ++a)
+  {
+    same += counts[a * k + a];
+  }
+  double p = 1. - same / total;
+
+  switch (method_)
+  {
+  case P_DISTANCE:
+    return p;
+  case JC69:
+  {
+    double b = 1. - 1. / static_cast<double>(k);
+    double x = 1. - p / b;
+    return x > 0 ? -b * log(x) : inf;
+  }
+  case K80:
+  {
+    double pt = (counts[0 * 4 + 2] + counts[2 * 4 + 0] + counts[1 * 4 + 3] + counts[3 * 4 + 1]) / total;
+    double q = p - pt;
+    double x1 = 1. - 2. * pt - q;
+    double x2 = 1. - 2. * q;
+    return x1 > 0 && x2 > 0 ? -0.5 * log(x1) - 0.25 * log(x2) : inf;
+  }
+  case TN93:
+  {
+    double piA = frequencies[0], piC = frequencies[1], piG = frequencies[2], piT = frequencies[3];
+    double piR = piA + piG;
+    double piY = piC + piT;
+    if (piA * piG <= 0 || piC * piT <= 0)
+      return numeric_limits<double>::quiet_NaN();
+    double p1 = (counts[0 * 4 + 2] + counts[2 * 4 + 0]) / total; // A <-> G
+    double p2 = (counts[1 * 4 + 3] + counts[3 * 4 + 1]) / total; // C <-> T
+    double q = p - p1 - p2;
+    double x1 = 1. - piR * p1 / (2. * piA * piG) - q / (2. * piR);
+    double x2 = 1. - piY * p2 / (2. * piC * piT) - q / (2. * piY);
+    double x3 = 1. - q / (2. * piR * piY);
+    if (x1 <= 0 || x2 <= 0 || x3 <= 0)
+      return inf;
+    return -2. * piA * piG / piR * log(x1)
+           - 2. * piC * piT / piY * log(x2)
+           - 2. * (piR * piY - piA * piG * piY / piR - piC * piT * piR / piY) * log(x3);
+  }
+  default: // LOGDET
+  {
+    // Only keep states present in both sequences, as the divergence matrix is
+    // singular otherwise. Removing a state may leave another one without sites:
+    vector<bool> kept(k, true);
+    vector<double> f1(k), f2(k);
+    double keptTotal = 0;
+    bool changed = true;
+    while (changed)
+    {
+      changed = false;
+      keptTotal = 0;
+      fill(f1.begin(), f1.end(), 0.);
+      fill(f2.begin(), f2.end(), 0.);
+      for (size_t a = 0; a < k; ++a)
+      {
+        for (size_t b = 0; b < k; ++b)
+        {
+          if (kept[a] && kept[b])
+          {
+            f1[a] += counts[a * k + b];
+            f2[b] += counts[a * k + b];
+            keptTotal += counts[a * k + b];
+          }
+        }
+      }
+      for (size_t a = 0; a < k; ++a)
+      {
+        if (kept[a] && (f1[a] <= 0 || f2[a] <= 0))
+        {
+          kept[a] = false;
+          changed = true;
+        }
+      }
+    }
+    if (keptTotal <= 0)
+      return numeric_limits<double>::quiet_NaN();
+    vector<size_t> states;
+    for (size_t a = 0; a < k; ++a)
+    {
+      if (kept[a])
+        states.push_back(a);
+    }
+    size_t kk = states.size();
+    vector<double> f(kk * kk);
+    double logDetP = 0;
+    for (size_t a = 0; a < kk; ++a)
+    {
+      logDetP += log(f1[states[a]] / keptTotal) + log(f2[states[a]] / keptTotal);
+      for (size_t b = 0; b < kk; ++b)
+      {
+        f[a * kk + b] = counts[states[a] * k + states[b]] / keptTotal;
+      }
+    }
+    double logDetF = logDeterminant(f, kk);
+    if (std::isnan(logDetF))
+      return inf;
+    return -(logDetF - logDetP / 2.) / static_cast<double>(kk);
+  }
+  }
+}
+
+/******************************************************************************/
+
+void DistanceEngine::computeTiles_(
+    const Encoding_& encoding,
+    const std::function<void(size_t, size_t, const RowMatrix<double>&)>& output,
+    const ExecutionContext& context) const
+{
+  size_t n = encoding.planes.size();
+  size_t nbTiles1 = (n + tileSize_ - 1) / tileSize_;
+  vector< pair<size_t, size_t>> tiles;
+  for (size_t ti = 0; ti < nbTiles1; ++ti)
+  {
+    for (size_t tj = 0; tj <= ti; ++tj)
+    {
+      tiles.push_back(make_pair(ti * tileSize_, tj * tileSize_));
+    }
+  }
+  bool full = method_ != P_DISTANCE && method_ != JC69;
+
+  context.forEachBlock(tiles.size(), [&](size_t begin, size_t end)
+  {
+    vector<double> counts;
+    for (size_t t = begin; t < end; ++t)
+    {
+      size_t iBegin = tiles[t].first;
+      size_t jBegin = tiles[t].second;
+      RowMatrix<double> tile(min(tileSize_, n - iBegin), min(tileSize_, n - jBegin));
+      for (size_t k = 0; k < tile.getNumberOfRows(); ++k)
+      {
+        size_t i = iBegin + k;
+        for (size_t l = 0; l < tile.getNumberOfColumns() && jBegin + l < i; ++l)
+        {
+          double total = countPair_(encoding, i, jBegin + l, full, counts);
+          tile(k, l) = distance_(counts, total, encoding.nbStates, encoding.frequencies);
+        }
+      }
+      output(iBegin, jBegin, tile);
+    }
+  }, 1);
+}
+
+/******************************************************************************/
+
+unique_ptr<DistanceMatrix> DistanceEngine::computeDistances(
+    const SiteContainerInterface& sites,
+    DistanceMatrix::Storage storage,
+    const ExecutionContext& context) const
+{
+  Encoding_ encoding = encode_(sites, context);
+  auto dist = make_unique<DistanceMatrix>(sites.getSequenceNames(), storage);
+  // Tiles cover distinct pairs, so that they can be set concurrently:
+  computeTiles_(encoding, [&](size_t iBegin, size_t jBegin, const RowMatrix<double>& tile)
+  {
+    for (size_t k = 0; k < tile.getNumberOfRows(); ++k)
+    {
+      for (size_t l = 0; l < tile.getNumberOfColumns() && jBegin + l < iBegin + k; ++l)
+      {
+        dist->set(iBegin + k, jBegin + l, tile(k, l));
+      }
+    }
+  }, context);
+  return dist;
+}
+
+/******************************************************************************/
+
+void DistanceEngine::computeDistances(
+    const SiteContainerInterface& sites,
+    DistanceMatrixFileWriter& writer,
+    const ExecutionContext& context) const
+{
+  if (writer.size() != sites.getNumberOfSequences())
+    throw DimensionException("DistanceEngine::computeDistances. The file does not have the right number of taxa.", writer.size(), sites.getNumberOfSequences());
+  Encoding_ encoding = encode_(sites, context);
+  computeTiles_(encoding, [&](size_t iBegin, size_t jBegin, const RowMatrix<double>& tile)
+  {
+    writer.writeTile(iBegin, jBegin, tile);
+  }, context);
+}
+
+/******************************************************************************/
+
+RowMatrix<double> DistanceEngine::getCountMatrix(const SiteContainerInterface& sites, size_t i, size_t j) const
+{
+  size_t n = sites.getNumberOfSequences();
+  if (i >= n)
+    throw IndexOutOfBoundsException("DistanceEngine::getCountMatrix.", i, 0, n);
+  if (j >= n)
+    throw IndexOutOfBoundsException("DistanceEngine::getCountMatrix.", j, 0, n);
+  shared_ptr<const Encoding_> encoding = getCachedEncoding_(sites);
+  vector<double> counts;
+  countPair_(*encoding, i, j, true, counts);
+  size_t k = encoding->nbStates;
+  RowMatrix<double> matrix(k, k);
+  for (size_t a = 0; a < k; ++a)
+  {
+    for (size_t b = 0; b < k; ++b)
+    {
+      matrix(a, b) = counts[a * k + b];
+    }
+  }
+  return matrix;
+}
+
+/******************************************************************************/
+
+std::vector<double> DistanceEngine::getStateFrequencies(const SiteContainerInterface& sites) const
+{
+  return getCachedEncoding_(sites)->frequencies;
+}
+
+/******************************************************************************/
+
+double DistanceEngine::computeDistance(const RowMatrix<double>& counts, const std::vector<double>& frequencies) const
+{
+  size_t k = counts.getNumberOfRows();
+  if (counts.getNumberOfColumns() != k)
+    throw DimensionException("DistanceEngine::computeDistance. The count matrix must be square.", counts.getNumberOfColumns(), k);
+  if ((method_ == K80 || method_ == TN93) && k != 4)
+    throw DimensionException("DistanceEngine::computeDistance. K80 and TN93 need 4 x 4 counts.", k, 4);
+  if (method_ == TN93 && frequencies.size() != 4)
+    throw DimensionException("DistanceEngine::computeDistance. TN93 needs 4 frequencies.", frequencies.size(), 4);
+  vector<double> values(k * k);
+  double total = 0;
+  for (size_t a = 0; a < k; ++a)
+  {
+    for (size_t b = 0; b < k; ++b)
+    {
+      values[a * k + b] = counts(a, b);
+      total += counts(a, b);
+    }
+  }
+  return distance_(values, total, k, frequencies);
+}
+
+/******************************************************************************/
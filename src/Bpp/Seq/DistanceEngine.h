@@ -0,0 +1,251 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_DISTANCEENGINE_H
+#define BPP_SEQ_DISTANCEENGINE_H
+
+#include <Bpp/Exceptions.h>
+#include <Bpp/Numeric/Matrix/Matrix.h>
+
+#include "Container/SiteContainer.h"
+#include "DistanceMatrix.h"
+#include "ExecutionContext.h"
+
+// From the STL:
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace bpp
+{
+class DistanceMatrixFileWriter;
+
+/**
+ * @brief Evolutionary distances between all pairs of sequences of an alignment.
+ *
+ * Available distances are:
+ * - P_DISTANCE: the proportion of differences,
+ * - JC69: Jukes and Cantor (1969), for nucleotides or proteins, d = -b ln(1 - p / b) with b = 1 - 1/k, k being the number of states,
+ * - K80: Kimura (1980), for nucleotides,
+ * - TN93: Tamura and Nei (1993), for nucleotides, with base frequencies estimated from the whole alignment,
+ * - LOGDET: d = -1/k [ln det F - (ln det Px + ln det Py) / 2], F being the divergence matrix of the pair and Px, Py the diagonal matrices of the state frequencies of each sequence (Lockhart et al. 1994). Only states present in both sequences are counted in k, and sites where one of the sequences has another state are ignored.
+ *
+ * Only sites with resolved states in both sequences are compared (pairwise
+ * deletion), or only sites with resolved states in all sequences (complete
+ * deletion). Distances are infinite when the correction is not defined
+ * (saturation), and NaN if no site can be compared.
+ *
+ * Sequences are encoded as one bit vector per state, 64 sites per word, and
+ * pairs are compared with bitwise operations and population counts. Pattern
+ * counts of compressed containers are used as site weights. Pairs are
+ * computed by tiles of sequences, run in parallel by an ExecutionContext.
+ *
+ * The encoding of the last alignment passed to getCountMatrix() or
+ * getStateFrequencies() is kept by the engine, so that pairs can be queried
+ * one by one. It is identified by its address and dimensions: call
+ * clearCache() if its content is modified in place.
+ */
+class DistanceEngine
+{
+public:
+  enum Method { P_DISTANCE, JC69, K80, TN93, LOGDET };
+
+  enum GapTreatment
+  {
+    PAIRWISE_DELETION, ///< Ignore sites with a gap or an ambiguity in one of the two sequences.
+    COMPLETE_DELETION  ///< Ignore sites with a gap or an ambiguity in any sequence.
+  };
+
+  /**
+   * @brief Default number of sequences per side of a tile.
+   */
+  static const size_t DEFAULT_TILE_SIZE;
+
+private:
+  Method method_;
+  GapTreatment gapTreatment_;
+  size_t tileSize_;
+
+  /**
+   * @brief Bit-parallel encoding of an alignment.
+   */
+  struct Encoding_
+  {
+    size_t nbStates;
+    size_t nbWords;
+    std::vector< std::vector<uint64_t>> planes; // For each sequence, one bit vector per state.
+    std::vector< std::vector<uint64_t>> valid;  // For each sequence, sites with a resolved state.
+    std::vector< std::vector<uint64_t>> weightPlanes; // Bit b of the weight of each site, empty if all weights are 1.
+    std::vector<double> frequencies; // Over all sequences.
+
+    Encoding_() : nbStates(0), nbWords(0), planes(), valid(), weightPlanes(), frequencies() {}
+  };
+
+  // Encoding of the last alignment passed to getCountMatrix or getStateFrequencies:
+  mutable std::shared_ptr<const Encoding_> cachedEncoding_;
+  mutable const SiteContainerInterface* cachedSites_;
+  mutable GapTreatment cachedGapTreatment_;
+  mutable size_t cachedNbSequences_;
+  mutable size_t cachedNbSites_;
+  mutable std::mutex cacheMutex_;
+
+public:
+  /**
+   * @param method       The distance to compute.
+   * @param gapTreatment How gaps and ambiguities are handled.
+   */
+  DistanceEngine(Method method = JC69, GapTreatment gapTreatment = PAIRWISE_DELETION) :
+    method_(method),
+    gapTreatment_(gapTreatment),
+    tileSize_(DEFAULT_TILE_SIZE),
+    cachedEncoding_(),
+    cachedSites_(nullptr),
+    cachedGapTreatment_(gapTreatment),
+    cachedNbSequences_(0),
+    cachedNbSites_(0),
+    cacheMutex_()
+  {}
+
+  /**
+   * @brief Copy the settings of an engine, but not its cache.
+   */
+  DistanceEngine(const DistanceEngine& engine) :
+    method_(engine.method_),
+    gapTreatment_(engine.gapTreatment_),
+    tileSize_(engine.tileSize_),
+    cachedEncoding_(),
+    cachedSites_(nullptr),
+    cachedGapTreatment_(engine.gapTreatment_),
+    cachedNbSequences_(0),
+    cachedNbSites_(0),
+    cacheMutex_()
+  {}
+
+  DistanceEngine& operator=(const DistanceEngine& engine)
+  {
+    method_ = engine.method_;
+    gapTreatment_ = engine.gapTreatment_;
+    tileSize_ = engine.tileSize_;
+    clearCache();
+    return *this;
+  }
+
+  virtual ~DistanceEngine() {}
+
+public:
+  Method getMethod() const { return method_; }
+
+  void setMethod(Method method) { method_ = method; }
+
+  GapTreatment getGapTreatment() const { return gapTreatment_; }
+
+  void setGapTreatment(GapTreatment gapTreatment) { gapTreatment_ = gapTreatment; }
+
+  size_t getTileSize() const { return tileSize_; }
+
+  /**
+   * @param tileSize The number of sequences per side of a tile of pairs (at least 1).
+   */
+  void setTileSize(size_t tileSize) { tileSize_ = tileSize > 0 ? tileSize : 1; }
+
+  /**
+   * @brief Release the encoding kept by getCountMatrix() and getStateFrequencies().
+   */
+  void clearCache() const
+  {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    cachedEncoding_.reset();
+    cachedSites_ = nullptr;
+  }
+
+  /**
+   * @brief Compute the distances between all pairs of sequences.
+   *
+   * @param sites   The alignment. With a CompressedVectorSiteContainer, unique sites are weighted by their counts.
+   * @param storage How distances are stored in the output matrix.
+   * @param context The execution context to be used.
+   * @return A matrix with one row per sequence, named after the sequences.
+   * @throw AlphabetException If the method is not available for the alphabet of the alignment.
+   */
+  std::unique_ptr<DistanceMatrix> computeDistances(
+      const SiteContainerInterface& sites,
+      DistanceMatrix::Storage storage = DistanceMatrix::FULL,
+      const ExecutionContext& context = ExecutionContext::global()) const;
+
+  /**
+   * @brief Compute the distances between all pairs of sequences, and write them to a binary file.
+   *
+   * The matrix is never held in memory, tiles are written as soon as they are computed.
+   *
+   * @param sites   The alignment.
+   * @param writer  The file to write, created with the names of the sequences.
+   * @param context The execution context to be used.
+   * @throw AlphabetException If the method is not available for the alphabet of the alignment.
+   */
+  void computeDistances(
+      const SiteContainerInterface& sites,
+      DistanceMatrixFileWriter& writer,
+      const ExecutionContext& context = ExecutionContext::global()) const;
+
+  /**
+   * @brief Get the substitution counts between two sequences.
+   *
+   * @param sites The alignment.
+   * @param i     The first sequence.
+   * @param j     The second sequence.
+   * @return A k x k matrix, with at (a, b) the (weighted) number of compared sites with state a in i and b in j.
+   */
+  RowMatrix<double> getCountMatrix(const SiteContainerInterface& sites, size_t i, size_t j) const;
+
+  /**
+   * @return The frequencies of the states over all sequences, as used by TN93.
+   *
+   * @param sites   The alignment.
+   */
+  std::vector<double> getStateFrequencies(const SiteContainerInterface& sites) const;
+
+  /**
+   * @brief Compute a distance from substitution counts.
+   *
+   * @param counts      The k x k substitution counts of a pair of sequences.
+   * @param frequencies The state frequencies, used by TN93.
+   * @return The distance.
+   */
+  double computeDistance(const RowMatrix<double>& counts, const std::vector<double>& frequencies) const;
+
+private:
+  void checkAlphabet_(const Alphabet& alphabet) const;
+
+  Encoding_ encode_(const SiteContainerInterface& sites, const ExecutionContext& context) const;
+
+  /**
+   * @return The encoding of an alignment, from the cache if it was the last one encoded.
+   */
+  std::shared_ptr<const Encoding_> getCachedEncoding_(const SiteContainerInterface& sites) const;
+
+  /**
+   * @brief Get the substitution counts of a pair, as a k x k array.
+   *
+   * @param full Tell if all k x k counts are needed, or only the diagonal.
+   * @return The number of compared sites.
+   */
+  double countPair_(const Encoding_& encoding, size_t i, size_t j, bool full, std::vector<double>& counts) const;
+
+  double distance_(const std::vector<double>& counts, double total, size_t nbStates, const std::vector<double>& frequencies) const;
+
+  /**
+   * @brief Compute all tiles of the lower triangle, and pass them to a function.
+   *
+   * The function is called concurrently, with the first row and column of the tile,
+   * and the distances. Entries of the tile above the diagonal are not set.
+   */
+  void computeTiles_(
+      const Encoding_& encoding,
+      const std::function<void(size_t, size_t, const RowMatrix<double>&)>& output,
+      const ExecutionContext& context) const;
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_DISTANCEENGINE_H
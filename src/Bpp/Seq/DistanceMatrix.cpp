@@ -4,16 +4,315 @@
 
 #include "DistanceMatrix.h"
 
+// From the STL:
+#include <algorithm>
+
 using namespace std;
 
 using namespace bpp;
 
+/******************************************************************************/
+
+DistanceMatrix::DistanceMatrix(const std::vector<std::string>& names, Storage storage) :
+  storage_(storage),
+  distances_(),
+  lower_(),
+  lowerFloat_(),
+  diagonal_(),
+  names_(),
+  diagonalData_(nullptr),
+  lowerData_(nullptr),
+  lowerFloatData_(nullptr),
+  owner_(),
+  nameIndex_(),
+  fullMatrix_(),
+  nameIndexReady_(false),
+  fullMatrixReady_(false),
+  mutex_()
+{
+  resize(names.size());
+  names_ = names;
+}
+
+/******************************************************************************/
+
+DistanceMatrix::DistanceMatrix(std::size_t n, Storage storage) :
+  storage_(storage),
+  distances_(),
+  lower_(),
+  lowerFloat_(),
+  diagonal_(),
+  names_(),
+  diagonalData_(nullptr),
+  lowerData_(nullptr),
+  lowerFloatData_(nullptr),
+  owner_(),
+  nameIndex_(),
+  fullMatrix_(),
+  nameIndexReady_(false),
+  fullMatrixReady_(false),
+  mutex_()
+{
+  resize(n);
+}
+
+/******************************************************************************/
+
+DistanceMatrix::DistanceMatrix(const DistanceMatrix& dist) :
+  storage_(dist.storage_),
+  distances_(dist.distances_),
+  lower_(dist.lower_),
+  lowerFloat_(dist.lowerFloat_),
+  diagonal_(dist.diagonal_),
+  names_(dist.names_),
+  diagonalData_(nullptr),
+  lowerData_(nullptr),
+  lowerFloatData_(nullptr),
+  owner_(),
+  nameIndex_(),
+  fullMatrix_(),
+  nameIndexReady_(false),
+  fullMatrixReady_(false),
+  mutex_()
+{
+  updateData_();
+  if (dist.isReadOnly())
+  {
+    diagonalData_ = dist.diagonalData_;
+    lowerData_ = dist.lowerData_;
+    lowerFloatData_ = dist.lowerFloatData_;
+    owner_ = dist.owner_;
+  }
+}
+
+/******************************************************************************/
+
+DistanceMatrix::DistanceMatrix(
+    const std::vector<std::string>& names,
+    const double* diagonal,
+    const double* lower,
+    std::shared_ptr<const void> owner) :
+  storage_(LOWER_TRIANGLE),
+  distances_(),
+  lower_(),
+  lowerFloat_(),
+  diagonal_(),
+  names_(names),
+  diagonalData_(diagonal),
+  lowerData_(lower),
+  lowerFloatData_(nullptr),
+  owner_(owner),
+  nameIndex_(),
+  fullMatrix_(),
+  nameIndexReady_(false),
+  fullMatrixReady_(false),
+  mutex_()
+{
+  if (!owner_)
+    throw NullPointerException("DistanceMatrix. The owner of external data must be provided.");
+}
+
+/******************************************************************************/
+
+DistanceMatrix::DistanceMatrix(
+    const std::vector<std::string>& names,
+    const double* diagonal,
+    const float* lower,
+    std::shared_ptr<const void> owner) :
+  storage_(LOWER_TRIANGLE_FLOAT),
+  distances_(),
+  lower_(),
+  lowerFloat_(),
+  diagonal_(),
+  names_(names),
+  diagonalData_(diagonal),
+  lowerData_(nullptr),
+  lowerFloatData_(lower),
+  owner_(owner),
+  nameIndex_(),
+  fullMatrix_(),
+  nameIndexReady_(false),
+  fullMatrixReady_(false),
+  mutex_()
+{
+  if (!owner_)
+    throw NullPointerException("DistanceMatrix. The owner of external data must be provided.");
+}
+
+/******************************************************************************/
+
+DistanceMatrix& DistanceMatrix::operator=(const DistanceMatrix& dist)
+{
+  if (this == &dist)
+    return *this;
+  storage_ = dist.storage_;
+  distances_ = dist.distances_;
+  lower_ = dist.lower_;
+  lowerFloat_ = dist.lowerFloat_;
+  diagonal_ = dist.diagonal_;
+  names_ = dist.names_;
+  updateData_();
+  if (dist.isReadOnly())
+  {
+    diagonalData_ = dist.diagonalData_;
+    lowerData_ = dist.lowerData_;
+    lowerFloatData_ = dist.lowerFloatData_;
+    owner_ = dist.owner_;
+  }
+  nameIndex_.clear();
+  nameIndexReady_.store(false);
+  fullMatrixReady_.store(false);
+  return *this;
+}
+
+/******************************************************************************/
+
+void DistanceMatrix::reset()
+{
+  checkWritable_("DistanceMatrix::reset.");
+  invalidateFullMatrix_();
+  size_t n = size();
+  for (size_t i = 0; i < distances_.getNumberOfRows(); ++i)
+  {
+    for (size_t j = 0; j < n; ++j)
+    {
+      distances_(i, j) = 0;
+    }
+  }
+  std::fill(lower_.begin(), lower_.end(), 0.);
+  std::fill(lowerFloat_.begin(), lowerFloat_.end(), 0.f);
+  std::fill(diagonal_.begin(), diagonal_.end(), 0.);
+}
+
+/******************************************************************************/
+
+void DistanceMatrix::resize(std::size_t n)
+{
+  checkWritable_("DistanceMatrix::resize.");
+  invalidateFullMatrix_();
+  size_t nbPairs = n > 0 ? n * (n - 1) / 2 : 0;
+  distances_.resize(storage_ == FULL ? n : 0, storage_ == FULL ? n : 0);
+  lower_.assign(storage_ == LOWER_TRIANGLE ? nbPairs : 0, 0.);
+  lowerFloat_.assign(storage_ == LOWER_TRIANGLE_FLOAT ? nbPairs : 0, 0.f);
+  diagonal_.assign(storage_ == FULL ? 0 : n, 0.);
+  updateData_();
+  names_.resize(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    names_[i] = "Taxon " + std::to_string(i);
+  }
+  nameIndexReady_.store(false);
+  reset();
+}
+
+/******************************************************************************/
+
+void DistanceMatrix::setStorage(Storage storage)
+{
+  if (storage == storage_ && !isReadOnly())
+    return;
+  DistanceMatrix converted(size(), storage);
+  for (size_t i = 0; i < size(); ++i)
+  {
+    for (size_t j = 0; j < i; ++j)
+    {
+      converted.set(i, j, get(i, j));
+    }
+    converted.set(i, i, get(i, i));
+  }
+  storage_ = storage;
+  distances_ = std::move(converted.distances_);
+  lower_ = std::move(converted.lower_);
+  lowerFloat_ = std::move(converted.lowerFloat_);
+  diagonal_ = std::move(converted.diagonal_);
+  updateData_();
+  invalidateFullMatrix_();
+}
+
+/******************************************************************************/
+
 size_t DistanceMatrix::getNameIndex(const std::string& name) const
 {
-  for (size_t i = 0; i < names_.size(); ++i)
+  if (!nameIndexReady_.load(memory_order_acquire))
+  {
+    lock_guard<mutex> lock(mutex_);
+    if (!nameIndexReady_.load(memory_order_relaxed))
+    {
+      nameIndex_.clear();
+      nameIndex_.reserve(names_.size());
+      for (size_t i = 0; i < names_.size(); ++i)
+      {
+        nameIndex_.emplace(names_[i], i); // Keeps the first occurrence.
+      }
+      nameIndexReady_.store(true, memory_order_release);
+    }
+  }
+  auto it = nameIndex_.find(name);
+  if (it == nameIndex_.end())
+    throw Exception("DistanceMatrix::getNameIndex. Name not found: '" + name + "'.");
+  return it->second;
+}
+
+/******************************************************************************/
+
+void DistanceMatrix::getRow(std::size_t i, std::vector<double>& row) const
+{
+  size_t n = size();
+  if (i >= n)
+    throw IndexOutOfBoundsException("DistanceMatrix::getRow. Invalid indice.", i, 0, n);
+  row.resize(n);
+  if (storage_ == FULL)
+  {
+    for (size_t j = 0; j < n; ++j)
+    {
+      row[j] = distances_(i, j);
+    }
+    return;
+  }
+  // Distances to j < i are contiguous, the other ones are one per row below:
+  size_t offset = i > 0 ? i * (i - 1) / 2 : 0;
+  for (size_t j = 0; j < i; ++j)
+  {
+    row[j] = storage_ == LOWER_TRIANGLE ? lowerData_[offset + j] : static_cast<double>(lowerFloatData_[offset + j]);
+  }
+  row[i] = diagonalData_[i];
+  for (size_t j = i + 1; j < n; ++j)
+  {
+    size_t k = j * (j - 1) / 2 + i;
+    row[j] = storage_ == LOWER_TRIANGLE ? lowerData_[k] : static_cast<double>(lowerFloatData_[k]);
+  }
+}
+
+/******************************************************************************/
+
+const Matrix<double>& DistanceMatrix::asMatrix() const
+{
+  if (storage_ == FULL)
+    return distances_;
+  if (!fullMatrixReady_.load(memory_order_acquire))
   {
-    if (names_[i] == name)
-      return i;
+    lock_guard<mutex> lock(mutex_);
+    if (!fullMatrixReady_.load(memory_order_relaxed))
+    {
+      // The matrix is updated in place, so that previous references remain valid:
+      size_t n = size();
+      if (!fullMatrix_)
+        fullMatrix_ = make_unique< RowMatrix<double>>(n, n);
+      else if (fullMatrix_->getNumberOfRows() != n)
+        fullMatrix_->resize(n, n);
+      vector<double> row;
+      for (size_t i = 0; i < n; ++i)
+      {
+        getRow(i, row);
+        for (size_t j = 0; j < n; ++j)
+        {
+          (*fullMatrix_)(i, j) = row[j];
+        }
+      }
+      fullMatrixReady_.store(true, memory_order_release);
+    }
   }
-  throw Exception("DistanceMatrix::getNameIndex. Name not found: '" + name + "'.");
+  return *fullMatrix_;
 }
+
+/******************************************************************************/
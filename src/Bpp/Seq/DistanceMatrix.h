@@ -8,63 +8,152 @@
 #include <Bpp/Exceptions.h>
 #include <Bpp/Numeric/Matrix/Matrix.h>
 #include <Bpp/Numeric/VectorExceptions.h> // DimensionException
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 
 namespace bpp
 {
-/// A Matrix class to store phylogenetic distances.
+/**
+ * @brief A Matrix class to store phylogenetic distances.
+ *
+ * By default (FULL storage), all n x n distances are stored. As distance matrices
+ * are symmetric, they can also store the strict lower triangle only
+ * (LOWER_TRIANGLE storage), possibly in single precision (LOWER_TRIANGLE_FLOAT
+ * storage), plus the diagonal. In these modes, writing (i, j) also sets (j, i).
+ *
+ * Names are indexed with a hash table, so that access by name is in constant time.
+ *
+ * Triangular matrices can also be read-only views on external data, for instance
+ * a file mapped in memory (see DistanceMatrixFile). Such matrices can not be
+ * modified, unless they are first loaded in memory with setStorage().
+ */
 class DistanceMatrix final : public virtual Clonable
 {
+public:
+  /**
+   * @brief How distances are stored.
+   */
+  enum Storage
+  {
+    FULL,                ///< n x n doubles.
+    LOWER_TRIANGLE,      ///< n (n - 1) / 2 doubles, plus the diagonal.
+    LOWER_TRIANGLE_FLOAT ///< n (n - 1) / 2 floats, plus the diagonal.
+  };
+
+  /**
+   * @brief A distance of a non-const matrix, as returned by operator().
+   *
+   * It converts to double for reading, which works whatever the storage, and
+   * writes through the matrix when assigned. In FULL storage, only (i, j) is
+   * written; with triangular storages, (i, j) and (j, i) are the same distance.
+   */
+  class Element
+  {
+private:
+    DistanceMatrix& matrix_;
+    std::size_t i_;
+    std::size_t j_;
+
+public:
+    Element(DistanceMatrix& matrix, std::size_t i, std::size_t j) :
+      matrix_(matrix), i_(i), j_(j) {}
+
+    Element(const Element& element) = default;
+
+public:
+    operator double() const { return matrix_.get(i_, j_); }
+
+    Element& operator=(double distance)
+    {
+      matrix_.setElement_(i_, j_, distance);
+      return *this;
+    }
+
+    Element& operator=(const Element& element) { return operator=(static_cast<double>(element)); }
+
+    Element& operator+=(double distance) { return operator=(static_cast<double>(*this) + distance); }
+
+    Element& operator-=(double distance) { return operator=(static_cast<double>(*this) - distance); }
+
+    Element& operator*=(double distance) { return operator=(static_cast<double>(*this) * distance); }
+
+    Element& operator/=(double distance) { return operator=(static_cast<double>(*this) / distance); }
+  };
+
 private:
-  RowMatrix<double> distances_;
+  Storage storage_;
+  RowMatrix<double> distances_;   // FULL storage.
+  std::vector<double> lower_;     // LOWER_TRIANGLE storage.
+  std::vector<float> lowerFloat_; // LOWER_TRIANGLE_FLOAT storage.
+  std::vector<double> diagonal_;  // Triangular storages.
   std::vector<std::string> names_;
 
+  // Triangular data, pointing either to the vectors above or to external data:
+  const double* diagonalData_;
+  const double* lowerData_;
+  const float* lowerFloatData_;
+  std::shared_ptr<const void> owner_; // Keeps external data alive, if any.
+
+  // Built on demand:
+  mutable std::unordered_map<std::string, std::size_t> nameIndex_;
+  mutable std::unique_ptr< RowMatrix<double>> fullMatrix_;
+  mutable std::atomic<bool> nameIndexReady_;
+  mutable std::atomic<bool> fullMatrixReady_;
+  mutable std::mutex mutex_;
+
 public:
   /**
    * @brief Build a new distance matrix with specified names.
    * The dimension of the matrix will be equal to the number of names
    * @param names The names to use.
+   * @param storage How distances are stored.
    */
-  DistanceMatrix(const std::vector<std::string>& names)
-    : distances_(names.size(), names.size())
-    , names_(names)
-  {
-    reset();
-  }
+  DistanceMatrix(const std::vector<std::string>& names, Storage storage = FULL);
 
   /**
    * @brief Build a new distance matrix with specified size.
    * Row names will be named 'Taxon 0', 'Taxon 1', and so on.
    * @param n The size of the matrix.
+   * @param storage How distances are stored.
    */
-  DistanceMatrix(std::size_t n)
-    : distances_(n, n)
-    , names_(n)
-  {
-    resize(n);
-  }
+  DistanceMatrix(std::size_t n, Storage storage = FULL);
 
-  DistanceMatrix(const DistanceMatrix& dist)
-    : distances_(dist.distances_)
-    , names_(dist.names_)
-  {}
+  /**
+   * @brief Build a read-only matrix on external data, in LOWER_TRIANGLE storage.
+   *
+   * @param names    The names to use.
+   * @param diagonal The n diagonal values.
+   * @param lower    The n (n - 1) / 2 values of the strict lower triangle, row by row.
+   * @param owner    An object keeping the data alive as long as the matrix (or its copies) are used.
+   */
+  DistanceMatrix(
+      const std::vector<std::string>& names,
+      const double* diagonal,
+      const double* lower,
+      std::shared_ptr<const void> owner);
 
-  DistanceMatrix& operator=(const DistanceMatrix& dist)
-  {
-    std::size_t n = dist.size();
-    resize(n);
-    for (std::size_t i = 0; i < n; ++i)
-    {
-      for (std::size_t j = 0; j < n; ++j)
-      {
-        distances_(i, j) = dist(i, j);
-      }
-    }
-    names_ = dist.names_;
-    return *this;
-  }
+  /**
+   * @brief Build a read-only matrix on external data, in LOWER_TRIANGLE_FLOAT storage.
+   *
+   * @param names    The names to use.
+   * @param diagonal The n diagonal values.
+   * @param lower    The n (n - 1) / 2 values of the strict lower triangle, row by row.
+   * @param owner    An object keeping the data alive as long as the matrix (or its copies) are used.
+   */
+  DistanceMatrix(
+      const std::vector<std::string>& names,
+      const double* diagonal,
+      const float* lower,
+      std::shared_ptr<const void> owner);
+
+  DistanceMatrix(const DistanceMatrix& dist);
+
+  DistanceMatrix& operator=(const DistanceMatrix& dist);
 
   DistanceMatrix* clone() const { return new DistanceMatrix(*this); }
 
@@ -72,23 +161,33 @@ public:
   /**
    * @brief Reset the distance matrix: all distances are set to 0.
    */
-  void reset()
-  {
-    std::size_t n = size();
-    for (std::size_t i = 0; i < n; ++i)
-    {
-      for (std::size_t j = 0; j < n; ++j)
-      {
-        distances_(i, j) = 0;
-      }
-    }
-  }
+  void reset();
 
   /**
    * @return The dimension of the matrix.
    */
   std::size_t size() const { return names_.size(); }
 
+  /**
+   * @return How distances are stored.
+   */
+  Storage getStorage() const { return storage_; }
+
+  /**
+   * @return True if the matrix is a view on external data, and can not be modified.
+   */
+  bool isReadOnly() const { return owner_ != nullptr; }
+
+  /**
+   * @brief Change the way distances are stored.
+   *
+   * When converting from FULL storage, the lower triangle (i > j) is kept.
+   * Read-only matrices are copied in memory, even if the storage does not change.
+   *
+   * @param storage The new storage.
+   */
+  void setStorage(Storage storage);
+
   /**
    * @return The names associated to the matrix.
    */
@@ -118,6 +217,7 @@ public:
     if (i >= size())
       throw IndexOutOfBoundsException("DistanceMatrix::setName. Invalid indice.", i, 0, size());
     names_[i] = name;
+    nameIndexReady_.store(false);
   }
 
   /**
@@ -131,11 +231,14 @@ public:
     if (names.size() != names_.size())
       throw DimensionException("DistanceMatrix::setNames. Invalid number of names.", names.size(), names_.size());
     names_ = names;
+    nameIndexReady_.store(false);
   }
 
   /**
    * @brief Get the index of a given name.
    *
+   * If several rows share the same name, the first one is returned.
+   *
    * @param name The name to look for.
    * @return The position of the name.
    * @throw Exception If no names are attached to this matrix, or if the name was not found.
@@ -147,16 +250,68 @@ public:
    *
    * @param n the new dimension of the matrix.
    */
-  void resize(std::size_t n)
+  void resize(std::size_t n);
+
+  /**
+   * @return The distance between i and j, whatever the storage.
+   */
+  double get(std::size_t i, std::size_t j) const
+  {
+    switch (storage_)
+    {
+    case FULL:
+      return distances_(i, j);
+    case LOWER_TRIANGLE:
+      return i == j ? diagonalData_[i] : lowerData_[triangleIndex_(i, j)];
+    default:
+      return i == j ? diagonalData_[i] : static_cast<double>(lowerFloatData_[triangleIndex_(i, j)]);
+    }
+  }
+
+  /**
+   * @brief Set the distance between i and j, and between j and i, whatever the storage.
+   *
+   * @throw Exception If the matrix is read-only.
+   */
+  void set(std::size_t i, std::size_t j, double distance)
   {
-    // RowMatrix<double>::resize(n, n);
-    distances_.resize(n, n);
-    names_.resize(n);
-    for (std::size_t i = 0; i < n; ++i)
+    checkWritable_("DistanceMatrix::set.");
+    invalidateFullMatrix_();
+    switch (storage_)
     {
-      names_[i] = "Taxon " + std::to_string(i);
+    case FULL:
+      distances_(i, j) = distances_(j, i) = distance;
+      break;
+    case LOWER_TRIANGLE:
+      if (i == j)
+        diagonal_[i] = distance;
+      else
+        lower_[triangleIndex_(i, j)] = distance;
+      break;
+    default:
+      if (i == j)
+        diagonal_[i] = distance;
+      else
+        lowerFloat_[triangleIndex_(i, j)] = static_cast<float>(distance);
     }
-    reset();
+  }
+
+  /**
+   * @brief Get all distances to i.
+   *
+   * @param i   The row index.
+   * @param row [out] The distances between i and 0, 1, ..., n - 1.
+   */
+  void getRow(std::size_t i, std::vector<double>& row) const;
+
+  /**
+   * @return All distances to i.
+   */
+  std::vector<double> getRow(std::size_t i) const
+  {
+    std::vector<double> row;
+    getRow(i, row);
+    return row;
   }
 
   /**
@@ -164,15 +319,12 @@ public:
    *
    * @param iName Name 1 (row)
    * @param jName Name 2 (column)
-   * @return A reference toward the specified distance.
+   * @return The specified distance.
    * @throw Exception if the matrix has no name of if one of the name do not match existing names.
    */
-  virtual const double& operator()(const std::string& iName, const std::string& jName) const
+  double operator()(const std::string& iName, const std::string& jName) const
   {
-    std::size_t i = getNameIndex(iName);
-    std::size_t j = getNameIndex(jName);
-    // return operator()(i,j);
-    return distances_(i, j);
+    return get(getNameIndex(iName), getNameIndex(jName));
   }
 
   /**
@@ -180,31 +332,93 @@ public:
    *
    * @param iName Name 1 (row)
    * @param jName Name 2 (column)
-   * @return A reference toward the specified distance.
+   * @return The specified distance, which can be read or assigned (see Element).
    * @throw Exception if the matrix has no name of if one of the name do not match existing names.
    */
-  virtual double& operator()(const std::string& iName, const std::string& jName)
+  Element operator()(const std::string& iName, const std::string& jName)
   {
-    std::size_t i = getNameIndex(iName);
-    std::size_t j = getNameIndex(jName);
-    // return operator()(i,j);
-    return distances_(i, j);
+    return Element(*this, getNameIndex(iName), getNameIndex(jName));
   }
 
-  virtual const double& operator()(std::size_t i, std::size_t j) const
+  double operator()(std::size_t i, std::size_t j) const
   {
-    // return RowMatrix<double>::operator()(i, j);
-    return distances_(i, j);
+    return get(i, j);
   }
-  virtual double& operator()(std::size_t i, std::size_t j)
+
+  /**
+   * @return The specified distance, which can be read whatever the storage, or
+   * assigned if the matrix is not read-only (see Element).
+   */
+  Element operator()(std::size_t i, std::size_t j)
   {
-    // return RowMatrix<double>::operator()(i, j);
-    return distances_(i, j);
+    return Element(*this, i, j);
   }
 
-  virtual const Matrix<double>& asMatrix() const { return distances_; }
+  /**
+   * @return The full matrix. With triangular storages, it is built on first call,
+   * and updated on the next call after the matrix is modified.
+   */
+  const Matrix<double>& asMatrix() const;
 
-  virtual Matrix<double>& asMatrix() { return distances_; }
+  /**
+   * @return The full matrix, for modification.
+   * @throw Exception If distances are not stored in memory in FULL storage: use
+   * the const version to read them, or setStorage() to convert the matrix first.
+   */
+  Matrix<double>& asMatrix()
+  {
+    if (storage_ != FULL || isReadOnly())
+      throw Exception("DistanceMatrix::asMatrix. The matrix can only be modified as a whole in FULL storage, use setStorage() first.");
+    return distances_;
+  }
+
+private:
+  static std::size_t triangleIndex_(std::size_t i, std::size_t j)
+  {
+    if (i < j)
+      std::swap(i, j);
+    return i * (i - 1) / 2 + j;
+  }
+
+  /**
+   * @brief Write one distance, as done by Element: only (i, j) in FULL storage.
+   */
+  void setElement_(std::size_t i, std::size_t j, double distance)
+  {
+    if (storage_ == FULL)
+    {
+      checkWritable_("DistanceMatrix::operator().");
+      distances_(i, j) = distance;
+    }
+    else
+      set(i, j, distance);
+  }
+
+  void checkWritable_(const std::string& method) const
+  {
+    if (isReadOnly())
+      throw Exception(method + " Read-only matrix, use setStorage() to load it in memory first.");
+  }
+
+  /**
+   * @brief Point triangular data to the in-memory vectors.
+   */
+  void updateData_()
+  {
+    diagonalData_ = diagonal_.data();
+    lowerData_ = lower_.data();
+    lowerFloatData_ = lowerFloat_.data();
+    owner_.reset();
+  }
+
+  /**
+   * @brief Mark the full matrix as outdated. It is kept, so that references
+   * returned by asMatrix() remain valid, and is refreshed on the next call.
+   */
+  void invalidateFullMatrix_()
+  {
+    fullMatrixReady_.store(false);
+  }
 };
 } // end of namespace bpp.
 #endif // BPP_SEQ_DISTANCEMATRIX_H
@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "ExecutionContext.h"
+
+// From the STL:
+#include <algorithm>
+
+using namespace bpp;
+using namespace std;
+
+const size_t ExecutionContext::DEFAULT_GRAIN_SIZE = 256;
+
+/******************************************************************************/
+
+ExecutionContext::ExecutionContext(unsigned int numberOfThreads, size_t grainSize) :
+  numberOfThreads_(1),
+  grainSize_(grainSize > 0 ? grainSize : 1),
+  pool_()
+{
+  setNumberOfThreads(numberOfThreads);
+}
+
+/******************************************************************************/
+
+void ExecutionContext::setNumberOfThreads(unsigned int numberOfThreads)
+{
+  numberOfThreads_ = numberOfThreads;
+  if (ThreadPool::resolveNumberOfThreads(numberOfThreads) > 1)
+    pool_ = make_shared<ThreadPool>(numberOfThreads);
+  else
+    pool_.reset();
+}
+
+/******************************************************************************/
+
+void ExecutionContext::forEachBlock(size_t n, const std::function<void(size_t, size_t)>& f, size_t grainSize) const
+{
+  size_t g = grainSize > 0 ? grainSize : grainSize_;
+  size_t nbBlocks = getNumberOfBlocks(n, g);
+  auto block = [&](size_t b)
+  {
+    size_t begin = b * g;
+    f(begin, std::min(n, begin + g));
+  };
+  if (pool_)
+  {
+    pool_->run(nbBlocks, block);
+  }
+  else
+  {
+    for (size_t b = 0; b < nbBlocks; ++b)
+    {
+      block(b);
+    }
+  }
+}
+
+/******************************************************************************/
+
+ExecutionContext& ExecutionContext::global()
+{
+  static ExecutionContext context;
+  return context;
+}
+
+/******************************************************************************/
@@ -0,0 +1,147 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_EXECUTIONCONTEXT_H
+#define BPP_SEQ_EXECUTIONCONTEXT_H
+
+#include "ThreadPool.h"
+
+// From the STL:
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief How whole-container algorithms are run: number of threads and partitioning.
+ *
+ * Work over n items (sites, sequences or pairs of sequences) is split into
+ * blocks of a fixed number of items, the grain size, and blocks are run on a
+ * ThreadPool. Blocks only depend on the grain size, and partial results are
+ * always combined in block order, so that results do not depend on the number
+ * of threads.
+ *
+ * Tools like SiteContainerTools and SequenceContainerTools take an optional
+ * context, and use the library-wide one, global(), by default. Readers and
+ * writers which parse or format in parallel (Pasta, Phylip, Clustal) hold an
+ * optional context, and also use the global one by default. The global
+ * context is sequential unless configured otherwise, for instance with the
+ * 'number_of_threads' option of BppSequenceApplication:
+ * @code
+ * ExecutionContext::global().setNumberOfThreads(0); // One thread per core.
+ * auto consensus = SiteContainerTools::getConsensus(sites);
+ * @endcode
+ *
+ * Contexts can be copied, copies share the same pool of threads. The number
+ * of threads should not be changed while the context is in use.
+ */
+class ExecutionContext
+{
+public:
+  /**
+   * @brief Default number of items per block.
+   */
+  static const size_t DEFAULT_GRAIN_SIZE;
+
+private:
+  unsigned int numberOfThreads_;
+  size_t grainSize_;
+  std::shared_ptr<ThreadPool> pool_;
+
+public:
+  /**
+   * @param numberOfThreads The number of threads (1 for sequential execution, 0 for one thread per core).
+   * @param grainSize       The default number of items per block.
+   */
+  ExecutionContext(unsigned int numberOfThreads = 1, size_t grainSize = DEFAULT_GRAIN_SIZE);
+
+  virtual ~ExecutionContext() {}
+
+public:
+  /**
+   * @return The number of threads, as set (0 means one thread per core).
+   */
+  unsigned int getNumberOfThreads() const { return numberOfThreads_; }
+
+  /**
+   * @return The actual number of threads used.
+   */
+  unsigned int getNumberOfWorkers() const { return pool_ ? pool_->getNumberOfThreads() : 1; }
+
+  /**
+   * @param numberOfThreads The number of threads (1 for sequential execution, 0 for one thread per core).
+   */
+  void setNumberOfThreads(unsigned int numberOfThreads);
+
+  size_t getGrainSize() const { return grainSize_; }
+
+  /**
+   * @param grainSize The default number of items per block (at least 1).
+   */
+  void setGrainSize(size_t grainSize) { grainSize_ = grainSize > 0 ? grainSize : 1; }
+
+  /**
+   * @return True if more than one thread is used.
+   */
+  bool isParallel() const { return pool_ != nullptr; }
+
+  /**
+   * @return The number of blocks for a given number of items.
+   *
+   * @param n         The number of items.
+   * @param grainSize The number of items per block (0 for the default grain size of the context).
+   */
+  size_t getNumberOfBlocks(size_t n, size_t grainSize = 0) const
+  {
+    size_t g = grainSize > 0 ? grainSize : grainSize_;
+    return (n + g - 1) / g;
+  }
+
+  /**
+   * @brief Call a function on each block of items.
+   *
+   * Blocks are run concurrently, in no particular order.
+   *
+   * @param n         The number of items.
+   * @param f         The function to call, with the first item of the block and the end of the block (excluded).
+   * @param grainSize The number of items per block (0 for the default grain size of the context).
+   */
+  void forEachBlock(size_t n, const std::function<void(size_t, size_t)>& f, size_t grainSize = 0) const;
+
+  /**
+   * @brief Compute a result per block, and combine them in block order.
+   *
+   * @param n         The number of items.
+   * @param init      The initial value of the reduction.
+   * @param map       The function computing the partial result of a block, given the first item and the end of the block (excluded).
+   * @param reduce    The function combining the current result (first argument) with the next partial result.
+   * @param grainSize The number of items per block (0 for the default grain size of the context).
+   * @return The reduced result.
+   */
+  template<class T, class MapFunction, class ReduceFunction>
+  T mapReduce(size_t n, T init, MapFunction map, ReduceFunction reduce, size_t grainSize = 0) const
+  {
+    size_t g = grainSize > 0 ? grainSize : grainSize_;
+    std::vector< std::unique_ptr<T>> partials(getNumberOfBlocks(n, g));
+    forEachBlock(n, [&](size_t begin, size_t end)
+    {
+      partials[begin / g].reset(new T(map(begin, end)));
+    }, g);
+    T result = std::move(init);
+    for (auto& partial : partials)
+    {
+      result = reduce(std::move(result), std::move(*partial));
+    }
+    return result;
+  }
+
+  /**
+   * @return The library-wide context, used by default by the container tools.
+   */
+  static ExecutionContext& global();
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_EXECUTIONCONTEXT_H
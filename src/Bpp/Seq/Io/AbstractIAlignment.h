@@ -9,6 +9,7 @@
 #include "../Alphabet/Alphabet.h"
 #include "../Container/AlignedSequenceContainer.h"
 #include "../Container/VectorSiteContainer.h"
+#include "../Profiler.h"
 #include "AbstractISequence.h"
 
 // From the STL:
@@ -92,10 +93,14 @@ protected:
    */
   virtual void appendAlignmentFromFile(const std::string& path, SequenceContainerInterface& sc) const
   {
+    ScopedTimer timer("io.parse_alignment_file");
     std::ifstream input(path.c_str(), std::ios::in);
     if (!input)
       throw IOException("AbstractIAlignment::appendAlignmentFromFile: can't read file " + path);
+    Profiler::global().countBytes("io.bytes_parsed", input);
+    size_t nbSequences = sc.getNumberOfSequences();
     appendAlignmentFromStream(input, sc);
+    Profiler::global().count("io.sequences_read", sc.getNumberOfSequences() - nbSequences);
     input.close();
   }
 
@@ -249,10 +254,14 @@ protected:
    */
   virtual void appendAlignmentFromFile(const std::string& path, ProbabilisticSequenceContainerInterface& sc) const
   {
+    ScopedTimer timer("io.parse_alignment_file");
     std::ifstream input(path.c_str(), std::ios::in);
     if (!input)
       throw IOException("AbstractIProbabilisticAlignment::appendAlignmentFromFile: can't read file " + path);
+    Profiler::global().countBytes("io.bytes_parsed", input);
+    size_t nbSequences = sc.getNumberOfSequences();
     appendAlignmentFromStream(input, sc);
+    Profiler::global().count("io.sequences_read", sc.getNumberOfSequences() - nbSequences);
     input.close();
   }
 
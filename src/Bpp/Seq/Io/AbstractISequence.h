@@ -8,6 +8,7 @@
 
 #include "../Alphabet/Alphabet.h"
 #include "../Container/VectorSequenceContainer.h"
+#include "../Profiler.h"
 #include "ISequence.h"
 
 // From the STL:
@@ -91,10 +92,14 @@ protected:
    */
   virtual void appendSequencesFromFile(const std::string& path, SequenceContainerInterface& sc) const
   {
+    ScopedTimer timer("io.parse_sequence_file");
     std::ifstream input(path.c_str(), std::ios::in);
     if (!input)
       throw IOException("AbstractIAlignment::appendSequencesFromFile: can't read file " + path);
+    Profiler::global().countBytes("io.bytes_parsed", input);
+    size_t nbSequences = sc.getNumberOfSequences();
     appendSequencesFromStream(input, sc);
+    Profiler::global().count("io.sequences_read", sc.getNumberOfSequences() - nbSequences);
     input.close();
   }
 
@@ -203,10 +208,14 @@ protected:
    */
   virtual void appendSequencesFromFile(const std::string& path, ProbabilisticSequenceContainerInterface& sc) const
   {
+    ScopedTimer timer("io.parse_sequence_file");
     std::ifstream input(path.c_str(), std::ios::in);
     if (!input)
       throw IOException("AbstractIProbabilisticSequences::appendSequencesFromFile: can't read file " + path);
+    Profiler::global().countBytes("io.bytes_parsed", input);
+    size_t nbSequences = sc.getNumberOfSequences();
     appendSequencesFromStream(input, sc);
+    Profiler::global().count("io.sequences_read", sc.getNumberOfSequences() - nbSequences);
     input.close();
   }
 
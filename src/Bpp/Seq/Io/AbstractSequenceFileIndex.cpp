@@ -0,0 +1,220 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Text/TextTools.h>
+
+#include "AbstractSequenceFileIndex.h"
+
+// From the STL:
+#include <cstring>
+#include <fstream>
+
+using namespace bpp;
+using namespace std;
+
+// File layout, in 64 bits words:
+// header: magic number, number of entries, number of slots, size of the ID pool (bytes)
+// slots: (hash, entry index + 1) pairs, 0 meaning an empty slot
+// entries: (offset, record length, sequence length, ID position in pool, ID length)
+// pool: the IDs, concatenated.
+static const uint64_t INDEX_MAGIC = 0x3158444951455342ULL; // "BSEQIDX1"
+static const size_t INDEX_HEADER_SIZE = 4;
+static const size_t INDEX_ENTRY_SIZE = 5;
+
+/******************************************************************************/
+
+void AbstractSequenceFileIndex::build(const std::string& path)
+{
+  ifstream input(path.c_str(), ios::in | ios::binary);
+  if (!input)
+    throw IOException("AbstractSequenceFileIndex::build. Can't open file " + path + ".");
+  clear_();
+  scan_(input);
+}
+
+/******************************************************************************/
+
+void AbstractSequenceFileIndex::clear_()
+{
+  ids_.clear();
+  entries_.clear();
+  index_.clear();
+  mapped_.close();
+  nbMappedEntries_ = 0;
+  nbSlots_ = 0;
+  slots_ = nullptr;
+  mappedEntries_ = nullptr;
+  pool_ = nullptr;
+}
+
+/******************************************************************************/
+
+void AbstractSequenceFileIndex::addEntry_(const std::string& id, uint64_t offset, uint64_t recordLength, uint64_t sequenceLength)
+{
+  if (index_.find(id) != index_.end())
+    throw Exception("AbstractSequenceFileIndex::addEntry_. Sequence ID found twice: " + id);
+  index_[id] = ids_.size();
+  ids_.push_back(id);
+  Entry entry = { offset, recordLength, sequenceLength };
+  entries_.push_back(entry);
+}
+
+/******************************************************************************/
+
+size_t AbstractSequenceFileIndex::getNumberOfSequences() const
+{
+  return mapped_.isOpen() ? static_cast<size_t>(nbMappedEntries_) : ids_.size();
+}
+
+/******************************************************************************/
+
+uint64_t AbstractSequenceFileIndex::hash_(const char* s, size_t n)
+{
+  // FNV-1a:
+  uint64_t h = 14695981039346656037ULL;
+  for (size_t i = 0; i < n; ++i)
+  {
+    h ^= static_cast<unsigned char>(s[i]);
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+/******************************************************************************/
+
+uint64_t AbstractSequenceFileIndex::findMapped_(const std::string& id) const
+{
+  uint64_t h = hash_(id.data(), id.size());
+  uint64_t mask = nbSlots_ - 1;
+  for (uint64_t slot = h & mask; ; slot = (slot + 1) & mask)
+  {
+    const uint64_t* s = slots_ + 2 * slot;
+    if (s[1] == 0)
+      return nbMappedEntries_; // Empty slot, the ID is not in the table.
+    if (s[0] == h)
+    {
+      const uint64_t* e = mappedEntries_ + INDEX_ENTRY_SIZE * (s[1] - 1);
+      if (e[4] == id.size() && memcmp(pool_ + e[3], id.data(), id.size()) == 0)
+        return s[1] - 1;
+    }
+  }
+}
+
+/******************************************************************************/
+
+bool AbstractSequenceFileIndex::hasSequence(const std::string& id) const
+{
+  if (mapped_.isOpen())
+    return findMapped_(id) < nbMappedEntries_;
+  return index_.find(id) != index_.end();
+}
+
+/******************************************************************************/
+
+AbstractSequenceFileIndex::Entry AbstractSequenceFileIndex::getEntry(const std::string& id) const
+{
+  if (mapped_.isOpen())
+  {
+    uint64_t i = findMapped_(id);
+    if (i == nbMappedEntries_)
+      throw Exception("Sequence not found: " + id);
+    const uint64_t* e = mappedEntries_ + INDEX_ENTRY_SIZE * i;
+    Entry entry = { e[0], e[1], e[2] };
+    return entry;
+  }
+  auto it = index_.find(id);
+  if (it == index_.end())
+    throw Exception("Sequence not found: " + id);
+  return entries_[it->second];
+}
+
+/******************************************************************************/
+
+std::string AbstractSequenceFileIndex::getSequenceId(size_t i) const
+{
+  if (i >= getNumberOfSequences())
+    throw IndexOutOfBoundsException("AbstractSequenceFileIndex::getSequenceId.", i, 0, getNumberOfSequences() - 1);
+  if (mapped_.isOpen())
+  {
+    const uint64_t* e = mappedEntries_ + INDEX_ENTRY_SIZE * i;
+    return string(pool_ + e[3], static_cast<size_t>(e[4]));
+  }
+  return ids_[i];
+}
+
+/******************************************************************************/
+
+void AbstractSequenceFileIndex::write(const std::string& path) const
+{
+  uint64_t n = getNumberOfSequences();
+  uint64_t nbSlots = 2;
+  while (nbSlots < 2 * n)
+  {
+    nbSlots *= 2;
+  }
+
+  vector<uint64_t> slots(2 * nbSlots, 0);
+  vector<uint64_t> entries(INDEX_ENTRY_SIZE * n);
+  string pool;
+  for (uint64_t i = 0; i < n; ++i)
+  {
+    string id = getSequenceId(static_cast<size_t>(i));
+    Entry entry = getEntry(id);
+    uint64_t* e = &entries[INDEX_ENTRY_SIZE * i];
+    e[0] = entry.offset;
+    e[1] = entry.recordLength;
+    e[2] = entry.sequenceLength;
+    e[3] = pool.size();
+    e[4] = id.size();
+    pool += id;
+
+    uint64_t h = hash_(id.data(), id.size());
+    uint64_t slot = h & (nbSlots - 1);
+    while (slots[2 * slot + 1] != 0)
+    {
+      slot = (slot + 1) & (nbSlots - 1);
+    }
+    slots[2 * slot] = h;
+    slots[2 * slot + 1] = i + 1;
+  }
+
+  ofstream output(path.c_str(), ios::out | ios::binary | ios::trunc);
+  if (!output)
+    throw IOException("AbstractSequenceFileIndex::write. Can't write file " + path + ".");
+  uint64_t header[INDEX_HEADER_SIZE] = { INDEX_MAGIC, n, nbSlots, pool.size() };
+  output.write(reinterpret_cast<const char*>(header), sizeof(header));
+  output.write(reinterpret_cast<const char*>(slots.data()), static_cast<streamsize>(slots.size() * sizeof(uint64_t)));
+  output.write(reinterpret_cast<const char*>(entries.data()), static_cast<streamsize>(entries.size() * sizeof(uint64_t)));
+  output.write(pool.data(), static_cast<streamsize>(pool.size()));
+  if (!output)
+    throw IOException("AbstractSequenceFileIndex::write. Error while writing file " + path + ".");
+}
+
+/******************************************************************************/
+
+void AbstractSequenceFileIndex::open(const std::string& path)
+{
+  clear_();
+  mapped_.open(path);
+  const uint64_t* header = reinterpret_cast<const uint64_t*>(mapped_.data());
+  size_t headerSize = INDEX_HEADER_SIZE * sizeof(uint64_t);
+  if (mapped_.size() < headerSize || header[0] != INDEX_MAGIC)
+  {
+    mapped_.close();
+    throw IOException("AbstractSequenceFileIndex::open. File " + path + " is not a sequence index.");
+  }
+  nbMappedEntries_ = header[1];
+  nbSlots_ = header[2];
+  uint64_t expected = headerSize + (2 * nbSlots_ + INDEX_ENTRY_SIZE * nbMappedEntries_) * sizeof(uint64_t) + header[3];
+  if (mapped_.size() != expected || nbSlots_ < 2 || (nbSlots_ & (nbSlots_ - 1)) != 0)
+  {
+    clear_();
+    throw IOException("AbstractSequenceFileIndex::open. File " + path + " is corrupted.");
+  }
+  slots_ = header + INDEX_HEADER_SIZE;
+  mappedEntries_ = slots_ + 2 * nbSlots_;
+  pool_ = reinterpret_cast<const char*>(mappedEntries_ + INDEX_ENTRY_SIZE * nbMappedEntries_);
+}
+
+/******************************************************************************/
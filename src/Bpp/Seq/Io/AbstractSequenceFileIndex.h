@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_IO_ABSTRACTSEQUENCEFILEINDEX_H
+#define BPP_SEQ_IO_ABSTRACTSEQUENCEFILEINDEX_H
+
+#include <Bpp/Exceptions.h>
+
+#include "MappedFile.h"
+#include "SequenceFileIndex.h"
+
+// From the STL:
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Partial implementation of the SequenceFileIndex interface, with persistent storage.
+ *
+ * For each record of a sequence file, the index stores the sequence ID, the byte
+ * offset of the record in the file, the size of the record in bytes, and the length
+ * of the sequence. Derived classes only have to implement the scan of a given
+ * file format.
+ *
+ * Indexes can be saved with write() and reopened with open(). The saved file contains
+ * an open-addressing hash table of the IDs, followed by the entries and the IDs
+ * themselves. It is mapped in memory when opened, so that opening takes constant
+ * time and each lookup only touches a few pages, whatever the number of sequences.
+ * Numbers are stored in the native byte order, so index files are not meant to be
+ * exchanged between platforms with different endianness.
+ */
+class AbstractSequenceFileIndex :
+  public SequenceFileIndex
+{
+public:
+  /**
+   * @brief Description of one record.
+   */
+  struct Entry
+  {
+    uint64_t offset;          // Position of the record in the file.
+    uint64_t recordLength;    // Size of the record, in bytes.
+    uint64_t sequenceLength;  // Length of the sequence (characters, or sites for probabilistic formats).
+  };
+
+private:
+  std::vector<std::string> ids_;
+  std::vector<Entry> entries_;
+  std::unordered_map<std::string, size_t> index_;
+  MappedFile mapped_;
+  uint64_t nbMappedEntries_;
+  uint64_t nbSlots_;
+  const uint64_t* slots_;
+  const uint64_t* mappedEntries_;
+  const char* pool_;
+
+public:
+  AbstractSequenceFileIndex() :
+    ids_(),
+    entries_(),
+    index_(),
+    mapped_(),
+    nbMappedEntries_(0),
+    nbSlots_(0),
+    slots_(nullptr),
+    mappedEntries_(nullptr),
+    pool_(nullptr)
+  {}
+
+  virtual ~AbstractSequenceFileIndex() {}
+
+private:
+  AbstractSequenceFileIndex(const AbstractSequenceFileIndex&) = delete;
+  AbstractSequenceFileIndex& operator=(const AbstractSequenceFileIndex&) = delete;
+
+public:
+  /**
+   * @brief Build the index given a path to the file.
+   *
+   * @throw IOException If the file cannot be read or is not properly formatted.
+   * @throw Exception If an ID is found twice.
+   */
+  void build(const std::string& path) override;
+
+  std::streampos getSequencePosition(const std::string& id) const override
+  {
+    return static_cast<std::streampos>(getEntry(id).offset);
+  }
+
+  size_t getNumberOfSequences() const override;
+
+  /**
+   * @return true if the index contains a given ID.
+   */
+  bool hasSequence(const std::string& id) const;
+
+  /**
+   * @return The description of a record.
+   * @throw Exception If the ID is not in the index.
+   */
+  Entry getEntry(const std::string& id) const;
+
+  /**
+   * @return The ID of the i-th record, in file order.
+   */
+  std::string getSequenceId(size_t i) const;
+
+  /**
+   * @brief Save the index to a file.
+   *
+   * @param path The index file to write.
+   */
+  void write(const std::string& path) const;
+
+  /**
+   * @brief Open an index file previously saved with write().
+   *
+   * The file is mapped in memory and is not loaded.
+   *
+   * @param path The index file to open.
+   * @throw IOException If the file is not a valid index.
+   */
+  void open(const std::string& path);
+
+protected:
+  /**
+   * @brief Scan a sequence file and register each record with addEntry_.
+   *
+   * @param input The stream to scan, positioned at the beginning of the file.
+   */
+  virtual void scan_(std::istream& input) = 0;
+
+  /**
+   * @brief Register a record.
+   *
+   * @throw Exception If the ID was already registered.
+   */
+  void addEntry_(const std::string& id, uint64_t offset, uint64_t recordLength, uint64_t sequenceLength);
+
+private:
+  void clear_();
+
+  /**
+   * @return The index of a record in the mapped file, or nbMappedEntries_ if not found.
+   */
+  uint64_t findMapped_(const std::string& id) const;
+
+  static uint64_t hash_(const char* s, size_t n);
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_IO_ABSTRACTSEQUENCEFILEINDEX_H
@@ -0,0 +1,281 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "AlignmentCache.h"
+#include "../Profiler.h"
+#include "MappedFile.h"
+
+// From the STL:
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+using namespace bpp;
+using namespace std;
+
+const char AlignmentCache::MAGIC[8] = { 'B', 'P', 'P', 'A', 'L', 'N', '0', '1' };
+
+const uint32_t AlignmentCache::BYTE_ORDER_MARK = 0x01020304;
+
+/******************************************************************************/
+
+uint64_t AlignmentCache::hash(const char* data, size_t size, uint64_t seed)
+{
+  const uint64_t m = 0x9E3779B97F4A7C15ULL;
+  uint64_t h = seed ^ (size * m);
+  size_t i = 0;
+  for ( ; i + 8 <= size; i += 8)
+  {
+    uint64_t word;
+    memcpy(&word, data + i, 8);
+    h ^= word * m;
+    h = (h << 31) | (h >> 33);
+    h *= 0xC2B2AE3D27D4EB4FULL;
+  }
+  uint64_t tail = 0;
+  if (i < size)
+    memcpy(&tail, data + i, size - i);
+  h ^= tail * m;
+  // Final mixing, so that all bits of the input affect all bits of the key:
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDULL;
+  h ^= h >> 33;
+  h *= 0xC4CEB9FE1A85EC53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+/******************************************************************************/
+
+string AlignmentCache::getKey(
+    const std::string& path,
+    const std::map<std::string, std::string>& options,
+    const Alphabet& alphabet)
+{
+  ScopedTimer timer("io.alignment_cache.hash");
+  MappedFile file(path);
+  uint64_t contentHash = hash(file.data(), file.size());
+
+  string description = alphabet.getAlphabetType() + "\n";
+  for (const auto& option : options)
+  {
+    description += option.first + "=" + option.second + "\n";
+  }
+  uint64_t optionsHash = hash(description.data(), description.size());
+
+  ostringstream key;
+  key << hex << setfill('0') << setw(16) << contentHash << "-" << setw(16) << optionsHash;
+  return key.str();
+}
+
+/******************************************************************************/
+
+unique_ptr<VectorSiteContainer> AlignmentCache::load(
+    const std::string& key,
+    std::shared_ptr<const Alphabet> alphabet,
+    const ExecutionContext& context) const
+{
+  ScopedTimer timer("io.alignment_cache.load");
+  string path = getPath(key);
+  {
+    ifstream test(path.c_str());
+    if (!test)
+      return nullptr;
+  }
+  MappedFile file(path);
+  const char* data = file.data();
+  uint64_t size = file.size();
+  if (size < 40 || memcmp(data, MAGIC, 8) != 0)
+    return nullptr;
+
+  uint32_t byteOrder;
+  uint32_t stateSize;
+  uint64_t n;
+  uint64_t m;
+  uint64_t dataOffset;
+  memcpy(&byteOrder, data + 8, 4);
+  memcpy(&stateSize, data + 12, 4);
+  memcpy(&n, data + 16, 8);
+  memcpy(&m, data + 24, 8);
+  memcpy(&dataOffset, data + 32, 8);
+  if (byteOrder != BYTE_ORDER_MARK || (stateSize != 1 && stateSize != 4) || n > size || m > size)
+    return nullptr;
+
+  // Alphabet type, keys and names:
+  vector<string> strings(static_cast<size_t>(1 + 2 * n));
+  uint64_t pos = 40;
+  for (auto& str : strings)
+  {
+    uint32_t length;
+    if (pos + 4 > size)
+      return nullptr;
+    memcpy(&length, data + pos, 4);
+    pos += 4;
+    if (pos + length > size)
+      return nullptr;
+    str.assign(data + pos, length);
+    pos += length;
+  }
+  if (strings[0] != alphabet->getAlphabetType())
+    return nullptr;
+  if (dataOffset != (pos + 7) / 8 * 8 || size != dataOffset + 8 * m + stateSize * m * n)
+    return nullptr;
+  vector<string> keys(strings.begin() + 1, strings.begin() + 1 + static_cast<ptrdiff_t>(n));
+  vector<string> names(strings.begin() + 1 + static_cast<ptrdiff_t>(n), strings.end());
+
+  // Sites are decoded in parallel, and added in order:
+  const char* coordinates = data + dataOffset;
+  const char* states = coordinates + 8 * m;
+  size_t nbSeq = static_cast<size_t>(n);
+  size_t nbSites = static_cast<size_t>(m);
+  vector<unique_ptr<Site>> sites(nbSites);
+  vector<exception_ptr> errors(nbSites);
+  context.forEachBlock(nbSites, [&](size_t begin, size_t end)
+  {
+    vector<int> content(nbSeq);
+    for (size_t i = begin; i < end; ++i)
+    {
+      try
+      {
+        int64_t coordinate;
+        memcpy(&coordinate, coordinates + 8 * i, 8);
+        if (stateSize == 1)
+        {
+          const int8_t* p = reinterpret_cast<const int8_t*>(states + i * nbSeq);
+          for (size_t j = 0; j < nbSeq; ++j)
+          {
+            content[j] = p[j];
+          }
+        }
+        else if (nbSeq > 0)
+        {
+          memcpy(&content[0], states + 4 * i * nbSeq, 4 * nbSeq);
+        }
+        sites[i] = make_unique<Site>(content, alphabet, static_cast<int>(coordinate));
+      }
+      catch (...)
+      {
+        errors[i] = current_exception();
+      }
+    }
+  });
+  for (const auto& error : errors)
+  {
+    if (error)
+      return nullptr; // Invalid states, this file is not usable.
+  }
+
+  auto sequences = make_unique<VectorSiteContainer>(keys, alphabet);
+  for (auto& site : sites)
+  {
+    sequences->addSite(site, false);
+  }
+  sequences->setSequenceNames(names, false);
+  return sequences;
+}
+
+/******************************************************************************/
+
+void AlignmentCache::store(const std::string& key, const SiteContainerInterface& sites) const
+{
+  ScopedTimer timer("io.alignment_cache.store");
+  string path = getPath(key);
+  // The temporary name is unique to this call, as other threads or programs may store the same key:
+  static atomic<uint64_t> counter(0);
+  static const uint64_t processId = (static_cast<uint64_t>(random_device()()) << 32) ^ random_device()();
+  ostringstream tmpName;
+  tmpName << path << "." << hex << processId << "-" << counter++ << ".tmp";
+  string tmpPath = tmpName.str();
+  vector<string> keys = sites.getSequenceKeys();
+  vector<string> names = sites.getSequenceNames();
+  uint64_t n = sites.getNumberOfSequences();
+  uint64_t m = sites.getNumberOfSites();
+
+  // Use one byte per state when possible:
+  uint32_t stateSize = 1;
+  for (size_t i = 0; i < m && stateSize == 1; ++i)
+  {
+    const Site& site = sites.site(i);
+    for (size_t j = 0; j < n; ++j)
+    {
+      if (site[j] < -128 || site[j] > 127)
+      {
+        stateSize = 4;
+        break;
+      }
+    }
+  }
+
+  {
+    ofstream output(tmpPath.c_str(), ios::out | ios::binary | ios::trunc);
+    if (!output)
+      throw IOException("AlignmentCache::store. Can't create file " + tmpPath + ".");
+    vector<string> strings;
+    strings.push_back(sites.getAlphabet()->getAlphabetType());
+    strings.insert(strings.end(), keys.begin(), keys.end());
+    strings.insert(strings.end(), names.begin(), names.end());
+    uint64_t pos = 40;
+    for (const auto& str : strings)
+    {
+      pos += 4 + str.size();
+    }
+    uint64_t dataOffset = (pos + 7) / 8 * 8;
+
+    output.write(MAGIC, 8);
+    output.write(reinterpret_cast<const char*>(&BYTE_ORDER_MARK), 4);
+    output.write(reinterpret_cast<const char*>(&stateSize), 4);
+    output.write(reinterpret_cast<const char*>(&n), 8);
+    output.write(reinterpret_cast<const char*>(&m), 8);
+    output.write(reinterpret_cast<const char*>(&dataOffset), 8);
+    for (const auto& str : strings)
+    {
+      uint32_t length = static_cast<uint32_t>(str.size());
+      output.write(reinterpret_cast<const char*>(&length), 4);
+      output.write(str.data(), static_cast<streamsize>(length));
+    }
+    const char padding[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    output.write(padding, static_cast<streamsize>(dataOffset - pos));
+
+    for (size_t i = 0; i < m; ++i)
+    {
+      int64_t coordinate = sites.site(i).getCoordinate();
+      output.write(reinterpret_cast<const char*>(&coordinate), 8);
+    }
+    vector<int8_t> buffer(static_cast<size_t>(n));
+    for (size_t i = 0; i < m; ++i)
+    {
+      const Site& site = sites.site(i);
+      if (stateSize == 1)
+      {
+        for (size_t j = 0; j < n; ++j)
+        {
+          buffer[j] = static_cast<int8_t>(site[j]);
+        }
+        output.write(reinterpret_cast<const char*>(buffer.data()), static_cast<streamsize>(n));
+      }
+      else if (n > 0)
+      {
+        output.write(reinterpret_cast<const char*>(&site.getContent()[0]), static_cast<streamsize>(4 * n));
+      }
+    }
+    output.close();
+    if (!output)
+    {
+      remove(tmpPath.c_str());
+      throw IOException("AlignmentCache::store. Can't write file " + tmpPath + ".");
+    }
+  }
+  if (rename(tmpPath.c_str(), path.c_str()) != 0)
+  {
+    remove(tmpPath.c_str());
+    throw IOException("AlignmentCache::store. Can't rename file " + tmpPath + " to " + path + ".");
+  }
+}
+
+/******************************************************************************/
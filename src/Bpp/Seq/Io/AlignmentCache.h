@@ -0,0 +1,129 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_IO_ALIGNMENTCACHE_H
+#define BPP_SEQ_IO_ALIGNMENTCACHE_H
+
+#include <Bpp/Exceptions.h>
+
+#include "../Container/VectorSiteContainer.h"
+#include "../ExecutionContext.h"
+
+// From the STL:
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace bpp
+{
+/**
+ * @brief An on-disk cache of parsed alignments.
+ *
+ * Parsing and filtering a large alignment file may take much longer than
+ * the analysis it is loaded for, and is repeated at each run of a program.
+ * This class stores a processed alignment in a binary file, whose name is
+ * a key computed from the content of the input file and from the options
+ * used to process it, so that any change of the file or of the options
+ * gives another key.
+ *
+ * Cache files are mapped in memory, and read without any parsing:
+ * - 8 bytes: the magic string "BPPALN01",
+ * - 4 bytes: 0x01020304 in the byte order of the writer,
+ * - 4 bytes: the size of states (1 or 4),
+ * - 8 bytes: the number of sequences n,
+ * - 8 bytes: the number of sites m,
+ * - 8 bytes: the offset of the data, a multiple of 8,
+ * - the alphabet type, the n sequence keys and the n sequence names,
+ *   each as a 4-byte length followed by the characters,
+ * - zero padding up to the offset of the data,
+ * - m site coordinates, as 8-byte integers,
+ * - m x n states, site by site.
+ *
+ * Sequence and container comments are not stored. Keys are built with a
+ * fast, non-cryptographic 64-bit hash.
+ *
+ * @see SequenceApplicationTools::getSiteContainer
+ */
+class AlignmentCache
+{
+public:
+  static const char MAGIC[8];
+
+  static const uint32_t BYTE_ORDER_MARK;
+
+private:
+  std::string directory_;
+
+public:
+  /**
+   * @param directory The directory where cache files are stored. It must exist.
+   */
+  AlignmentCache(const std::string& directory) :
+    directory_(directory) {}
+
+  virtual ~AlignmentCache() {}
+
+public:
+  const std::string& getDirectory() const { return directory_; }
+
+  /**
+   * @return The path of the cache file of a key.
+   */
+  std::string getPath(const std::string& key) const
+  {
+    return directory_ + "/" + key + ".bppaln";
+  }
+
+  /**
+   * @brief Compute the key of an alignment.
+   *
+   * @param path     The input file, whose whole content is hashed.
+   * @param options  The options used to read and process the file.
+   * @param alphabet The alphabet of the processed alignment.
+   * @return A key of 33 characters, usable as a file name.
+   * @throw IOException If the input file cannot be read.
+   */
+  static std::string getKey(
+      const std::string& path,
+      const std::map<std::string, std::string>& options,
+      const Alphabet& alphabet);
+
+  /**
+   * @brief Load an alignment from the cache.
+   *
+   * @param key      The key of the alignment.
+   * @param alphabet The alphabet of the alignment.
+   * @param context  The execution context to be used, sites being decoded in parallel.
+   * @return The alignment, or a null pointer if there is no valid cache file for this key.
+   */
+  std::unique_ptr<VectorSiteContainer> load(
+      const std::string& key,
+      std::shared_ptr<const Alphabet> alphabet,
+      const ExecutionContext& context = ExecutionContext::global()) const;
+
+  /**
+   * @brief Store an alignment in the cache.
+   *
+   * The file is written under a temporary name, unique to each call, and then
+   * renamed, so that concurrent readers never see a partial file and that
+   * concurrent writers of the same key do not interfere.
+   *
+   * @param key   The key of the alignment.
+   * @param sites The alignment.
+   * @throw IOException If the file cannot be written.
+   */
+  void store(const std::string& key, const SiteContainerInterface& sites) const;
+
+  /**
+   * @brief Hash a block of memory.
+   *
+   * @param data The data to hash.
+   * @param size The number of bytes.
+   * @param seed The initial value, to chain several blocks.
+   */
+  static uint64_t hash(const char* data, size_t size, uint64_t seed = 0);
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_IO_ALIGNMENTCACHE_H
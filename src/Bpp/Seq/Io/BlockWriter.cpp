@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "BlockWriter.h"
+
+// From the STL:
+#include <algorithm>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+BlockWriter::BlockWriter(std::ostream& output, size_t capacity) :
+  output_(output),
+  buffer_(),
+  capacity_(capacity)
+{
+  buffer_.reserve(capacity_ + capacity_ / 8);
+}
+
+/******************************************************************************/
+
+BlockWriter::~BlockWriter()
+{
+  try
+  {
+    flush();
+  }
+  catch (...)
+  {}
+}
+
+/******************************************************************************/
+
+void BlockWriter::flush()
+{
+  if (!buffer_.empty())
+    output_.write(buffer_.data(), static_cast<streamsize>(buffer_.size()));
+  buffer_.clear();
+  if (!output_)
+    throw IOException("BlockWriter::flush. Error while writing to stream.");
+}
+
+/******************************************************************************/
+
+void BlockWriter::writeBlocks(
+    size_t nbBlocks,
+    const std::function<void(size_t, std::string&)>& formatBlock,
+    const ExecutionContext& context)
+{
+  if (!context.isParallel() || nbBlocks <= 1)
+  {
+    for (size_t b = 0; b < nbBlocks; ++b)
+    {
+      formatBlock(b, buffer_);
+      commit();
+    }
+    return;
+  }
+
+  // Blocks are formatted by batches, holding about as much text as the buffer.
+  // The first batch has one block per thread, and is used to estimate the size of blocks:
+  flush();
+  size_t nbWorkers = context.getNumberOfWorkers();
+  size_t batchSize = nbWorkers;
+  vector<string> texts;
+  size_t n = 0;
+  for (size_t first = 0; first < nbBlocks; first += n)
+  {
+    n = min(batchSize, nbBlocks - first);
+    if (texts.size() < n)
+      texts.resize(n);
+    context.forEachBlock(n, [&](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        texts[i].clear();
+        formatBlock(first + i, texts[i]);
+      }
+    }, 1);
+    size_t batchBytes = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+      output_.write(texts[i].data(), static_cast<streamsize>(texts[i].size()));
+      batchBytes += texts[i].size();
+    }
+    if (!output_)
+      throw IOException("BlockWriter::writeBlocks. Error while writing to stream.");
+    size_t blockBytes = max(static_cast<size_t>(1), batchBytes / n);
+    batchSize = max(nbWorkers, capacity_ / blockBytes);
+  }
+}
+
+/******************************************************************************/
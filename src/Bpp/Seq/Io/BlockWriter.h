@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_IO_BLOCKWRITER_H
+#define BPP_SEQ_IO_BLOCKWRITER_H
+
+#include <Bpp/Exceptions.h>
+
+#include "../ExecutionContext.h"
+
+// From the STL:
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace bpp
+{
+/**
+ * @brief Buffered output for sequence writers.
+ *
+ * Text is appended to an internal buffer which is written to the stream in
+ * large chunks, instead of line by line with std::endl, which flushes the
+ * stream each time.
+ *
+ * Files made of independent blocks, like interleaved alignments, can be
+ * formatted in parallel with writeBlocks(): blocks are formatted in batches
+ * by the threads of an ExecutionContext, then written in order. Batches hold
+ * about as much text as the buffer, so that memory usage does not depend on
+ * the size of the file.
+ */
+class BlockWriter
+{
+private:
+  std::ostream& output_;
+  std::string buffer_;
+  size_t capacity_;
+
+public:
+  /**
+   * @param output   The stream to write to.
+   * @param capacity The size of the buffer, in bytes.
+   */
+  BlockWriter(std::ostream& output, size_t capacity = 1048576);
+
+  /**
+   * @brief The remaining content of the buffer is written, errors are ignored.
+   *
+   * Call flush() explicitly to be notified of errors.
+   */
+  virtual ~BlockWriter();
+
+private:
+  BlockWriter(const BlockWriter&) = delete;
+  BlockWriter& operator=(const BlockWriter&) = delete;
+
+public:
+  /**
+   * @return The buffer, to which text can be appended directly. Call commit() afterwards.
+   */
+  std::string& buffer() { return buffer_; }
+
+  /**
+   * @brief Write the buffer if it is full.
+   */
+  void commit()
+  {
+    if (buffer_.size() >= capacity_)
+      flush();
+  }
+
+  /**
+   * @brief Write the content of the buffer to the stream.
+   *
+   * @throw IOException If the stream is in a bad state after writing.
+   */
+  void flush();
+
+  /**
+   * @brief Format and write a series of blocks, in order.
+   *
+   * @param nbBlocks    The number of blocks.
+   * @param formatBlock A function appending the text of the given block to a string.
+   * It is called concurrently from several threads, and must not modify shared data.
+   * @param context     The execution context to use.
+   * @throw Exception The exception thrown by formatBlock for the first failing block is rethrown, after all threads have stopped.
+   */
+  void writeBlocks(
+      size_t nbBlocks,
+      const std::function<void(size_t, std::string&)>& formatBlock,
+      const ExecutionContext& context = ExecutionContext::global());
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_IO_BLOCKWRITER_H
@@ -14,6 +14,7 @@
 #include "NexusIoSequence.h"
 #include "Pasta.h"
 #include "Phylip.h"
+#include "Stockholm.h"
 
 using namespace bpp;
 using namespace std;
@@ -78,6 +79,10 @@ unique_ptr<IAlignment> BppOAlignmentReaderFormat::read(const std::string& descri
   {
     iAln.reset(new NexusIOSequence());
   }
+  else if (format == "Stockholm")
+  {
+    iAln.reset(new Stockholm());
+  }
   else
   {
     throw IOException("Sequence format '" + format + "' unknown.");
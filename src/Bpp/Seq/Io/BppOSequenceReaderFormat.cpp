@@ -14,6 +14,7 @@
 #include "Mase.h"
 #include "NexusIoSequence.h"
 #include "Phylip.h"
+#include "Stockholm.h"
 
 using namespace bpp;
 using namespace std;
@@ -82,6 +83,10 @@ unique_ptr<ISequence> BppOSequenceReaderFormat::read(const std::string& descript
   {
     iSeq.reset(new NexusIOSequence());
   }
+  else if (format == "Stockholm")
+  {
+    iSeq.reset(new Stockholm());
+  }
   else
   {
     throw IOException("Sequence format '" + format + "' unknown.");
@@ -8,6 +8,7 @@
 
 #include "BppOSequenceStreamReaderFormat.h"
 #include "Fasta.h"
+#include "GenBank.h"
 
 using namespace bpp;
 using namespace std;
@@ -24,6 +25,10 @@ unique_ptr<ISequenceStream> BppOSequenceStreamReaderFormat::read(const std::stri
     bool extended    = ApplicationTools::getBooleanParameter("extended", unparsedArguments_, false, "", true, false);
     iSeq = make_unique<Fasta>(100, true, extended, strictNames);
   }
+  else if (format == "GenBank")
+  {
+    iSeq = make_unique<GenBank>();
+  }
   else
   {
     throw IOException("Sequence format '" + format + "' unknown.");
@@ -6,7 +6,10 @@
 #include <Bpp/Text/StringTokenizer.h>
 #include <Bpp/Text/TextTools.h>
 
+#include "../SymbolDecoder.h"
+#include "BlockWriter.h"
 #include "Clustal.h"
+#include "InterleavedBlockParser.h"
 
 using namespace bpp;
 
@@ -23,9 +26,6 @@ void Clustal::appendAlignmentFromStream(std::istream& input, SequenceContainerIn
     throw IOException ("Clustal::read : fail to open file");
   }
 
-  auto alphaPtr = sc.getAlphabet();
-  vector< unique_ptr<Sequence>> sequences;
-
   string lineRead("");
 
   Comments comments(1);
@@ -52,41 +52,46 @@ void Clustal::appendAlignmentFromStream(std::istream& input, SequenceContainerIn
   }
   if (beginSeq == 0)
     throw IOException("Clustal::read. Bad intput file.");
+  string::size_type endName = beginSeq - nbSpacesBeforeSeq_;
 
-  unsigned int countSequences = 0;
+  // Blocks are encoded directly into per-sequence buffers:
+  InterleavedBlockParser parser(sc.getAlphabet(), 0, ingestPolicy_);
 
   // Read first sequences block:
   bool test = true;
   do
   {
-    sequences.push_back(make_unique<Sequence>(TextTools::removeSurroundingWhiteSpaces(lineRead.substr(0, beginSeq - nbSpacesBeforeSeq_)), lineRead.substr(beginSeq), alphaPtr));
+    if (lineRead.size() < beginSeq)
+      throw IOException("Clustal::read. Bad intput file.");
+    parser.addRow(TextTools::removeSurroundingWhiteSpaces(lineRead.substr(0, endName)), lineRead.data() + beginSeq, lineRead.data() + lineRead.size());
     getline(input, lineRead, '\n');
-    countSequences++;
-    test = !TextTools::isEmpty(lineRead) && !TextTools::isEmpty(lineRead.substr(0, beginSeq - nbSpacesBeforeSeq_));
+    test = !TextTools::isEmpty(lineRead) && !InterleavedBlockParser::isBlank(lineRead, endName);
   }
   while (input && test);
+  size_t countSequences = parser.getNumberOfRows();
+
+  // The length of the alignment is not known, we estimate it from the size of the file:
+  parser.estimateExpectedLength(input);
 
-  // Read other blocks
-  lineRead = FileTools::getNextLine(input); // Read first sequence of next block.
-  while (!TextTools::isEmpty(lineRead))
+  // Read other blocks. Lines with no name (conservation lines) and blank lines are skipped.
+  size_t countLines = 0;
+  while (getline(input, lineRead, '\n'))
   {
-    // Read next block:
-    for (unsigned int i = 0; i < countSequences; ++i)
+    if (TextTools::isEmpty(lineRead) || InterleavedBlockParser::isBlank(lineRead, endName))
     {
-      // Complete sequences
-      if (TextTools::isEmpty(lineRead))
+      if (countLines % countSequences != 0)
         throw IOException("Clustal::read. Bad intput file.");
-      sequences[i]->append(lineRead.substr(beginSeq));
-      getline(input, lineRead, '\n');
+      continue;
     }
-    // At this point, lineRead is the first line after the current block.
-    lineRead = FileTools::getNextLine(input);
+    if (lineRead.size() < beginSeq)
+      throw IOException("Clustal::read. Bad intput file.");
+    parser.appendToRow(countLines % countSequences, lineRead.data() + beginSeq, lineRead.data() + lineRead.size());
+    ++countLines;
   }
+  if (countLines % countSequences != 0)
+    throw IOException("Clustal::read. Bad intput file.");
 
-  for (unsigned int i = 0; i < countSequences; ++i)
-  {
-    sc.addSequence(sequences[i]->getName(), sequences[i]);
-  }
+  parser.flush(sc);
   sc.setComments(comments);
 }
 
@@ -97,23 +102,37 @@ void Clustal::writeAlignment(std::ostream& output, const SiteContainerInterface&
   if (sc.getNumberOfSequences() == 0)
     return;
 
-  vector<string> text;
+  SymbolDecoder decoder(sc.getAlphabet());
   size_t length = 0;
+  vector<const vector<int>*> contents(sc.getNumberOfSequences());
   for (size_t i = 0; i < sc.getNumberOfSequences(); ++i)
   {
     const Sequence& seq = sc.sequence(i);
     if (seq.getName().size() > length)
       length = seq.getName().size();
-    text.push_back(sc.sequence(i).toString());
+    contents[i] = &seq.getContent();
   }
   length += nbSpacesBeforeSeq_;
-  for (unsigned int j = 0; j < text[0].size(); j += charsByLine_)
+  vector<string> names(sc.getNumberOfSequences());
+  for (size_t i = 0; i < sc.getNumberOfSequences(); ++i)
   {
-    for (unsigned int i = 0; i < sc.getNumberOfSequences(); ++i)
+    names[i] = TextTools::resizeRight(sc.sequence(i).getName(), length);
+  }
+
+  size_t nbChars = contents[0]->size() * decoder.getCodingSize();
+  size_t nbBlocks = (nbChars + charsByLine_ - 1) / charsByLine_;
+  auto formatBlock = [&](size_t b, string& text)
+  {
+    size_t j = b * charsByLine_;
+    for (size_t i = 0; i < contents.size(); ++i)
     {
-      output << TextTools::resizeRight(sc.sequence(i).getName(), length);
-      output << text[i].substr(j, charsByLine_) << endl;
+      text += names[i];
+      decoder.decode(*contents[i], j, j + charsByLine_, text);
+      text += '\n';
     }
-    output << endl;
-  }
+    text += '\n';
+  };
+  BlockWriter writer(output);
+  writer.writeBlocks(nbBlocks, formatBlock, getExecutionContext());
+  writer.flush();
 }
@@ -7,8 +7,10 @@
 
 
 #include "../Container/SiteContainer.h"
+#include "../ExecutionContext.h"
 #include "AbstractIAlignment.h"
 #include "AbstractOAlignment.h"
+#include "IngestPolicy.h"
 
 // From the STL:
 #include <iostream>
@@ -28,6 +30,8 @@ private:
   bool checkNames_;
   unsigned int nbSpacesBeforeSeq_;
   unsigned int charsByLine_;
+  std::shared_ptr<const ExecutionContext> context_; // Used to format blocks (output only), global one if null
+  IngestPolicy ingestPolicy_;                       // How invalid characters are handled (input only)
 
 public:
   /**
@@ -40,7 +44,9 @@ public:
   Clustal(bool checkSequenceNames = true, unsigned int nbExtraSpacesBeforeSeq = 5, unsigned int charsByLine = 100) :
     checkNames_(checkSequenceNames),
     nbSpacesBeforeSeq_(nbExtraSpacesBeforeSeq + 1),
-    charsByLine_(charsByLine)
+    charsByLine_(charsByLine),
+    context_(),
+    ingestPolicy_()
   {}
 
   virtual ~Clustal() {}
@@ -108,6 +114,32 @@ public:
    * @param yn whether the sequence names should be checked when reading from files.
    */
   void checkNames(bool yn) { checkNames_ = yn; }
+
+  /**
+   * @return The execution context used to format blocks when writing alignments.
+   */
+  const ExecutionContext& getExecutionContext() const { return context_ ? *context_ : ExecutionContext::global(); }
+
+  /**
+   * @brief Set the execution context used to format blocks when writing alignments.
+   *
+   * Blocks are formatted in parallel and written in file order.
+   *
+   * @param context The context to use, or null for the library-wide one, ExecutionContext::global() (the default).
+   */
+  void setExecutionContext(std::shared_ptr<const ExecutionContext> context) { context_ = context; }
+
+  /**
+   * @return How characters which are not part of the alphabet are handled when reading.
+   */
+  const IngestPolicy& getIngestPolicy() const { return ingestPolicy_; }
+
+  /**
+   * @brief Set how characters which are not part of the alphabet are handled when reading.
+   *
+   * @param policy The policy to use (strict by default).
+   */
+  void setIngestPolicy(const IngestPolicy& policy) { ingestPolicy_ = policy; }
 };
 } // end of namespace bpp.
 #endif // BPP_SEQ_IO_CLUSTAL_H
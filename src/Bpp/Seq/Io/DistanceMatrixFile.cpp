@@ -0,0 +1,263 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "DistanceMatrixFile.h"
+#include "MappedFile.h"
+
+// From the STL:
+#include <algorithm>
+#include <cstring>
+
+using namespace bpp;
+using namespace std;
+
+const char DistanceMatrixFile::MAGIC[8] = { 'B', 'P', 'P', 'D', 'I', 'S', 'T', '1' };
+
+const uint32_t DistanceMatrixFile::BYTE_ORDER_MARK = 0x01020304;
+
+/******************************************************************************/
+
+uint64_t DistanceMatrixFile::getDataOffset(const std::vector<std::string>& names)
+{
+  uint64_t offset = 32;
+  for (const auto& name : names)
+  {
+    offset += 4 + name.size();
+  }
+  return (offset + 7) / 8 * 8;
+}
+
+/******************************************************************************/
+
+void DistanceMatrixFile::write(const DistanceMatrix& dist, const std::string& path, bool singlePrecision)
+{
+  DistanceMatrixFileWriter writer(path, dist.getNames(), singlePrecision);
+  vector<double> row;
+  for (size_t i = 0; i < dist.size(); ++i)
+  {
+    dist.getRow(i, row);
+    writer.setDiagonal(i, row[i]);
+    if (i > 0)
+      writer.writeRow(i, 0, &row[0], i);
+  }
+  writer.close();
+}
+
+/******************************************************************************/
+
+unique_ptr<const DistanceMatrix> DistanceMatrixFile::map(const std::string& path)
+{
+  auto file = make_shared<MappedFile>(path);
+  const char* data = file->data();
+  size_t size = file->size();
+  if (size < 32 || memcmp(data, MAGIC, 8) != 0)
+    throw IOException("DistanceMatrixFile::map. Not a distance matrix file: " + path + ".");
+
+  uint32_t valueSize;
+  uint32_t byteOrder;
+  uint64_t n;
+  uint64_t dataOffset;
+  memcpy(&valueSize, data + 8, 4);
+  memcpy(&byteOrder, data + 12, 4);
+  memcpy(&n, data + 16, 8);
+  memcpy(&dataOffset, data + 24, 8);
+  if (byteOrder != BYTE_ORDER_MARK)
+    throw IOException("DistanceMatrixFile::map. File written with another byte order: " + path + ".");
+  if (valueSize != 4 && valueSize != 8)
+    throw IOException("DistanceMatrixFile::map. Invalid value size in file " + path + ".");
+
+  // Check the dimension against the size of the file before allocating anything,
+  // without overflows: each name takes at least 4 bytes, each distance valueSize bytes.
+  uint64_t fileSize = size;
+  if (n > (fileSize - 32) / 4 || dataOffset > fileSize || (fileSize - dataOffset) / 8 < n)
+    throw IOException("DistanceMatrixFile::map. Invalid dimension in file " + path + ".");
+  uint64_t lowerSize = fileSize - dataOffset - 8 * n;
+  uint64_t maxPairs = lowerSize / valueSize;
+  if (n > 1 && n - 1 > 2 * maxPairs / n)
+    throw IOException("DistanceMatrixFile::map. Truncated file: " + path + ".");
+  uint64_t nbPairs = n > 0 ? n * (n - 1) / 2 : 0;
+  if (lowerSize != valueSize * nbPairs)
+    throw IOException("DistanceMatrixFile::map. Invalid file size: " + path + ".");
+
+  vector<string> names(static_cast<size_t>(n));
+  uint64_t pos = 32;
+  for (auto& name : names)
+  {
+    uint32_t length;
+    if (pos + 4 > size)
+      throw IOException("DistanceMatrixFile::map. Truncated file: " + path + ".");
+    memcpy(&length, data + pos, 4);
+    pos += 4;
+    if (pos + length > size)
+      throw IOException("DistanceMatrixFile::map. Truncated file: " + path + ".");
+    name.assign(data + pos, length);
+    pos += length;
+  }
+  if (dataOffset != (pos + 7) / 8 * 8)
+    throw IOException("DistanceMatrixFile::map. Invalid data offset in file " + path + ".");
+
+  // Data are aligned, as mappings start on a page boundary:
+  const double* diagonal = reinterpret_cast<const double*>(data + dataOffset);
+  const char* lower = data + dataOffset + 8 * n;
+  if (valueSize == 8)
+    return make_unique<DistanceMatrix>(names, diagonal, reinterpret_cast<const double*>(lower), file);
+  else
+    return make_unique<DistanceMatrix>(names, diagonal, reinterpret_cast<const float*>(lower), file);
+}
+
+/******************************************************************************/
+
+unique_ptr<DistanceMatrix> DistanceMatrixFile::read(const std::string& path)
+{
+  auto dist = make_unique<DistanceMatrix>(*map(path));
+  dist->setStorage(dist->getStorage()); // Copies the values in memory.
+  return dist;
+}
+
+/******************************************************************************/
+
+DistanceMatrixFileWriter::DistanceMatrixFileWriter(const std::string& path, const std::vector<std::string>& names, bool singlePrecision) :
+  path_(path),
+  output_(path.c_str(), ios::out | ios::binary | ios::trunc),
+  mutex_(),
+  n_(names.size()),
+  singlePrecision_(singlePrecision),
+  diagonalOffset_(DistanceMatrixFile::getDataOffset(names)),
+  lowerOffset_(0),
+  floatBuffer_()
+{
+  if (!output_)
+    throw IOException("DistanceMatrixFileWriter. Can't create file " + path + ".");
+  uint64_t n = n_;
+  uint32_t valueSize = singlePrecision ? 4 : 8;
+  lowerOffset_ = diagonalOffset_ + 8 * n;
+  uint64_t nbPairs = n > 0 ? n * (n - 1) / 2 : 0;
+
+  output_.write(DistanceMatrixFile::MAGIC, 8);
+  output_.write(reinterpret_cast<const char*>(&valueSize), 4);
+  output_.write(reinterpret_cast<const char*>(&DistanceMatrixFile::BYTE_ORDER_MARK), 4);
+  output_.write(reinterpret_cast<const char*>(&n), 8);
+  output_.write(reinterpret_cast<const char*>(&diagonalOffset_), 8);
+  for (const auto& name : names)
+  {
+    uint32_t length = static_cast<uint32_t>(name.size());
+    output_.write(reinterpret_cast<const char*>(&length), 4);
+    output_.write(name.data(), static_cast<streamsize>(length));
+  }
+  // Extend the file to its final size, with zeros:
+  uint64_t end = lowerOffset_ + valueSize * nbPairs;
+  uint64_t pos = static_cast<uint64_t>(output_.tellp());
+  if (end > pos)
+  {
+    output_.seekp(static_cast<streamoff>(end - 1));
+    output_.put('\0');
+  }
+  if (!output_)
+    throw IOException("DistanceMatrixFileWriter. Can't write file " + path + ".");
+}
+
+/******************************************************************************/
+
+DistanceMatrixFileWriter::~DistanceMatrixFileWriter()
+{
+  try
+  {
+    close();
+  }
+  catch (IOException& e) {} // Call close() explicitly to get errors.
+}
+
+/******************************************************************************/
+
+void DistanceMatrixFileWriter::setDiagonal(size_t i, double value)
+{
+  if (i >= n_)
+    throw IndexOutOfBoundsException("DistanceMatrixFileWriter::setDiagonal.", i, 0, n_);
+  lock_guard<mutex> lock(mutex_);
+  checkOpen_("DistanceMatrixFileWriter::setDiagonal.");
+  output_.seekp(static_cast<streamoff>(diagonalOffset_ + 8 * i));
+  output_.write(reinterpret_cast<const char*>(&value), 8);
+}
+
+/******************************************************************************/
+
+void DistanceMatrixFileWriter::writeRow(size_t i, size_t jBegin, const double* values, size_t count)
+{
+  if (jBegin + count > i || i >= n_)
+    throw IndexOutOfBoundsException("DistanceMatrixFileWriter::writeRow. Values out of the strict lower triangle.", jBegin + count, 0, i);
+  lock_guard<mutex> lock(mutex_);
+  checkOpen_("DistanceMatrixFileWriter::writeRow.");
+  writeRow_(i, jBegin, values, count);
+}
+
+/******************************************************************************/
+
+void DistanceMatrixFileWriter::writeTile(size_t iBegin, size_t jBegin, const Matrix<double>& tile)
+{
+  size_t nbRows = tile.getNumberOfRows();
+  size_t nbCols = tile.getNumberOfColumns();
+  if (iBegin + nbRows > n_ || jBegin + nbCols > n_)
+    throw IndexOutOfBoundsException("DistanceMatrixFileWriter::writeTile. Tile out of the matrix.", max(iBegin + nbRows, jBegin + nbCols), 0, n_);
+  vector<double> values;
+  lock_guard<mutex> lock(mutex_);
+  checkOpen_("DistanceMatrixFileWriter::writeTile.");
+  for (size_t k = 0; k < nbRows; ++k)
+  {
+    size_t i = iBegin + k;
+    if (i < jBegin)
+      continue;
+    size_t count = min(nbCols, i - jBegin);
+    values.resize(count);
+    for (size_t l = 0; l < count; ++l)
+    {
+      values[l] = tile(k, l);
+    }
+    if (count > 0)
+      writeRow_(i, jBegin, &values[0], count);
+    if (i - jBegin < nbCols)
+    {
+      double value = tile(k, i - jBegin);
+      output_.seekp(static_cast<streamoff>(diagonalOffset_ + 8 * i));
+      output_.write(reinterpret_cast<const char*>(&value), 8);
+    }
+  }
+}
+
+/******************************************************************************/
+
+void DistanceMatrixFileWriter::writeRow_(size_t i, size_t jBegin, const double* values, size_t count)
+{
+  if (count == 0)
+    return;
+  uint64_t index = static_cast<uint64_t>(i) * (i - 1) / 2 + jBegin;
+  if (singlePrecision_)
+  {
+    floatBuffer_.resize(count);
+    for (size_t l = 0; l < count; ++l)
+    {
+      floatBuffer_[l] = static_cast<float>(values[l]);
+    }
+    output_.seekp(static_cast<streamoff>(lowerOffset_ + 4 * index));
+    output_.write(reinterpret_cast<const char*>(&floatBuffer_[0]), static_cast<streamsize>(4 * count));
+  }
+  else
+  {
+    output_.seekp(static_cast<streamoff>(lowerOffset_ + 8 * index));
+    output_.write(reinterpret_cast<const char*>(values), static_cast<streamsize>(8 * count));
+  }
+}
+
+/******************************************************************************/
+
+void DistanceMatrixFileWriter::close()
+{
+  lock_guard<mutex> lock(mutex_);
+  if (!output_.is_open())
+    return;
+  output_.close();
+  if (output_.fail())
+    throw IOException("DistanceMatrixFileWriter::close. Error while writing file " + path_ + ".");
+}
+
+/******************************************************************************/
@@ -0,0 +1,184 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_IO_DISTANCEMATRIXFILE_H
+#define BPP_SEQ_IO_DISTANCEMATRIXFILE_H
+
+#include <Bpp/Exceptions.h>
+#include <Bpp/Numeric/Matrix/Matrix.h>
+
+#include "../DistanceMatrix.h"
+
+// From the STL:
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Binary files of distance matrices.
+ *
+ * Files store the names and the lower triangle of the matrix, in double or
+ * single precision, so that they can be mapped in memory and used without
+ * parsing:
+ * - 8 bytes: the magic string "BPPDIST1",
+ * - 4 bytes: the size of distance values (8 or 4),
+ * - 4 bytes: 0x01020304 in the byte order of the writer,
+ * - 8 bytes: the number of taxa n,
+ * - 8 bytes: the offset of the data, a multiple of 8,
+ * - the names, each as a 4-byte length followed by the characters,
+ * - zero padding up to the offset of the data,
+ * - n diagonal values, in double precision,
+ * - n (n - 1) / 2 values of the strict lower triangle, row by row: (1, 0), (2, 0), (2, 1), (3, 0)...
+ *
+ * Files are read on machines with the same byte order only.
+ *
+ * @see DistanceMatrixFileWriter
+ */
+class DistanceMatrixFile
+{
+public:
+  static const char MAGIC[8];
+
+  static const uint32_t BYTE_ORDER_MARK;
+
+public:
+  /**
+   * @brief Write a matrix to a binary file.
+   *
+   * @param dist            The matrix to write.
+   * @param path            The file to write.
+   * @param singlePrecision Tell if values should be stored as floats.
+   * @throw IOException If the file can not be written.
+   */
+  static void write(const DistanceMatrix& dist, const std::string& path, bool singlePrecision = false);
+
+  /**
+   * @brief Map a binary file in memory.
+   *
+   * Opening is immediate whatever the size of the file, and values are only
+   * loaded when accessed. The returned matrix is read-only, and keeps the file
+   * mapped as long as it (or one of its copies) exists.
+   *
+   * @param path The file to map.
+   * @return A read-only matrix, in LOWER_TRIANGLE or LOWER_TRIANGLE_FLOAT storage.
+   * @throw IOException If the file can not be read or is not a valid distance matrix file.
+   */
+  static std::unique_ptr<const DistanceMatrix> map(const std::string& path);
+
+  /**
+   * @brief Read a binary file in memory.
+   *
+   * @param path The file to read.
+   * @return A matrix in LOWER_TRIANGLE or LOWER_TRIANGLE_FLOAT storage.
+   * @throw IOException If the file can not be read or is not a valid distance matrix file.
+   */
+  static std::unique_ptr<DistanceMatrix> read(const std::string& path);
+
+  /**
+   * @return The size of the file header, names included, padded to a multiple of 8 bytes.
+   */
+  static uint64_t getDataOffset(const std::vector<std::string>& names);
+};
+
+/**
+ * @brief Write a binary distance matrix file by parts.
+ *
+ * The file is created with its final size, and distances can then be
+ * written in any order, for instance tile by tile by a distance engine
+ * when the whole matrix does not fit in memory. Values not written are 0.
+ * Writes are serialized, so that several threads can share the writer.
+ *
+ * @see DistanceMatrixFile
+ */
+class DistanceMatrixFileWriter
+{
+private:
+  std::string path_;
+  std::ofstream output_;
+  std::mutex mutex_;
+  size_t n_;
+  bool singlePrecision_;
+  uint64_t diagonalOffset_;
+  uint64_t lowerOffset_;
+  std::vector<float> floatBuffer_;
+
+public:
+  /**
+   * @brief Create a new file.
+   *
+   * @param path            The file to write.
+   * @param names           The names of the taxa.
+   * @param singlePrecision Tell if values should be stored as floats.
+   * @throw IOException If the file can not be created.
+   */
+  DistanceMatrixFileWriter(const std::string& path, const std::vector<std::string>& names, bool singlePrecision = false);
+
+  virtual ~DistanceMatrixFileWriter();
+
+private:
+  DistanceMatrixFileWriter(const DistanceMatrixFileWriter&) = delete;
+  DistanceMatrixFileWriter& operator=(const DistanceMatrixFileWriter&) = delete;
+
+public:
+  /**
+   * @return The number of taxa.
+   */
+  size_t size() const { return n_; }
+
+  /**
+   * @brief Set a diagonal value.
+   *
+   * @throw IOException If the file is closed.
+   */
+  void setDiagonal(size_t i, double value);
+
+  /**
+   * @brief Write consecutive distances of a row of the lower triangle.
+   *
+   * @param i      The row.
+   * @param jBegin The first column, with jBegin + count <= i.
+   * @param values The distances (i, jBegin), (i, jBegin + 1), ..., (i, jBegin + count - 1).
+   * @param count  The number of values.
+   * @throw IndexOutOfBoundsException If the values are not in the strict lower triangle.
+   * @throw IOException If the file is closed.
+   */
+  void writeRow(size_t i, size_t jBegin, const double* values, size_t count);
+
+  /**
+   * @brief Write a tile of distances.
+   *
+   * Only the values of the tile in the strict lower triangle and on the
+   * diagonal are written, the others being symmetric.
+   *
+   * @param iBegin The row of the first line of the tile.
+   * @param jBegin The column of the first column of the tile.
+   * @param tile   The distances (iBegin + k, jBegin + l).
+   * @throw IndexOutOfBoundsException If the tile is not in the matrix.
+   * @throw IOException If the file is closed.
+   */
+  void writeTile(size_t iBegin, size_t jBegin, const Matrix<double>& tile);
+
+  /**
+   * @brief Flush and close the file. Nothing can be written afterwards.
+   *
+   * @throw IOException If an error occured while writing.
+   */
+  void close();
+
+private:
+  void writeRow_(size_t i, size_t jBegin, const double* values, size_t count);
+
+  void checkOpen_(const std::string& method) const
+  {
+    if (!output_.is_open())
+      throw IOException(method + " File " + path_ + " is closed.");
+  }
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_IO_DISTANCEMATRIXFILE_H
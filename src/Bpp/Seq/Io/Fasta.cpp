@@ -79,7 +79,23 @@ bool Fasta::nextSequence(istream& input, Sequence& seq) const
     seq.setComments(seqcmts);
   }
   seq.setName(seqname);
-  seq.setContent(content);
+  ScopedTimer timer("io.encode_symbols");
+  if (ingestPolicy_.getInvalidSymbolAction() == SymbolEncoder::THROW_ON_INVALID)
+    seq.setContent(content);
+  else
+  {
+    // Invalid characters are replaced while encoding:
+    SymbolEncoder encoder = ingestPolicy_.createEncoder(seq.getAlphabet());
+    vector<int> states;
+    states.reserve(content.size() / encoder.getCodingSize());
+    string pending;
+    vector<SymbolEncoder::InvalidSymbol> invalid;
+    encoder.encode(content.data(), content.data() + content.size(), states, pending, invalid);
+    if (!pending.empty())
+      throw BadCharException(pending, "Fasta::nextSequence. Incomplete state at the end of sequence " + seqname + ".", seq.getAlphabet());
+    ingestPolicy_.record(seqname, invalid);
+    seq.setContent(states);
+  }
   return res;
 }
 
@@ -13,6 +13,7 @@
 #include "AbstractISequence.h"
 #include "AbstractOSequence.h"
 #include "ISequenceStream.h"
+#include "IngestPolicy.h"
 #include "OSequenceStream.h"
 #include "SequenceFileIndex.h"
 
@@ -38,6 +39,7 @@ protected:
   bool checkNames_;          // If names must be checked in container
   bool extended_;            // If using HUPO-PSI extensions
   bool strictNames_;         // If name is between '>' and first space
+  IngestPolicy ingestPolicy_; // How invalid characters are handled (input only)
 
 public:
   /**
@@ -48,7 +50,7 @@ public:
    * @param extended Tells if we should read general comments and sequence comments in HUPO-PSI format.
    * @param strictSequenceNames Tells if the sequence names should be restricted to the characters between '>' and the first blank one.
    */
-  Fasta(unsigned int charsByLine = 100, bool checkSequenceNames = true, bool extended = false, bool strictSequenceNames = false) : charsByLine_(charsByLine), checkNames_(checkSequenceNames), extended_(extended), strictNames_(strictSequenceNames) {}
+  Fasta(unsigned int charsByLine = 100, bool checkSequenceNames = true, bool extended = false, bool strictSequenceNames = false) : charsByLine_(charsByLine), checkNames_(checkSequenceNames), extended_(extended), strictNames_(strictSequenceNames), ingestPolicy_() {}
 
   // Class destructor
   virtual ~Fasta() {}
@@ -139,6 +141,18 @@ public:
    */
   void strictNames(bool yn) { strictNames_ = yn; }
 
+  /**
+   * @return How characters which are not part of the alphabet are handled when reading.
+   */
+  const IngestPolicy& getIngestPolicy() const { return ingestPolicy_; }
+
+  /**
+   * @brief Set how characters which are not part of the alphabet are handled when reading.
+   *
+   * @param policy The policy to use (strict by default).
+   */
+  void setIngestPolicy(const IngestPolicy& policy) { ingestPolicy_ = policy; }
+
   /**
    * @brief The SequenceFileIndex class for Fasta format
    * @author Sylvain Gaillard
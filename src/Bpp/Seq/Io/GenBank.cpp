@@ -7,6 +7,9 @@
 
 #include "GenBank.h"
 
+// From the STL:
+#include <fstream>
+
 using namespace bpp;
 using namespace std;
 
@@ -19,37 +22,302 @@ void GenBank::appendSequencesFromStream(std::istream& input, SequenceContainerIn
     throw IOException ("GenBank::read: fail to open file");
   }
 
-  string temp, name, sequence = "";  // Initialization
   auto alphaPtr = vsc.getAlphabet();
+  SymbolEncoder encoder(alphaPtr);
+  Record record;
+  vector<int> content;
+
+  // Main loop : for all records
+  while (readRecord_(input, encoder, content, record, false))
+  {
+    if (content.empty())
+      continue; // No ORIGIN block.
+    if (record.getAccession() == "")
+      throw Exception("GenBank::read(). Sequence with no ACCESSION number!");
+    auto seq = make_unique<Sequence>(record.getAccession(), content, alphaPtr);
+    vsc.addSequence(seq->getName(), seq);
+  }
+}
+
+/****************************************************************************************/
+
+bool GenBank::nextSequence(std::istream& input, Sequence& seq) const
+{
+  Record record;
+  SymbolEncoder encoder(seq.getAlphabet());
+  vector<int> content;
+  if (!readRecord_(input, encoder, content, record, false))
+    return false;
+  if (record.getAccession() == "")
+    throw Exception("GenBank::nextSequence(). Sequence with no ACCESSION number!");
+  seq.setName(record.getAccession());
+  seq.setContent(content);
+  return true;
+}
+
+/****************************************************************************************/
+
+bool GenBank::nextRecord(std::istream& input, Sequence& seq, Record& record) const
+{
+  SymbolEncoder encoder(seq.getAlphabet());
+  vector<int> content;
+  if (!readRecord_(input, encoder, content, record, true))
+    return false;
+  if (record.getAccession() == "")
+    throw Exception("GenBank::nextRecord(). Sequence with no ACCESSION number!");
+  seq.setName(record.getAccession());
+  seq.setContent(content);
+  return true;
+}
+
+/****************************************************************************************/
 
-  // Main loop : for all file lines
-  while (!input.eof())
+bool GenBank::readRecord_(std::istream& input, const SymbolEncoder& encoder, std::vector<int>& content, Record& record, bool keepFeatures) const
+{
+  if (!input)
+    throw IOException("GenBank::nextSequence: can't read from istream input");
+
+  enum Section { OTHER, DEFINITION, FEATURES, ORIGIN };
+  Section section = OTHER;
+  record.clear();
+  content.clear();
+  string line;
+  string pending;
+  bool found = false;
+  streamoff featuresSize = 0;
+  // Lines are encoded one by one, their encoding time is reported once per record:
+  CumulativeTimer encodeTimer("io.encode_symbols");
+  while (getline(input, line, '\n'))
   {
-    getline(input, temp, '\n');  // Copy current line in temporary string
+    if (!found)
+    {
+      // Skip blank lines between records:
+      if (TextTools::isEmpty(line))
+        continue;
+      found = true;
+    }
+    if (line.compare(0, 2, "//") == 0)
+      break; // End of record.
 
-    if (temp.size() >= 9 && temp.substr(0, 9) == "ACCESSION")
+    if (section == ORIGIN)
     {
-      name = TextTools::removeSurroundingWhiteSpaces(temp.substr(10));
-      StringTokenizer st(name, " ");
-      name = st.nextToken();
-      // cout << name << endl;
+      // Skip the position at the beginning of the line, the encoder ignores white spaces:
+      const char* p = line.data();
+      const char* end = p + line.size();
+      while (p < end && ((*p >= '0' && *p <= '9') || TextTools::isWhiteSpaceCharacter(*p)))
+      {
+        ++p;
+      }
+      encodeTimer.start();
+      encoder.encode(p, end, content, pending);
+      encodeTimer.stop();
+      continue;
     }
-    if (temp.size() >= 6 && temp.substr(0, 6) == "ORIGIN")
+
+    if (!line.empty() && !TextTools::isWhiteSpaceCharacter(line[0]))
     {
-      sequence = "";
-      getline(input, temp, '\n');  // Copy current line in temporary string
-      while (!input.eof() && temp.size() > 2 && temp.substr(0, 2) != "//")
+      // A new keyword:
+      if (section == FEATURES && keepFeatures && record.featuresBegin_ != streampos(-1))
+        record.featuresEnd_ = record.featuresBegin_ + featuresSize;
+      section = OTHER;
+      if (line.compare(0, 5, "LOCUS") == 0)
+      {
+        record.locus_ = TextTools::removeSurroundingWhiteSpaces(line.substr(5));
+        StringTokenizer st(record.locus_, " ");
+        string previous;
+        while (st.hasMoreToken())
+        {
+          string token = st.nextToken();
+          if ((token == "bp" || token == "aa") && TextTools::isDecimalInteger(previous))
+            record.length_ = TextTools::to<size_t>(previous);
+          previous = token;
+        }
+      }
+      else if (line.compare(0, 9, "ACCESSION") == 0)
+      {
+        StringTokenizer st(line.substr(9), " ");
+        if (st.hasMoreToken())
+          record.accession_ = st.nextToken();
+      }
+      else if (line.compare(0, 10, "DEFINITION") == 0)
+      {
+        record.definition_ = TextTools::removeSurroundingWhiteSpaces(line.substr(10));
+        section = DEFINITION;
+      }
+      else if (line.compare(0, 8, "FEATURES") == 0)
+      {
+        section = FEATURES;
+        if (keepFeatures)
+          record.featuresBegin_ = input.tellg();
+      }
+      else if (line.compare(0, 6, "ORIGIN") == 0)
       {
-        sequence += TextTools::removeWhiteSpaces(temp.substr(10));
-        getline(input, temp, '\n');  // Copy current line in temporary string
+        section = ORIGIN;
+        // The length is given in characters:
+        content.reserve(record.length_ / encoder.getCodingSize());
       }
-      if (name == "")
-        throw Exception("GenBank::read(). Sequence with no ACCESSION number!");
-      auto seq = make_unique<Sequence>(name, sequence, alphaPtr);
-      vsc.addSequence(seq->getName(), seq);
-      name = "";
+    }
+    else if (section == DEFINITION)
+    {
+      record.definition_ += " " + TextTools::removeSurroundingWhiteSpaces(line);
+    }
+    else if (section == FEATURES && keepFeatures)
+    {
+      // Features are stored as is, and only parsed on request:
+      record.features_ += line;
+      record.features_ += '\n';
+      featuresSize += static_cast<streamoff>(line.size() + 1);
     }
   }
+  if (section == FEATURES && keepFeatures && record.featuresBegin_ != streampos(-1))
+    record.featuresEnd_ = record.featuresBegin_ + featuresSize;
+  if (!pending.empty())
+    throw BadCharException(pending, "GenBank::nextSequence. Incomplete state at the end of sequence " + record.accession_ + ".", encoder.getAlphabet());
+  return found;
+}
+
+/****************************************************************************************/
+
+void GenBank::Record::clear()
+{
+  locus_ = "";
+  accession_ = "";
+  definition_ = "";
+  length_ = 0;
+  features_.clear();
+  featuresBegin_ = -1;
+  featuresEnd_ = -1;
+}
+
+/****************************************************************************************/
+
+std::vector<GenBank::Feature> GenBank::Record::parseFeatures() const
+{
+  vector<Feature> features;
+  bool inQualifier = false;
+  StringTokenizer lines(features_, "\n", true, false);
+  while (lines.hasMoreToken())
+  {
+    const string& line = lines.nextToken();
+    if (line.size() > 5 && !TextTools::isWhiteSpaceCharacter(line[5]))
+    {
+      // A new feature: key in columns 6-20, location from column 22.
+      features.push_back(Feature());
+      features.back().key = TextTools::removeSurroundingWhiteSpaces(line.substr(5, 16));
+      if (line.size() > 21)
+        features.back().location = TextTools::removeSurroundingWhiteSpaces(line.substr(21));
+      inQualifier = false;
+      continue;
+    }
+    if (features.empty())
+      throw Exception("GenBank::Record::parseFeatures. Qualifier found before the first feature key.");
+    string text = TextTools::removeSurroundingWhiteSpaces(line);
+    if (text.empty())
+      continue;
+    Feature& feature = features.back();
+    if (text[0] == '/')
+    {
+      // A new qualifier:
+      string::size_type eq = text.find('=');
+      if (eq == string::npos)
+        feature.qualifiers.push_back(make_pair(text.substr(1), string()));
+      else
+        feature.qualifiers.push_back(make_pair(text.substr(1, eq - 1), text.substr(eq + 1)));
+      inQualifier = true;
+    }
+    else if (inQualifier)
+    {
+      // Protein translations are split without spaces:
+      auto& qualifier = feature.qualifiers.back();
+      qualifier.second += (qualifier.first == "translation" ? "" : " ") + text;
+    }
+    else
+    {
+      feature.location += text;
+    }
+  }
+
+  // Remove quotes around values:
+  for (auto& feature : features)
+  {
+    for (auto& qualifier : feature.qualifiers)
+    {
+      string& value = qualifier.second;
+      if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+        value = value.substr(1, value.size() - 2);
+    }
+  }
+  return features;
+}
+
+/****************************************************************************************/
+
+// FileIndex class
+
+void GenBank::FileIndex::scan_(std::istream& input)
+{
+  string line;
+  string id;
+  uint64_t pos = 0;
+  uint64_t start = 0;
+  uint64_t sequenceLength = 0;
+  bool inRecord = false;
+  bool inOrigin = false;
+  while (getline(input, line, '\n'))
+  {
+    uint64_t lineSize = line.size() + (input.eof() ? 0 : 1);
+    if (!inRecord)
+    {
+      if (TextTools::isEmpty(line))
+      {
+        pos += lineSize;
+        continue;
+      }
+      inRecord = true;
+      inOrigin = false;
+      start = pos;
+      id = "";
+      sequenceLength = 0;
+    }
+    if (line.compare(0, 2, "//") == 0)
+    {
+      if (id == "")
+        throw Exception("GenBank::FileIndex::build. Record with no ACCESSION number at offset " + TextTools::toString(start) + ".");
+      addEntry_(id, start, pos + lineSize - start, sequenceLength);
+      inRecord = false;
+    }
+    else if (inOrigin)
+    {
+      for (char c : line)
+      {
+        if (!(c >= '0' && c <= '9') && !TextTools::isWhiteSpaceCharacter(c))
+          ++sequenceLength;
+      }
+    }
+    else if (line.compare(0, 9, "ACCESSION") == 0)
+    {
+      StringTokenizer st(line.substr(9), " ");
+      if (st.hasMoreToken())
+        id = st.nextToken();
+    }
+    else if (line.compare(0, 6, "ORIGIN") == 0)
+    {
+      inOrigin = true;
+    }
+    pos += lineSize;
+  }
+  if (inRecord && id != "")
+    addEntry_(id, start, pos - start, sequenceLength); // Last record with no terminating '//'.
+}
+
+void GenBank::FileIndex::getSequence(const std::string& seqid, Sequence& seq, const std::string& path) const
+{
+  GenBank gb;
+  streampos seqPos = getSequencePosition(seqid);
+  std::ifstream input(path.c_str());
+  input.seekg(seqPos);
+  gb.nextSequence(input, seq);
+  input.close();
 }
 
 /****************************************************************************************/
@@ -9,18 +9,144 @@
 #include "../Container/SequenceContainer.h"
 #include "../Container/VectorSequenceContainer.h"
 #include "../Sequence.h"
+#include "../SymbolEncoder.h"
 #include "AbstractISequence.h"
+#include "AbstractSequenceFileIndex.h"
+#include "ISequenceStream.h"
+
+// From the STL:
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace bpp
 {
 /**
  * @brief The GenBank sequence file format.
  *
- * For now, only read raw sequences. Features are not yet supported.
+ * Sequences are read from the ORIGIN block of each record, and named according to
+ * their accession number. Records can be read one at a time with the ISequenceStream
+ * interface, or with nextRecord, which also gives access to the header lines and to
+ * the features of the record. Features are stored as raw text and only parsed on
+ * request, so that large files can be scanned without paying for the annotation.
  */
 class GenBank :
-  public AbstractISequence
+  public AbstractISequence,
+  public virtual ISequenceStream
 {
+public:
+  /**
+   * @brief A feature of a GenBank record.
+   */
+  struct Feature
+  {
+    std::string key;
+    std::string location;
+    std::vector< std::pair<std::string, std::string>> qualifiers;
+
+    Feature() : key(), location(), qualifiers() {}
+  };
+
+  /**
+   * @brief The annotation of a GenBank record.
+   */
+  class Record
+  {
+private:
+    std::string locus_;
+    std::string accession_;
+    std::string definition_;
+    size_t length_;
+    std::string features_;
+    std::streampos featuresBegin_;
+    std::streampos featuresEnd_;
+
+public:
+    Record() :
+      locus_(),
+      accession_(),
+      definition_(),
+      length_(0),
+      features_(),
+      featuresBegin_(-1),
+      featuresEnd_(-1)
+    {}
+
+    virtual ~Record() {}
+
+public:
+    /**
+     * @return The content of the LOCUS line, without the keyword.
+     */
+    const std::string& getLocus() const { return locus_; }
+
+    /**
+     * @return The first accession number of the record.
+     */
+    const std::string& getAccession() const { return accession_; }
+
+    const std::string& getDefinition() const { return definition_; }
+
+    /**
+     * @return The sequence length given in the LOCUS line (0 if not available).
+     */
+    size_t getLength() const { return length_; }
+
+    bool hasFeatures() const { return !features_.empty(); }
+
+    /**
+     * @return The raw lines of the FEATURES block, header line excluded.
+     */
+    const std::string& getRawFeatures() const { return features_; }
+
+    /**
+     * @return The position of the FEATURES block in the input stream, as a [begin, end) range.
+     * Positions are -1 if the stream does not support positioning.
+     */
+    std::pair<std::streampos, std::streampos> getFeaturesRange() const
+    {
+      return std::make_pair(featuresBegin_, featuresEnd_);
+    }
+
+    /**
+     * @brief Parse the FEATURES block.
+     *
+     * Multi-line locations and qualifier values are joined, and quotes surrounding
+     * qualifier values are removed.
+     *
+     * @return The list of features, in file order.
+     */
+    std::vector<Feature> parseFeatures() const;
+
+    void clear();
+
+    friend class GenBank;
+  };
+
+  /**
+   * @brief The SequenceFileIndex class for GenBank format.
+   *
+   * Records are identified by their accession number. Offsets point to the
+   * beginning of the records, and sequence lengths are the number of characters
+   * in the ORIGIN blocks.
+   */
+  class FileIndex :
+    public AbstractSequenceFileIndex
+  {
+public:
+    FileIndex() {}
+    virtual ~FileIndex() {}
+
+    /**
+     * @brief Get a sequence given its ID.
+     */
+    void getSequence(const std::string& seqid, Sequence& seq, const std::string& path) const;
+
+protected:
+    void scan_(std::istream& input) override;
+  };
+
 public:
   /**
    * @brief Build a new GenBank object.
@@ -35,20 +161,52 @@ public:
    *
    * @{
    */
-  void appendSequencesFromStream(std::istream& input, SequenceContainerInterface& sc) const;
+  void appendSequencesFromStream(std::istream& input, SequenceContainerInterface& sc) const override;
   /** @} */
 
+  /**
+   * @name The ISequenceStream interface.
+   *
+   * @{
+   */
+  bool nextSequence(std::istream& input, Sequence& seq) const override;
+  /** @} */
+
+  /**
+   * @brief Read the next record of a stream.
+   *
+   * @param input The stream to read.
+   * @param seq The sequence to fill.
+   * @param record The record annotation to fill.
+   * @return true if a record was read or false if the end of the stream was reached.
+   * @throw Exception If the record has no accession number, or if the sequence contains invalid characters.
+   */
+  bool nextRecord(std::istream& input, Sequence& seq, Record& record) const;
+
   /**
    * @name The IOSequence interface.
    *
    * @{
    */
-  const std::string getFormatName() const { return "GenBank file"; }
-  const std::string getFormatDescription() const
+  const std::string getFormatName() const override { return "GenBank file"; }
+  const std::string getFormatDescription() const override
   {
     return "Sequences following the GenBank data base format.";
   }
   /** @} */
+
+private:
+  /**
+   * @brief Read one record, up to and including the '//' line.
+   *
+   * @param input The stream to read.
+   * @param encoder The encoder used to convert the ORIGIN block.
+   * @param content The states of the sequence (output).
+   * @param record The record annotation (output). Features are only stored if keepFeatures is true.
+   * @param keepFeatures Tell if the FEATURES block should be stored.
+   * @return true if a record was found.
+   */
+  bool readRecord_(std::istream& input, const SymbolEncoder& encoder, std::vector<int>& content, Record& record, bool keepFeatures) const;
 };
 } // end of namespace bpp.
 #endif // BPP_SEQ_IO_GENBANK_H
@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_IO_INGESTPOLICY_H
+#define BPP_SEQ_IO_INGESTPOLICY_H
+
+#include "../SymbolEncoder.h"
+#include "IngestReport.h"
+
+// From the STL:
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief How sequence readers handle characters which are not part of the alphabet.
+ *
+ * By default, readers are strict and throw a BadCharException. With a permissive
+ * policy, invalid characters are replaced by the unknown or gap state while
+ * encoding, and optionally recorded in an IngestReport shared with the caller:
+ * @code
+ * auto report = std::make_shared<IngestReport>();
+ * Fasta fasta;
+ * fasta.setIngestPolicy(IngestPolicy(SymbolEncoder::REPLACE_BY_UNKNOWN, report));
+ * auto sequences = fasta.readSequences("messy.fasta", AlphabetTools::DNA_ALPHABET);
+ * @endcode
+ */
+class IngestPolicy
+{
+private:
+  SymbolEncoder::InvalidSymbolAction action_;
+  std::shared_ptr<IngestReport> report_;
+
+public:
+  /**
+   * @param action What to do with invalid characters.
+   * @param report Where to record replaced characters (optional).
+   */
+  IngestPolicy(SymbolEncoder::InvalidSymbolAction action = SymbolEncoder::THROW_ON_INVALID, std::shared_ptr<IngestReport> report = nullptr) :
+    action_(action), report_(report) {}
+
+  virtual ~IngestPolicy() {}
+
+public:
+  SymbolEncoder::InvalidSymbolAction getInvalidSymbolAction() const { return action_; }
+
+  std::shared_ptr<IngestReport> getReport() const { return report_; }
+
+  /**
+   * @return A symbol encoder applying this policy.
+   */
+  SymbolEncoder createEncoder(std::shared_ptr<const Alphabet> alphabet) const
+  {
+    return SymbolEncoder(alphabet, action_);
+  }
+
+  /**
+   * @brief Record the invalid symbols of a sequence in the report, if any.
+   */
+  void record(const std::string& sequenceName, const std::vector<SymbolEncoder::InvalidSymbol>& invalid) const
+  {
+    if (report_)
+      report_->add(sequenceName, invalid);
+  }
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_IO_INGESTPOLICY_H
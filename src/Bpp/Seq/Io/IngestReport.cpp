@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "IngestReport.h"
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+void IngestReport::add(const std::string& sequenceName, const std::vector<SymbolEncoder::InvalidSymbol>& invalid)
+{
+  if (invalid.empty())
+    return;
+  lock_guard<mutex> lock(mutex_);
+  names_.push_back(sequenceName);
+  for (const auto& symbol : invalid)
+  {
+    positions_.push_back(symbol.position);
+    characters_ += symbol.character;
+  }
+  offsets_.push_back(positions_.size());
+}
+
+/******************************************************************************/
+
+size_t IngestReport::getNumberOfSequences() const
+{
+  lock_guard<mutex> lock(mutex_);
+  return names_.size();
+}
+
+/******************************************************************************/
+
+size_t IngestReport::getNumberOfInvalidSymbols() const
+{
+  lock_guard<mutex> lock(mutex_);
+  return positions_.size();
+}
+
+/******************************************************************************/
+
+std::string IngestReport::getSequenceName(size_t i) const
+{
+  lock_guard<mutex> lock(mutex_);
+  if (i >= names_.size())
+    throw IndexOutOfBoundsException("IngestReport::getSequenceName.", i, 0, names_.size() - 1);
+  return names_[i];
+}
+
+/******************************************************************************/
+
+std::vector<SymbolEncoder::InvalidSymbol> IngestReport::getInvalidSymbols(size_t i) const
+{
+  lock_guard<mutex> lock(mutex_);
+  if (i >= names_.size())
+    throw IndexOutOfBoundsException("IngestReport::getInvalidSymbols.", i, 0, names_.size() - 1);
+  vector<SymbolEncoder::InvalidSymbol> invalid;
+  for (size_t j = offsets_[i]; j < offsets_[i + 1]; ++j)
+  {
+    SymbolEncoder::InvalidSymbol symbol = { positions_[j], characters_[j] };
+    invalid.push_back(symbol);
+  }
+  return invalid;
+}
+
+/******************************************************************************/
+
+void IngestReport::clear()
+{
+  lock_guard<mutex> lock(mutex_);
+  names_.clear();
+  offsets_.assign(1, 0);
+  positions_.clear();
+  characters_.clear();
+}
+
+/******************************************************************************/
@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_IO_INGESTREPORT_H
+#define BPP_SEQ_IO_INGESTREPORT_H
+
+#include <Bpp/Exceptions.h>
+
+#include "../SymbolEncoder.h"
+
+// From the STL:
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Collect the invalid symbols replaced while reading sequences.
+ *
+ * Only sequences with at least one replaced symbol are recorded. Records
+ * are stored in flat arrays (one name per sequence, then one position and
+ * one character per symbol), so that large files with many errors can be
+ * reported without creating one object per error.
+ *
+ * Records can be added concurrently by several threads.
+ *
+ * @see IngestPolicy
+ */
+class IngestReport
+{
+private:
+  mutable std::mutex mutex_;
+  std::vector<std::string> names_;
+  std::vector<size_t> offsets_;   // Index of the first symbol of each sequence, plus a final one.
+  std::vector<size_t> positions_;
+  std::string characters_;
+
+public:
+  IngestReport() :
+    mutex_(),
+    names_(),
+    offsets_(1, 0),
+    positions_(),
+    characters_()
+  {}
+
+  virtual ~IngestReport() {}
+
+private:
+  IngestReport(const IngestReport&) = delete;
+  IngestReport& operator=(const IngestReport&) = delete;
+
+public:
+  /**
+   * @brief Record the invalid symbols of a sequence.
+   *
+   * Nothing is done if the list is empty.
+   *
+   * @param sequenceName The name of the sequence.
+   * @param invalid      The replaced symbols, as reported by SymbolEncoder.
+   */
+  void add(const std::string& sequenceName, const std::vector<SymbolEncoder::InvalidSymbol>& invalid);
+
+  /**
+   * @return The number of sequences with invalid symbols.
+   */
+  size_t getNumberOfSequences() const;
+
+  /**
+   * @return The total number of replaced symbols.
+   */
+  size_t getNumberOfInvalidSymbols() const;
+
+  /**
+   * @return The name of the i-th sequence with invalid symbols.
+   */
+  std::string getSequenceName(size_t i) const;
+
+  /**
+   * @return The replaced symbols of the i-th sequence with invalid symbols.
+   */
+  std::vector<SymbolEncoder::InvalidSymbol> getInvalidSymbols(size_t i) const;
+
+  void clear();
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_IO_INGESTREPORT_H
@@ -0,0 +1,143 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Text/TextTools.h>
+
+#include "InterleavedBlockParser.h"
+
+// From the STL:
+#include <algorithm>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+InterleavedBlockParser::InterleavedBlockParser(std::shared_ptr<const Alphabet> alphabet, size_t expectedLength, const IngestPolicy& policy) :
+  policy_(policy),
+  encoder_(policy.createEncoder(alphabet)),
+  names_(),
+  contents_(),
+  pending_(),
+  invalid_(),
+  index_(),
+  expectedLength_(expectedLength),
+  cursor_(0),
+  encodeTimer_("io.encode_symbols")
+{}
+
+/******************************************************************************/
+
+void InterleavedBlockParser::setExpectedLength(size_t length)
+{
+  expectedLength_ = length;
+  for (auto& content : contents_)
+  {
+    content.reserve(expectedLength_);
+  }
+}
+
+/******************************************************************************/
+
+void InterleavedBlockParser::estimateExpectedLength(std::istream& input)
+{
+  if (expectedLength_ > 0 || names_.size() == 0)
+    return;
+  streampos current = input.tellg();
+  if (current == streampos(-1))
+    return;
+  input.seekg(0, ios::end);
+  streampos last = input.tellg();
+  // Reset the error state of a failed seek, so that the stream can still be read:
+  input.clear();
+  input.seekg(current);
+  if (last == streampos(-1) || last < current)
+    return;
+  // This is an upper bound, as names and separators are included:
+  size_t remaining = static_cast<size_t>(last - current) / names_.size() / encoder_.getCodingSize();
+  setExpectedLength(contents_[0].size() + remaining);
+}
+
+/******************************************************************************/
+
+size_t InterleavedBlockParser::addRow(const std::string& name, const char* begin, const char* end)
+{
+  size_t row = names_.size();
+  names_.push_back(name);
+  index_[name] = row;
+  contents_.push_back(vector<int>());
+  contents_.back().reserve(expectedLength_);
+  pending_.push_back("");
+  invalid_.push_back(vector<SymbolEncoder::InvalidSymbol>());
+  encodeTimer_.start();
+  encoder_.encode(begin, end, contents_.back(), pending_.back(), invalid_.back());
+  encodeTimer_.stop();
+  cursor_ = row;
+  return row;
+}
+
+/******************************************************************************/
+
+void InterleavedBlockParser::appendToRow(size_t row, const char* begin, const char* end)
+{
+  if (row >= names_.size())
+    throw IndexOutOfBoundsException("InterleavedBlockParser::appendToRow.", row, 0, names_.size() - 1);
+  encodeTimer_.start();
+  encoder_.encode(begin, end, contents_[row], pending_[row], invalid_[row]);
+  encodeTimer_.stop();
+  cursor_ = row;
+}
+
+/******************************************************************************/
+
+size_t InterleavedBlockParser::findRow(const std::string& name)
+{
+  if (names_.size() == 0)
+    return 0;
+  size_t next = (cursor_ + 1) % names_.size();
+  if (names_[next] == name)
+    return next;
+  auto it = index_.find(name);
+  if (it == index_.end())
+    return names_.size();
+  return it->second;
+}
+
+/******************************************************************************/
+
+void InterleavedBlockParser::flush(SequenceContainerInterface& sc)
+{
+  auto alphaPtr = encoder_.getAlphabet();
+  for (size_t i = 0; i < names_.size(); ++i)
+  {
+    if (!pending_[i].empty())
+      throw BadCharException(pending_[i], "InterleavedBlockParser::flush. Incomplete state at the end of sequence " + names_[i] + ".", alphaPtr);
+    policy_.record(names_[i], invalid_[i]);
+    auto seqPtr = make_unique<Sequence>(names_[i], contents_[i], alphaPtr);
+    vector<int>().swap(contents_[i]);
+    sc.addSequence(names_[i], seqPtr);
+  }
+  names_.clear();
+  contents_.clear();
+  pending_.clear();
+  invalid_.clear();
+  index_.clear();
+  cursor_ = 0;
+  encodeTimer_.report();
+}
+
+/******************************************************************************/
+
+bool InterleavedBlockParser::isBlank(const std::string& line, size_t length)
+{
+  size_t n = std::min(length, line.size());
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (!TextTools::isWhiteSpaceCharacter(line[i]))
+      return false;
+  }
+  return true;
+}
+
+/******************************************************************************/
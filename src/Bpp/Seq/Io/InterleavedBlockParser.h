@@ -0,0 +1,145 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_IO_INTERLEAVEDBLOCKPARSER_H
+#define BPP_SEQ_IO_INTERLEAVEDBLOCKPARSER_H
+
+
+#include "../Container/SequenceContainer.h"
+#include "../Profiler.h"
+#include "../Sequence.h"
+#include "../SymbolEncoder.h"
+#include "IngestPolicy.h"
+
+// From the STL:
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Shared helper for readers of interleaved alignment formats (Phylip, Clustal, Stockholm).
+ *
+ * Interleaved files store the alignment as successive blocks, each block containing
+ * one line per sequence. The row layout (names and order) is learnt from the first
+ * block, then the content of each line is encoded directly into a per-row buffer of
+ * states, which is presized when the final length is known (Phylip header) or estimated.
+ * Sequence objects are only built once, at the end of the parsing.
+ *
+ * Lines are given as raw character ranges, so that readers can reuse a single line
+ * buffer and avoid intermediate string copies.
+ *
+ * Invalid characters are handled according to an IngestPolicy. Replaced symbols
+ * are collected per row and recorded when the sequences are built.
+ *
+ * The time spent encoding lines is cumulated, and reported to the profiler as
+ * a single "io.encode_symbols" call when the sequences are built.
+ */
+class InterleavedBlockParser
+{
+private:
+  IngestPolicy policy_;
+  SymbolEncoder encoder_;
+  std::vector<std::string> names_;
+  std::vector< std::vector<int>> contents_;
+  std::vector<std::string> pending_;
+  std::vector< std::vector<SymbolEncoder::InvalidSymbol>> invalid_;
+  std::unordered_map<std::string, size_t> index_;
+  size_t expectedLength_;
+  size_t cursor_;
+  CumulativeTimer encodeTimer_;
+
+public:
+  /**
+   * @param alphabet The alphabet to use for encoding.
+   * @param expectedLength The expected number of states per row, if known (0 otherwise).
+   * @param policy How to handle characters which are not part of the alphabet.
+   */
+  InterleavedBlockParser(std::shared_ptr<const Alphabet> alphabet, size_t expectedLength = 0, const IngestPolicy& policy = IngestPolicy());
+
+  virtual ~InterleavedBlockParser() {}
+
+public:
+  /**
+   * @return The number of rows registered so far.
+   */
+  size_t getNumberOfRows() const { return names_.size(); }
+
+  const std::string& getName(size_t row) const { return names_[row]; }
+
+  std::shared_ptr<const Alphabet> getAlphabet() const { return encoder_.getAlphabet(); }
+
+  /**
+   * @return A state already read for a given row.
+   */
+  int getState(size_t row, size_t position) const { return contents_[row][position]; }
+
+  /**
+   * @return The number of states already read for a given row.
+   */
+  size_t getRowLength(size_t row) const { return contents_[row].size(); }
+
+  /**
+   * @brief Set the expected number of states per row, used to presize row buffers.
+   */
+  void setExpectedLength(size_t length);
+
+  /**
+   * @brief Estimate the expected row length from the number of remaining bytes in a stream.
+   *
+   * This is used when the format does not give the alignment length. The stream
+   * position is left unchanged. Nothing is done if the stream is not seekable.
+   *
+   * @param input The input stream, positioned after the first block.
+   */
+  void estimateExpectedLength(std::istream& input);
+
+  /**
+   * @brief Register a new row (first block).
+   *
+   * @param name The sequence name.
+   * @param begin Start of the row content.
+   * @param end End of the row content (excluded).
+   * @return The row index.
+   */
+  size_t addRow(const std::string& name, const char* begin, const char* end);
+
+  /**
+   * @brief Append content to an existing row.
+   */
+  void appendToRow(size_t row, const char* begin, const char* end);
+
+  /**
+   * @brief Find the row corresponding to a name.
+   *
+   * Rows are expected to come in the same order in every block, so the lookup first
+   * checks the row following the previously found one, and falls back to a hash lookup.
+   *
+   * @param name The name to look for.
+   * @return The row index, or getNumberOfRows() if the name is unknown.
+   */
+  size_t findRow(const std::string& name);
+
+  /**
+   * @brief Build the sequences and add them to a container.
+   *
+   * Row buffers are released as soon as the corresponding sequence is created,
+   * and replaced symbols are recorded according to the ingest policy.
+   *
+   * @param sc The container to fill.
+   * @throw BadCharException If a row ends with an incomplete state.
+   */
+  void flush(SequenceContainerInterface& sc);
+
+  /**
+   * @brief Tell if the beginning of a line only contains white spaces.
+   *
+   * @param line The line to check.
+   * @param length The number of characters to check (the whole line if shorter).
+   */
+  static bool isBlank(const std::string& line, size_t length);
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_IO_INTERLEAVEDBLOCKPARSER_H
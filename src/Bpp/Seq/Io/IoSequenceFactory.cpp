@@ -2,6 +2,11 @@
 //
 // SPDX-License-Identifier: CECILL-2.1
 
+#include <Bpp/Text/StringTokenizer.h>
+#include <Bpp/Text/TextTools.h>
+
+#include "../Alphabet/AlphabetTools.h"
+#include "../Alphabet/BinaryAlphabet.h"
 #include "Clustal.h"
 #include "Dcse.h"
 #include "Fasta.h"
@@ -10,6 +15,12 @@
 #include "Mase.h"
 #include "NexusIoSequence.h"
 #include "Phylip.h"
+#include "NumberScanner.h"
+#include "Stockholm.h"
+
+// From the STL:
+#include <fstream>
+#include <vector>
 
 using namespace bpp;
 using namespace std;
@@ -24,6 +35,12 @@ const string IoSequenceFactory::PAML_FORMAT_INTERLEAVED   = "PAML I";
 const string IoSequenceFactory::PAML_FORMAT_SEQUENTIAL    = "PAML S";
 const string IoSequenceFactory::GENBANK_FORMAT            = "GenBank";
 const string IoSequenceFactory::NEXUS_FORMAT              = "Nexus";
+const string IoSequenceFactory::STOCKHOLM_FORMAT          = "Stockholm";
+const string IoSequenceFactory::PASTA_FORMAT              = "Pasta";
+const string IoSequenceFactory::FASTQ_FORMAT              = "Fastq";
+const string IoSequenceFactory::PHD_FORMAT                = "Phd";
+
+const size_t IoSequenceFactory::DETECTION_SIZE = 8192;
 
 unique_ptr<ISequence> IoSequenceFactory::createReader(const string& format)
 {
@@ -47,6 +64,8 @@ unique_ptr<ISequence> IoSequenceFactory::createReader(const string& format)
     return make_unique<GenBank>();
   else if (format == NEXUS_FORMAT)
     return make_unique<NexusIOSequence>();
+  else if (format == STOCKHOLM_FORMAT)
+    return make_unique<Stockholm>();
   else
     throw Exception("Format " + format + " is not supported for sequences input.");
 }
@@ -71,6 +90,8 @@ unique_ptr<IAlignment> IoSequenceFactory::createAlignmentReader(const string& fo
     return make_unique<Phylip>(true, true);
   else if (format == NEXUS_FORMAT)
     return make_unique<NexusIOSequence>();
+  else if (format == STOCKHOLM_FORMAT)
+    return make_unique<Stockholm>();
   else
     throw Exception("Format " + format + " is not supported for alignment input.");
 }
@@ -102,3 +123,363 @@ unique_ptr<OAlignment> IoSequenceFactory::createAlignmentWriter(const string& fo
   else
     throw Exception("Format " + format + " is not supported for output.");
 }
+
+IoSequenceFactory::DetectedFormat IoSequenceFactory::detectFormat(const string& path)
+{
+  ifstream input(path.c_str(), ios::in | ios::binary);
+  if (!input)
+    throw IOException("IoSequenceFactory::detectFormat. Can't open file " + path + ".");
+  return detectFormat(input);
+}
+
+IoSequenceFactory::DetectedFormat IoSequenceFactory::detectFormat(istream& input)
+{
+  streampos start = input.tellg();
+  if (start == streampos(-1))
+    throw IOException("IoSequenceFactory::detectFormat. Format detection requires a seekable stream.");
+  string sample(DETECTION_SIZE, '\0');
+  input.read(&sample[0], static_cast<streamsize>(DETECTION_SIZE));
+  sample.resize(static_cast<size_t>(input.gcount()));
+  bool truncated = sample.size() == DETECTION_SIZE;
+  input.clear();
+  input.seekg(start);
+
+  DetectedFormat result;
+
+  // Compressed data:
+  if (sample.compare(0, 2, "\x1f\x8b") == 0)
+    result.compression = "gzip";
+  else if (sample.compare(0, 3, "BZh") == 0)
+    result.compression = "bzip2";
+  else if (sample.compare(0, 6, string("\xfd" "7zXZ\0", 6)) == 0)
+    result.compression = "xz";
+  else if (sample.compare(0, 4, "\x28\xb5\x2f\xfd") == 0)
+    result.compression = "zstd";
+  if (result.compression != "")
+    return result;
+
+  // Split lines, the last one may be incomplete:
+  vector<string> lines;
+  string::size_type begin = 0;
+  while (begin < sample.size())
+  {
+    string::size_type end = sample.find('\n', begin);
+    if (end == string::npos)
+    {
+      if (!truncated)
+        lines.push_back(sample.substr(begin));
+      break;
+    }
+    lines.push_back(sample.substr(begin, end - begin));
+    begin = end + 1;
+  }
+  for (auto& line : lines)
+  {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+  }
+  size_t f = 0;
+  while (f < lines.size() && TextTools::isEmpty(lines[f]))
+  {
+    ++f;
+  }
+  if (f == lines.size())
+    return result;
+
+  // Index of the next non-empty line after a given one:
+  auto nextLine = [&lines](size_t i) {
+    ++i;
+    while (i < lines.size() && TextTools::isEmpty(lines[i]))
+    {
+      ++i;
+    }
+    return i;
+  };
+  auto lastToken = [](const string& line) {
+    string::size_type pos = line.find_last_of(" \t");
+    return pos == string::npos ? line : line.substr(pos + 1);
+  };
+  auto isNumeric = [](const string& line) {
+    const char* p = NumberScanner::skipWhiteSpaces(line.data(), line.data() + line.size());
+    double value;
+    return p < line.data() + line.size() && NumberScanner::scanDouble(p, line.data() + line.size(), value);
+  };
+
+  const string& first = lines[f];
+  string residues;
+  if (first.compare(0, 7, "CLUSTAL") == 0 || first.compare(0, 6, "MUSCLE") == 0)
+  {
+    result.format = CLUSTAL_FORMAT;
+    for (size_t i = f + 1; i < lines.size(); ++i)
+    {
+      if (!TextTools::isEmpty(lines[i]) && !TextTools::isWhiteSpaceCharacter(lines[i][0]))
+        residues += lastToken(lines[i]);
+    }
+  }
+  else if (first.compare(0, 11, "# STOCKHOLM") == 0)
+  {
+    result.format = STOCKHOLM_FORMAT;
+    for (size_t i = f + 1; i < lines.size(); ++i)
+    {
+      if (!TextTools::isEmpty(lines[i]) && lines[i][0] != '#' && lines[i].compare(0, 2, "//") != 0)
+        residues += lastToken(lines[i]);
+    }
+  }
+  else if (TextTools::toUpper(first).compare(0, 6, "#NEXUS") == 0)
+  {
+    result.format = NEXUS_FORMAT;
+    bool inMatrix = false;
+    for (size_t i = f + 1; i < lines.size(); ++i)
+    {
+      string line = TextTools::removeSurroundingWhiteSpaces(lines[i]);
+      if (TextTools::toUpper(line).compare(0, 6, "MATRIX") == 0)
+        inMatrix = true;
+      else if (inMatrix && line.find(';') != string::npos)
+        break;
+      else if (inMatrix && !line.empty())
+        residues += lastToken(line);
+    }
+  }
+  else if (first.compare(0, 5, "LOCUS") == 0)
+  {
+    result.format = GENBANK_FORMAT;
+    bool inOrigin = false;
+    for (size_t i = f + 1; i < lines.size(); ++i)
+    {
+      if (lines[i].compare(0, 6, "ORIGIN") == 0)
+        inOrigin = true;
+      else if (lines[i].compare(0, 2, "//") == 0)
+        inOrigin = false;
+      else if (inOrigin)
+      {
+        for (char c : lines[i])
+        {
+          if (!(c >= '0' && c <= '9') && !TextTools::isWhiteSpaceCharacter(c))
+            residues += c;
+        }
+      }
+    }
+  }
+  else if (first.compare(0, 14, "BEGIN_SEQUENCE") == 0)
+  {
+    result.format = PHD_FORMAT;
+    bool inDna = false;
+    for (size_t i = f + 1; i < lines.size(); ++i)
+    {
+      if (lines[i].compare(0, 9, "BEGIN_DNA") == 0)
+        inDna = true;
+      else if (lines[i].compare(0, 7, "END_DNA") == 0)
+        inDna = false;
+      else if (inDna && !lines[i].empty())
+        residues += lines[i][0];
+    }
+  }
+  else if (first[0] == ';')
+  {
+    result.format = MASE_FORMAT;
+    // Sequence names follow comment lines:
+    for (size_t i = f + 1; i < lines.size(); ++i)
+    {
+      if (!lines[i].empty() && lines[i][0] != ';' && lines[i - 1].compare(0, 1, ";") != 0)
+        residues += lines[i];
+    }
+  }
+  else if (first[0] == '@' && f + 2 < lines.size() && lines[f + 2].compare(0, 1, "+") == 0)
+  {
+    result.format = FASTQ_FORMAT;
+    for (size_t i = f; i + 1 < lines.size(); i += 4)
+    {
+      residues += lines[i + 1];
+    }
+  }
+  else if (first[0] == '>')
+  {
+    size_t next = nextLine(f);
+    if (next < lines.size() && isNumeric(lines[next]))
+    {
+      result.format = PASTA_FORMAT;
+      result.alphabetType = "Binary";
+    }
+    else
+    {
+      result.format = FASTA_FORMAT;
+      for (size_t i = f + 1; i < lines.size(); ++i)
+      {
+        if (lines[i].compare(0, 1, ">") != 0)
+          residues += lines[i];
+      }
+    }
+  }
+  else
+  {
+    StringTokenizer st(first, " \t");
+    vector<string> tokens;
+    while (st.hasMoreToken())
+    {
+      tokens.push_back(st.nextToken());
+    }
+    size_t next = nextLine(f);
+    if (tokens.size() >= 2 && TextTools::isDecimalInteger(tokens[0]) && TextTools::isDecimalInteger(tokens[1]))
+    {
+      if (sample.find("Helix numbering") != string::npos)
+      {
+        result.format = DCSE_FORMAT;
+        for (size_t i = next; i < lines.size(); ++i)
+        {
+          string::size_type endOfSeq = lines[i].find("     ");
+          if (endOfSeq != string::npos)
+            residues += lines[i].substr(0, endOfSeq);
+        }
+      }
+      else
+      {
+        // Phylip: names separated by two spaces (PAML) or on 10 characters (classic),
+        // sequences on one or several blocks. The first consistent layout is kept:
+        size_t nbSequences = TextTools::to<size_t>(tokens[0]);
+        size_t nbSites = TextTools::to<size_t>(tokens[1]);
+        bool found = false;
+        for (bool extended : { true, false })
+        {
+          for (bool interleaved : { true, false })
+          {
+            if (!found && checkPhylipLayout_(lines, next, nbSequences, nbSites, extended, interleaved, truncated, residues))
+            {
+              if (extended)
+                result.format = interleaved ? PAML_FORMAT_INTERLEAVED : PAML_FORMAT_SEQUENTIAL;
+              else
+                result.format = interleaved ? PHYLIP_FORMAT_INTERLEAVED : PHYLIP_FORMAT_SEQUENTIAL;
+              found = true;
+            }
+          }
+        }
+      }
+    }
+    else if (next < lines.size() && lines[next].compare(0, 1, ">") == 0)
+    {
+      // Pasta files start with the labels of the states:
+      result.format = PASTA_FORMAT;
+      residues = TextTools::removeWhiteSpaces(first);
+    }
+  }
+
+  if (result.alphabetType == "")
+    result.alphabetType = guessAlphabetType_(residues);
+  if (result.alphabetType == "DNA")
+    result.alphabet = AlphabetTools::DNA_ALPHABET;
+  else if (result.alphabetType == "RNA")
+    result.alphabet = AlphabetTools::RNA_ALPHABET;
+  else if (result.alphabetType == "Protein")
+    result.alphabet = AlphabetTools::PROTEIN_ALPHABET;
+  else if (result.alphabetType == "Binary")
+    result.alphabet = make_shared<BinaryAlphabet>();
+  return result;
+}
+
+bool IoSequenceFactory::checkPhylipLayout_(
+    const std::vector<std::string>& lines,
+    size_t first,
+    size_t nbSequences,
+    size_t nbSites,
+    bool extended,
+    bool interleaved,
+    bool truncated,
+    std::string& residues)
+{
+  // Extract the data of a row starting with a sequence name:
+  auto splitRow = [extended](const string& line, string& data) {
+    if (line.empty() || TextTools::isWhiteSpaceCharacter(line[0]))
+      return false;
+    string::size_type pos = extended ? line.find("  ") : 10;
+    if (pos == string::npos || pos >= line.size())
+      return false;
+    data = TextTools::removeWhiteSpaces(line.substr(pos));
+    return true;
+  };
+
+  string states;
+  string data;
+  size_t i = first;
+  if (interleaved)
+  {
+    size_t blockLength = 0;
+    size_t count = 0;
+    for ( ; i < lines.size() && count < nbSequences && !TextTools::isEmpty(lines[i]); ++i)
+    {
+      if (!splitRow(lines[i], data) || data.empty() || (count > 0 && data.size() != blockLength))
+        return false;
+      blockLength = data.size();
+      states += data;
+      ++count;
+    }
+    if (count == 0 || blockLength >= nbSites)
+      return false;
+    // The block must end with an empty line, followed by other blocks, or with the sample:
+    if (i < lines.size() ? count < nbSequences || !TextTools::isEmpty(lines[i]) : !truncated)
+      return false;
+  }
+  else
+  {
+    size_t count = 0;
+    while (count < nbSequences)
+    {
+      while (i < lines.size() && TextTools::isEmpty(lines[i]))
+      {
+        ++i;
+      }
+      if (i == lines.size())
+      {
+        if (!truncated)
+          return false;
+        break;
+      }
+      if (!splitRow(lines[i], data))
+        return false;
+      states += data;
+      size_t length = data.size();
+      // The sequence may span several lines:
+      for (++i; length < nbSites && i < lines.size(); ++i)
+      {
+        data = TextTools::removeWhiteSpaces(lines[i]);
+        states += data;
+        length += data.size();
+      }
+      if (length > nbSites || (length < nbSites && (i < lines.size() || !truncated)))
+        return false;
+      ++count;
+    }
+    if (count == 0)
+      return false;
+  }
+  residues += states;
+  return true;
+}
+
+string IoSequenceFactory::guessAlphabetType_(const string& residues)
+{
+  size_t nbLetters = 0;
+  size_t nbNucleotides = 0;
+  size_t nbT = 0;
+  size_t nbU = 0;
+  size_t nbBinary = 0;
+  for (char c : residues)
+  {
+    char u = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    if (u == '0' || u == '1')
+      ++nbBinary;
+    if (u < 'A' || u > 'Z')
+      continue;
+    ++nbLetters;
+    if (u == 'A' || u == 'C' || u == 'G' || u == 'T' || u == 'U' || u == 'N')
+      ++nbNucleotides;
+    if (u == 'T')
+      ++nbT;
+    if (u == 'U')
+      ++nbU;
+  }
+  if (nbLetters == 0)
+    return nbBinary > 0 ? "Binary" : "";
+  // Protein sequences also contain A, C, G and T, but rarely more than 90% of them:
+  if (static_cast<double>(nbNucleotides) >= 0.9 * static_cast<double>(nbLetters))
+    return (nbU > 0 && nbT == 0) ? "RNA" : "DNA";
+  return "Protein";
+}
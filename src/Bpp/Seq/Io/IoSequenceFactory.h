@@ -10,6 +10,11 @@
 #include "ISequence.h"
 #include "OSequence.h"
 
+// From the STL:
+#include <istream>
+#include <memory>
+#include <string>
+
 namespace bpp
 {
 /**
@@ -28,6 +33,45 @@ public:
   static const std::string PAML_FORMAT_SEQUENTIAL;
   static const std::string GENBANK_FORMAT;
   static const std::string NEXUS_FORMAT;
+  static const std::string STOCKHOLM_FORMAT;
+  static const std::string PASTA_FORMAT;
+  static const std::string FASTQ_FORMAT;
+  static const std::string PHD_FORMAT;
+
+  /**
+   * @brief Number of bytes inspected by detectFormat.
+   */
+  static const size_t DETECTION_SIZE;
+
+  /**
+   * @brief The result of a format detection.
+   *
+   * Empty strings and null pointers mean that the information could not be guessed.
+   */
+  struct DetectedFormat
+  {
+    /**
+     * @brief One of the format names defined in this class.
+     */
+    std::string format;
+
+    /**
+     * @brief The type of alphabet ("DNA", "RNA", "Protein" or "Binary"), as used in option files.
+     */
+    std::string alphabetType;
+
+    /**
+     * @brief The corresponding alphabet.
+     */
+    std::shared_ptr<const Alphabet> alphabet;
+
+    /**
+     * @brief The compression method ("gzip", "bzip2", "xz", "zstd") if the data is compressed.
+     */
+    std::string compression;
+
+    DetectedFormat() : format(), alphabetType(), alphabet(), compression() {}
+  };
 
 public:
   /**
@@ -79,6 +123,74 @@ public:
    * @throw Exception If the format name do not match any available format.
    */
   virtual std::unique_ptr<OAlignment> createAlignmentWriter(const std::string& format);
+
+  /**
+   * @brief Guess the format of a stream from its first bytes.
+   *
+   * At most DETECTION_SIZE bytes are read, and the stream is set back to its
+   * initial position, so that it can be directly passed to the corresponding reader.
+   * The alphabet is guessed from the frequencies of the characters found in the sampled
+   * sequence lines (or from the state labels for the Pasta format).
+   *
+   * Compressed data is recognized, but not decompressed: only the compression
+   * field is then set.
+   *
+   * Pasta, Fastq and Phd files are recognized, but no reader is available for them
+   * through createReader.
+   *
+   * @param input A seekable input stream.
+   * @return The detected format and alphabet.
+   * @throw IOException If the stream is not seekable.
+   */
+  virtual DetectedFormat detectFormat(std::istream& input);
+
+  /**
+   * @brief Guess the format of a file from its first bytes.
+   *
+   * @param path The file to inspect.
+   * @return The detected format and alphabet.
+   * @throw IOException If the file cannot be opened.
+   */
+  virtual DetectedFormat detectFormat(const std::string& path);
+
+private:
+  /**
+   * @brief Guess the alphabet type from a sample of sequence characters.
+   *
+   * @param residues Characters taken from sequence data.
+   * @return "DNA", "RNA", "Protein", "Binary", or an empty string if the sample contains no state.
+   */
+  static std::string guessAlphabetType_(const std::string& residues);
+
+  /**
+   * @brief Check that the rows following a Phylip header are consistent with a layout.
+   *
+   * Each sequence row must start with a name, separated from the data by two spaces
+   * (extended format) or given on 10 characters (classic format). In an interleaved
+   * file, the first block has one row per sequence, with the same number of states,
+   * followed by an empty line. In a sequential file, the states of each sequence add
+   * up to the number of sites given in the header. If the sample is truncated, rows
+   * beyond it are not checked.
+   *
+   * @param lines       The complete lines of the sample.
+   * @param first       The index of the first row after the header.
+   * @param nbSequences The number of sequences given in the header.
+   * @param nbSites     The number of sites given in the header.
+   * @param extended    Whether names are separated by two spaces.
+   * @param interleaved Whether the file is interleaved.
+   * @param truncated   Whether the sample is only the beginning of the file.
+   * @param residues    The states of the rows read, for alphabet detection (output).
+   * @return true if all rows in the sample are consistent with the layout.
+   */
+  static bool checkPhylipLayout_(
+      const std::vector<std::string>& lines,
+      size_t first,
+      size_t nbSequences,
+      size_t nbSites,
+      bool extended,
+      bool interleaved,
+      bool truncated,
+      std::string& residues);
 };
 } // end of namespace bpp.
 #endif // BPP_SEQ_IO_IOSEQUENCEFACTORY_H
@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "MappedFile.h"
+
+// From the STL:
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BPP_SEQ_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+MappedFile::MappedFile(const std::string& path) :
+  path_(),
+  data_(nullptr),
+  size_(0),
+  mapped_(false),
+  buffer_()
+{
+  open(path);
+}
+
+/******************************************************************************/
+
+void MappedFile::open(const std::string& path)
+{
+  close();
+#ifdef BPP_SEQ_USE_MMAP
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw IOException("MappedFile::open. Can't open file " + path + ".");
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+  {
+    ::close(fd);
+    throw IOException("MappedFile::open. Can't get the size of file " + path + ".");
+  }
+  size_ = static_cast<size_t>(st.st_size);
+  if (size_ > 0)
+  {
+    void* p = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED)
+    {
+      ::close(fd);
+      size_ = 0;
+      throw IOException("MappedFile::open. Can't map file " + path + ".");
+    }
+    data_ = static_cast<const char*>(p);
+    mapped_ = true;
+  }
+  ::close(fd); // The mapping remains valid.
+#else
+  ifstream input(path.c_str(), ios::in | ios::binary);
+  if (!input)
+    throw IOException("MappedFile::open. Can't open file " + path + ".");
+  input.seekg(0, ios::end);
+  size_ = static_cast<size_t>(input.tellg());
+  input.seekg(0, ios::beg);
+  buffer_.resize(size_);
+  if (size_ > 0)
+  {
+    input.read(&buffer_[0], static_cast<streamsize>(size_));
+    data_ = &buffer_[0];
+  }
+#endif
+  path_ = path;
+}
+
+/******************************************************************************/
+
+void MappedFile::close()
+{
+#ifdef BPP_SEQ_USE_MMAP
+  if (mapped_)
+    munmap(const_cast<char*>(data_), size_);
+#endif
+  mapped_ = false;
+  path_ = "";
+  data_ = nullptr;
+  size_ = 0;
+  vector<char>().swap(buffer_);
+}
+
+/******************************************************************************/
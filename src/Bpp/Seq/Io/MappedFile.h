@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_IO_MAPPEDFILE_H
+#define BPP_SEQ_IO_MAPPEDFILE_H
+
+#include <Bpp/Exceptions.h>
+
+// From the STL:
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Read-only view of a whole file in memory.
+ *
+ * On POSIX systems the file is mapped with mmap, so that opening is immediate
+ * and pages are only loaded when accessed. On other systems, the file content
+ * is read in memory.
+ */
+class MappedFile
+{
+private:
+  std::string path_;
+  const char* data_;
+  size_t size_;
+  bool mapped_;
+  std::vector<char> buffer_;
+
+public:
+  /**
+   * @brief Build an empty object, with no file attached.
+   */
+  MappedFile() : path_(), data_(nullptr), size_(0), mapped_(false), buffer_() {}
+
+  /**
+   * @param path The file to map.
+   * @throw IOException If the file cannot be opened or mapped.
+   */
+  MappedFile(const std::string& path);
+
+  virtual ~MappedFile() { close(); }
+
+private:
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+public:
+  /**
+   * @brief Map a file, releasing the previous one if any.
+   *
+   * @param path The file to map.
+   * @throw IOException If the file cannot be opened or mapped.
+   */
+  void open(const std::string& path);
+
+  /**
+   * @brief Release the mapping.
+   */
+  void close();
+
+  bool isOpen() const { return !path_.empty(); }
+
+  const std::string& getPath() const { return path_; }
+
+  const char* data() const { return data_; }
+
+  size_t size() const { return size_; }
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_IO_MAPPEDFILE_H
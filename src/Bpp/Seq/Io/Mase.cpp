@@ -3,6 +3,8 @@
 // SPDX-License-Identifier: CECILL-2.1
 
 #include "../StringSequenceTools.h"
+#include "../SymbolDecoder.h"
+#include "BlockWriter.h"
 #include "Mase.h"
 
 using namespace bpp;
@@ -99,59 +101,56 @@ void Mase::writeSequences(ostream& output, const SequenceContainerInterface& sc)
   }
 
   Comments comments = sc.getComments();
+  BlockWriter writer(output);
+  string& buffer = writer.buffer();
 
   // Writing all general comments in file
   if (comments.size() == 0)
   {
-    output << ";;" << endl;
+    buffer += ";;\n";
   }
   for (size_t i = 0; i < comments.size(); i++)
   {
-    output << ";;" << comments[i] << endl;
+    buffer += ";;" + comments[i] + "\n";
   }
 
-  string seq, temp = "";  // Initialization
+  // Sequences are decoded line by line in the output buffer:
+  SymbolDecoder decoder(sc.getAlphabet());
 
   // Main loop : for all sequences
   for (const auto& seqKey: sc.getSequenceKeys())
   {
-    comments = sc.sequence(seqKey).getComments();
+    const auto& seq = sc.sequence(seqKey);
+    comments = seq.getComments();
 
     // Writing all sequence comments in file
     // If no comments are associated with current sequence, an empy commentary line will be writed
     if (comments.size() == 0)
     {
-      output << ";" << endl;
+      buffer += ";\n";
     }
     else
     {
       for (size_t j = 0; j < comments.size(); j++)
       {
-        output << ";" << comments[j] << endl;
+        buffer += ";" + comments[j] + "\n";
       }
     }
 
     // Sequence name writing
-    output << sc.sequence(seqKey).getName() << endl;
+    buffer += seq.getName() + "\n";
 
     // Sequence cutting to specified characters number per line
-    seq = sc.sequence(seqKey).toString();
-    while (seq != "")
+    const vector<int>& content = seq.getContent();
+    size_t nbChars = content.size() * decoder.getCodingSize();
+    for (size_t j = 0; j < nbChars; j += charsByLine_)
     {
-      if (seq.size() > charsByLine_)
-      {
-        temp = seq;
-        temp.erase(temp.begin() + static_cast<ptrdiff_t>(charsByLine_), temp.end());
-        output << temp  << endl;
-        seq.erase(seq.begin(), seq.begin() + static_cast<ptrdiff_t>(charsByLine_));
-      }
-      else
-      {
-        output << seq << endl;
-        seq = "";
-      }
+      decoder.decode(content, j, j + charsByLine_, buffer);
+      buffer += '\n';
+      writer.commit();
     }
   }
+  writer.flush();
 }
 
 /****************************************************************************************/
@@ -2,173 +2,398 @@
 //
 // SPDX-License-Identifier: CECILL-2.1
 
-#include <Bpp/Io/FileTools.h>
-#include <Bpp/Text/KeyvalTools.h>
+#include <Bpp/Text/StringTokenizer.h>
 #include <Bpp/Text/TextTools.h>
 
-#include "../Alphabet/AlphabetTools.h"
-#include "../Container/SiteContainerTools.h"
 #include "NexusIoSequence.h"
-#include "NexusTools.h"
 
 using namespace bpp;
 
 // From the STL:
-#include <sstream>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 
 using namespace std;
 
 /******************************************************************************/
 
-const std::vector<std::string> NexusIOSequence::splitNameAndSequence_(const std::string& s) const
+std::vector<size_t> NexusIOSequence::CharacterSet::getPositions() const
 {
-  vector<string> v(2);
-  string::size_type index = s.find(" ");
-  if (index == string::npos)
-    throw Exception("NexusIOSequence::splitNameAndSequence_(). No sequence name found.");
-  v[0] = TextTools::removeSurroundingWhiteSpaces(s.substr(0, index));
-  v[1] = TextTools::removeFirstWhiteSpaces(s.substr(index + 1));
-  return v;
+  vector<size_t> positions;
+  for (const auto& range : ranges)
+  {
+    for (size_t i = range.begin; i < range.end; i += range.step)
+    {
+      positions.push_back(i);
+    }
+  }
+  return positions;
 }
 
-
 /******************************************************************************/
 
-void NexusIOSequence::appendAlignmentFromStream(std::istream& input, SequenceContainerInterface& vsc) const
+void NexusIOSequence::skipWhiteSpacesAndComments_(const char*& p, const char* end)
 {
-  // Checking the existence of specified file
-  if (!input)
+  while (p < end)
   {
-    throw IOException ("NexusIOSequence::read(). Fail to open file");
+    if (TextTools::isWhiteSpaceCharacter(*p))
+      ++p;
+    else if (*p == '[')
+    {
+      const char* q = static_cast<const char*>(memchr(p, ']', static_cast<size_t>(end - p)));
+      if (!q)
+        throw IOException("NexusIOSequence. Unterminated comment.");
+      p = q + 1;
+    }
+    else
+      break;
   }
+}
 
-  // Look for the DATA block:
-  string line = "";
-  while (TextTools::toUpper(line) != "BEGIN DATA;")
-  {
-    if (input.eof())
-      throw Exception("NexusIOSequence::appendFromStream(). No data block was found.");
-    line = TextTools::removeSurroundingWhiteSpaces(FileTools::getNextLine(input));
-  }
+/******************************************************************************/
 
-  // Look for the DIMENSIONS command:
-  string cmdName = "", cmdArgs = "";
-  while (cmdName != "DIMENSIONS")
+std::string NexusIOSequence::nextToken_(const char*& p, const char* end)
+{
+  skipWhiteSpacesAndComments_(p, end);
+  if (p == end)
+    return "";
+  if (*p == ';' || *p == '=' || *p == ',')
+    return string(1, *p++);
+  if (*p == '\'')
   {
-    if (input.eof())
-      throw Exception("NexusIOSequence::appendFromStream(). No DIMENSIONS command was found.");
-    NexusTools::getNextCommand(input, cmdName, cmdArgs);
-    cmdName = TextTools::toUpper(cmdName);
+    // Quoted token, with '' standing for a single quote:
+    string token;
+    for (++p; p < end; ++p)
+    {
+      if (*p == '\'')
+      {
+        if (p + 1 < end && p[1] == '\'')
+          ++p;
+        else
+        {
+          ++p;
+          return token;
+        }
+      }
+      token += *p;
+    }
+    throw IOException("NexusIOSequence. Unterminated quoted token.");
   }
-  map<string, string> args;
-  KeyvalTools::multipleKeyvals(cmdArgs, args, " ");
-  map<string, string> argsUp;
-  for (map<string, string>::iterator it = args.begin(); it != args.end(); it++)
+  const char* begin = p;
+  while (p < end && !TextTools::isWhiteSpaceCharacter(*p) && *p != ';' && *p != '=' && *p != ',' && *p != '[')
   {
-    argsUp[TextTools::toUpper(it->first)] = it->second;
+    ++p;
   }
-  if (argsUp["NTAX"] == "")
-    throw Exception("NexusIOSequence::appendFromStream(). DIMENSIONS command does not have a NTAX argument.");
-  size_t ntax = TextTools::to<size_t>(argsUp["NTAX"]);
+  return string(begin, p);
+}
 
-  // Look for the FORMAT command:
-  while (cmdName != "FORMAT")
-  {
-    if (input.eof())
-      throw Exception("NexusIOSequence::appendFromStream(). No FORMAT command was found.");
-    NexusTools::getNextCommand(input, cmdName, cmdArgs);
-    cmdName = TextTools::toUpper(cmdName);
-  }
-  if (TextTools::hasSubstring(cmdArgs, "TRANSPOSE"))
-    throw Exception("NexusIOSequence::appendFromStream(). TRANSPOSE option is not supported.");
+/******************************************************************************/
 
-  // Check if the alignment is dotted or not:
-  bool matchChar = TextTools::hasSubstring(TextTools::toUpper(cmdArgs), "MATCHCHAR");
+void NexusIOSequence::appendAlignmentFromFile(const std::string& path, SequenceContainerInterface& sc, std::vector<CharacterSet>& charSets) const
+{
+  ifstream input(path.c_str(), ios::in | ios::binary);
+  if (!input)
+    throw IOException("NexusIOSequence::appendAlignmentFromFile. Can't read file " + path);
+  appendAlignmentFromStream(input, sc, charSets);
+}
 
-  auto alphaPtr = std::dynamic_pointer_cast<const Alphabet>(AlphabetTools::DEFAULT_ALPHABET);
-  auto alignment = make_unique<AlignedSequenceContainer>(alphaPtr);
+/******************************************************************************/
 
-  // Look for the MATRIX command:
-  line = "";
-  while (!TextTools::startsWith(TextTools::toUpper(line), "MATRIX"))
+void NexusIOSequence::appendAlignmentFromStream(std::istream& input, SequenceContainerInterface& sc, std::vector<CharacterSet>& charSets) const
+{
+  // Checking the existence of specified file
+  if (!input)
   {
-    if (input.eof())
-      throw Exception("NexusIOSequence::appendFromStream(). No MATRIX command was found.");
-    line = TextTools::removeSurroundingWhiteSpaces(FileTools::getNextLine(input));
+    throw IOException ("NexusIOSequence::read(). Fail to open file");
   }
-  line = FileTools::getNextLine(input);
 
-  vector<string> names, seqs;
-  // Read first block:
-  bool commandFinished = false;
-  for (size_t i = 0; i < ntax && !input.eof(); ++i)
+  // The whole file is tokenised from memory:
+  string text((istreambuf_iterator<char>(input)), istreambuf_iterator<char>());
+  const char* p = text.data();
+  const char* end = p + text.size();
+
+  string block = "";
+  size_t ntax = 0;
+  size_t nchar = 0;
+  bool interleaved = false;
+  char missing = '?';
+  char gap = '-';
+  char matchChar = '\0';
+  bool dataFound = false;
+  size_t firstCharSet = charSets.size();
+  InterleavedBlockParser parser(sc.getAlphabet(), 0, ingestPolicy_);
+
+  // Reads the arguments of a command, until the final semicolon:
+  auto readArguments = [&p, end](vector<string>& args) {
+    args.clear();
+    for (string token = nextToken_(p, end); token != ";"; token = nextToken_(p, end))
+    {
+      if (token.empty())
+        throw IOException("NexusIOSequence::appendAlignmentFromStream. Unterminated command.");
+      args.push_back(token);
+    }
+  };
+  // Get the value of a 'key = value' argument:
+  auto getValue = [](const vector<string>& args, size_t i) {
+    if (i + 2 >= args.size() || args[i + 1] != "=")
+      throw IOException("NexusIOSequence::appendAlignmentFromStream. Missing value for argument " + args[i] + ".");
+    return args[i + 2];
+  };
+
+  vector<string> args;
+  while (p < end)
   {
-    if (TextTools::endsWith(line, ";"))
+    string command = TextTools::toUpper(nextToken_(p, end));
+    if (command.empty())
+      break;
+    if (command == "BEGIN")
     {
-      if (i < ntax - 1)
-        throw IOException("NexusIOSequence::appendFromStream. Early end of MATRIX command, some sequences are missing.");
-      else
+      block = TextTools::toUpper(nextToken_(p, end));
+      readArguments(args);
+    }
+    else if (block == "")
+    {
+      // Outside blocks, only the #NEXUS header is expected.
+      continue;
+    }
+    else if (command == "END" || command == "ENDBLOCK")
+    {
+      readArguments(args);
+      block = "";
+    }
+    else if (command == "CHARSET")
+    {
+      readCharacterSet_(p, end, nchar, charSets);
+    }
+    else if (block != "DATA" && block != "CHARACTERS" && block != "TAXA")
+    {
+      readArguments(args);
+    }
+    else if (command == "DIMENSIONS")
+    {
+      readArguments(args);
+      for (size_t i = 0; i < args.size(); ++i)
+      {
+        string key = TextTools::toUpper(args[i]);
+        if (key == "NTAX")
+          ntax = TextTools::to<size_t>(getValue(args, i));
+        else if (key == "NCHAR")
+          nchar = TextTools::to<size_t>(getValue(args, i));
+      }
+    }
+    else if (command == "FORMAT" && block != "TAXA")
+    {
+      readArguments(args);
+      for (size_t i = 0; i < args.size(); ++i)
       {
-        commandFinished = true;
-        line = line.substr(0, line.size() - 1); // Remove trailing semi-colon.
+        string key = TextTools::toUpper(args[i]);
+        if (key == "TRANSPOSE")
+          throw IOException("NexusIOSequence::appendAlignmentFromStream. TRANSPOSE option is not supported.");
+        else if (key == "INTERLEAVE")
+          interleaved = (i + 1 >= args.size() || args[i + 1] != "=" || TextTools::toUpper(getValue(args, i)) != "NO");
+        else if (key == "MISSING")
+          missing = getValue(args, i)[0];
+        else if (key == "GAP")
+          gap = getValue(args, i)[0];
+        else if (key == "MATCHCHAR")
+          matchChar = getValue(args, i)[0];
       }
     }
-    vector<string> v = splitNameAndSequence_(line);
-    names.push_back(v[0]);
-    seqs.push_back(v[1]);
-    line = FileTools::getNextLine(input);
+    else if (command == "MATRIX" && block != "TAXA")
+    {
+      if (dataFound)
+        throw IOException("NexusIOSequence::appendAlignmentFromStream. Only one data matrix is supported.");
+      if (nchar > 0)
+        parser.setExpectedLength(nchar / parser.getAlphabet()->getStateCodingSize());
+      readMatrix_(p, end, ntax, nchar, interleaved, missing, gap, matchChar, parser);
+      if (parser.getNumberOfRows() > 0)
+        nchar = parser.getRowLength(0) * parser.getAlphabet()->getStateCodingSize();
+      parser.flush(sc);
+      dataFound = true;
+    }
+    else
+    {
+      readArguments(args);
+    }
+  }
+  if (!dataFound)
+    throw IOException("NexusIOSequence::appendAlignmentFromStream. No DATA or CHARACTERS block was found.");
+
+  // Check that all character sets fit in the alignment:
+  for (size_t i = firstCharSet; i < charSets.size(); ++i)
+  {
+    for (const auto& range : charSets[i].ranges)
+    {
+      if (range.end > nchar)
+        throw IOException("NexusIOSequence::appendAlignmentFromStream. Character set " + charSets[i].name + " goes beyond the end of the alignment.");
+    }
   }
+}
+
+/******************************************************************************/
+
+void NexusIOSequence::readMatrix_(const char*& p, const char* end, size_t ntax, size_t nchar, bool interleaved, char missing, char gap, char matchChar, InterleavedBlockParser& parser) const
+{
+  auto alphaPtr = parser.getAlphabet();
+  unsigned int codingSize = alphaPtr->getStateCodingSize();
+  if (matchChar != '\0' && codingSize != 1)
+    throw IOException("NexusIOSequence::readMatrix_. MATCHCHAR is only supported for alphabets with one character per state.");
+  size_t nbStates = nchar / codingSize;
+  bool translate = (gap != '-' || missing != '?' || matchChar != '\0');
+  string buffer;
 
-  // Then read all other blocks:
-  commandFinished = TextTools::removeSurroundingWhiteSpaces(line) == ";"; // In case the end of command is on a separate line.
-  while (!commandFinished)
+  while (true)
   {
-    for (size_t i = 0; i < ntax && !input.eof(); ++i)
+    skipWhiteSpacesAndComments_(p, end);
+    if (p == end)
+      throw IOException("NexusIOSequence::readMatrix_. Unterminated MATRIX command.");
+    if (*p == ';')
+    {
+      ++p;
+      break;
+    }
+    string name = nextToken_(p, end);
+    size_t row = parser.findRow(name);
+    bool isNew = (row == parser.getNumberOfRows());
+    if (isNew && ntax > 0 && parser.getNumberOfRows() == ntax)
+      throw IOException("NexusIOSequence::readMatrix_. Unknown taxon " + name + ", or more than " + TextTools::toString(ntax) + " taxa.");
+    if (!isNew && !interleaved && checkNames_ && nbStates > 0 && parser.getRowLength(row) >= nbStates)
+      throw IOException("NexusIOSequence::readMatrix_. Sequence name found twice: " + name);
+
+    // Sequence data: until the end of the line in interleaved matrices, until the expected length otherwise.
+    while (true)
     {
-      if (TextTools::endsWith(line, ";"))
+      const char* lineEnd = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(end - p)));
+      if (!lineEnd)
+        lineEnd = end;
+      const char* chunkEnd = p;
+      while (chunkEnd < lineEnd && *chunkEnd != ';' && *chunkEnd != '[')
       {
-        if (i < ntax - 1)
-          throw IOException("NexusIOSequence::appendFromStream. Early end of MATRIX command, some sequences are missing.");
-        else
+        ++chunkEnd;
+      }
+      const char* begin = p;
+      const char* stop = chunkEnd;
+      if (translate)
+      {
+        // Special characters are replaced in a copy of the chunk:
+        buffer.assign(p, chunkEnd);
+        size_t pos = isNew ? 0 : parser.getRowLength(row);
+        for (auto& c : buffer)
         {
-          commandFinished = true;
-          line = line.substr(0, line.size() - 1); // Remove trailing semi-colon.
+          if (TextTools::isWhiteSpaceCharacter(c))
+            continue;
+          if (c == gap)
+            c = '-';
+          else if (c == missing)
+            c = '?';
+          else if (c == matchChar)
+          {
+            if (parser.getNumberOfRows() == 0 || row == 0 || pos >= parser.getRowLength(0))
+              throw IOException("NexusIOSequence::readMatrix_. Match character without reference for taxon " + name + ".");
+            c = alphaPtr->intToChar(parser.getState(0, pos))[0];
+          }
+          ++pos;
         }
+        begin = buffer.data();
+        stop = begin + buffer.size();
       }
-
-      vector<string> v = splitNameAndSequence_(line);
-      if (v[0] != names[i])
-        throw IOException("NexusIOSequence::appendFromStream. Bad file, the sequences are not in the same order in interleaved blocks, or one taxon is missing.");
-      seqs[i] += v[1];
-      line = FileTools::getNextLine(input);
-      commandFinished = TextTools::removeSurroundingWhiteSpaces(line) == ";"; // In case the end of command is on a separate line.
+      if (isNew)
+      {
+        row = parser.addRow(name, begin, stop);
+        isNew = false;
+      }
+      else
+        parser.appendToRow(row, begin, stop);
+      p = chunkEnd;
+      if (p < end && *p == '[')
+      {
+        skipWhiteSpacesAndComments_(p, end);
+        continue;
+      }
+      if (p == end || *p == ';')
+        break;
+      ++p; // End of line.
+      if (interleaved || nbStates == 0 || parser.getRowLength(row) >= nbStates)
+        break;
     }
   }
-  for (size_t i = 0; i < names.size(); ++i)
+
+  // Check the final matrix:
+  if (ntax > 0 && parser.getNumberOfRows() != ntax)
+    throw IOException("NexusIOSequence::readMatrix_. Expected " + TextTools::toString(ntax) + " taxa, found " + TextTools::toString(parser.getNumberOfRows()) + ".");
+  for (size_t i = 0; i < parser.getNumberOfRows(); ++i)
+  {
+    size_t length = parser.getRowLength(i);
+    if ((nbStates > 0 && length != nbStates) || length != parser.getRowLength(0))
+      throw IOException("NexusIOSequence::readMatrix_. Sequence " + parser.getName(i) + " does not have the expected length.");
+  }
+}
+
+/******************************************************************************/
+
+void NexusIOSequence::readCharacterSet_(const char*& p, const char* end, size_t nchar, std::vector<CharacterSet>& charSets)
+{
+  CharacterSet charSet;
+  charSet.name = nextToken_(p, end);
+  if (charSet.name == "*")
+    charSet.name = nextToken_(p, end); // Default set marker.
+  string token = nextToken_(p, end);
+  if (token != "=")
+    throw IOException("NexusIOSequence::readCharacterSet_. Bad CHARSET command for " + charSet.name + ", '=' expected.");
+
+  // Ranges may contain spaces around '-' and '\':
+  string spec;
+  for (token = nextToken_(p, end); token != ";"; token = nextToken_(p, end))
   {
-    auto seqPtr = make_unique<Sequence>(names[i], seqs[i], alphaPtr);
-    alignment->addSequence(seqPtr->getName(), seqPtr);
+    if (token.empty())
+      throw IOException("NexusIOSequence::readCharacterSet_. Unterminated CHARSET command for " + charSet.name + ".");
+    if (!spec.empty() && spec.back() != '-' && spec.back() != '\\' && token[0] != '-' && token[0] != '\\')
+      spec += ' ';
+    spec += token;
   }
 
-  if (matchChar)
+  StringTokenizer st(spec, " ");
+  while (st.hasMoreToken())
   {
-    // Now we resolve the alignment:
-    auto resolvedAlignment =
-        SiteContainerTools::resolveDottedAlignment(*alignment, alphaPtr);
-    for (size_t i = 0; i < resolvedAlignment->getNumberOfSequences(); ++i)
+    string item = st.nextToken();
+    CharacterRange range = { 0, 0, 1 };
+    string::size_type slash = item.find('\\');
+    if (slash != string::npos)
     {
-      auto seqPtr = unique_ptr<Sequence>(resolvedAlignment->sequence(i).clone());
-      vsc.addSequence(seqPtr->getName(), seqPtr);
+      range.step = TextTools::to<size_t>(item.substr(slash + 1));
+      item = item.substr(0, slash);
     }
-  }
-  else
-  {
-    for (size_t i = 0; i < alignment->getNumberOfSequences(); ++i)
+    string::size_type dash = item.find('-');
+    string first = item.substr(0, dash);
+    if (TextTools::isDecimalInteger(first))
     {
-      auto seqPtr = unique_ptr<Sequence>(alignment->sequence(i).clone());
-      vsc.addSequence(seqPtr->getName(), seqPtr);
+      range.begin = TextTools::to<size_t>(first);
+      string last = dash == string::npos ? first : item.substr(dash + 1);
+      range.end = (last == ".") ? nchar : TextTools::to<size_t>(last);
+      if (range.begin == 0 || range.step == 0 || range.end < range.begin)
+        throw IOException("NexusIOSequence::readCharacterSet_. Invalid range '" + item + "' in character set " + charSet.name + ".");
+      --range.begin; // Positions start at 1 in Nexus files, and the last position is included.
+      charSet.ranges.push_back(range);
+    }
+    else
+    {
+      // Reference to a previous set:
+      bool found = false;
+      for (const auto& previous : charSets)
+      {
+        if (TextTools::toUpper(previous.name) == TextTools::toUpper(item))
+        {
+          charSet.ranges.insert(charSet.ranges.end(), previous.ranges.begin(), previous.ranges.end());
+          found = true;
+          break;
+        }
+      }
+      if (!found)
+        throw IOException("NexusIOSequence::readCharacterSet_. Unknown element '" + item + "' in character set " + charSet.name + ".");
     }
   }
+  charSets.push_back(charSet);
 }
 
 /******************************************************************************/
@@ -11,9 +11,12 @@
 #include "../Container/VectorSequenceContainer.h"
 #include "../Sequence.h"
 #include "AbstractIAlignment.h"
+#include "InterleavedBlockParser.h"
 
 // From the STL:
 #include <iostream>
+#include <string>
+#include <vector>
 
 namespace bpp
 {
@@ -26,6 +29,13 @@ namespace bpp
  * but only extract the sequence data. Only a basic subset of the options
  * are and will be supported.
  *
+ * The matrix is read from a DATA or CHARACTERS block, in sequential or
+ * interleaved layout. The whole file is tokenised from memory, and each
+ * line of the matrix is encoded directly into the buffer of its taxon.
+ * The MISSING, GAP and MATCHCHAR options of the FORMAT command are supported.
+ * CHARSET commands, found in any block (typically SETS or ASSUMPTIONS),
+ * can be retrieved as ranges of site positions, see CharacterSet.
+ *
  * This format is described in the following paper:
  * Maddison D, Swofford D, and Maddison W (1997), _Syst Biol_ 46(4):590-621
  *
@@ -35,6 +45,38 @@ class NexusIOSequence :
   public AbstractIAlignment2,
   public virtual ISequence
 {
+public:
+  /**
+   * @brief A range of site positions, as used in character sets.
+   *
+   * Positions start at 0, and 'end' is excluded.
+   */
+  struct CharacterRange
+  {
+    size_t begin;
+    size_t end;
+    size_t step;
+  };
+
+  /**
+   * @brief A named set of sites, as defined by a CHARSET command.
+   *
+   * The positions can be used to build a SiteContainerView of the
+   * alignment, or a copy with SiteContainerTools::getSelectedSites.
+   */
+  struct CharacterSet
+  {
+    std::string name;
+    std::vector<CharacterRange> ranges;
+
+    CharacterSet() : name(), ranges() {}
+
+    /**
+     * @return The positions of all sites in the set, in the order of the ranges.
+     */
+    std::vector<size_t> getPositions() const;
+  };
+
 protected:
   /**
    * @brief The maximum number of chars to be written on a line.
@@ -43,6 +85,8 @@ protected:
 
   bool checkNames_;
 
+  IngestPolicy ingestPolicy_; // How invalid characters are handled
+
 public:
   /**
    * @brief Build a new Nexus file reader.
@@ -51,7 +95,7 @@ public:
    * @param checkSequenceNames Tell if the names in the file should be checked for unicity (slower, in o(n*n) where n is the number of sequences).
    */
   NexusIOSequence(unsigned int charsByLine = 100, bool checkSequenceNames = true) :
-    charsByLine_(charsByLine), checkNames_(checkSequenceNames) {}
+    charsByLine_(charsByLine), checkNames_(checkSequenceNames), ingestPolicy_() {}
 
   virtual ~NexusIOSequence() {}
 
@@ -61,9 +105,33 @@ public:
    *
    * @{
    */
-  void appendAlignmentFromStream(std::istream& input, SequenceContainerInterface& sc) const override;
+  void appendAlignmentFromStream(std::istream& input, SequenceContainerInterface& sc) const override
+  {
+    std::vector<CharacterSet> charSets;
+    appendAlignmentFromStream(input, sc, charSets);
+  }
   /** @} */
 
+  /**
+   * @brief Read an alignment and its character sets.
+   *
+   * @param input    The input stream.
+   * @param sc       The container to which sequences are added.
+   * @param charSets The vector to which character sets are appended, in file order.
+   * @throw IOException If the file is not properly formatted, or if a character set does not match the alignment.
+   */
+  void appendAlignmentFromStream(std::istream& input, SequenceContainerInterface& sc, std::vector<CharacterSet>& charSets) const;
+
+  /**
+   * @brief Read an alignment and its character sets from a file.
+   *
+   * @param path     The file to read.
+   * @param sc       The container to which sequences are added.
+   * @param charSets The vector to which character sets are appended, in file order.
+   * @throw IOException If the file cannot be read or is not properly formatted.
+   */
+  void appendAlignmentFromFile(const std::string& path, SequenceContainerInterface& sc, std::vector<CharacterSet>& charSets) const;
+
   /**
    * @name The IOSequence interface.
    *
@@ -86,9 +154,27 @@ public:
    */
   void checkNames(bool yn) { checkNames_ = yn; }
 
+  /**
+   * @return How characters which are not part of the alphabet are handled when reading.
+   */
+  const IngestPolicy& getIngestPolicy() const { return ingestPolicy_; }
+
+  /**
+   * @brief Set how characters which are not part of the alphabet are handled when reading.
+   *
+   * @param policy The policy to use (strict by default).
+   */
+  void setIngestPolicy(const IngestPolicy& policy) { ingestPolicy_ = policy; }
+
 private:
   // Reading tools:
-  const std::vector<std::string> splitNameAndSequence_(const std::string& s) const;
+  void readMatrix_(const char*& p, const char* end, size_t ntax, size_t nchar, bool interleaved, char missing, char gap, char matchChar, InterleavedBlockParser& parser) const;
+
+  static void readCharacterSet_(const char*& p, const char* end, size_t nchar, std::vector<CharacterSet>& charSets);
+
+  static void skipWhiteSpacesAndComments_(const char*& p, const char* end);
+
+  static std::string nextToken_(const char*& p, const char* end);
 };
 } // end of namespace bpp.
 #endif // BPP_SEQ_IO_NEXUSIOSEQUENCE_H
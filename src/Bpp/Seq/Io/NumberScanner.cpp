@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Text/TextTools.h>
+
+#include "NumberScanner.h"
+
+// From the STL:
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+const char* NumberScanner::skipWhiteSpaces(const char* begin, const char* end)
+{
+  while (begin < end && TextTools::isWhiteSpaceCharacter(*begin))
+  {
+    ++begin;
+  }
+  return begin;
+}
+
+/******************************************************************************/
+
+bool NumberScanner::scanDouble(const char*& p, const char* end, double& value)
+{
+  // Powers of ten which are exactly representable as doubles:
+  static const double powersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+
+  const char* q = p;
+  bool negative = false;
+  if (q < end && (*q == '-' || *q == '+'))
+  {
+    negative = (*q == '-');
+    ++q;
+  }
+
+  uint64_t mantissa = 0;
+  int exponent = 0;
+  unsigned int nbDigits = 0;
+  bool exact = true;
+  bool hasDigits = false;
+  for ( ; q < end && *q >= '0' && *q <= '9'; ++q)
+  {
+    hasDigits = true;
+    if (nbDigits < 19)
+    {
+      mantissa = mantissa * 10 + static_cast<uint64_t>(*q - '0');
+      if (mantissa > 0)
+        ++nbDigits;
+    }
+    else
+    {
+      ++exponent;
+      exact = false;
+    }
+  }
+  if (q < end && *q == '.')
+  {
+    ++q;
+    for ( ; q < end && *q >= '0' && *q <= '9'; ++q)
+    {
+      hasDigits = true;
+      if (nbDigits < 19)
+      {
+        mantissa = mantissa * 10 + static_cast<uint64_t>(*q - '0');
+        if (mantissa > 0)
+          ++nbDigits;
+        --exponent;
+      }
+      else
+      {
+        exact = false;
+      }
+    }
+  }
+  if (hasDigits && q < end && (*q == 'e' || *q == 'E'))
+  {
+    const char* r = q + 1;
+    bool negativeExponent = false;
+    if (r < end && (*r == '-' || *r == '+'))
+    {
+      negativeExponent = (*r == '-');
+      ++r;
+    }
+    if (r < end && *r >= '0' && *r <= '9')
+    {
+      int e = 0;
+      for ( ; r < end && *r >= '0' && *r <= '9'; ++r)
+      {
+        if (e < 100000)
+          e = e * 10 + (*r - '0');
+      }
+      exponent += negativeExponent ? -e : e;
+      q = r;
+    }
+  }
+
+  if (hasDigits && exact && mantissa < (static_cast<uint64_t>(1) << 53) && exponent >= -22 && exponent <= 22)
+  {
+    if (q < end && !TextTools::isWhiteSpaceCharacter(*q))
+      return false;
+    double v = static_cast<double>(mantissa);
+    if (exponent < 0)
+      v /= powersOfTen[-exponent];
+    else
+      v *= powersOfTen[exponent];
+    value = negative ? -v : v;
+    p = q;
+    return true;
+  }
+
+  // Slow path, also used for special values:
+  const char* tokenEnd = p;
+  while (tokenEnd < end && !TextTools::isWhiteSpaceCharacter(*tokenEnd))
+  {
+    ++tokenEnd;
+  }
+  string token(p, tokenEnd);
+  char* parsed = nullptr;
+  double v = strtod(token.c_str(), &parsed);
+  if (token.empty() || parsed != token.c_str() + token.size())
+    return false;
+  value = v;
+  p = tokenEnd;
+  return true;
+}
+
+/******************************************************************************/
@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_IO_NUMBERSCANNER_H
+#define BPP_SEQ_IO_NUMBERSCANNER_H
+
+
+// From the STL:
+#include <cstddef>
+
+namespace bpp
+{
+/**
+ * @brief Fast scanning of numbers from raw character buffers.
+ *
+ * Numerical file formats (Pasta, index files) store large amounts of decimal
+ * numbers. Converting them through string streams or TextTools requires a
+ * temporary string per value, which dominates the reading time. These functions
+ * work directly on character ranges.
+ *
+ * Decimal numbers with at most 19 significant digits and a decimal exponent
+ * between -22 and 22 are converted exactly with integer arithmetic and a single
+ * multiplication or division by an exact power of ten. Other numbers (very long
+ * mantissas, large exponents, 'inf', 'nan') fall back to the C library, so that
+ * the result is always correctly rounded.
+ */
+class NumberScanner
+{
+public:
+  /**
+   * @return A pointer toward the first non-white character in [begin, end), or end.
+   */
+  static const char* skipWhiteSpaces(const char* begin, const char* end);
+
+  /**
+   * @brief Read a floating point number.
+   *
+   * @param[in,out] p Pointer toward the first character of the number. On success,
+   * it is moved after the last character of the number.
+   * @param end End of the buffer.
+   * @param[out] value The number read.
+   * @return true if a number was read and is followed by a white space or by the
+   * end of the buffer.
+   */
+  static bool scanDouble(const char*& p, const char* end, double& value);
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_IO_NUMBERSCANNER_H
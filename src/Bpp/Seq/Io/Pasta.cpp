@@ -9,21 +9,33 @@
 
 #include "../StringSequenceTools.h"
 #include "../Container/SequenceContainer.h"
+#include "NumberScanner.h"
 #include "Pasta.h"
 
+// From the STL:
+#include <algorithm>
+
 using namespace bpp;
 using namespace std;
 
 /********************************************************************************/
 
 bool Pasta::nextSequence(istream& input, ProbabilisticSequence& seq, bool hasLabels, const vector<size_t>& permutationMap) const
+{
+  string header;
+  string content;
+  bool res = readRecord_(input, header, content);
+  parseRecord_(header, content, seq, hasLabels, permutationMap);
+  return res;
+}
+
+/********************************************************************************/
+
+bool Pasta::readRecord_(istream& input, string& header, string& content) const
 {
   if (!input)
     throw IOException("Pasta::nextSequence : can't read from istream input");
 
-  string seqname = "";
-  vector<double> tokens;
-  Comments seqcmts;
   short seqcpt = 0;
   string linebuffer = "";
   char c;
@@ -47,24 +59,26 @@ bool Pasta::nextSequence(istream& input, ProbabilisticSequence& seq, bool hasLab
     if (c == '>')
     {
       // get the sequence name line
-      seqname = string(linebuffer.begin() + 1, linebuffer.end());
+      header = string(linebuffer.begin() + 1, linebuffer.end());
     }
 
     if (c != '>' && !TextTools::isWhiteSpaceCharacter(c))
     {
       // sequence content : probabilities for each site are space-separated
-      StringTokenizer st(linebuffer, " \t\n", false, false);
-      while (st.hasMoreToken())
-      {
-        double t;
-        stringstream ss(st.nextToken());
-        ss >> t;
-        tokens.push_back(t);
-      }
+      content += linebuffer;
+      content += '\n';
     }
   }
 
-  bool res = (!input.eof());
+  return !input.eof();
+}
+
+/********************************************************************************/
+
+void Pasta::parseRecord_(const string& header, const string& content, ProbabilisticSequence& seq, bool hasLabels, const vector<size_t>& permutationMap) const
+{
+  string seqname = header;
+  Comments seqcmts;
 
   // Sequence name and comments isolation (identical to that of Fasta)
   if (strictNames_ || extended_)
@@ -97,46 +111,55 @@ bool Pasta::nextSequence(istream& input, ProbabilisticSequence& seq, bool hasLab
 
   /* finally, deal with the content */
 
+  // Probabilities are scanned into a flat buffer, without intermediate strings:
+  vector<double> tokens;
+  tokens.reserve(content.size() / 2);
+  const char* p = content.data();
+  const char* end = p + content.size();
+  while ((p = NumberScanner::skipWhiteSpaces(p, end)) < end)
+  {
+    double t;
+    if (!NumberScanner::scanDouble(p, end, t))
+      throw IOException("Pasta::nextSequence : invalid number in sequence " + seqname + ".");
+    tokens.push_back(t);
+  }
+
   // there is a header that specifies to which character each
   // probability is associated
-  auto size = seq.getAlphabet()->getSize();
+  size_t size = seq.getAlphabet()->getSize();
   if (hasLabels)
   {
-    DataTable content(size, 0);
-    vector<double>::const_iterator i = tokens.begin();
-    while (i != tokens.end())
+    // junk up the tokens into groups, and permute
+    // according to how the header is permuted
+    size_t nbLabels = permutationMap.size();
+    if ((nbLabels == 0 && !tokens.empty()) || (nbLabels > 0 && tokens.size() % nbLabels != 0))
+      throw Exception("Pasta::nextSequence : input is incomplete");
+    size_t nbSites = nbLabels > 0 ? tokens.size() / nbLabels : 0;
+    DataTable table(size, nbSites);
+    for (size_t i = 0; i < nbSites; ++i)
     {
-      // junk up the tokens into groups of alphabetsize, and permute
-      // according to how the header is permuted
-      vector<double> row(size, 0.);
-      for (const auto j:permutationMap)
+      vector<double>& column = table.getColumn(i);
+      const double* row = &tokens[i * nbLabels];
+      for (size_t j = 0; j < nbLabels; ++j)
       {
-        if (i == tokens.end())
-          throw Exception("Pasta::nextSequence : input is incomplete");
-        row[(size_t)j] = *i;
-        ++i;
+        column[permutationMap[j]] = row[j];
       }
-
-      content.addColumn(row);
     }
     // finally set the content
-    seq.setContent(content.getData());
+    seq.setContent(table);
   }
   // o.w., we assume that each probability is that a (binary)
   // character is 1
   else
   {
-    DataTable content(2, 0);
-
     // fill in pairs of probabilities that (binary) character is 0,
     // resp. 1
-    for (const auto& i : tokens)
+    DataTable table(2, tokens.size());
+    for (size_t i = 0; i < tokens.size(); ++i)
     {
-      // the following will throw an exception if v[i] is not a properly
-      // formatted double : a check that we want to have
-
-      vector<double> pair_v{1. - i, i};
-      content.addColumn(pair_v);
+      vector<double>& column = table.getColumn(i);
+      column[0] = 1. - tokens[i];
+      column[1] = tokens[i];
     }
 
     // finally, we set the content of the sequence to the above.
@@ -145,10 +168,54 @@ bool Pasta::nextSequence(istream& input, ProbabilisticSequence& seq, bool hasLab
     // construction of a DataTable object, the only thing left that
     // could go wrong is that p(0) + p(1) != 1 : a check that is done
     // in the call of the function below
-    seq.setContent(content.getData());
+    seq.setContent(table);
   }
+}
 
-  return res;
+/********************************************************************************/
+
+std::vector<size_t> Pasta::getPermutationMap_(const std::string& line, const Alphabet& alphabet)
+{
+  vector<string> labels;
+  StringTokenizer st(line, " \t\n", false, false);
+  while (st.hasMoreToken())
+  {
+    labels.push_back(st.nextToken());
+  }
+
+  /* check labels against alphabet of the container */
+  vector<string> resolved_chars = alphabet.getResolvedChars();
+
+  // build permutation map on the content, error should one exist
+  vector<size_t> permutationMap;
+  for (const auto&  i : labels)
+  {
+    bool found = false;
+
+    for (size_t j = 0; j < resolved_chars.size(); ++j)
+    {
+      if (i == resolved_chars[j])
+      {
+        if (found)
+          throw Exception("Pasta::appendSequencesFromStream. Label " + i + " found twice.");
+
+        permutationMap.push_back(j);
+        found = true;
+      }
+    }
+
+    if (!found)
+    {
+      string states = "<";
+      for (const auto&  i2 :  resolved_chars)
+      {
+        states += " " + i2;
+      }
+      states += " >";
+      throw Exception("Pasta::appendSequencesFromStream. Label " + i + " is not found in alphabet " + states + ".");
+    }
+  }
+  return permutationMap;
 }
 
 /********************************************************************************/
@@ -168,9 +235,34 @@ void Pasta::appendAlignmentFromStream(istream& input, ProbabilisticSequenceConta
 
   // labels for the states
   bool hasLabels = false;
-  vector<string> labels;
   vector<size_t> permutationMap;
 
+  // Raw records are read sequentially, then parsed by batches, possibly in parallel:
+  const ExecutionContext& context = getExecutionContext();
+  size_t batchSize = context.isParallel() ? 16 * static_cast<size_t>(context.getNumberOfWorkers()) : 1;
+  vector<string> headers;
+  vector<string> contents;
+  auto parseBatch = [&]()
+  {
+    size_t n = headers.size();
+    vector< unique_ptr<ProbabilisticSequence>> sequences(n);
+    // One record per block, the error of the first invalid record is rethrown:
+    context.forEachBlock(n, [&](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        sequences[i] = make_unique<ProbabilisticSequence>(alphaPtr);
+        parseRecord_(headers[i], contents[i], *sequences[i], hasLabels, permutationMap);
+      }
+    }, 1);
+    for (size_t i = 0; i < n; ++i)
+    {
+      container.addSequence(sequences[i]->getName(), sequences[i]);
+    }
+    headers.clear();
+    contents.clear();
+  };
+
   while (!input.eof() && hasSeq)
   {
     last_c = c;
@@ -213,45 +305,7 @@ void Pasta::appendAlignmentFromStream(istream& input, ProbabilisticSequenceConta
       c = last_c;
 
       getline(input, line);
-      StringTokenizer st(line, " \t\n", false, false);
-
-      while (st.hasMoreToken())
-      {
-        string s = st.nextToken();
-        labels.push_back(s);
-      }
-
-      /* check labels against alphabet of the container */
-      vector<string> resolved_chars = container.getAlphabet()->getResolvedChars();
-
-      // build permutation map on the content, error should one exist
-      for (const auto&  i : labels)
-      {
-        bool found = false;
-
-        for (size_t j = 0; j < resolved_chars.size(); ++j)
-        {
-          if (i == resolved_chars[j])
-          {
-            if (found)
-              throw Exception("Pasta::appendSequencesFromStream. Label " + i + " found twice.");
-
-            permutationMap.push_back(j);
-            found = true;
-          }
-        }
-
-        if (!found)
-        {
-          string states = "<";
-          for (const auto&  i2 :  resolved_chars)
-          {
-            states += " " + i2;
-          }
-          states += " >";
-          throw Exception("Pasta::appendSequencesFromStream. Label " + i + " is not found in alphabet " + states + ".");
-        }
-      }
+      permutationMap = getPermutationMap_(line, *container.getAlphabet());
     }
 
     // detect the sequence
@@ -259,11 +313,14 @@ void Pasta::appendAlignmentFromStream(istream& input, ProbabilisticSequenceConta
     {
       input.putback(c);
       c = last_c;
-      auto tmpseq = make_unique<ProbabilisticSequence>(alphaPtr); // add probabilistic sequences instead
-      hasSeq = nextSequence(input, *tmpseq, hasLabels, permutationMap);
-      container.addSequence(tmpseq->getName(), tmpseq);
+      headers.push_back("");
+      contents.push_back("");
+      hasSeq = readRecord_(input, headers.back(), contents.back());
+      if (headers.size() == batchSize)
+        parseBatch(); // add probabilistic sequences instead
     }
   }
+  parseBatch();
   if (extended_ && cmts.size())
   {
     container.setComments(cmts);
@@ -358,3 +415,93 @@ void Pasta::writeSequence(ostream& output, const Sequence& seq, bool header) con
     output << endl;
   }
 }
+
+/********************************************************************************/
+
+// FileIndex class
+
+void Pasta::FileIndex::scan_(std::istream& input)
+{
+  string line;
+  string id;
+  uint64_t pos = 0;
+  uint64_t start = 0;
+  uint64_t nbTokens = 0;
+  uint64_t nbLabels = 0;
+  bool inRecord = false;
+  auto countTokens = [](const string& s) {
+    uint64_t n = 0;
+    bool inToken = false;
+    for (char c : s)
+    {
+      bool white = TextTools::isWhiteSpaceCharacter(c);
+      if (!white && !inToken)
+        ++n;
+      inToken = !white;
+    }
+    return n;
+  };
+  auto addRecord = [&](uint64_t end) {
+    uint64_t length = nbLabels > 0 ? nbTokens / nbLabels : nbTokens;
+    addEntry_(id, start, end - start, length);
+  };
+  while (getline(input, line, '\n'))
+  {
+    uint64_t lineSize = line.size() + (input.eof() ? 0 : 1);
+    if (!line.empty() && line[0] == '>')
+    {
+      if (inRecord)
+        addRecord(pos);
+      inRecord = true;
+      start = pos;
+      nbTokens = 0;
+      id = line.substr(1);
+      if (strictNames_)
+        id = id.substr(0, id.find_first_of(" \t"));
+    }
+    else if (!line.empty() && !TextTools::isWhiteSpaceCharacter(line[0]))
+    {
+      if (inRecord)
+        nbTokens += countTokens(line);
+      else if (line[0] != '#')
+        nbLabels = countTokens(line); // The labels of the states.
+    }
+    pos += lineSize;
+  }
+  if (inRecord)
+    addRecord(pos);
+}
+
+/********************************************************************************/
+
+void Pasta::FileIndex::getSequence(const std::string& seqid, ProbabilisticSequence& seq, const std::string& path) const
+{
+  Pasta pasta(100, false, strictNames_);
+  streampos seqPos = getSequencePosition(seqid);
+  ifstream input(path.c_str());
+  if (!input)
+    throw IOException("Pasta::FileIndex::getSequence. Can't read file " + path + ".");
+
+  // The labels of the states are given before the first record:
+  bool hasLabels = false;
+  vector<size_t> permutationMap;
+  string line;
+  while (getline(input, line, '\n') && (line.empty() || line[0] != '>'))
+  {
+    if (!TextTools::isEmpty(line) && line[0] != '#')
+    {
+      hasLabels = true;
+      permutationMap = getPermutationMap_(line, *seq.getAlphabet());
+      break;
+    }
+  }
+
+  input.clear();
+  input.seekg(seqPos);
+  string header;
+  string content;
+  pasta.readRecord_(input, header, content);
+  pasta.parseRecord_(header, content, seq, hasLabels, permutationMap);
+}
+
+/********************************************************************************/
@@ -8,12 +8,14 @@
 #include <Bpp/Numeric/Table.h>
 
 #include "../Container/VectorSiteContainer.h"
+#include "../ExecutionContext.h"
 #include "../ProbabilisticSequence.h"
 #include "../Container/AlignmentData.h"
 #include "AbstractIAlignment.h"
 #include "AbstractISequence.h"
 #include "AbstractOAlignment.h"
 #include "AbstractOSequence.h"
+#include "AbstractSequenceFileIndex.h"
 
 namespace bpp
 {
@@ -40,6 +42,7 @@ protected:
 
   bool extended_;            // If using HUPO-PSI extensions
   bool strictNames_;         // If name is between '>' and first space
+  std::shared_ptr<const ExecutionContext> context_; // Used to parse sequences (input only), global one if null
 
 public:
   typedef Table<double> DataTable;
@@ -51,7 +54,7 @@ public:
    * @param extended Tell if we should read general comments and sequence comments in HUPO-PSI format.
    * @param strictSequenceNames Tells if the sequence names should be restricted to the characters between '>' and the first blank one.
    */
-  Pasta(unsigned int charsByLine = 100, bool extended = false, bool strictSequenceNames = false) : charsByLine_(charsByLine), extended_(extended), strictNames_(strictSequenceNames) {}
+  Pasta(unsigned int charsByLine = 100, bool extended = false, bool strictSequenceNames = false) : charsByLine_(charsByLine), extended_(extended), strictNames_(strictSequenceNames), context_() {}
 
   // class destructor
   virtual ~Pasta() {}
@@ -68,6 +71,21 @@ public:
     return "By rows: alphabet, then Sequence name (preceded by >) in one line, and rows of sequence content.";
   }
 
+  /**
+   * @return The execution context used to parse sequence contents when reading alignments.
+   */
+  const ExecutionContext& getExecutionContext() const { return context_ ? *context_ : ExecutionContext::global(); }
+
+  /**
+   * @brief Set the execution context used to parse sequence contents when reading alignments.
+   *
+   * Records are read sequentially from the stream, and their numerical contents are then
+   * converted by batches in parallel. Sequences are added to the container in file order.
+   *
+   * @param context The context to use, or null for the library-wide one, ExecutionContext::global() (the default).
+   */
+  void setExecutionContext(std::shared_ptr<const ExecutionContext> context) { context_ = context; }
+
   /**
    * @name The "ISequenceStream interface"
    *
@@ -129,6 +147,70 @@ public:
   using AbstractOSequence2::writeAlignment;
 
   const std::string getDataType() const override { return "(Probabilistic) sequence container"; }
+
+  /**
+   * @brief The SequenceFileIndex class for Pasta format.
+   *
+   * Offsets point to the '>' header line of each sequence, and can be used with
+   * nextSequence. Sequence lengths are numbers of sites.
+   */
+  class FileIndex :
+    public AbstractSequenceFileIndex
+  {
+private:
+    bool strictNames_;
+
+public:
+    /**
+     * @param strictSequenceNames Tells if the sequence IDs should be restricted to the characters between '>' and the first blank one.
+     */
+    FileIndex(bool strictSequenceNames = false) : strictNames_(strictSequenceNames) {}
+    virtual ~FileIndex() {}
+
+    /**
+     * @brief Get a sequence given its ID.
+     *
+     * The labels of the states, if any, are read from the beginning of the file.
+     *
+     * @param seqid The ID of the sequence.
+     * @param seq The sequence to fill, with the alphabet of the file.
+     * @param path The path to the indexed file.
+     * @throw Exception If the ID is not in the index, or if the record cannot be read.
+     */
+    void getSequence(const std::string& seqid, ProbabilisticSequence& seq, const std::string& path) const;
+
+protected:
+    void scan_(std::istream& input) override;
+  };
+
+protected:
+  /**
+   * @brief Read the raw text of a record: the header line and the content lines.
+   *
+   * @param input The stream to read.
+   * @param header The record header, without the leading '>'.
+   * @param content The content lines, separated by new lines.
+   * @return true if the end of the stream was not reached.
+   */
+  bool readRecord_(std::istream& input, std::string& header, std::string& content) const;
+
+  /**
+   * @brief Set the name, comments and content of a sequence from a raw record.
+   *
+   * Probabilities are scanned directly from the text into a single buffer, where
+   * they are stored at their final position according to the permutation map.
+   */
+  void parseRecord_(const std::string& header, const std::string& content, ProbabilisticSequence& seq, bool hasLabels, const std::vector<size_t>& permutationMap) const;
+
+  /**
+   * @brief Map the labels of the states, given on the first line of the file, to the resolved states of an alphabet.
+   *
+   * @param line The line of labels.
+   * @param alphabet The alphabet of the sequences.
+   * @return The index of the resolved state of each label.
+   * @throw Exception If a label is not a resolved state of the alphabet, or is found twice.
+   */
+  static std::vector<size_t> getPermutationMap_(const std::string& line, const Alphabet& alphabet);
 };
 } // end of namespace bpp
 #endif // BPP_SEQ_IO_PASTA_H
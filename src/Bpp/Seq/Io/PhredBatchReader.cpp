@@ -0,0 +1,341 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Text/TextTools.h>
+
+#include "PhredBatchReader.h"
+
+// From the STL:
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BPP_SEQ_USE_DIRENT
+#include <dirent.h>
+#endif
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+template<class T>
+std::vector< std::unique_ptr<T>> PhredBatchReader::parseFiles_(
+    const std::vector<std::string>& paths,
+    const std::function<std::unique_ptr<T>(Buffers_&)>& parser,
+    std::vector<std::string>& messages,
+    const ExecutionContext& context) const
+{
+  size_t n = paths.size();
+  vector< unique_ptr<T>> results(n);
+  messages.assign(n, "");
+
+  // Small blocks, as the sizes of files may vary a lot, but with at least a few files to reuse buffers:
+  size_t grainSize = min(static_cast<size_t>(8), max(static_cast<size_t>(1), n / (4 * static_cast<size_t>(context.getNumberOfWorkers()))));
+  context.forEachBlock(n, [&](size_t begin, size_t end)
+  {
+    Buffers_ buffers;
+    for (size_t i = begin; i < end; ++i)
+    {
+      try
+      {
+        readFile_(paths[i], buffers.text);
+        results[i] = parser(buffers);
+      }
+      catch (exception& e)
+      {
+        messages[i] = e.what();
+      }
+      catch (...)
+      {
+        messages[i] = "Unknown error.";
+      }
+    }
+  }, grainSize);
+  return results;
+}
+
+/******************************************************************************/
+
+template<class SequenceType>
+std::unique_ptr< TemplateVectorSequenceContainer<SequenceType>> PhredBatchReader::read_(
+    const std::vector<std::string>& paths,
+    std::shared_ptr<const Alphabet> alphabet,
+    std::vector<Error>& errors,
+    const std::function<std::unique_ptr<SequenceType>(Buffers_&)>& parser,
+    const ExecutionContext& context) const
+{
+  vector<string> messages;
+  auto sequences = parseFiles_(paths, parser, messages, context);
+  auto container = make_unique< TemplateVectorSequenceContainer<SequenceType>>(alphabet);
+  for (size_t i = 0; i < sequences.size(); ++i)
+  {
+    if (sequences[i])
+    {
+      try
+      {
+        container->addSequence(sequences[i]->getName(), sequences[i]);
+      }
+      catch (exception& e)
+      {
+        messages[i] = e.what(); // Typically a duplicated name.
+      }
+    }
+  }
+  reportErrors_(paths, messages, errors);
+  return container;
+}
+
+/******************************************************************************/
+
+std::unique_ptr< TemplateVectorSequenceContainer<SequenceWithQuality>> PhredBatchReader::readPhdFiles(
+    const std::vector<std::string>& paths,
+    std::shared_ptr<const Alphabet> alphabet,
+    std::vector<Error>& errors,
+    const ExecutionContext& context) const
+{
+  return read_<SequenceWithQuality>(paths, alphabet, errors, [&](Buffers_& buffers)
+  {
+    parsePhd_(buffers);
+    return make_unique<SequenceWithQuality>(buffers.name, buffers.sequence, buffers.quality.toVector(), alphabet);
+  }, context);
+}
+
+/******************************************************************************/
+
+std::vector<PhredBatchReader::PhdRecord> PhredBatchReader::readPhdRecords(
+    const std::vector<std::string>& paths,
+    std::vector<Error>& errors,
+    const ExecutionContext& context) const
+{
+  vector<string> messages;
+  auto parsed = parseFiles_<PhdRecord>(paths, [&](Buffers_& buffers)
+  {
+    parsePhd_(buffers);
+    auto record = make_unique<PhdRecord>();
+    record->name = buffers.name;
+    record->sequence = buffers.sequence;
+    record->quality = buffers.quality;
+    return record;
+  }, messages, context);
+  vector<PhdRecord> records;
+  for (auto& record : parsed)
+  {
+    if (record)
+      records.push_back(std::move(*record));
+  }
+  reportErrors_(paths, messages, errors);
+  return records;
+}
+
+/******************************************************************************/
+
+std::unique_ptr<VectorSequenceContainer> PhredBatchReader::readPolyFiles(
+    const std::vector<std::string>& paths,
+    std::shared_ptr<const Alphabet> alphabet,
+    std::vector<Error>& errors,
+    const ExecutionContext& context) const
+{
+  return read_<Sequence>(paths, alphabet, errors, [&](Buffers_& buffers)
+  {
+    parsePoly_(buffers, *alphabet);
+    return make_unique<Sequence>(buffers.name, buffers.sequence, alphabet);
+  }, context);
+}
+
+/******************************************************************************/
+
+void PhredBatchReader::reportErrors_(const std::vector<std::string>& paths, const std::vector<std::string>& messages, std::vector<Error>& errors)
+{
+  for (size_t i = 0; i < messages.size(); ++i)
+  {
+    if (!messages[i].empty())
+    {
+      Error error = { paths[i], messages[i] };
+      errors.push_back(error);
+    }
+  }
+}
+
+/******************************************************************************/
+
+void PhredBatchReader::readFile_(const std::string& path, std::string& text)
+{
+  ifstream input(path.c_str(), ios::in | ios::binary);
+  if (!input)
+    throw IOException("PhredBatchReader::readFile_. Can't open file " + path + ".");
+  input.seekg(0, ios::end);
+  streampos size = input.tellg();
+  input.seekg(0, ios::beg);
+  if (size == streampos(-1))
+    throw IOException("PhredBatchReader::readFile_. Can't get the size of file " + path + ".");
+  // The capacity of the buffer is kept from one file to the next:
+  text.resize(static_cast<size_t>(size));
+  if (!text.empty())
+    input.read(&text[0], static_cast<streamsize>(text.size()));
+  if (!input)
+    throw IOException("PhredBatchReader::readFile_. Error while reading file " + path + ".");
+}
+
+/******************************************************************************/
+
+void PhredBatchReader::parsePhd_(Buffers_& buffers) const
+{
+  buffers.name.clear();
+  buffers.sequence.clear();
+  buffers.quality.clear();
+  const char* p = buffers.text.data();
+  const char* end = p + buffers.text.size();
+  bool inDna = false;
+  bool dnaFound = false;
+  while (p < end)
+  {
+    const char* lineEnd = find(p, end, '\n');
+    // Tokens of the line:
+    const char* tokens[4][2];
+    size_t nbTokens = 0;
+    const char* q = p;
+    while (q < lineEnd)
+    {
+      while (q < lineEnd && TextTools::isWhiteSpaceCharacter(*q))
+      {
+        ++q;
+      }
+      if (q == lineEnd)
+        break;
+      const char* b = q;
+      while (q < lineEnd && !TextTools::isWhiteSpaceCharacter(*q))
+      {
+        ++q;
+      }
+      if (nbTokens < 4)
+      {
+        tokens[nbTokens][0] = b;
+        tokens[nbTokens][1] = q;
+      }
+      ++nbTokens;
+    }
+    p = lineEnd < end ? lineEnd + 1 : end;
+    if (nbTokens == 0)
+      continue;
+    string first(tokens[0][0], tokens[0][1]);
+    if (inDna)
+    {
+      if (first == "END_DNA")
+        break;
+      if (nbTokens == 3)
+      {
+        // Base call, quality and position on the trace:
+        if (tokens[0][1] - tokens[0][0] != 1)
+          throw IOException("PhredBatchReader::parsePhd_. Invalid base call: " + first);
+        buffers.sequence += static_cast<char>(toupper(static_cast<unsigned char>(*tokens[0][0])));
+        char* parsed = nullptr;
+        long quality = strtol(tokens[1][0], &parsed, 10);
+        if (parsed != tokens[1][1] || quality < 0 || quality > 255)
+          throw IOException("PhredBatchReader::parsePhd_. Invalid quality: " + string(tokens[1][0], tokens[1][1]));
+        buffers.quality.push_back(static_cast<uint8_t>(quality));
+      }
+    }
+    else if (first == "BEGIN_SEQUENCE" && nbTokens > 1)
+      buffers.name.assign(tokens[1][0], tokens[1][1]);
+    else if (first == "BEGIN_DNA")
+    {
+      inDna = true;
+      dnaFound = true;
+    }
+  }
+  if (buffers.name.empty())
+    throw IOException("PhredBatchReader::parsePhd_. Sequence without name.");
+  if (!dnaFound)
+    throw IOException("PhredBatchReader::parsePhd_. No DNA section found for sequence " + buffers.name + ".");
+}
+
+/******************************************************************************/
+
+void PhredBatchReader::parsePoly_(Buffers_& buffers, const Alphabet& alphabet) const
+{
+  buffers.name.clear();
+  buffers.sequence.clear();
+  const char* p = buffers.text.data();
+  const char* end = p + buffers.text.size();
+  bool firstLine = true;
+  vector<string> states;
+  while (p < end)
+  {
+    const char* lineEnd = find(p, end, '\n');
+    const char* tokens[12][2];
+    size_t nbTokens = 0;
+    const char* q = p;
+    while (q < lineEnd)
+    {
+      while (q < lineEnd && TextTools::isWhiteSpaceCharacter(*q))
+      {
+        ++q;
+      }
+      if (q == lineEnd)
+        break;
+      const char* b = q;
+      while (q < lineEnd && !TextTools::isWhiteSpaceCharacter(*q))
+      {
+        ++q;
+      }
+      if (nbTokens < 12)
+      {
+        tokens[nbTokens][0] = b;
+        tokens[nbTokens][1] = q;
+      }
+      ++nbTokens;
+    }
+    p = lineEnd < end ? lineEnd + 1 : end;
+    if (firstLine)
+    {
+      // The first line starts with the sequence name:
+      if (nbTokens > 0)
+        buffers.name.assign(tokens[0][0], tokens[0][1]);
+      firstLine = false;
+    }
+    else if (nbTokens == 12)
+    {
+      double a = strtod(string(tokens[3][0], tokens[3][1]).c_str(), nullptr);
+      double b = strtod(string(tokens[7][0], tokens[7][1]).c_str(), nullptr);
+      if (a < b)
+        swap(a, b);
+      states.assign(1, string(tokens[0][0], tokens[0][1])); // The called base
+      if (b / a > ratio_)
+        states.push_back(string(tokens[4][0], tokens[4][1])); // The uncalled base, if the areas of the peaks are similar
+      buffers.sequence += alphabet.getGeneric(states);
+    }
+  }
+  if (buffers.name.empty())
+    throw IOException("PhredBatchReader::parsePoly_. Sequence without name.");
+}
+
+/******************************************************************************/
+
+std::vector<std::string> PhredBatchReader::listFiles(const std::string& directory, const std::string& suffix)
+{
+  vector<string> paths;
+#ifdef BPP_SEQ_USE_DIRENT
+  DIR* dir = opendir(directory.c_str());
+  if (!dir)
+    throw IOException("PhredBatchReader::listFiles. Can't read directory " + directory + ".");
+  for (struct dirent* entry = readdir(dir); entry; entry = readdir(dir))
+  {
+    string name = entry->d_name;
+    if (name == "." || name == "..")
+      continue;
+    if (name.size() >= suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)
+      paths.push_back(directory + "/" + name);
+  }
+  closedir(dir);
+#else
+  throw IOException("PhredBatchReader::listFiles. Listing directories is not supported on this platform, please provide a list of files.");
+#endif
+  sort(paths.begin(), paths.end());
+  return paths;
+}
+
+/******************************************************************************/
@@ -0,0 +1,191 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_IO_PHREDBATCHREADER_H
+#define BPP_SEQ_IO_PHREDBATCHREADER_H
+
+#include <Bpp/Exceptions.h>
+
+#include "../Container/VectorSequenceContainer.h"
+#include "../ExecutionContext.h"
+#include "../PhredScores.h"
+#include "../Sequence.h"
+#include "../SequenceWithQuality.h"
+
+// From the STL:
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Read large collections of phd or poly files from the phred software.
+ *
+ * PhredPhd and PhredPoly read one stream at a time. This class reads a list of
+ * files (typically a whole directory of Sanger reads) in parallel with an
+ * ExecutionContext, and gathers all sequences in a single container. Files are
+ * read by small blocks, which reuse their file and parsing buffers from one
+ * file to the next.
+ *
+ * A file which cannot be read or parsed does not stop the batch: the error is
+ * recorded together with the path of the file, and the file is skipped.
+ * Sequences are added to the container in the order of the file list.
+ *
+ * Quality scores are parsed into compact PhredScores. readPhdRecords() keeps
+ * them in this form, which uses one byte per base call instead of the int
+ * stored by SequenceWithQuality.
+ *
+ * @see PhredPhd, PhredPoly
+ */
+class PhredBatchReader
+{
+public:
+  /**
+   * @brief Description of a file which could not be read.
+   */
+  struct Error
+  {
+    std::string path;
+    std::string message;
+  };
+
+  /**
+   * @brief A read from a phd file, with compact quality scores.
+   */
+  struct PhdRecord
+  {
+    std::string name;
+    std::string sequence;
+    PhredScores quality;
+
+    PhdRecord() : name(), sequence(), quality() {}
+  };
+
+private:
+  double ratio_;
+
+public:
+  /**
+   * @param ratio The minimum ratio between the two highest peaks to call an ambiguous base in poly files (see PhredPoly).
+   */
+  PhredBatchReader(double ratio = 0.8) :
+    ratio_(ratio) {}
+
+  virtual ~PhredBatchReader() {}
+
+public:
+  /**
+   * @brief Read phd files.
+   *
+   * The container holds SequenceWithQuality objects, with the quality of each base call.
+   *
+   * @param paths    The files to read.
+   * @param alphabet The alphabet of the sequences (typically DNA).
+   * @param errors   The vector to which errors are appended.
+   * @param context  The execution context used to read files in parallel.
+   * @return A container with one sequence per successfully read file.
+   */
+  std::unique_ptr< TemplateVectorSequenceContainer<SequenceWithQuality>> readPhdFiles(
+      const std::vector<std::string>& paths,
+      std::shared_ptr<const Alphabet> alphabet,
+      std::vector<Error>& errors,
+      const ExecutionContext& context = ExecutionContext::global()) const;
+
+  /**
+   * @brief Read phd files, without creating sequence objects.
+   *
+   * Base calls are stored as text and quality scores as PhredScores, for
+   * large batches of reads which are filtered or trimmed before being
+   * converted to sequences.
+   *
+   * @param paths    The files to read.
+   * @param errors   The vector to which errors are appended.
+   * @param context  The execution context used to read files in parallel.
+   * @return One record per successfully read file, in the order of the file list.
+   */
+  std::vector<PhdRecord> readPhdRecords(
+      const std::vector<std::string>& paths,
+      std::vector<Error>& errors,
+      const ExecutionContext& context = ExecutionContext::global()) const;
+
+  /**
+   * @brief Read poly files.
+   *
+   * @param paths    The files to read.
+   * @param alphabet The alphabet of the sequences (typically DNA).
+   * @param errors   The vector to which errors are appended.
+   * @param context  The execution context used to read files in parallel.
+   * @return A container with one sequence per successfully read file.
+   */
+  std::unique_ptr<VectorSequenceContainer> readPolyFiles(
+      const std::vector<std::string>& paths,
+      std::shared_ptr<const Alphabet> alphabet,
+      std::vector<Error>& errors,
+      const ExecutionContext& context = ExecutionContext::global()) const;
+
+  /**
+   * @brief List the files of a directory with a given suffix, sorted by name.
+   *
+   * @param directory The directory to list.
+   * @param suffix    The end of the file names to keep, for instance ".phd.1" (all files if empty).
+   * @throw IOException If the directory cannot be read, or if listing directories is not supported on this platform.
+   */
+  static std::vector<std::string> listFiles(const std::string& directory, const std::string& suffix = "");
+
+private:
+  /**
+   * @brief Buffers reused from one file to the next.
+   */
+  struct Buffers_
+  {
+    std::string text;
+    std::string name;
+    std::string sequence;
+    PhredScores quality;
+
+    Buffers_() : text(), name(), sequence(), quality() {}
+  };
+
+  /**
+   * @brief Read and parse files in parallel.
+   *
+   * @param paths    The files to read.
+   * @param parser   A function creating an object from the content of a file.
+   * @param messages The error message of each file, empty if the file was parsed.
+   * @param context  The execution context to use.
+   * @return The object created for each file, null if the file could not be parsed.
+   */
+  template<class T>
+  std::vector< std::unique_ptr<T>> parseFiles_(
+      const std::vector<std::string>& paths,
+      const std::function<std::unique_ptr<T>(Buffers_&)>& parser,
+      std::vector<std::string>& messages,
+      const ExecutionContext& context) const;
+
+  template<class SequenceType>
+  std::unique_ptr< TemplateVectorSequenceContainer<SequenceType>> read_(
+      const std::vector<std::string>& paths,
+      std::shared_ptr<const Alphabet> alphabet,
+      std::vector<Error>& errors,
+      const std::function<std::unique_ptr<SequenceType>(Buffers_&)>& parser,
+      const ExecutionContext& context) const;
+
+  /**
+   * @brief Parse the text of a phd file into the name, sequence and quality buffers.
+   */
+  void parsePhd_(Buffers_& buffers) const;
+
+  /**
+   * @brief Parse the text of a poly file into the name and sequence buffers.
+   */
+  void parsePoly_(Buffers_& buffers, const Alphabet& alphabet) const;
+
+  static void reportErrors_(const std::vector<std::string>& paths, const std::vector<std::string>& messages, std::vector<Error>& errors);
+
+  static void readFile_(const std::string& path, std::string& text);
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_IO_PHREDBATCHREADER_H
@@ -7,6 +7,10 @@
 #include <Bpp/Text/TextTools.h>
 
 #include "../Container/SequenceContainerTools.h"
+#include "../SymbolDecoder.h"
+#include "../SymbolEncoder.h"
+#include "BlockWriter.h"
+#include "InterleavedBlockParser.h"
 #include "Phylip.h"
 
 using namespace bpp;
@@ -50,6 +54,23 @@ void Phylip::readSequential(std::istream& in, SequenceContainerInterface& sc) co
   string name = "";
   string seq  = "";
 
+  // Invalid characters are handled according to the ingest policy:
+  SymbolEncoder encoder = ingestPolicy_.createEncoder(alphaPtr);
+  auto addSequence = [&]()
+  {
+    vector<int> states;
+    states.reserve(seq.size() / encoder.getCodingSize());
+    string pending;
+    vector<SymbolEncoder::InvalidSymbol> invalid;
+    ScopedTimer timer("io.encode_symbols");
+    encoder.encode(seq.data(), seq.data() + seq.size(), states, pending, invalid);
+    if (!pending.empty())
+      throw BadCharException(pending, "Phylip::readSequential. Incomplete state at the end of sequence " + name + ".", alphaPtr);
+    ingestPolicy_.record(name, invalid);
+    auto seqPtr = make_unique<Sequence>(name, states, alphaPtr);
+    sc.addSequence(name, seqPtr);
+  };
+
   while (!in.eof())
   {
     // Read each sequence:
@@ -69,8 +90,7 @@ void Phylip::readSequential(std::istream& in, SequenceContainerInterface& sc) co
       if (!TextTools::isEmpty(name)) // If this is not the first sequence!
       {
         // Add the previous sequence to the container:
-        auto seqPtr = make_unique<Sequence>(name, seq, alphaPtr);
-        sc.addSequence(name, seqPtr);
+        addSequence();
       }
       name = v[0];
       seq  = v[1];
@@ -92,8 +112,7 @@ void Phylip::readSequential(std::istream& in, SequenceContainerInterface& sc) co
     temp = TextTools::removeSurroundingWhiteSpaces(FileTools::getNextLine(in));
   }
   // Add last sequence:
-  auto seqPtr = make_unique<Sequence>(name, seq, alphaPtr);
-  sc.addSequence(name, seqPtr);
+  addSequence();
 }
 
 /******************************************************************************/
@@ -101,43 +120,47 @@ void Phylip::readSequential(std::istream& in, SequenceContainerInterface& sc) co
 void Phylip::readInterleaved(std::istream& in, SequenceContainerInterface& sc) const
 {
   auto alphaPtr = sc.getAlphabet();
-  string temp;
+  string line;
 
   // Read first line:
-  getline(in, temp, '\n'); // Copy current line in temporary string
-  StringTokenizer st(temp);
+  getline(in, line, '\n'); // Copy current line in temporary string
+  StringTokenizer st(line);
   unsigned int nbSequences = TextTools::to<unsigned int>(st.nextToken());
-  // int nbSites     = TextTools::toInt(st.nextToken());
-  temp = FileTools::getNextLine(in);
-
-  vector<string> names, seqs;
-  // Read first block:
-  for (size_t i = 0; i < nbSequences && !in.eof() && !TextTools::isEmpty(temp); ++i)
-  {
-    vector<string> v = splitNameAndSequence(temp);
-    names.push_back(v[0]);
-    seqs.push_back(v[1]);
-    getline(in, temp, '\n');  // read next line in file.
-  }
+  size_t nbSites = st.hasMoreToken() ? TextTools::to<size_t>(st.nextToken()) : 0;
 
-  // Then read all other blocks:
-  temp = FileTools::getNextLine(in);
-  while (!in.eof())
+  // Row buffers are presized from the header, and blocks are encoded as they come:
+  InterleavedBlockParser parser(alphaPtr, nbSites / alphaPtr->getStateCodingSize(), ingestPolicy_);
+  bool firstBlock = true;
+  size_t count = 0;
+  while (getline(in, line, '\n'))
   {
-    for (size_t i = 0; i < names.size(); ++i)
+    if (TextTools::isEmpty(line))
     {
-      if (TextTools::isEmpty(temp))
+      if (firstBlock)
+      {
+        if (parser.getNumberOfRows() > 0)
+          firstBlock = false;
+      }
+      else if (count % parser.getNumberOfRows() != 0)
         throw IOException("Phylip::readInterleaved. Bad file,there are not the same number of sequence in each block.");
-      seqs[i] += TextTools::removeWhiteSpaces(temp);
-      getline(in, temp, '\n');  // read next line in file.
+      continue;
+    }
+    if (firstBlock)
+    {
+      vector<string> v = splitNameAndSequence(line);
+      parser.addRow(v[0], v[1].data(), v[1].data() + v[1].size());
+      if (parser.getNumberOfRows() == nbSequences)
+        firstBlock = false;
+    }
+    else
+    {
+      parser.appendToRow(count % parser.getNumberOfRows(), line.data(), line.data() + line.size());
+      ++count;
     }
-    temp = FileTools::getNextLine(in);
-  }
-  for (size_t i = 0; i < names.size(); ++i)
-  {
-    auto seqPtr = make_unique<Sequence>(names[i], seqs[i], alphaPtr);
-    sc.addSequence(names[i], seqPtr);
   }
+  if (parser.getNumberOfRows() > 0 && count % parser.getNumberOfRows() != 0)
+    throw IOException("Phylip::readInterleaved. Bad file,there are not the same number of sequence in each block.");
+  parser.flush(sc);
 }
 
 /******************************************************************************/
@@ -212,53 +235,63 @@ std::vector<std::string> Phylip::getSizedNames(const std::vector<std::string>& n
 
 void Phylip::writeSequential(std::ostream& out, const SiteContainerInterface& sc) const
 {
-  // cout << "Write sequential" << endl;
-  size_t numberOfSites = sc.sequence(sc.getSequenceNames()[0]).size() * sc.getAlphabet()->getStateCodingSize();
+  SymbolDecoder decoder(sc.getAlphabet());
+  size_t numberOfSites = sc.sequence(0).size() * decoder.getCodingSize();
   out << sc.getNumberOfSequences() << " " << numberOfSites << endl;
 
   vector<string> seqNames = sc.getSequenceNames();
   vector<string> names = getSizedNames(seqNames);
+  // Rows are decoded line by line in the output buffer:
+  BlockWriter writer(out);
+  string& buffer = writer.buffer();
   for (size_t i = 0; i < sc.getNumberOfSequences(); ++i)
   {
-    vector<string> seq = TextTools::split(sc.sequence(i).toString(), charsByLine_);
-    out << names[i] << seq[0] << endl;
-    for (size_t j = 1; j < seq.size(); ++j)
+    const vector<int>& content = sc.sequence(i).getContent();
+    size_t nbChars = content.size() * decoder.getCodingSize();
+    buffer += names[i];
+    for (size_t j = 0; j < nbChars || j == 0; j += charsByLine_)
     {
-      out << string(names[i].size(), ' ') << seq[j] << endl;
+      if (j > 0)
+        buffer.append(names[i].size(), ' ');
+      decoder.decode(content, j, j + charsByLine_, buffer);
+      buffer += '\n';
+      writer.commit();
     }
-    out << endl;
+    buffer += '\n';
   }
+  writer.flush();
 }
 
 void Phylip::writeInterleaved(std::ostream& out, const SiteContainerInterface& sc) const
 {
-  // cout << "Write interleaved;" << endl;
-  size_t numberOfSites = sc.sequence(sc.getSequenceNames()[0]).size() * sc.getAlphabet()->getStateCodingSize();
+  SymbolDecoder decoder(sc.getAlphabet());
+  size_t numberOfSites = sc.sequence(0).size() * decoder.getCodingSize();
   out << sc.getNumberOfSequences() << " " << numberOfSites << endl;
 
   vector<string> seqNames = sc.getSequenceNames();
   vector<string> names = getSizedNames(seqNames);
-  // Split sequences:
-  vector< vector<string>> seqs(sc.getNumberOfSequences());
+  vector<const vector<int>*> contents(sc.getNumberOfSequences());
   for (size_t i = 0; i < sc.getNumberOfSequences(); ++i)
   {
-    seqs[i] = TextTools::split(sc.sequence(i).toString(), charsByLine_);
-  }
-  // Write first block:
-  for (size_t i = 0; i < names.size(); ++i)
-  {
-    out << names[i] << seqs[i][0] << endl;
+    contents[i] = &sc.sequence(i).getContent();
   }
-  out << endl;
-  // Write other blocks:
-  for (size_t j = 1; j < seqs[0].size(); ++j)
+  // Each block is decoded independently, only the first one has sequence names:
+  size_t nbBlocks = max(static_cast<size_t>(1), (numberOfSites + charsByLine_ - 1) / charsByLine_);
+  auto formatBlock = [&](size_t b, string& text)
   {
-    for (size_t i = 0; i < sc.getNumberOfSequences(); ++i)
+    size_t j = b * charsByLine_;
+    for (size_t i = 0; i < contents.size(); ++i)
     {
-      out << seqs[i][j] << endl;
+      if (b == 0)
+        text += names[i];
+      decoder.decode(*contents[i], j, j + charsByLine_, text);
+      text += '\n';
     }
-    out << endl;
-  }
+    text += '\n';
+  };
+  BlockWriter writer(out);
+  writer.writeBlocks(nbBlocks, formatBlock, getExecutionContext());
+  writer.flush();
 }
 
 /******************************************************************************/
@@ -293,3 +326,88 @@ const std::string Phylip::getFormatDescription() const
 }
 
 /******************************************************************************/
+
+// FileIndex class
+
+void Phylip::FileIndex::scan_(std::istream& input)
+{
+  Phylip format(extended_, true, 100, namesSplit_);
+  string line;
+  getline(input, line, '\n');
+  uint64_t pos = line.size() + 1;
+  StringTokenizer st(line, " \t");
+  if (st.numberOfRemainingTokens() < 2)
+    throw IOException("Phylip::FileIndex::build. Bad file, invalid header line: " + line);
+  size_t nbSequences = TextTools::to<size_t>(st.nextToken());
+  size_t nbCharacters = TextTools::to<size_t>(st.nextToken());
+
+  for (size_t i = 0; i < nbSequences; ++i)
+  {
+    // Skip blank lines between sequences:
+    bool found = false;
+    while (!found && getline(input, line, '\n'))
+    {
+      found = !TextTools::isEmpty(line);
+      if (!found)
+        pos += line.size() + 1;
+    }
+    if (!found)
+      throw IOException("Phylip::FileIndex::build. Bad file, expected " + TextTools::toString(nbSequences) + " sequences.");
+    uint64_t start = pos;
+    vector<string> v;
+    try
+    {
+      v = format.splitNameAndSequence(line);
+    }
+    catch (Exception& e)
+    {
+      throw IOException("Phylip::FileIndex::build. No sequence name found in line: " + line);
+    }
+    // Sequences may span several lines:
+    size_t count = SymbolEncoder::countSymbols(v[1].data(), v[1].data() + v[1].size());
+    pos += line.size() + 1;
+    while (count < nbCharacters)
+    {
+      if (!getline(input, line, '\n'))
+        throw IOException("Phylip::FileIndex::build. Unexpected end of file in sequence " + v[0] + ".");
+      count += SymbolEncoder::countSymbols(line.data(), line.data() + line.size());
+      pos += line.size() + 1;
+    }
+    if (count != nbCharacters)
+      throw IOException("Phylip::FileIndex::build. Sequence " + v[0] + " does not have the length given in the header.");
+    addEntry_(v[0], start, pos - start, nbCharacters);
+  }
+}
+
+/******************************************************************************/
+
+void Phylip::FileIndex::getSequence(const std::string& seqid, Sequence& seq, const std::string& path) const
+{
+  Phylip format(extended_, true, 100, namesSplit_);
+  Entry entry = getEntry(seqid);
+  ifstream input(path.c_str(), ios::in | ios::binary);
+  if (!input)
+    throw IOException("Phylip::FileIndex::getSequence. Can't read file " + path + ".");
+  input.seekg(static_cast<streamoff>(entry.offset));
+  string record(static_cast<size_t>(entry.recordLength), ' ');
+  if (!input.read(&record[0], static_cast<streamsize>(record.size())))
+    throw IOException("Phylip::FileIndex::getSequence. Unexpected end of file in sequence " + seqid + ".");
+
+  // The name is on the first line, the content may span several lines:
+  string::size_type lineEnd = record.find('\n');
+  vector<string> v = format.splitNameAndSequence(record.substr(0, lineEnd));
+  SymbolEncoder encoder(seq.getAlphabet());
+  vector<int> content;
+  content.reserve(static_cast<size_t>(entry.sequenceLength));
+  string text = v[1];
+  if (lineEnd != string::npos)
+    text += record.substr(lineEnd + 1);
+  {
+    ScopedTimer timer("io.encode_symbols");
+    encoder.encode(text, content);
+  }
+  seq.setName(v[0]);
+  seq.setContent(content);
+}
+
+/******************************************************************************/
@@ -9,9 +9,12 @@
 #include "../Container/AlignedSequenceContainer.h"
 #include "../Container/SequenceContainer.h"
 #include "../Container/VectorSequenceContainer.h"
+#include "../ExecutionContext.h"
 #include "../Sequence.h"
 #include "AbstractIAlignment.h"
 #include "AbstractOAlignment.h"
+#include "AbstractSequenceFileIndex.h"
+#include "IngestPolicy.h"
 
 // From the STL:
 #include <iostream>
@@ -46,6 +49,10 @@ private:
 
   std::string namesSplit_;
 
+  std::shared_ptr<const ExecutionContext> context_; // Used to format blocks (output only), global one if null
+
+  IngestPolicy ingestPolicy_; // How invalid characters are handled (input only)
+
 public:
   /**
    * @brief Build a new Phylip file reader.
@@ -56,7 +63,7 @@ public:
    * @param split The string to use to split sequence name from content (only for 'extended' format). This will typically be "  " (two spaces) or "\t" (a tabulation).
    */
   Phylip(bool extended = true, bool sequential = true, unsigned int charsByLine = 100, const std::string& split = "  ") :
-    extended_(extended), sequential_(sequential), charsByLine_(charsByLine), namesSplit_(split) {}
+    extended_(extended), sequential_(sequential), charsByLine_(charsByLine), namesSplit_(split), context_(), ingestPolicy_() {}
 
   virtual ~Phylip() {}
 
@@ -127,6 +134,67 @@ public:
    */
   void setSplit(const std::string& split) { namesSplit_ = split; }
 
+  /**
+   * @return The execution context used to format blocks when writing interleaved alignments.
+   */
+  const ExecutionContext& getExecutionContext() const { return context_ ? *context_ : ExecutionContext::global(); }
+
+  /**
+   * @brief Set the execution context used to format blocks when writing interleaved alignments.
+   *
+   * Blocks are formatted in parallel and written in file order.
+   *
+   * @param context The context to use, or null for the library-wide one, ExecutionContext::global() (the default).
+   */
+  void setExecutionContext(std::shared_ptr<const ExecutionContext> context) { context_ = context; }
+
+  /**
+   * @return How characters which are not part of the alphabet are handled when reading.
+   */
+  const IngestPolicy& getIngestPolicy() const { return ingestPolicy_; }
+
+  /**
+   * @brief Set how characters which are not part of the alphabet are handled when reading.
+   *
+   * @param policy The policy to use (strict by default).
+   */
+  void setIngestPolicy(const IngestPolicy& policy) { ingestPolicy_ = policy; }
+
+  /**
+   * @brief The SequenceFileIndex class for sequential Phylip format.
+   *
+   * Offsets point to the line starting with the sequence name, and sequence lengths
+   * are the number of characters given in the file header.
+   */
+  class FileIndex :
+    public AbstractSequenceFileIndex
+  {
+private:
+    bool extended_;
+    std::string namesSplit_;
+
+public:
+    /**
+     * @param extended If using PAML extension, where names are separated from the content by 'split'.
+     * @param split The string used to split sequence names from content (extended format only).
+     */
+    FileIndex(bool extended = true, const std::string& split = "  ") : extended_(extended), namesSplit_(split) {}
+    virtual ~FileIndex() {}
+
+    /**
+     * @brief Get a sequence given its ID.
+     *
+     * @param seqid The ID of the sequence.
+     * @param seq The sequence to fill, with the alphabet of the file.
+     * @param path The path to the indexed file.
+     * @throw Exception If the ID is not in the index, or if the record cannot be read.
+     */
+    void getSequence(const std::string& seqid, Sequence& seq, const std::string& path) const;
+
+protected:
+    void scan_(std::istream& input) override;
+  };
+
 protected:
   // Reading tools:
   const std::vector<std::string> splitNameAndSequence(const std::string& s) const;
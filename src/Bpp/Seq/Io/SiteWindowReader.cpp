@@ -0,0 +1,226 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Text/StringTokenizer.h>
+#include <Bpp/Text/TextTools.h>
+
+#include "../Profiler.h"
+#include "IoSequenceFactory.h"
+#include "SiteWindowReader.h"
+
+// From the STL:
+#include <algorithm>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+SiteWindowReader::SiteWindowReader(
+    const std::string& path,
+    const std::string& format,
+    std::shared_ptr<const Alphabet> alphabet,
+    size_t windowSize) :
+  path_(path),
+  format_(format),
+  encoder_(alphabet),
+  input_(path.c_str(), ios::in | ios::binary),
+  names_(),
+  startOffsets_(),
+  offsets_(),
+  numberOfSites_(0),
+  windowSize_(0),
+  position_(0),
+  buffer_(1 << 16)
+{
+  if (!input_)
+    throw IOException("SiteWindowReader. Can't open file " + path + ".");
+  setWindowSize(windowSize);
+  if (format == IoSequenceFactory::FASTA_FORMAT)
+    indexFasta_();
+  else if (format == IoSequenceFactory::PHYLIP_FORMAT_SEQUENTIAL)
+    indexPhylip_(false);
+  else if (format == IoSequenceFactory::PAML_FORMAT_SEQUENTIAL)
+    indexPhylip_(true);
+  else
+    throw Exception("SiteWindowReader. Format " + format + " is not supported for windowed input.");
+  offsets_ = startOffsets_;
+}
+
+/******************************************************************************/
+
+void SiteWindowReader::setWindowSize(size_t windowSize)
+{
+  if (windowSize == 0)
+    throw Exception("SiteWindowReader::setWindowSize. Window size must be positive.");
+  windowSize_ = windowSize;
+}
+
+/******************************************************************************/
+
+void SiteWindowReader::indexFasta_()
+{
+  string line;
+  vector<size_t> lengths;
+  while (getline(input_, line, '\n'))
+  {
+    if (!line.empty() && line[0] == '>')
+    {
+      names_.push_back(TextTools::removeSurroundingWhiteSpaces(line.substr(1)));
+      startOffsets_.push_back(input_.tellg());
+      lengths.push_back(0);
+    }
+    else if (!names_.empty())
+    {
+      lengths.back() += SymbolEncoder::countSymbols(line.data(), line.data() + line.size());
+    }
+    else if (!TextTools::isEmpty(line))
+    {
+      throw IOException("SiteWindowReader::indexFasta_. Bad file, content found before the first sequence header.");
+    }
+  }
+  if (names_.empty())
+    throw IOException("SiteWindowReader::indexFasta_. No sequence found in file " + path_ + ".");
+  for (size_t i = 0; i < names_.size(); ++i)
+  {
+    if (lengths[i] != lengths[0])
+      throw IOException("SiteWindowReader::indexFasta_. Sequence " + names_[i] + " does not have the same length as the first sequence.");
+  }
+  if (lengths[0] % encoder_.getCodingSize() != 0)
+    throw IOException("SiteWindowReader::indexFasta_. Sequence length is not a multiple of the alphabet coding size.");
+  numberOfSites_ = lengths[0] / encoder_.getCodingSize();
+}
+
+/******************************************************************************/
+
+void SiteWindowReader::indexPhylip_(bool extended)
+{
+  string line;
+  getline(input_, line, '\n');
+  StringTokenizer st(line, " \t");
+  if (st.numberOfRemainingTokens() < 2)
+    throw IOException("SiteWindowReader::indexPhylip_. Bad file, invalid header line: " + line);
+  size_t nbSequences = TextTools::to<size_t>(st.nextToken());
+  size_t nbCharacters = TextTools::to<size_t>(st.nextToken());
+  if (nbCharacters % encoder_.getCodingSize() != 0)
+    throw IOException("SiteWindowReader::indexPhylip_. Sequence length is not a multiple of the alphabet coding size.");
+
+  for (size_t i = 0; i < nbSequences; ++i)
+  {
+    // Skip blank lines between sequences:
+    streampos lineStart;
+    do
+    {
+      lineStart = input_.tellg();
+      if (!getline(input_, line, '\n'))
+        throw IOException("SiteWindowReader::indexPhylip_. Bad file, expected " + TextTools::toString(nbSequences) + " sequences.");
+    }
+    while (TextTools::isEmpty(line));
+
+    size_t beginSeq = 0;
+    if (extended)
+    {
+      string::size_type index = line.find("  ");
+      if (index == string::npos)
+        throw IOException("SiteWindowReader::indexPhylip_. No sequence name found in line: " + line);
+      names_.push_back(TextTools::removeSurroundingWhiteSpaces(line.substr(0, index)));
+      beginSeq = index + 2;
+    }
+    else
+    {
+      names_.push_back(TextTools::removeSurroundingWhiteSpaces(line.substr(0, 10)));
+      beginSeq = min(line.size(), static_cast<size_t>(10));
+    }
+    startOffsets_.push_back(lineStart + static_cast<streamoff>(beginSeq));
+
+    // Sequences may span several lines:
+    size_t count = SymbolEncoder::countSymbols(line.data() + beginSeq, line.data() + line.size());
+    while (count < nbCharacters)
+    {
+      if (!getline(input_, line, '\n'))
+        throw IOException("SiteWindowReader::indexPhylip_. Unexpected end of file in sequence " + names_.back() + ".");
+      count += SymbolEncoder::countSymbols(line.data(), line.data() + line.size());
+    }
+    if (count != nbCharacters)
+      throw IOException("SiteWindowReader::indexPhylip_. Sequence " + names_.back() + " does not have the length given in the header.");
+  }
+  numberOfSites_ = nbCharacters / encoder_.getCodingSize();
+}
+
+/******************************************************************************/
+
+void SiteWindowReader::readRow_(size_t row, size_t nbStates, std::vector<int>& content)
+{
+  size_t needed = nbStates * encoder_.getCodingSize();
+  input_.clear();
+  input_.seekg(offsets_[row]);
+  streampos pos = offsets_[row];
+  string pending;
+  CumulativeTimer encodeTimer("io.encode_symbols");
+  while (needed > 0)
+  {
+    // Lines are usually short compared to the window, so a small margin for line breaks is enough:
+    size_t chunk = min(buffer_.size(), needed + needed / 16 + 16);
+    input_.read(&buffer_[0], static_cast<streamsize>(chunk));
+    size_t n = static_cast<size_t>(input_.gcount());
+    if (n == 0)
+      throw IOException("SiteWindowReader::nextWindow. Unexpected end of file in sequence " + names_[row] + ".");
+    size_t i = 0;
+    for ( ; i < n && needed > 0; ++i)
+    {
+      char c = buffer_[i];
+      if (c == '>')
+        throw IOException("SiteWindowReader::nextWindow. Sequence " + names_[row] + " is too short.");
+      if (!TextTools::isWhiteSpaceCharacter(c))
+        --needed;
+    }
+    encodeTimer.start();
+    encoder_.encode(&buffer_[0], &buffer_[0] + i, content, pending);
+    encodeTimer.stop();
+    pos += static_cast<streamoff>(i);
+  }
+  offsets_[row] = pos;
+}
+
+/******************************************************************************/
+
+std::unique_ptr<VectorSiteContainer> SiteWindowReader::nextWindow()
+{
+  if (!hasMoreWindows())
+    return nullptr;
+
+  size_t nbSites = min(windowSize_, numberOfSites_ - position_);
+  size_t nbSequences = names_.size();
+  vector< vector<int>> rows(nbSequences);
+  for (size_t i = 0; i < nbSequences; ++i)
+  {
+    rows[i].reserve(nbSites);
+    readRow_(i, nbSites, rows[i]);
+  }
+
+  auto alphaPtr = encoder_.getAlphabet();
+  auto sites = make_unique<VectorSiteContainer>(names_, alphaPtr);
+  vector<int> column(nbSequences);
+  for (size_t j = 0; j < nbSites; ++j)
+  {
+    for (size_t i = 0; i < nbSequences; ++i)
+    {
+      column[i] = rows[i][j];
+    }
+    auto site = make_unique<Site>(column, alphaPtr, static_cast<int>(position_ + j + 1));
+    sites->addSite(site, false);
+  }
+  position_ += nbSites;
+  return sites;
+}
+
+/******************************************************************************/
+
+void SiteWindowReader::reset()
+{
+  offsets_ = startOffsets_;
+  position_ = 0;
+}
+
+/******************************************************************************/
@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_IO_SITEWINDOWREADER_H
+#define BPP_SEQ_IO_SITEWINDOWREADER_H
+
+
+#include "../Container/VectorSiteContainer.h"
+#include "../SymbolEncoder.h"
+
+// From the STL:
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Read an alignment file by windows of consecutive sites.
+ *
+ * This reader is meant for alignments too large to be loaded in memory at once.
+ * The file is scanned once when the reader is created, in order to record the
+ * name of each sequence and the file offset where its content starts. Windows
+ * of sites are then read on demand: for each sequence, the reader seeks to the
+ * current offset of the row, reads the requested number of states and stores
+ * the new offset. Only the current window is kept in memory, whatever the size
+ * of the file.
+ *
+ * Supported formats are sequential ones, where the content of each sequence is
+ * stored contiguously:
+ * - IoSequenceFactory::FASTA_FORMAT (sequence names are the full header lines),
+ * - IoSequenceFactory::PHYLIP_FORMAT_SEQUENTIAL (names on 10 characters),
+ * - IoSequenceFactory::PAML_FORMAT_SEQUENTIAL (names separated from the content by at least two spaces).
+ *
+ * Sites are numbered according to their position in the full alignment, starting at 1.
+ *
+ * Example:
+ * @code
+ * SiteWindowReader reader("genome.fasta", IoSequenceFactory::FASTA_FORMAT, AlphabetTools::DNA_ALPHABET, 100000);
+ * while (reader.hasMoreWindows())
+ * {
+ *   auto window = reader.nextWindow();
+ *   // compute statistics on window...
+ * }
+ * @endcode
+ */
+class SiteWindowReader
+{
+private:
+  std::string path_;
+  std::string format_;
+  SymbolEncoder encoder_;
+  std::ifstream input_;
+  std::vector<std::string> names_;
+  std::vector<std::streampos> startOffsets_;
+  std::vector<std::streampos> offsets_;
+  size_t numberOfSites_;
+  size_t windowSize_;
+  size_t position_;
+  std::vector<char> buffer_;
+
+public:
+  /**
+   * @brief Open a file and index its sequences.
+   *
+   * @param path The file to read.
+   * @param format The file format, as defined in IoSequenceFactory.
+   * @param alphabet The alphabet to use.
+   * @param windowSize The number of sites in each window.
+   * @throw IOException If the file cannot be read, or if the sequences do not have the same length.
+   * @throw Exception If the format is not supported.
+   */
+  SiteWindowReader(
+      const std::string& path,
+      const std::string& format,
+      std::shared_ptr<const Alphabet> alphabet,
+      size_t windowSize = 100000);
+
+  virtual ~SiteWindowReader() {}
+
+private:
+  SiteWindowReader(const SiteWindowReader&) = delete;
+  SiteWindowReader& operator=(const SiteWindowReader&) = delete;
+
+public:
+  std::shared_ptr<const Alphabet> getAlphabet() const { return encoder_.getAlphabet(); }
+
+  size_t getNumberOfSequences() const { return names_.size(); }
+
+  const std::vector<std::string>& getSequenceNames() const { return names_; }
+
+  /**
+   * @return The total number of sites in the alignment.
+   */
+  size_t getNumberOfSites() const { return numberOfSites_; }
+
+  size_t getWindowSize() const { return windowSize_; }
+
+  void setWindowSize(size_t windowSize);
+
+  /**
+   * @return The index of the first site of the next window (0-based).
+   */
+  size_t getPosition() const { return position_; }
+
+  bool hasMoreWindows() const { return position_ < numberOfSites_; }
+
+  /**
+   * @brief Read the next window of sites.
+   *
+   * The last window of the alignment may be smaller than the window size.
+   *
+   * @return A container with the sites of the window, or a null pointer if there are no more sites.
+   * @throw IOException If a sequence ends before the expected position.
+   * @throw BadCharException If a character is not part of the alphabet.
+   */
+  std::unique_ptr<VectorSiteContainer> nextWindow();
+
+  /**
+   * @brief Go back to the first site of the alignment.
+   */
+  void reset();
+
+private:
+  void indexFasta_();
+  void indexPhylip_(bool extended);
+
+  /**
+   * @brief Read and encode a given number of states of a row, starting at the current offset of that row.
+   */
+  void readRow_(size_t row, size_t nbStates, std::vector<int>& content);
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_IO_SITEWINDOWREADER_H
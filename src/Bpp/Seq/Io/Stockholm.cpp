@@ -7,6 +7,9 @@
 #include <Bpp/Text/TextTools.h>
 
 #include "../StringSequenceTools.h"
+#include "../SymbolDecoder.h"
+#include "BlockWriter.h"
+#include "InterleavedBlockParser.h"
 #include "Stockholm.h"
 
 using namespace bpp;
@@ -14,6 +17,76 @@ using namespace std;
 
 /******************************************************************************/
 
+void Stockholm::appendAlignmentFromStream(std::istream& input, SequenceContainerInterface& sc) const
+{
+  if (!input)
+    throw IOException("Stockholm::appendAlignmentFromStream: can't read from istream input");
+
+  string lineRead;
+  getline(input, lineRead, '\n');
+  if (lineRead.compare(0, 11, "# STOCKHOLM") != 0)
+    throw IOException("Stockholm::appendAlignmentFromStream. Bad file, missing '# STOCKHOLM' header.");
+
+  // Blocks are encoded directly into per-sequence buffers:
+  InterleavedBlockParser parser(sc.getAlphabet(), 0, ingestPolicy_);
+  Comments comments;
+  bool firstBlock = true;
+  bool estimated = false;
+  while (getline(input, lineRead, '\n'))
+  {
+    if (lineRead.compare(0, 2, "//") == 0)
+      break;
+    if (TextTools::isEmpty(lineRead))
+    {
+      if (parser.getNumberOfRows() > 0)
+        firstBlock = false;
+      continue;
+    }
+    if (lineRead[0] == '#')
+    {
+      if (lineRead.compare(0, 8, "#=GF CC ") == 0)
+        comments.push_back(lineRead.substr(8));
+      continue;
+    }
+    string::size_type endName = lineRead.find_first_of(" \t");
+    if (endName == string::npos)
+      throw IOException("Stockholm::appendAlignmentFromStream. Bad file, no sequence data in line: " + lineRead);
+    string name = lineRead.substr(0, endName);
+    // '.' is used for gaps in insert columns:
+    for (size_t i = endName; i < lineRead.size(); ++i)
+    {
+      if (lineRead[i] == '.')
+        lineRead[i] = '-';
+    }
+    size_t row = parser.findRow(name);
+    if (row == parser.getNumberOfRows())
+    {
+      if (!firstBlock)
+        throw IOException("Stockholm::appendAlignmentFromStream. Bad file, sequence " + name + " is not in the first block.");
+      parser.addRow(name, lineRead.data() + endName, lineRead.data() + lineRead.size());
+    }
+    else if (firstBlock && checkNames_)
+    {
+      throw Exception("Stockholm::appendAlignmentFromStream. Sequence name " + name + " is duplicated.");
+    }
+    else
+    {
+      if (!estimated)
+      {
+        // The length of the alignment is not known, we estimate it from the size of the file:
+        parser.estimateExpectedLength(input);
+        estimated = true;
+      }
+      parser.appendToRow(row, lineRead.data() + endName, lineRead.data() + lineRead.size());
+    }
+  }
+
+  parser.flush(sc);
+  sc.setComments(comments);
+}
+
+/******************************************************************************/
+
 void Stockholm::writeAlignment(ostream& output, const SiteContainerInterface& sc) const
 {
   if (!output)
@@ -37,11 +110,21 @@ void Stockholm::writeAlignment(ostream& output, const SiteContainerInterface& sc
   }
   if (maxSize > 255)
     maxSize = 255;
+  // Rows are decoded directly in the output buffer:
+  SymbolDecoder decoder(sc.getAlphabet());
+  BlockWriter writer(output);
+  string& buffer = writer.buffer();
   for (size_t i = 0; i < sc.getNumberOfSequences(); ++i)
   {
-    output << TextTools::resizeRight(names[i], maxSize) << " " << sc.sequence(i).toString() << endl;
+    const vector<int>& content = sc.sequence(i).getContent();
+    buffer += TextTools::resizeRight(names[i], maxSize);
+    buffer += ' ';
+    decoder.decode(content.data(), content.data() + content.size(), buffer);
+    buffer += '\n';
+    writer.commit();
   }
-  output << "//" << endl;
+  buffer += "//\n";
+  writer.flush();
 }
 
 /******************************************************************************/
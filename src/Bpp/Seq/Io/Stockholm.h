@@ -9,21 +9,28 @@
 #include "../Container/AlignedSequenceContainer.h"
 #include "../Container/SequenceContainer.h"
 #include "../Sequence.h"
+#include "AbstractIAlignment.h"
 #include "AbstractOAlignment.h"
+#include "IngestPolicy.h"
 
 namespace bpp
 {
 /**
  * @brief The Stockholm alignment file format.
  *
- * Write to Stockholm files.
- * Only sequence data is read/written, annotation and secondary structures are ignored.
+ * Read and write Stockholm files.
+ * Only sequence data is read/written, annotation and secondary structures are ignored,
+ * except for general comments (#=GF CC lines).
+ * When reading, '.' characters are read as gaps, and only the first alignment of the
+ * file is read.
  */
 class Stockholm :
+  public AbstractIAlignment2,
   public AbstractOAlignment
 {
 private:
   bool checkNames_;
+  IngestPolicy ingestPolicy_; // How invalid characters are handled (input only)
 
 public:
   /**
@@ -31,12 +38,39 @@ public:
    *
    * @param checkSequenceNames Tell if the names in the file should be checked for unicity (slower, in o(n*n) where n is the number of sequences).
    */
-  Stockholm(bool checkSequenceNames = true) : checkNames_(checkSequenceNames) {}
+  Stockholm(bool checkSequenceNames = true) : checkNames_(checkSequenceNames), ingestPolicy_() {}
 
   // Class destructor
   virtual ~Stockholm() {}
 
 public:
+  /**
+   * @name The AbstractIAlignment interface.
+   *
+   * @{
+   */
+  void appendAlignmentFromStream(std::istream& input, SequenceContainerInterface& sc) const override;
+  /** @} */
+
+  /**
+   * @name The ISequence interface.
+   *
+   * As a SiteContainer is a subclass of SequenceContainer, we hereby implement the ISequence
+   * interface by downcasting the interface.
+   *
+   * @{
+   */
+  std::unique_ptr<SequenceContainerInterface> readSequences(std::istream& input, std::shared_ptr<const Alphabet> alpha) const override
+  {
+    return readAlignment(input, alpha);
+  }
+
+  std::unique_ptr<SequenceContainerInterface> readSequences(const std::string& path, std::shared_ptr<const Alphabet> alpha) const override
+  {
+    return readAlignment(path, alpha);
+  }
+  /** @} */
+
   /**
    * @name The OAlignment interface.
    *
@@ -62,7 +96,6 @@ public:
   /** @} */
 
   /**
-   * @warning This is not used for now, will be when reading is implemented.
    * @return true if the names are to be checked when reading sequences from files.
    */
   bool checkNames() const { return checkNames_; }
@@ -70,10 +103,21 @@ public:
   /**
    * @brief Tell whether the sequence names should be checked when reading from files.
    *
-   * @warning This is not used for now, will be when reading is implemented.
    * @param yn whether the sequence names should be checked when reading from files.
    */
   void checkNames(bool yn) { checkNames_ = yn; }
+
+  /**
+   * @return How characters which are not part of the alphabet are handled when reading.
+   */
+  const IngestPolicy& getIngestPolicy() const { return ingestPolicy_; }
+
+  /**
+   * @brief Set how characters which are not part of the alphabet are handled when reading.
+   *
+   * @param policy The policy to use (strict by default).
+   */
+  void setIngestPolicy(const IngestPolicy& policy) { ingestPolicy_ = policy; }
 };
 } // end of namespace bpp.
 #endif // BPP_SEQ_IO_STOCKHOLM_H
@@ -37,13 +37,13 @@ NucleicAcidsReplication::NucleicAcidsReplication(
 int NucleicAcidsReplication::translate(int state) const
 {
   nuc1_->intToChar(state);
-  return trans_[state];
+  return trans_.at(state);
 }
 
 std::string NucleicAcidsReplication::translate(const std::string& state) const
 {
   int i = nuc1_->charToInt(state);
-  return nuc2_->intToChar(trans_[i]);
+  return nuc2_->intToChar(trans_.at(i));
 }
 
 unique_ptr<Sequence> NucleicAcidsReplication::translate(const SequenceInterface& sequence) const
@@ -63,13 +63,13 @@ unique_ptr<Sequence> NucleicAcidsReplication::translate(const SequenceInterface&
 int NucleicAcidsReplication::reverse(int state) const
 {
   nuc2_->intToChar(state);
-  return trans_[state];
+  return trans_.at(state);
 }
 
 std::string NucleicAcidsReplication::reverse(const std::string& state) const
 {
   int i = nuc2_->charToInt(state);
-  return nuc1_->intToChar(trans_[i]);
+  return nuc1_->intToChar(trans_.at(i));
 }
 
 unique_ptr<Sequence> NucleicAcidsReplication::reverse(const SequenceInterface& sequence) const
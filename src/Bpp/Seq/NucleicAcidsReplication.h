@@ -33,7 +33,7 @@ class NucleicAcidsReplication :
 {
 private:
   std::shared_ptr<const NucleicAlphabet> nuc1_, nuc2_;
-  mutable std::map<int, int> trans_;
+  std::map<int, int> trans_;
 
 public:
   NucleicAcidsReplication(
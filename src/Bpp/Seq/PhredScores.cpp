@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Text/TextTools.h>
+
+#include "PhredScores.h"
+
+// From the STL:
+#include <algorithm>
+
+using namespace bpp;
+using namespace std;
+
+const int PhredScores::SANGER_OFFSET = 33;
+
+/******************************************************************************/
+
+PhredScores::PhredScores(const std::vector<int>& scores) :
+  scores_(scores.size())
+{
+  int minScore = 0;
+  int maxScore = 0;
+  for (size_t i = 0; i < scores.size(); ++i)
+  {
+    minScore = min(minScore, scores[i]);
+    maxScore = max(maxScore, scores[i]);
+    scores_[i] = static_cast<uint8_t>(scores[i]);
+  }
+  if (minScore < 0)
+    throw BadIntegerException("PhredScores. Negative quality score.", minScore);
+  if (maxScore > 255)
+    throw BadIntegerException("PhredScores. Quality score larger than 255.", maxScore);
+}
+
+/******************************************************************************/
+
+void PhredScores::assignFastq(const char* data, size_t length, int offset)
+{
+  scores_.resize(length);
+  // No test in the loop, so that it can be vectorized:
+  int minChar = 255;
+  for (size_t i = 0; i < length; ++i)
+  {
+    int c = static_cast<unsigned char>(data[i]);
+    minChar = min(minChar, c);
+    scores_[i] = static_cast<uint8_t>(c - offset);
+  }
+  if (length > 0 && minChar < offset)
+    throw Exception("PhredScores::assignFastq. Character '" + string(1, static_cast<char>(minChar)) + "' is below the quality offset " + TextTools::toString(offset) + ".");
+}
+
+/******************************************************************************/
+
+string PhredScores::toFastq(int offset) const
+{
+  string line(scores_.size(), ' ');
+  int maxScore = 0;
+  for (size_t i = 0; i < scores_.size(); ++i)
+  {
+    maxScore = max(maxScore, static_cast<int>(scores_[i]));
+    line[i] = static_cast<char>(scores_[i] + offset);
+  }
+  if (maxScore + offset > 126)
+    throw Exception("PhredScores::toFastq. Score " + TextTools::toString(maxScore) + " cannot be written with offset " + TextTools::toString(offset) + ".");
+  return line;
+}
+
+/******************************************************************************/
+
+void PhredScores::trim(size_t begin, size_t end)
+{
+  if (end > scores_.size())
+    throw IndexOutOfBoundsException("PhredScores::trim. End position out of bounds.", end, 0, scores_.size());
+  if (begin > end)
+    throw IndexOutOfBoundsException("PhredScores::trim. Begin position after end position.", begin, 0, end);
+  scores_.erase(scores_.begin() + static_cast<ptrdiff_t>(end), scores_.end());
+  scores_.erase(scores_.begin(), scores_.begin() + static_cast<ptrdiff_t>(begin));
+}
+
+/******************************************************************************/
@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_PHREDSCORES_H
+#define BPP_SEQ_PHREDSCORES_H
+
+#include <Bpp/Exceptions.h>
+
+// From the STL:
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief A compact vector of Phred quality scores.
+ *
+ * SequenceQuality stores one int per position, and is kept in sync with its
+ * sequence through edition events. For read quality control, where millions
+ * of short reads are loaded, trimmed and filtered, this class stores scores on
+ * one byte each (Phred scores range from 0 to 93 in FASTQ files), and is
+ * filled directly from the quality line of a FASTQ record.
+ *
+ * Bulk operations (mean and minimum quality, trimming, masking) are available
+ * in SequenceWithQualityTools.
+ *
+ * @see SequenceQuality, SequenceWithQualityTools
+ */
+class PhredScores
+{
+private:
+  std::vector<uint8_t> scores_;
+
+public:
+  /**
+   * @brief The offset of Sanger and Illumina 1.8+ FASTQ files ('!').
+   */
+  static const int SANGER_OFFSET;
+
+public:
+  /**
+   * @param size  The number of scores.
+   * @param score The initial value of all scores.
+   */
+  PhredScores(size_t size = 0, uint8_t score = 20) :
+    scores_(size, score) {}
+
+  /**
+   * @param scores The scores, as stored by SequenceQuality.
+   * @throw BadIntegerException If a score is not between 0 and 255.
+   */
+  PhredScores(const std::vector<int>& scores);
+
+  virtual ~PhredScores() {}
+
+public:
+  /**
+   * @brief Replace all scores by the content of a FASTQ quality line.
+   *
+   * @param data   The characters of the quality line.
+   * @param length The number of characters.
+   * @param offset The ASCII code of quality 0.
+   * @throw Exception If a character is below the offset.
+   */
+  void assignFastq(const char* data, size_t length, int offset = SANGER_OFFSET);
+
+  void assignFastq(const std::string& line, int offset = SANGER_OFFSET)
+  {
+    assignFastq(line.data(), line.size(), offset);
+  }
+
+  /**
+   * @return The scores as a FASTQ quality line.
+   * @throw Exception If a score cannot be encoded as a character with this offset.
+   */
+  std::string toFastq(int offset = SANGER_OFFSET) const;
+
+  /**
+   * @return The scores as a vector of int, as stored by SequenceQuality.
+   */
+  std::vector<int> toVector() const
+  {
+    return std::vector<int>(scores_.begin(), scores_.end());
+  }
+
+  size_t size() const { return scores_.size(); }
+
+  bool empty() const { return scores_.empty(); }
+
+  const uint8_t& operator[](size_t i) const { return scores_[i]; }
+
+  uint8_t& operator[](size_t i) { return scores_[i]; }
+
+  const uint8_t* data() const { return scores_.data(); }
+
+  uint8_t* data() { return scores_.data(); }
+
+  const std::vector<uint8_t>& getScores() const { return scores_; }
+
+  void push_back(uint8_t score) { scores_.push_back(score); }
+
+  void clear() { scores_.clear(); }
+
+  /**
+   * @brief Only keep the scores of positions [begin, end).
+   *
+   * @throw IndexOutOfBoundsException If the interval is not valid.
+   */
+  void trim(size_t begin, size_t end);
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_PHREDSCORES_H
@@ -0,0 +1,221 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "Profiler.h"
+
+// From the STL:
+#include <algorithm>
+#include <iomanip>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BPP_SEQ_USE_GETRUSAGE
+#include <sys/resource.h>
+#endif
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+Profiler::Profiler() :
+  enabled_(false),
+  mutex_(),
+  timers_(),
+  counters_(),
+  start_(chrono::steady_clock::now())
+{}
+
+/******************************************************************************/
+
+Profiler& Profiler::global()
+{
+  static Profiler profiler;
+  return profiler;
+}
+
+/******************************************************************************/
+
+void Profiler::setEnabled(bool enabled)
+{
+  lock_guard<mutex> lock(mutex_);
+  if (enabled && !enabled_)
+    start_ = chrono::steady_clock::now();
+  enabled_ = enabled;
+}
+
+/******************************************************************************/
+
+void Profiler::reset()
+{
+  lock_guard<mutex> lock(mutex_);
+  timers_.clear();
+  counters_.clear();
+  start_ = chrono::steady_clock::now();
+}
+
+/******************************************************************************/
+
+void Profiler::addTime(const char* name, double seconds)
+{
+  lock_guard<mutex> lock(mutex_);
+  Timer& timer = timers_[name];
+  timer.calls++;
+  timer.seconds += seconds;
+  timer.maxSeconds = max(timer.maxSeconds, seconds);
+}
+
+/******************************************************************************/
+
+void Profiler::addCount_(const char* name, uint64_t n)
+{
+  lock_guard<mutex> lock(mutex_);
+  counters_[name] += n;
+}
+
+/******************************************************************************/
+
+void Profiler::countBytes(const char* name, std::istream& input)
+{
+  if (!isEnabled())
+    return;
+  input.seekg(0, ios::end);
+  streamoff size = input.tellg();
+  input.clear();
+  input.seekg(0, ios::beg);
+  if (size > 0)
+    addCount_(name, static_cast<uint64_t>(size));
+}
+
+/******************************************************************************/
+
+map<string, Profiler::Timer> Profiler::getTimers() const
+{
+  lock_guard<mutex> lock(mutex_);
+  return timers_;
+}
+
+/******************************************************************************/
+
+map<string, uint64_t> Profiler::getCounters() const
+{
+  lock_guard<mutex> lock(mutex_);
+  return counters_;
+}
+
+/******************************************************************************/
+
+double Profiler::getElapsedTime() const
+{
+  lock_guard<mutex> lock(mutex_);
+  return chrono::duration<double>(chrono::steady_clock::now() - start_).count();
+}
+
+/******************************************************************************/
+
+uint64_t Profiler::getPeakMemory()
+{
+#ifdef BPP_SEQ_USE_GETRUSAGE
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#ifdef __APPLE__
+  return static_cast<uint64_t>(usage.ru_maxrss); // In bytes.
+#else
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024; // In kilobytes.
+#endif
+#else
+  return 0;
+#endif
+}
+
+/******************************************************************************/
+
+void Profiler::print(std::ostream& out) const
+{
+  auto timers = getTimers();
+  auto counters = getCounters();
+  ios::fmtflags flags = out.flags();
+  streamsize precision = out.precision();
+  size_t width = 11; // "Peak memory"
+  for (const auto& timer : timers)
+  {
+    width = max(width, timer.first.size());
+  }
+  for (const auto& counter : counters)
+  {
+    width = max(width, counter.first.size());
+  }
+
+  out << left << setw(static_cast<int>(width)) << "Elapsed" << "  " << fixed << setprecision(6) << getElapsedTime() << " s" << endl;
+  uint64_t peak = getPeakMemory();
+  if (peak > 0)
+    out << setw(static_cast<int>(width)) << "Peak memory" << "  " << peak / 1024 << " kB" << endl;
+  if (!timers.empty())
+  {
+    out << endl << setw(static_cast<int>(width)) << "Timer" << "  " << right << setw(10) << "Calls" << setw(14) << "Total (s)" << setw(14) << "Max (s)" << endl;
+    for (const auto& timer : timers)
+    {
+      out << left << setw(static_cast<int>(width)) << timer.first << "  " << right << setw(10) << timer.second.calls;
+      out << setw(14) << timer.second.seconds << setw(14) << timer.second.maxSeconds << endl;
+    }
+  }
+  if (!counters.empty())
+  {
+    out << endl << left << setw(static_cast<int>(width)) << "Counter" << "  " << right << setw(10) << "Value" << endl;
+    for (const auto& counter : counters)
+    {
+      out << left << setw(static_cast<int>(width)) << counter.first << "  " << right << setw(10) << counter.second << endl;
+    }
+  }
+  out.flags(flags);
+  out.precision(precision);
+}
+
+/******************************************************************************/
+
+void Profiler::writeJson(std::ostream& out) const
+{
+  // Names are identifiers chosen in the code, only quotes and backslashes are escaped:
+  auto quote = [](const string& name)
+  {
+    string quoted = "\"";
+    for (char c : name)
+    {
+      if (c == '"' || c == '\\')
+        quoted += '\\';
+      quoted += c;
+    }
+    return quoted + "\"";
+  };
+
+  auto timers = getTimers();
+  auto counters = getCounters();
+  streamsize precision = out.precision(9);
+  out << "{" << endl;
+  out << "  \"elapsed_seconds\": " << getElapsedTime() << "," << endl;
+  out << "  \"peak_memory_bytes\": " << getPeakMemory() << "," << endl;
+  out << "  \"timers\": {";
+  bool first = true;
+  for (const auto& timer : timers)
+  {
+    out << (first ? "" : ",") << endl;
+    out << "    " << quote(timer.first) << ": { \"calls\": " << timer.second.calls;
+    out << ", \"seconds\": " << timer.second.seconds << ", \"max_seconds\": " << timer.second.maxSeconds << " }";
+    first = false;
+  }
+  out << (first ? "" : "\n  ") << "}," << endl;
+  out << "  \"counters\": {";
+  first = true;
+  for (const auto& counter : counters)
+  {
+    out << (first ? "" : ",") << endl;
+    out << "    " << quote(counter.first) << ": " << counter.second;
+    first = false;
+  }
+  out << (first ? "" : "\n  ") << "}" << endl;
+  out << "}" << endl;
+  out.precision(precision);
+}
+
+/******************************************************************************/
@@ -0,0 +1,236 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_PROFILER_H
+#define BPP_SEQ_PROFILER_H
+
+// From the STL:
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace bpp
+{
+/**
+ * @brief Timers and counters of the costly steps of the library.
+ *
+ * Readers, site filters of SiteContainerTools and loaders of
+ * SequenceApplicationTools report the time they take and the amount of data
+ * they process (bytes parsed, sequences and sites read, scanned or copied)
+ * to the global profiler. It is disabled by default, and then each timer or
+ * counter only costs the test of a flag.
+ *
+ * Times are cumulated over all calls, and over all threads for code run in
+ * parallel, so they may exceed the elapsed time.
+ * @code
+ * Profiler::global().setEnabled(true);
+ * {
+ *   ScopedTimer timer("my.step");
+ *   Profiler::global().count("my.items", n);
+ * }
+ * Profiler::global().writeJson(std::cout);
+ * @endcode
+ *
+ * In programs based on BppSequenceApplication, the profile is displayed at
+ * the end of the run with the 'profile' option.
+ */
+class Profiler
+{
+public:
+  struct Timer
+  {
+    uint64_t calls;
+    double seconds;
+    double maxSeconds;
+
+    Timer() : calls(0), seconds(0), maxSeconds(0) {}
+  };
+
+private:
+  std::atomic<bool> enabled_;
+  mutable std::mutex mutex_;
+  std::map<std::string, Timer> timers_;
+  std::map<std::string, uint64_t> counters_;
+  std::chrono::steady_clock::time_point start_;
+
+public:
+  Profiler();
+
+  virtual ~Profiler() {}
+
+  Profiler(const Profiler&) = delete;
+  Profiler& operator=(const Profiler&) = delete;
+
+public:
+  /**
+   * @return The profiler used by the library.
+   */
+  static Profiler& global();
+
+  bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Enable or disable the profiler. Enabling it resets the elapsed time.
+   */
+  void setEnabled(bool enabled);
+
+  /**
+   * @brief Remove all timers and counters, and reset the elapsed time.
+   */
+  void reset();
+
+  /**
+   * @brief Add a call to a timer.
+   */
+  void addTime(const char* name, double seconds);
+
+  /**
+   * @brief Increment a counter, if the profiler is enabled.
+   */
+  void count(const char* name, uint64_t n = 1)
+  {
+    if (isEnabled())
+      addCount_(name, n);
+  }
+
+  /**
+   * @brief Increment a counter by the size of a file stream, if the profiler is enabled.
+   *
+   * The stream is read from its beginning afterwards.
+   */
+  void countBytes(const char* name, std::istream& input);
+
+  std::map<std::string, Timer> getTimers() const;
+
+  std::map<std::string, uint64_t> getCounters() const;
+
+  /**
+   * @return The time elapsed since the profiler was enabled or reset, in seconds.
+   */
+  double getElapsedTime() const;
+
+  /**
+   * @return The peak resident memory of the process in bytes, or 0 if it is not available on this platform.
+   */
+  static uint64_t getPeakMemory();
+
+  /**
+   * @brief Print all timers and counters as a table.
+   */
+  void print(std::ostream& out) const;
+
+  /**
+   * @brief Write all timers and counters as a JSON object.
+   */
+  void writeJson(std::ostream& out) const;
+
+private:
+  void addCount_(const char* name, uint64_t n);
+};
+
+/**
+ * @brief Measure the time spent in a scope, if the profiler is enabled.
+ */
+class ScopedTimer
+{
+private:
+  Profiler* profiler_; // Null if disabled.
+  const char* name_;
+  std::chrono::steady_clock::time_point start_;
+
+public:
+  /**
+   * @param name     The name of the timer. It must remain valid until the end of the scope.
+   * @param profiler The profiler to report to.
+   */
+  ScopedTimer(const char* name, Profiler& profiler = Profiler::global()) :
+    profiler_(profiler.isEnabled() ? &profiler : nullptr),
+    name_(name),
+    start_()
+  {
+    if (profiler_)
+      start_ = std::chrono::steady_clock::now();
+  }
+
+  ~ScopedTimer()
+  {
+    if (profiler_)
+      profiler_->addTime(name_, std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count());
+  }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+/**
+ * @brief Cumulate the time spent in many short sections, and report it as a single call.
+ *
+ * ScopedTimer reports each scope to the profiler, which takes a lock. This
+ * class is meant for steps repeated on every line of a file: the time between
+ * start() and stop() is summed locally, and only reported by report() or by
+ * the destructor.
+ */
+class CumulativeTimer
+{
+private:
+  Profiler* profiler_; // Null if disabled.
+  const char* name_;
+  std::chrono::steady_clock::time_point start_;
+  std::chrono::steady_clock::duration total_;
+  bool used_;
+
+public:
+  /**
+   * @param name     The name of the timer. It must remain valid until the timer is destroyed.
+   * @param profiler The profiler to report to.
+   */
+  CumulativeTimer(const char* name, Profiler& profiler = Profiler::global()) :
+    profiler_(profiler.isEnabled() ? &profiler : nullptr),
+    name_(name),
+    start_(),
+    total_(std::chrono::steady_clock::duration::zero()),
+    used_(false)
+  {}
+
+  ~CumulativeTimer()
+  {
+    report();
+  }
+
+  CumulativeTimer(const CumulativeTimer&) = delete;
+  CumulativeTimer& operator=(const CumulativeTimer&) = delete;
+
+public:
+  void start()
+  {
+    if (profiler_)
+      start_ = std::chrono::steady_clock::now();
+  }
+
+  void stop()
+  {
+    if (profiler_)
+    {
+      total_ += std::chrono::steady_clock::now() - start_;
+      used_ = true;
+    }
+  }
+
+  /**
+   * @brief Report the cumulated time as a single call, if any, and reset it.
+   */
+  void report()
+  {
+    if (profiler_ && used_)
+      profiler_->addTime(name_, std::chrono::duration<double>(total_).count());
+    total_ = std::chrono::steady_clock::duration::zero();
+    used_ = false;
+  }
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_PROFILER_H
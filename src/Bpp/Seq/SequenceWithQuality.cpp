@@ -43,3 +43,38 @@ void SequenceQuality::afterSequenceDeleted(const IntSymbolListDeletionEvent& eve
 }
 
 /******************************************************************************/
+
+size_t SequenceWithQuality::maskLowQuality(int threshold)
+{
+  const vector<int>& scores = qualScores_->getScores();
+  size_t n = content_.size();
+  size_t count = 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    count += scores[i] < threshold;
+  }
+  if (count == 0)
+    return 0;
+  size_t first = 0;
+  while (scores[first] >= threshold)
+  {
+    ++first;
+  }
+  size_t last = n - 1;
+  while (scores[last] >= threshold)
+  {
+    --last;
+  }
+
+  int unknown = getAlphabet()->getUnknownCharacterCode();
+  IntSymbolListSubstitutionEvent event(this, first, last);
+  fireBeforeSequenceSubstituted(event);
+  for (size_t i = first; i <= last; ++i)
+  {
+    content_[i] = scores[i] < threshold ? unknown : content_[i];
+  }
+  fireAfterSequenceSubstituted(event);
+  return count;
+}
+
+/******************************************************************************/
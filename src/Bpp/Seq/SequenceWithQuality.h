@@ -469,16 +469,23 @@ public:
   /** @} */
 
   SequenceWithQuality(const SequenceWithQuality& sequence) :
-    AbstractTemplateSymbolList<int>(sequence.getAlphabet()),
-    SequenceWithAnnotation(sequence), qualScores_(nullptr)
+    AbstractTemplateSymbolList<int>(sequence.getContent(), sequence.getAlphabet()),
+    SequenceWithAnnotation(sequence),
+    qualScores_(new SequenceQuality(sequence.getQualities(), false))
   {
-    qualScores_.reset(dynamic_cast<SequenceQuality*>(&annotation(SequenceQuality::QUALITY_SCORE)));
+    addAnnotation(qualScores_);
   }
 
   SequenceWithQuality& operator=(const SequenceWithQuality& sequence)
   {
     SequenceWithAnnotation::operator=(sequence);
-    qualScores_.reset(dynamic_cast<SequenceQuality*>(&annotation(SequenceQuality::QUALITY_SCORE)));
+    // Listeners have been copied, get the copy of the quality scores:
+    for (size_t i = 0; i < getNumberOfListeners(); ++i)
+    {
+      auto qual = std::dynamic_pointer_cast<SequenceQuality>(getListener(i));
+      if (qual)
+        qualScores_ = qual;
+    }
     return *this;
   }
 
@@ -550,6 +557,18 @@ public:
     return qualScores_->getScores();
   }
 
+  /**
+   * @brief Replace all states with a quality below a threshold by the unknown state.
+   *
+   * Qualities are not modified. All positions are processed at once, and
+   * listeners are notified by a single substitution event spanning the masked
+   * positions.
+   *
+   * @param threshold The minimum quality of the states to keep.
+   * @return The number of masked positions.
+   */
+  size_t maskLowQuality(int threshold);
+
   using SequenceWithAnnotation::append;
 
   /**
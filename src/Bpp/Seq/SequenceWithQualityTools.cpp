@@ -4,6 +4,12 @@
 
 #include "SequenceWithQualityTools.h"
 
+// From the STL:
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
 using namespace bpp;
 using namespace std;
 
@@ -130,3 +136,192 @@ unique_ptr<SequenceWithQuality> SequenceWithQualityTools::removeGaps(const Seque
 }
 
 /******************************************************************************/
+
+template<class T>
+double SequenceWithQualityTools::getMeanQuality_(const T* scores, size_t size)
+{
+  if (size == 0)
+    return std::numeric_limits<double>::quiet_NaN();
+  int64_t sum = 0;
+  for (size_t i = 0; i < size; ++i)
+  {
+    sum += scores[i];
+  }
+  return static_cast<double>(sum) / static_cast<double>(size);
+}
+
+/******************************************************************************/
+
+template<class T>
+int SequenceWithQualityTools::getMinQuality_(const T* scores, size_t size)
+{
+  if (size == 0)
+    throw Exception("SequenceWithQualityTools::getMinQuality. Empty sequence.");
+  int minScore = numeric_limits<int>::max();
+  for (size_t i = 0; i < size; ++i)
+  {
+    minScore = min(minScore, static_cast<int>(scores[i]));
+  }
+  return minScore;
+}
+
+/******************************************************************************/
+
+template<class T>
+void SequenceWithQualityTools::getQualityTrimmingBounds_(
+    const T* scores,
+    size_t size,
+    int threshold,
+    size_t window,
+    size_t& begin,
+    size_t& end)
+{
+  if (window == 0)
+    throw BadIntegerException("SequenceWithQualityTools::getQualityTrimmingBounds. Window size must be positive.", 0);
+  begin = 0;
+  end = 0;
+  if (size == 0)
+    return;
+  size_t w = min(window, size);
+  // Sums are compared, rather than means:
+  int64_t minSum = static_cast<int64_t>(threshold) * static_cast<int64_t>(w);
+
+  // First window from the left:
+  int64_t sum = 0;
+  for (size_t i = 0; i < w; ++i)
+  {
+    sum += scores[i];
+  }
+  size_t first = 0;
+  while (sum < minSum)
+  {
+    if (first + w == size)
+      return; // No window reaches the threshold.
+    sum += static_cast<int64_t>(scores[first + w]) - static_cast<int64_t>(scores[first]);
+    ++first;
+  }
+
+  // Last window from the right, which cannot start before the first one:
+  sum = 0;
+  for (size_t i = size - w; i < size; ++i)
+  {
+    sum += scores[i];
+  }
+  size_t last = size;
+  while (sum < minSum)
+  {
+    --last;
+    sum += static_cast<int64_t>(scores[last - w]) - static_cast<int64_t>(scores[last]);
+  }
+  begin = first;
+  end = last;
+}
+
+/******************************************************************************/
+
+double SequenceWithQualityTools::getMeanQuality(const SequenceWithQuality& sequence)
+{
+  return getMeanQuality_(sequence.getQualities().data(), sequence.getQualities().size());
+}
+
+/******************************************************************************/
+
+double SequenceWithQualityTools::getMeanQuality(const PhredScores& scores)
+{
+  return getMeanQuality_(scores.data(), scores.size());
+}
+
+/******************************************************************************/
+
+int SequenceWithQualityTools::getMinQuality(const SequenceWithQuality& sequence)
+{
+  return getMinQuality_(sequence.getQualities().data(), sequence.getQualities().size());
+}
+
+/******************************************************************************/
+
+int SequenceWithQualityTools::getMinQuality(const PhredScores& scores)
+{
+  return getMinQuality_(scores.data(), scores.size());
+}
+
+/******************************************************************************/
+
+void SequenceWithQualityTools::getQualityTrimmingBounds(
+    const SequenceWithQuality& sequence,
+    int threshold,
+    size_t window,
+    size_t& begin,
+    size_t& end)
+{
+  getQualityTrimmingBounds_(sequence.getQualities().data(), sequence.getQualities().size(), threshold, window, begin, end);
+}
+
+/******************************************************************************/
+
+void SequenceWithQualityTools::getQualityTrimmingBounds(
+    const PhredScores& scores,
+    int threshold,
+    size_t window,
+    size_t& begin,
+    size_t& end)
+{
+  getQualityTrimmingBounds_(scores.data(), scores.size(), threshold, window, begin, end);
+}
+
+/******************************************************************************/
+
+void SequenceWithQualityTools::trim(SequenceWithQuality& sequence, size_t begin, size_t end)
+{
+  size_t size = sequence.size();
+  if (end > size)
+    throw IndexOutOfBoundsException("SequenceWithQualityTools::trim. End position out of bounds.", end, 0, size);
+  if (begin > end)
+    throw IndexOutOfBoundsException("SequenceWithQualityTools::trim. Begin position after end position.", begin, 0, end);
+  if (end < size)
+    sequence.deleteElements(end, size - end);
+  if (begin > 0)
+    sequence.deleteElements(0, begin);
+}
+
+/******************************************************************************/
+
+size_t SequenceWithQualityTools::trimLowQuality(SequenceWithQuality& sequence, int threshold, size_t window)
+{
+  size_t begin, end;
+  getQualityTrimmingBounds(sequence, threshold, window, begin, end);
+  trim(sequence, begin, end);
+  return sequence.size();
+}
+
+/******************************************************************************/
+
+size_t SequenceWithQualityTools::trimLowQuality(std::string& bases, PhredScores& scores, int threshold, size_t window)
+{
+  if (bases.size() != scores.size())
+    throw DimensionException("SequenceWithQualityTools::trimLowQuality. Bases and scores must have the same size.", scores.size(), bases.size());
+  size_t begin, end;
+  getQualityTrimmingBounds(scores, threshold, window, begin, end);
+  bases.erase(end);
+  bases.erase(0, begin);
+  scores.trim(begin, end);
+  return bases.size();
+}
+
+/******************************************************************************/
+
+size_t SequenceWithQualityTools::maskLowQuality(std::string& bases, const PhredScores& scores, int threshold, char mask)
+{
+  if (bases.size() != scores.size())
+    throw DimensionException("SequenceWithQualityTools::maskLowQuality. Bases and scores must have the same size.", scores.size(), bases.size());
+  size_t count = 0;
+  for (size_t i = 0; i < bases.size(); ++i)
+  {
+    bool low = scores[i] < threshold;
+    count += low;
+    bases[i] = low ? mask : bases[i];
+  }
+  return count;
+}
+
+/******************************************************************************/
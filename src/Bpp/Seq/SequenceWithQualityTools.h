@@ -6,9 +6,13 @@
 #define BPP_SEQ_SEQUENCEWITHQUALITYTOOLS_H
 
 
+#include "PhredScores.h"
 #include "SequenceTools.h"
 #include "SequenceWithQuality.h"
 
+// From the STL:
+#include <string>
+
 namespace bpp
 {
 /**
@@ -147,6 +151,116 @@ public:
    * @return A new SequenceWithQuality object without gaps.
    */
   static std::unique_ptr<SequenceWithQuality> removeGaps(const SequenceWithQuality& seq);
+
+  /**
+   * @name Quality control
+   *
+   * Bulk operations on the quality scores of reads, stored in a
+   * SequenceWithQuality or in compact PhredScores. Scores are processed in
+   * loops without data-dependent branches, which the compiler can vectorize.
+   *
+   * @{
+   */
+
+  /**
+   * @return The mean quality of a sequence, or NaN if it is empty.
+   */
+  static double getMeanQuality(const SequenceWithQuality& sequence);
+
+  static double getMeanQuality(const PhredScores& scores);
+
+  /**
+   * @return The minimum quality of a sequence.
+   * @throw Exception If the sequence is empty.
+   */
+  static int getMinQuality(const SequenceWithQuality& sequence);
+
+  static int getMinQuality(const PhredScores& scores);
+
+  /**
+   * @brief Find the part of a read to keep after trimming its low-quality ends.
+   *
+   * A window of a fixed size slides along the read. The first kept position
+   * is the beginning of the first window with a mean quality of at least
+   * the threshold, and the last kept position is the end of the last such
+   * window. A read shorter than the window is considered as a single window.
+   *
+   * @param sequence  The read.
+   * @param threshold The minimum mean quality of a window.
+   * @param window    The size of the window.
+   * @param begin     [out] The first position to keep.
+   * @param end       [out] The position after the last position to keep. If no window
+   * reaches the threshold, begin and end are both set to 0.
+   * @throw BadIntegerException If the window size is 0.
+   */
+  static void getQualityTrimmingBounds(
+      const SequenceWithQuality& sequence,
+      int threshold,
+      size_t window,
+      size_t& begin,
+      size_t& end);
+
+  static void getQualityTrimmingBounds(
+      const PhredScores& scores,
+      int threshold,
+      size_t window,
+      size_t& begin,
+      size_t& end);
+
+  /**
+   * @brief Only keep positions [begin, end) of a sequence.
+   *
+   * Both ends are removed as a whole, each with a single deletion event, so
+   * that quality scores and other annotations are resized once per end.
+   *
+   * @throw IndexOutOfBoundsException If the interval is not valid.
+   */
+  static void trim(SequenceWithQuality& sequence, size_t begin, size_t end);
+
+  /**
+   * @brief Trim the low-quality ends of a read.
+   *
+   * @see getQualityTrimmingBounds
+   * @return The size of the trimmed read.
+   */
+  static size_t trimLowQuality(SequenceWithQuality& sequence, int threshold, size_t window);
+
+  /**
+   * @brief Trim the low-quality ends of a read, as stored in a FASTQ record.
+   *
+   * @param bases     The bases of the read, one character each.
+   * @param scores    The quality scores of the read.
+   * @param threshold The minimum mean quality of a window.
+   * @param window    The size of the window.
+   * @return The size of the trimmed read.
+   * @throw DimensionException If there is not one score per base.
+   */
+  static size_t trimLowQuality(std::string& bases, PhredScores& scores, int threshold, size_t window);
+
+  /**
+   * @brief Replace all bases with a quality below a threshold.
+   *
+   * @see SequenceWithQuality::maskLowQuality
+   * @param bases     The bases of the read, one character each.
+   * @param scores    The quality scores of the read.
+   * @param threshold The minimum quality of the bases to keep.
+   * @param mask      The character to use for masked bases.
+   * @return The number of masked bases.
+   * @throw DimensionException If there is not one score per base.
+   */
+  static size_t maskLowQuality(std::string& bases, const PhredScores& scores, int threshold, char mask = 'N');
+
+  /** @} */
+
+private:
+  template<class T>
+  static double getMeanQuality_(const T* scores, size_t size);
+
+  template<class T>
+  static int getMinQuality_(const T* scores, size_t size);
+
+  template<class T>
+  static void getQualityTrimmingBounds_(const T* scores, size_t size, int threshold, size_t window, size_t& begin, size_t& end);
 };
 }
 #endif // BPP_SEQ_SEQUENCEWITHQUALITYTOOLS_H
@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "Alphabet/AlphabetTools.h"
+#include "SymbolDecoder.h"
+
+// From the STL:
+#include <algorithm>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+SymbolDecoder::SymbolDecoder(std::shared_ptr<const Alphabet> alphabet) :
+  alphabet_(alphabet),
+  codingSize_(AlphabetTools::getAlphabetCodingSize(*alphabet)), // Warning, an exception may be thrown here!
+  minState_(0),
+  table_()
+{
+  const vector<int>& states = alphabet_->getSupportedInts();
+  if (states.empty())
+    return;
+  minState_ = *min_element(states.begin(), states.end());
+  int maxState = *max_element(states.begin(), states.end());
+  table_.assign(static_cast<size_t>(maxState - minState_ + 1) * codingSize_, '\0');
+  for (int state : states)
+  {
+    string text = alphabet_->intToChar(state);
+    if (text.size() == codingSize_)
+      copy(text.begin(), text.end(), table_.begin() + static_cast<ptrdiff_t>(static_cast<size_t>(state - minState_) * codingSize_));
+  }
+}
+
+/******************************************************************************/
+
+void SymbolDecoder::decode(const int* begin, const int* end, std::string& output) const
+{
+  if (codingSize_ == 1)
+  {
+    size_t pos = output.size();
+    output.resize(pos + static_cast<size_t>(end - begin));
+    for (const int* p = begin; p < end; ++p, ++pos)
+    {
+      const char* c = find_(*p);
+      if (!c)
+        throw BadIntException(*p, "SymbolDecoder::decode", alphabet_.get());
+      output[pos] = *c;
+    }
+  }
+  else
+  {
+    for (const int* p = begin; p < end; ++p)
+    {
+      const char* c = find_(*p);
+      if (c)
+        output.append(c, codingSize_);
+      else
+        output += alphabet_->intToChar(*p); // Throws if the state is not valid.
+    }
+  }
+}
+
+/******************************************************************************/
+
+void SymbolDecoder::decode(const std::vector<int>& content, size_t charBegin, size_t charEnd, std::string& output) const
+{
+  charEnd = min(charEnd, content.size() * codingSize_);
+  if (charBegin >= charEnd)
+    return;
+  if (codingSize_ == 1)
+  {
+    decode(content.data() + charBegin, content.data() + charEnd, output);
+    return;
+  }
+  // States may be cut at both ends of the range:
+  size_t first = charBegin / codingSize_;
+  size_t last = (charEnd - 1) / codingSize_;
+  string text;
+  decode(content.data() + first, content.data() + last + 1, text);
+  size_t offset = charBegin - first * codingSize_;
+  output.append(text, offset, charEnd - charBegin);
+}
+
+/******************************************************************************/
@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_SYMBOLDECODER_H
+#define BPP_SEQ_SYMBOLDECODER_H
+
+#include <Bpp/Exceptions.h>
+
+#include "Alphabet/Alphabet.h"
+#include "Alphabet/AlphabetExceptions.h"
+
+// From the STL:
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Fast conversion of alphabet states to characters.
+ *
+ * This is the counterpart of SymbolEncoder, used by writers. The characters of
+ * every supported state are stored once in a flat table, so that rows can be
+ * decoded directly into an output buffer, without building the string of the
+ * whole sequence with SymbolList::toString.
+ *
+ * The table is filled in the constructor and never modified afterwards, so
+ * that a single decoder can be shared between threads.
+ *
+ * @see SymbolEncoder, StringSequenceTools::decodeSequence
+ */
+class SymbolDecoder
+{
+private:
+  std::shared_ptr<const Alphabet> alphabet_;
+  unsigned int codingSize_;
+  int minState_;
+  std::vector<char> table_; // codingSize_ characters per state, starting from minState_.
+
+public:
+  /**
+   * @param alphabet The alphabet to use.
+   * @throw AlphabetException If the alphabet does not have a constant coding size.
+   */
+  SymbolDecoder(std::shared_ptr<const Alphabet> alphabet);
+
+  virtual ~SymbolDecoder() {}
+
+public:
+  std::shared_ptr<const Alphabet> getAlphabet() const { return alphabet_; }
+
+  const Alphabet& alphabet() const { return *alphabet_; }
+
+  /**
+   * @return The number of characters used to code one state.
+   */
+  unsigned int getCodingSize() const { return codingSize_; }
+
+  /**
+   * @brief Append the characters of a range of states to a string.
+   *
+   * @param begin  First state.
+   * @param end    End of the range (excluded).
+   * @param output The string to which characters are appended.
+   * @throw BadIntException If a state is not in the alphabet.
+   */
+  void decode(const int* begin, const int* end, std::string& output) const;
+
+  /**
+   * @brief Append a range of the text of a sequence to a string.
+   *
+   * Positions are given in characters, not in states, so that text can be cut
+   * into lines of a fixed width whatever the coding size of the alphabet.
+   *
+   * @param content   The states of the sequence.
+   * @param charBegin Position of the first character.
+   * @param charEnd   End of the range (excluded).
+   * @param output    The string to which characters are appended.
+   * @throw BadIntException If a state is not in the alphabet.
+   */
+  void decode(const std::vector<int>& content, size_t charBegin, size_t charEnd, std::string& output) const;
+
+private:
+  /**
+   * @return A pointer to the characters of a state, or nullptr if the state is not in the table.
+   */
+  const char* find_(int state) const
+  {
+    size_t i = static_cast<size_t>(static_cast<long long>(state) - minState_) * codingSize_;
+    if (state < minState_ || i >= table_.size() || table_[i] == '\0')
+      return nullptr;
+    return &table_[i];
+  }
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_SYMBOLDECODER_H
@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Text/TextTools.h>
+
+#include "Alphabet/AlphabetTools.h"
+#include "SymbolEncoder.h"
+
+using namespace bpp;
+using namespace std;
+
+const int SymbolEncoder::SKIP_CODE = numeric_limits<int>::min();
+const int SymbolEncoder::INVALID_CODE = numeric_limits<int>::min() + 1;
+
+/******************************************************************************/
+
+SymbolEncoder::SymbolEncoder(std::shared_ptr<const Alphabet> alphabet, InvalidSymbolAction action) :
+  alphabet_(alphabet),
+  codingSize_(AlphabetTools::getAlphabetCodingSize(*alphabet)), // Warning, an exception may be thrown here!
+  table_(),
+  action_(action),
+  replacement_(action == REPLACE_BY_GAP ? alphabet->getGapCharacterCode() : alphabet->getUnknownCharacterCode())
+{
+  table_.fill(INVALID_CODE);
+  if (codingSize_ == 1)
+  {
+    // Only 7-bits characters can be alphabet letters:
+    for (int c = 1; c < 128; ++c)
+    {
+      string s(1, static_cast<char>(c));
+      if (alphabet_->isCharInAlphabet(s))
+        table_[static_cast<size_t>(c)] = alphabet_->charToInt(s);
+    }
+  }
+  table_[static_cast<size_t>(' ')]  = SKIP_CODE;
+  table_[static_cast<size_t>('\t')] = SKIP_CODE;
+  table_[static_cast<size_t>('\n')] = SKIP_CODE;
+  table_[static_cast<size_t>('\r')] = SKIP_CODE;
+  table_[static_cast<size_t>('\f')] = SKIP_CODE;
+}
+
+/******************************************************************************/
+
+void SymbolEncoder::replaceInvalid_(const std::string& symbol, std::vector<int>& content, std::vector<InvalidSymbol>* invalid) const
+{
+  if (action_ == THROW_ON_INVALID)
+    throw BadCharException(symbol, "SymbolEncoder::encode", alphabet_);
+  if (invalid)
+  {
+    InvalidSymbol record = { content.size(), symbol[0] };
+    invalid->push_back(record);
+  }
+  content.push_back(replacement_);
+}
+
+/******************************************************************************/
+
+void SymbolEncoder::encode_(const char* begin, const char* end, std::vector<int>& content, std::string& pending, std::vector<InvalidSymbol>* invalid) const
+{
+  if (codingSize_ == 1)
+  {
+    for (const char* p = begin; p < end; ++p)
+    {
+      int code = table_[static_cast<unsigned char>(*p)];
+      if (code == SKIP_CODE)
+        continue;
+      if (code == INVALID_CODE)
+        replaceInvalid_(string(1, *p), content, invalid);
+      else
+        content.push_back(code);
+    }
+  }
+  else
+  {
+    for (const char* p = begin; p < end; ++p)
+    {
+      if (table_[static_cast<unsigned char>(*p)] == SKIP_CODE)
+        continue;
+      pending.push_back(*p);
+      if (pending.size() == codingSize_)
+      {
+        if (alphabet_->isCharInAlphabet(pending))
+          content.push_back(alphabet_->charToInt(pending));
+        else
+          replaceInvalid_(pending, content, invalid);
+        pending.clear();
+      }
+    }
+  }
+}
+
+/******************************************************************************/
+
+void SymbolEncoder::encode(const std::string& text, std::vector<int>& content) const
+{
+  string pending;
+  encode(text.data(), text.data() + text.size(), content, pending);
+  if (!pending.empty())
+    throw BadCharException(pending, "SymbolEncoder::encode. Incomplete state at the end of the text.", alphabet_);
+}
+
+/******************************************************************************/
+
+size_t SymbolEncoder::countSymbols(const char* begin, const char* end)
+{
+  size_t n = 0;
+  for (const char* p = begin; p < end; ++p)
+  {
+    if (!TextTools::isWhiteSpaceCharacter(*p))
+      ++n;
+  }
+  return n;
+}
+
+/******************************************************************************/
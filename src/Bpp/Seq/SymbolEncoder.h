@@ -0,0 +1,179 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_SYMBOLENCODER_H
+#define BPP_SEQ_SYMBOLENCODER_H
+
+#include <Bpp/Exceptions.h>
+
+#include "Alphabet/Alphabet.h"
+#include "Alphabet/AlphabetExceptions.h"
+
+// From the STL:
+#include <array>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Fast conversion of raw characters to alphabet states.
+ *
+ * Alphabet::charToInt works on strings and goes through a map lookup, which
+ * dominates the parsing time of large alignments. This class builds, once for
+ * a given alphabet, a 256-entry lookup table mapping each byte to its state,
+ * so that a whole buffer can be encoded in a single pass without creating any
+ * temporary string.
+ *
+ * White spaces are skipped while encoding, so that raw lines from files can be
+ * passed directly. For alphabets with states coded on several characters
+ * (codons, words), characters are accumulated until a complete state is read,
+ * and the conversion falls back to Alphabet::charToInt.
+ *
+ * Characters which are not part of the alphabet throw a BadCharException by
+ * default. Alternatively, they can be replaced by the unknown or gap state,
+ * in the same pass and without any exception, and reported in a list of
+ * InvalidSymbol records (see InvalidSymbolAction).
+ *
+ * The table is filled in the constructor and never modified afterwards, so
+ * that a single encoder can be shared between threads.
+ *
+ * @see StringSequenceTools::codeSequence
+ */
+class SymbolEncoder
+{
+public:
+  /**
+   * @brief What to do with characters which are not part of the alphabet.
+   */
+  enum InvalidSymbolAction
+  {
+    THROW_ON_INVALID,   // Throw a BadCharException.
+    REPLACE_BY_UNKNOWN, // Encode as the unknown state of the alphabet.
+    REPLACE_BY_GAP      // Encode as a gap.
+  };
+
+  /**
+   * @brief An invalid character found while encoding.
+   *
+   * For alphabets with states coded on several characters, the first
+   * character of the invalid group is stored.
+   */
+  struct InvalidSymbol
+  {
+    size_t position;  // Position of the replaced state in the encoded content.
+    char character;
+  };
+
+private:
+  std::shared_ptr<const Alphabet> alphabet_;
+  unsigned int codingSize_;
+  std::array<int, 256> table_;
+  InvalidSymbolAction action_;
+  int replacement_;
+
+public:
+  /**
+   * @brief Table value for characters which are ignored (white spaces).
+   */
+  static const int SKIP_CODE;
+
+  /**
+   * @brief Table value for characters which are not part of the alphabet.
+   */
+  static const int INVALID_CODE;
+
+public:
+  /**
+   * @param alphabet The alphabet to use.
+   * @param action   What to do with characters which are not part of the alphabet.
+   * @throw AlphabetException If the alphabet does not have a constant coding size.
+   */
+  SymbolEncoder(std::shared_ptr<const Alphabet> alphabet, InvalidSymbolAction action = THROW_ON_INVALID);
+
+  virtual ~SymbolEncoder() {}
+
+public:
+  std::shared_ptr<const Alphabet> getAlphabet() const { return alphabet_; }
+
+  const Alphabet& alphabet() const { return *alphabet_; }
+
+  /**
+   * @return The number of characters used to code one state.
+   */
+  unsigned int getCodingSize() const { return codingSize_; }
+
+  InvalidSymbolAction getInvalidSymbolAction() const { return action_; }
+
+  /**
+   * @return The raw table code of a character (only meaningful for one-character alphabets).
+   */
+  int getCode(char c) const { return table_[static_cast<unsigned char>(c)]; }
+
+  /**
+   * @brief Encode a buffer and append the resulting states to a vector.
+   *
+   * White spaces are skipped. With multi-characters states, characters which do
+   * not complete a state are stored in 'pending' and used by the next call,
+   * allowing states to span several lines or blocks.
+   *
+   * @param begin   Start of the buffer.
+   * @param end     End of the buffer (excluded).
+   * @param content The vector to which states are appended.
+   * @param pending Unprocessed characters from a previous call (updated).
+   * @throw BadCharException If a character (or group of characters) is not a valid state,
+   * and invalid symbols are not replaced.
+   */
+  void encode(const char* begin, const char* end, std::vector<int>& content, std::string& pending) const
+  {
+    encode_(begin, end, content, pending, nullptr);
+  }
+
+  /**
+   * @brief Encode a buffer, and report replaced symbols.
+   *
+   * Same as the previous method, but characters replaced according to the
+   * InvalidSymbolAction are also appended to a list.
+   *
+   * @param begin   Start of the buffer.
+   * @param end     End of the buffer (excluded).
+   * @param content The vector to which states are appended.
+   * @param pending Unprocessed characters from a previous call (updated).
+   * @param invalid The vector to which replaced symbols are appended.
+   * @throw BadCharException If a character is not a valid state, and invalid symbols are not replaced.
+   */
+  void encode(const char* begin, const char* end, std::vector<int>& content, std::string& pending, std::vector<InvalidSymbol>& invalid) const
+  {
+    encode_(begin, end, content, pending, &invalid);
+  }
+
+  /**
+   * @brief Encode a whole string and append the resulting states to a vector.
+   *
+   * @param text    The text to encode.
+   * @param content The vector to which states are appended.
+   * @throw BadCharException If a character (or group of characters) is not a valid state,
+   * or if the number of characters is not a multiple of the coding size.
+   */
+  void encode(const std::string& text, std::vector<int>& content) const;
+
+  /**
+   * @brief Count the number of non-white characters in a buffer.
+   *
+   * This is used to presize content vectors before encoding.
+   */
+  static size_t countSymbols(const char* begin, const char* end);
+
+private:
+  void encode_(const char* begin, const char* end, std::vector<int>& content, std::string& pending, std::vector<InvalidSymbol>* invalid) const;
+
+  /**
+   * @brief Handle an invalid character or group of characters (out of the main loop).
+   */
+  void replaceInvalid_(const std::string& symbol, std::vector<int>& content, std::vector<InvalidSymbol>* invalid) const;
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_SYMBOLENCODER_H
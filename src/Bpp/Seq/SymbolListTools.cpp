@@ -446,7 +446,7 @@ double SymbolListTools::getGCContent(
           case (7): gc++; break; // G or C
           case (4): gc += 0.5; break; // A or C
           case (5): gc += 0.5; break; // A or G
-          case (6): gc += 0.5; break; // C or T
+          case (8): gc += 0.5; break; // C or T
           case (9): gc += 0.5; break; // G or T
           case (10): gc += 2. / 3.; break; // A or C or G
           case (11): gc += 1. / 3.; break; // A or C or T
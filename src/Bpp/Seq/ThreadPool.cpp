@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "ThreadPool.h"
+
+using namespace bpp;
+using namespace std;
+
+static thread_local bool insideWorker = false;
+
+/******************************************************************************/
+
+ThreadPool::ThreadPool(unsigned int numberOfThreads) :
+  workers_(),
+  mutex_(),
+  wakeUp_(),
+  done_(),
+  runMutex_(),
+  task_(nullptr),
+  nbTasks_(0),
+  next_(0),
+  nbBusy_(0),
+  generation_(0),
+  stop_(false),
+  error_(),
+  errorIndex_(0)
+{
+  unsigned int n = resolveNumberOfThreads(numberOfThreads);
+  for (unsigned int i = 1; i < n; ++i)
+  {
+    workers_.push_back(thread(&ThreadPool::workerLoop_, this));
+  }
+}
+
+/******************************************************************************/
+
+ThreadPool::~ThreadPool()
+{
+  {
+    lock_guard<mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wakeUp_.notify_all();
+  for (auto& worker : workers_)
+  {
+    worker.join();
+  }
+}
+
+/******************************************************************************/
+
+unsigned int ThreadPool::resolveNumberOfThreads(unsigned int numberOfThreads)
+{
+  if (numberOfThreads > 0)
+    return numberOfThreads;
+  unsigned int n = thread::hardware_concurrency();
+  return n > 0 ? n : 1;
+}
+
+/******************************************************************************/
+
+bool ThreadPool::isWorkerThread()
+{
+  return insideWorker;
+}
+
+/******************************************************************************/
+
+void ThreadPool::work_(const std::function<void(size_t)>& task, size_t nbTasks)
+{
+  for (size_t i = next_.fetch_add(1); i < nbTasks; i = next_.fetch_add(1))
+  {
+    try
+    {
+      task(i);
+    }
+    catch (...)
+    {
+      lock_guard<mutex> lock(mutex_);
+      if (!error_ || i < errorIndex_)
+      {
+        error_ = current_exception();
+        errorIndex_ = i;
+      }
+      next_.store(nbTasks); // Skip the remaining tasks.
+    }
+  }
+}
+
+/******************************************************************************/
+
+void ThreadPool::workerLoop_()
+{
+  insideWorker = true;
+  size_t seen = 0;
+  while (true)
+  {
+    const function<void(size_t)>* task;
+    size_t nbTasks;
+    {
+      unique_lock<mutex> lock(mutex_);
+      wakeUp_.wait(lock, [&]() { return stop_ || generation_ != seen; });
+      if (stop_)
+        return;
+      seen = generation_;
+      task = task_;
+      nbTasks = nbTasks_;
+    }
+    work_(*task, nbTasks);
+    {
+      lock_guard<mutex> lock(mutex_);
+      if (--nbBusy_ == 0)
+        done_.notify_one();
+    }
+  }
+}
+
+/******************************************************************************/
+
+void ThreadPool::run(size_t nbTasks, const std::function<void(size_t)>& task)
+{
+  // Small batches, nested calls and concurrent batches are run serially:
+  unique_lock<mutex> running(runMutex_, defer_lock);
+  if (nbTasks <= 1 || workers_.empty() || insideWorker || !running.try_lock())
+  {
+    for (size_t i = 0; i < nbTasks; ++i)
+    {
+      task(i);
+    }
+    return;
+  }
+
+  {
+    lock_guard<mutex> lock(mutex_);
+    task_ = &task;
+    nbTasks_ = nbTasks;
+    next_.store(0);
+    nbBusy_ = workers_.size();
+    error_ = nullptr;
+    ++generation_;
+  }
+  wakeUp_.notify_all();
+
+  // The calling thread works too, and is marked as a worker so that nested calls run serially:
+  insideWorker = true;
+  work_(task, nbTasks);
+  insideWorker = false;
+
+  exception_ptr error;
+  {
+    unique_lock<mutex> lock(mutex_);
+    done_.wait(lock, [&]() { return nbBusy_ == 0; });
+    task_ = nullptr;
+    error = error_;
+    error_ = nullptr;
+  }
+  if (error)
+    rethrow_exception(error);
+}
+
+/******************************************************************************/
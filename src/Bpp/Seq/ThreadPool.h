@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef BPP_SEQ_THREADPOOL_H
+#define BPP_SEQ_THREADPOOL_H
+
+#include <Bpp/Exceptions.h>
+
+// From the STL:
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief A pool of persistent worker threads.
+ *
+ * The pool runs one batch of indexed tasks at a time. Tasks are handed out
+ * dynamically, so that unequal tasks are balanced between threads, and the
+ * calling thread takes part in the work. Threads are created once, and sleep
+ * between batches.
+ *
+ * Batches submitted from a worker thread (nested parallelism), or while the
+ * pool is busy with a batch from another thread, are run by the calling
+ * thread alone, so that run() never deadlocks.
+ *
+ * @see ExecutionContext
+ */
+class ThreadPool
+{
+private:
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable wakeUp_;
+  std::condition_variable done_;
+  std::mutex runMutex_;  // Only one batch at a time.
+
+  // Current batch:
+  const std::function<void(size_t)>* task_;
+  size_t nbTasks_;
+  std::atomic<size_t> next_;
+  size_t nbBusy_;
+  size_t generation_;
+  bool stop_;
+  std::exception_ptr error_;
+  size_t errorIndex_;
+
+public:
+  /**
+   * @param numberOfThreads The total number of threads, including the calling one (0 for one thread per core).
+   */
+  ThreadPool(unsigned int numberOfThreads);
+
+  virtual ~ThreadPool();
+
+private:
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+public:
+  /**
+   * @return The total number of threads used to run a batch, including the calling one.
+   */
+  unsigned int getNumberOfThreads() const { return static_cast<unsigned int>(workers_.size() + 1); }
+
+  /**
+   * @brief Run a batch of tasks and wait for their completion.
+   *
+   * @param nbTasks The number of tasks.
+   * @param task    The function to call with each task index, from 0 to nbTasks - 1.
+   * @throw Exception If a task throws, the exception of the task with the smallest index is rethrown
+   * once all running tasks are finished. Tasks not started yet are skipped.
+   */
+  void run(size_t nbTasks, const std::function<void(size_t)>& task);
+
+  /**
+   * @return True if the calling thread is a worker of a pool.
+   */
+  static bool isWorkerThread();
+
+  /**
+   * @return The number of threads to use for a given setting (0 means one per core).
+   */
+  static unsigned int resolveNumberOfThreads(unsigned int numberOfThreads);
+
+private:
+  void workerLoop_();
+
+  void work_(const std::function<void(size_t)>& task, size_t nbTasks);
+};
+} // end of namespace bpp.
+#endif // BPP_SEQ_THREADPOOL_H
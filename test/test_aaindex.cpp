@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/AlphabetIndex/AAIndexDatabase.h>
+#include <Bpp/Seq/Container/VectorSequenceContainer.h>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+using namespace bpp;
+using namespace std;
+
+const string AAINDEX1 =
+  "H ANDN920101\n"
+  "D alpha-CH chemical shifts (Andersen et al., 1992)\n"
+  "R PMID:1575719\n"
+  "I    A/L     R/K     N/M     D/F     C/P     Q/S     E/T     G/W     H/Y     I/V\n"
+  "    4.35    4.38    4.75    4.76    4.65    4.37    4.29    3.97    4.63    3.95\n"
+  "    4.17    4.36    4.52    4.66    4.44    4.50    4.35    4.70    4.60    3.95\n"
+  "//\n"
+  "H TEST000002\n"
+  "D A test index with\n"
+  "  missing values\n"
+  "I    A/L     R/K     N/M     D/F     C/P     Q/S     E/T     G/W     H/Y     I/V\n"
+  "      1.      2.      NA     -4.      5.      6.      7.      8.      9.     10.\n"
+  "     11.     12.     13.     14.     NA      16.     17.     18.     19.     20.\n"
+  "//\n";
+
+const string AAINDEX2 =
+  "H TEST000003\n"
+  "D A lower triangle\n"
+  "M rows = ARNDCQEGHILKMFPSTWYV, cols = ARNDCQEGHILKMFPSTWYV\n"
+  "      1.\n"
+  "      2.      3.\n"
+  "      4.      5.      6.\n"
+  "      0.      0.      0.      0.\n"
+  "      0.      0.      0.      0.      0.\n"
+  "      0.      0.      0.      0.      0.      0.\n"
+  "      0.      0.      0.      0.      0.      0.      0.\n"
+  "      0.      0.      0.      0.      0.      0.      0.      0.\n"
+  "      0.      0.      0.      0.      0.      0.      0.      0.      0.\n"
+  "      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.\n"
+  "      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.\n"
+  "      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.\n"
+  "      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.\n"
+  "      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.\n"
+  "      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.\n"
+  "      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.\n"
+  "      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.\n"
+  "      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.\n"
+  "      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.\n"
+  "      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.      0.     7.\n"
+  "//\n";
+
+int main()
+{
+  size_t nbErrors = 0;
+  istringstream input1(AAINDEX1);
+  AAIndexDatabase db1(input1);
+  nbErrors += db1.size() != 2 || db1.getType() != AAIndexDatabase::INDEX1 || !db1.hasMissingValues();
+  nbErrors += db1.getEntryIndex("TEST000002") != 1;
+  nbErrors += db1.getDescription(1) != "A test index with missing values";
+  nbErrors += db1.getValues(0)[19] != 3.95 || db1.getValues(1)[3] != -4. || !std::isnan(db1.getValues(1)[2]);
+
+  shared_ptr<const Alphabet> protein = AlphabetTools::PROTEIN_ALPHABET;
+  VectorSequenceContainer proteins(protein);
+  vector<string> data = {
+    "MKTAYIAKQRQISFVKSHFSRQLEERLGLIEVQAPILSRVGDGTQDNLSG",
+    "MKTAYIAK-RQISFVKSHXSRQLEERLG",
+    "NPNPNPNP"
+  };
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    auto seq = make_unique<Sequence>("prot" + to_string(i), data[i], protein);
+    proteins.addSequence(seq->getName(), seq);
+  }
+
+  // Naive mean of an index over a part of a sequence:
+  auto naiveMean = [&](size_t e, const Sequence& seq, size_t begin, size_t end)
+  {
+    double sum = 0, count = 0;
+    for (size_t l = begin; l < end; ++l)
+    {
+      int state = seq[l];
+      if (state < 0 || state >= 20 || std::isnan(db1.getValues(e)[state]))
+        continue;
+      sum += db1.getValues(e)[state];
+      count++;
+    }
+    return count > 0 ? sum / count : NAN;
+  };
+
+  ExecutionContext parallel(4, 1);
+  RowMatrix<double> means = db1.getMeans(proteins, parallel);
+  size_t window = 5;
+  vector< RowMatrix<double>> profiles = db1.getSlidingMeans(proteins, window, parallel);
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    const Sequence& seq = proteins.sequence(i);
+    for (size_t e = 0; e < db1.size(); ++e)
+    {
+      double expected = naiveMean(e, seq, 0, seq.size());
+      nbErrors += !(abs(means(i, e) - expected) < 1e-12 || (std::isnan(expected) && std::isnan(means(i, e))));
+      nbErrors += profiles[i].getNumberOfRows() != seq.size() - window + 1;
+      for (size_t k = 0; k < profiles[i].getNumberOfRows(); ++k)
+      {
+        expected = naiveMean(e, seq, k, k + window);
+        nbErrors += !(abs(profiles[i](k, e) - expected) < 1e-12 || (std::isnan(expected) && std::isnan(profiles[i](k, e))));
+      }
+    }
+  }
+  // Only N and P, both missing in the second index:
+  nbErrors += !std::isnan(means(2, 1));
+  nbErrors += abs(db1.getIndex1(0)->getIndex("V") - 3.95) > 1e-12;
+
+  istringstream input2(AAINDEX2);
+  AAIndexDatabase db2(input2, false);
+  RowMatrix<double> matrix = db2.getMatrix(0);
+  nbErrors += db2.getType() != AAIndexDatabase::INDEX2;
+  nbErrors += matrix(2, 1) != 5. || matrix(1, 2) != -5. || matrix(19, 19) != 7.;
+  try
+  {
+    db2.getMeans(proteins);
+    nbErrors++;
+  }
+  catch (Exception& e) {}
+
+  if (nbErrors > 0)
+  {
+    cerr << nbErrors << " errors." << endl;
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
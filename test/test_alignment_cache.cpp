@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/App/SequenceApplicationTools.h>
+#include <Bpp/Seq/Io/AlignmentCache.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+using namespace bpp;
+using namespace std;
+
+size_t compare(const SiteContainerInterface& sites1, const SiteContainerInterface& sites2)
+{
+  size_t nbErrors = 0;
+  nbErrors += sites1.getSequenceNames() != sites2.getSequenceNames();
+  nbErrors += sites1.getSequenceKeys() != sites2.getSequenceKeys();
+  if (sites1.getNumberOfSites() != sites2.getNumberOfSites())
+    return nbErrors + 1;
+  for (size_t i = 0; i < sites1.getNumberOfSites(); ++i)
+  {
+    nbErrors += sites1.site(i).getContent() != sites2.site(i).getContent();
+    nbErrors += sites1.site(i).getCoordinate() != sites2.site(i).getCoordinate();
+  }
+  return nbErrors;
+}
+
+int main()
+{
+  size_t nbErrors = 0;
+  shared_ptr<const Alphabet> dna = AlphabetTools::DNA_ALPHABET;
+
+  {
+    ofstream file("cache_test.fasta");
+    file << ">seq1\nACGT-ACGTNACGT\n>seq2\nACGTTACG-RACGA\n>seq3\nTCGTTACGTAACGA\n";
+  }
+
+  map<string, string> params;
+  params["input.sequence.file"] = "cache_test.fasta";
+  params["input.sequence.format"] = "Fasta";
+  params["input.site.selection"] = "(2:12)";
+  params["input.sequence.cache"] = ".";
+  // Options used by the loader to build keys:
+  map<string, string> options;
+  options["input.sequence.format"] = "Fasta";
+  options["input.site.selection"] = "(2:12)";
+  options["input.sequence.keep_names"] = "all";
+  options["input.sequence.remove_names"] = "none";
+
+  // Keys depend on the content of the file and on the options:
+  AlignmentCache cache(".");
+  string key = AlignmentCache::getKey("cache_test.fasta", options, *dna);
+  nbErrors += key.size() != 33;
+  map<string, string> options2 = options;
+  options2["input.sequence.sites_to_use"] = "nogap";
+  nbErrors += AlignmentCache::getKey("cache_test.fasta", options2, *dna) == key;
+  nbErrors += AlignmentCache::getKey("cache_test.fasta", options, *AlphabetTools::RNA_ALPHABET) == key;
+  nbErrors += AlignmentCache::getKey("cache_test.fasta", options, *dna) != key;
+  nbErrors += cache.load(key, dna) != nullptr;
+
+  // The first call reads the file, and fills the cache:
+  auto sites1 = SequenceApplicationTools::getSiteContainer(dna, params, "", true, false);
+  nbErrors += sites1->getNumberOfSites() != 11;
+  auto cached = cache.load(key, dna, ExecutionContext(2, 3));
+  nbErrors += !cached || compare(*sites1, *cached);
+
+  // The second call uses the cache:
+  sites1->setSequenceNames({ "a", "b", "c" }, false);
+  cache.store(key, *sites1);
+  auto sites2 = SequenceApplicationTools::getSiteContainer(dna, params, "", true, false);
+  nbErrors += compare(*sites1, *sites2);
+
+  // Options applied after loading, or meant for other alignments, do not change the key:
+  map<string, string> params2 = params;
+  params2["input.sequence.sites_to_use"] = "nogap";
+  params2["input.sequence.max_gap_allowed"] = "10%";
+  params2["input.sequence.file2"] = "other.fasta";
+  params2["input.sequence.format2"] = "Phylip";
+  auto sites2b = SequenceApplicationTools::getSiteContainer(dna, params2, "", true, false);
+  nbErrors += compare(*sites1, *sites2b);
+  params2["input.sequence.remove_names"] = "seq2";
+  auto sites2c = SequenceApplicationTools::getSiteContainer(dna, params2, "", true, false);
+  nbErrors += sites2c->getNumberOfSequences() != 2;
+  options["input.sequence.remove_names"] = "seq2";
+  remove(cache.getPath(AlignmentCache::getKey("cache_test.fasta", options, *dna)).c_str());
+  options["input.sequence.remove_names"] = "none";
+
+  // Concurrent stores of the same key do not interfere:
+  ExecutionContext(4).forEachBlock(16, [&](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      cache.store(key, *sites1);
+    }
+  }, 1);
+  auto stored = cache.load(key, dna);
+  nbErrors += !stored || compare(*sites1, *stored);
+
+  // Alignments are still loaded if they cannot be cached:
+  map<string, string> params3 = params;
+  params3["input.sequence.cache"] = "missing_cache_directory";
+  auto sites2d = SequenceApplicationTools::getSiteContainer(dna, params3, "", true, false);
+  nbErrors += sites2d->getNumberOfSites() != 11;
+
+  // A change in the file changes the key:
+  {
+    ofstream file("cache_test.fasta");
+    file << ">seq1\nACGT-ACGTNACGT\n>seq2\nACGTTACG-RACGA\n>seq3\nTCGTTACGTAACGT\n";
+  }
+  string key2 = AlignmentCache::getKey("cache_test.fasta", options, *dna);
+  nbErrors += key2 == key;
+  auto sites3 = SequenceApplicationTools::getSiteContainer(dna, params, "", true, false);
+  nbErrors += sites3->getSequenceNames()[0] != "seq1";
+  nbErrors += sites3->sequence(2).toString() != "CGTTACGTAAC";
+
+  // Invalid files are ignored:
+  {
+    ofstream file(cache.getPath(key).c_str());
+    file << "Not an alignment cache.";
+  }
+  nbErrors += cache.load(key, dna) != nullptr;
+  cache.store(key, *sites1);
+  nbErrors += cache.load(key, AlphabetTools::PROTEIN_ALPHABET) != nullptr;
+
+  remove("cache_test.fasta");
+  remove(cache.getPath(key).c_str());
+  remove(cache.getPath(key2).c_str());
+
+  if (nbErrors > 0)
+  {
+    cerr << nbErrors << " errors." << endl;
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/AlphabetIndex/AlphabetIndexTools.h>
+#include <Bpp/Seq/AlphabetIndex/KD_AAHydropathyIndex.h>
+#include <Bpp/Seq/Container/VectorSequenceContainer.h>
+#include <Bpp/Seq/SymbolListTools.h>
+#include <cmath>
+#include <iostream>
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  size_t nbErrors = 0;
+  ExecutionContext parallel(4, 1);
+
+  // Hydropathy profiles:
+  shared_ptr<const Alphabet> protein = AlphabetTools::PROTEIN_ALPHABET;
+  KD_AAHydropathyIndex kd;
+  VectorSequenceContainer proteins(protein);
+  vector<string> data = {
+    "MKTAYIAKQRQISFVKSHFSRQLEERLGLIEVQAPILSRVGDGTQDNLSGAEKAVQVKVKALPDAQFEVV",
+    "MKTAYIAK-RQISFVKSHFSRQXEERLGLIEVQAPILSRVGDGTQDNLSG",
+    "GSHMASMTGGQQMGRGS"
+  };
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    auto seq = make_unique<Sequence>("prot" + to_string(i), data[i], protein);
+    proteins.addSequence(seq->getName(), seq);
+  }
+  size_t window = 9;
+  auto profiles = AlphabetIndexTools::getSlidingMeans(kd, proteins, window, parallel);
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    const Sequence& seq = proteins.sequence(i);
+    nbErrors += profiles[i].size() != seq.size() - window + 1;
+    for (size_t k = 0; k < profiles[i].size(); ++k)
+    {
+      double sum = 0, count = 0;
+      for (size_t l = k; l < k + window; ++l)
+      {
+        if (!protein->isGap(seq[l]) && !protein->isUnresolved(seq[l]))
+        {
+          sum += kd.getIndex(seq[l]);
+          count++;
+        }
+      }
+      nbErrors += abs(profiles[i][k] - sum / count) > 1e-12;
+    }
+  }
+  vector<double> values;
+  AlphabetIndexTools::getValues(kd, proteins.sequence(1), values);
+  nbErrors += values[0] != kd.getIndex("M") || !std::isnan(values[8]) || !std::isnan(values[22]);
+
+  // GC profiles:
+  shared_ptr<const Alphabet> dna = AlphabetTools::DNA_ALPHABET;
+  VectorSequenceContainer nucleotides(dna);
+  auto seq = make_unique<Sequence>("dna", "ATGCGCRTA-NNACGGSCCWTTAGCGAATTCGCGTAGCTAGT", dna);
+  nucleotides.addSequence(seq->getName(), seq);
+  for (bool ignoreUnresolved : {true, false})
+  {
+    for (bool ignoreGap : {true, false})
+    {
+      window = 7;
+      vector<double> gc = AlphabetIndexTools::getGCProfiles(nucleotides, window, ignoreUnresolved, ignoreGap, parallel)[0];
+      const Sequence& s = nucleotides.sequence(0);
+      for (size_t k = 0; k < gc.size(); ++k)
+      {
+        Sequence part("part", vector<int>(s.getContent().begin() + static_cast<ptrdiff_t>(k), s.getContent().begin() + static_cast<ptrdiff_t>(k + window)), dna);
+        nbErrors += abs(gc[k] - SymbolListTools::getGCContent(part, ignoreUnresolved, ignoreGap)) > 1e-12;
+      }
+    }
+  }
+
+  try
+  {
+    AlphabetIndexTools::getSlidingMeans(kd, proteins.sequence(2), 100);
+    nbErrors++;
+  }
+  catch (BadIntegerException& e) {}
+  try
+  {
+    AlphabetIndexTools::getValues(kd, nucleotides.sequence(0), values);
+    nbErrors++;
+  }
+  catch (AlphabetMismatchException& e) {}
+
+  if (nbErrors > 0)
+  {
+    cerr << nbErrors << " errors." << endl;
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
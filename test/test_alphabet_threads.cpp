@@ -0,0 +1,118 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/Alphabet/CodonAlphabet.h>
+#include <Bpp/Seq/Alphabet/DNA.h>
+#include <Bpp/Seq/Alphabet/ProteicAlphabet.h>
+#include <Bpp/Seq/Alphabet/RNA.h>
+#include <Bpp/Seq/AlphabetIndex/AAMassIndex.h>
+#include <Bpp/Seq/AlphabetIndex/GranthamAAChemicalDistance.h>
+#include <Bpp/Seq/GeneticCode/StandardGeneticCode.h>
+#include <Bpp/Seq/NucleicAcidsReplication.h>
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+// Stress test: fresh alphabets, genetic codes and indices are shared by
+// several threads, which all query them at the same time, starting with
+// the lists which are computed on first use.
+
+int main()
+{
+  const size_t nbThreads = 8;
+  const size_t nbRounds = 20;
+  const size_t nbIterations = 200;
+
+  // Reference values, computed by a single thread on separate instances:
+  auto refDna = make_shared<DNA>();
+  auto refPro = make_shared<ProteicAlphabet>();
+  auto refCodons = make_shared<CodonAlphabet>(refDna);
+  StandardGeneticCode refCode(refDna);
+  vector<int> refInts = refCodons->getSupportedInts();
+  vector<string> refChars = refCodons->getSupportedChars();
+  vector<string> refResolved = refDna->getResolvedChars();
+  vector<int> senseCodons;
+  vector<int> refTranslations;
+  for (int c = 0; c < 64; ++c)
+  {
+    if (!refCode.isStop(c))
+    {
+      senseCodons.push_back(c);
+      refTranslations.push_back(refCode.translate(c));
+    }
+  }
+
+  atomic<size_t> nbErrors(0);
+  for (size_t r = 0; r < nbRounds; ++r)
+  {
+    auto dna = make_shared<DNA>();
+    auto rna = make_shared<RNA>();
+    auto pro = make_shared<ProteicAlphabet>();
+    auto codons = make_shared<CodonAlphabet>(dna);
+    StandardGeneticCode code(dna);
+    AAMassIndex mass;
+    GranthamAAChemicalDistance grantham;
+    NucleicAcidsReplication transcription(dna, rna);
+
+    atomic<bool> go(false);
+    auto worker = [&](size_t t)
+    {
+      while (!go.load())
+      {
+        this_thread::yield();
+      }
+      size_t errors = 0;
+      for (size_t i = 0; i < nbIterations; ++i)
+      {
+        // Alternate the first call between threads:
+        if ((t + i) % 2 == 0)
+        {
+          errors += codons->getSupportedInts() != refInts;
+          errors += codons->getSupportedChars() != refChars;
+        }
+        else
+        {
+          errors += codons->getSupportedChars() != refChars;
+          errors += codons->getSupportedInts() != refInts;
+        }
+        errors += dna->getResolvedChars() != refResolved;
+        errors += dna->getSupportedChars().size() != dna->getNumberOfStates();
+        errors += pro->getResolvedChars().size() != refPro->getResolvedChars().size();
+
+        size_t k = (t * nbIterations + i) % senseCodons.size();
+        int c = senseCodons[k];
+        errors += code.translate(c) != refTranslations[k];
+        errors += code.translate(codons->intToChar(c)) != code.getTargetAlphabet()->intToChar(refTranslations[k]);
+        errors += codons->charToInt(refChars[k]) != refInts[k];
+
+        int aa = c % 20;
+        errors += mass.getIndex(aa) != mass.getIndex(pro->intToChar(aa));
+        errors += grantham.getIndex(aa, (aa + 1) % 20) != grantham.getIndexMatrix()(static_cast<size_t>(aa), static_cast<size_t>((aa + 1) % 20));
+
+        int n = c % 4;
+        errors += transcription.reverse(transcription.translate(n)) != n;
+      }
+      nbErrors += errors;
+    };
+
+    vector<thread> threads;
+    for (size_t t = 0; t < nbThreads; ++t)
+    {
+      threads.push_back(thread(worker, t));
+    }
+    go.store(true);
+    for (auto& th : threads)
+    {
+      th.join();
+    }
+  }
+
+  cout << "Errors: " << nbErrors.load() << endl;
+  return nbErrors.load() == 0 ? 0 : 1;
+}
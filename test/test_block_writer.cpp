@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Exceptions.h>
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/ExecutionContext.h>
+#include <Bpp/Seq/Io/BlockWriter.h>
+#include <Bpp/Seq/Io/Clustal.h>
+#include <Bpp/Seq/Io/Fasta.h>
+#include <Bpp/Seq/Io/Phylip.h>
+#include <iostream>
+#include <sstream>
+
+using namespace bpp;
+using namespace std;
+
+// Block i is made of i + 1 copies of its index, so that blocks have different sizes.
+static void formatBlock(size_t i, string& text)
+{
+  for (size_t j = 0; j <= i; ++j)
+  {
+    text += to_string(i);
+  }
+  text += "\n";
+}
+
+static string writeBlocks(size_t nbBlocks, size_t capacity, const ExecutionContext& context)
+{
+  ostringstream output;
+  {
+    BlockWriter writer(output, capacity);
+    writer.buffer() += "header\n";
+    writer.writeBlocks(nbBlocks, formatBlock, context);
+    writer.buffer() += "footer\n";
+  }
+  return output.str();
+}
+
+static string getError(size_t nbBlocks, const ExecutionContext& context)
+{
+  ostringstream output;
+  BlockWriter writer(output, 64);
+  try
+  {
+    writer.writeBlocks(nbBlocks, [](size_t i, string& text)
+    {
+      if (i == 37 || i == 80)
+        throw Exception("Bad block " + to_string(i) + ".");
+      formatBlock(i, text);
+    }, context);
+  }
+  catch (exception& e)
+  {
+    return e.what();
+  }
+  return "";
+}
+
+int main()
+{
+  size_t nbErrors = 0;
+  ExecutionContext sequential(1);
+  ExecutionContext parallel(4);
+
+  // Blocks are written in order, whatever the number of threads and the size of batches:
+  string expected = "header\n";
+  for (size_t i = 0; i < 200; ++i)
+  {
+    formatBlock(i, expected);
+  }
+  expected += "footer\n";
+  for (size_t capacity : { 1, 64, 1024, 1048576 })
+  {
+    nbErrors += writeBlocks(200, capacity, sequential) != expected;
+    nbErrors += writeBlocks(200, capacity, parallel) != expected;
+  }
+  nbErrors += writeBlocks(0, 64, parallel) != "header\nfooter\n";
+
+  // The error of the first failing block is reported, whatever the number of threads:
+  string error1 = getError(200, sequential);
+  string error2 = getError(200, parallel);
+  nbErrors += error1.find("Bad block 37.") == string::npos;
+  nbErrors += error1 != error2;
+
+  // Interleaved Phylip and Clustal files are the same when written with several threads:
+  shared_ptr<const Alphabet> alpha = AlphabetTools::PROTEIN_ALPHABET;
+  Fasta fasta;
+  auto sites = fasta.readAlignment("example.fasta", alpha);
+
+  Phylip phylip(true, false, 20);
+  Clustal clustal(true, 5, 15);
+  ostringstream phylip1, phylip2, clustal1, clustal2;
+  phylip.setExecutionContext(make_shared<ExecutionContext>(1));
+  phylip.writeAlignment(phylip1, *sites);
+  clustal.setExecutionContext(make_shared<ExecutionContext>(1));
+  clustal.writeAlignment(clustal1, *sites);
+  phylip.setExecutionContext(make_shared<ExecutionContext>(4));
+  phylip.writeAlignment(phylip2, *sites);
+  clustal.setExecutionContext(make_shared<ExecutionContext>(4));
+  clustal.writeAlignment(clustal2, *sites);
+  nbErrors += phylip1.str().empty() || phylip1.str() != phylip2.str();
+  nbErrors += clustal1.str().empty() || clustal1.str() != clustal2.str();
+
+  // Files written in parallel can be read back:
+  istringstream phylipInput(phylip2.str());
+  auto sites2 = phylip.readAlignment(phylipInput, alpha);
+  istringstream clustalInput(clustal2.str());
+  auto sites3 = clustal.readAlignment(clustalInput, alpha);
+  for (size_t i = 0; i < sites->getNumberOfSequences(); ++i)
+  {
+    nbErrors += sites2->sequence(i).toString() != sites->sequence(i).toString();
+    nbErrors += sites3->sequence(i).toString() != sites->sequence(i).toString();
+  }
+
+  if (nbErrors > 0)
+  {
+    cerr << nbErrors << " errors." << endl;
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
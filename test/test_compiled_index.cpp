@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/Alphabet/DNA.h>
+#include <Bpp/Seq/AlphabetIndex/BLOSUM50.h>
+#include <Bpp/Seq/AlphabetIndex/CodonFromProteicAlphabetIndex2.h>
+#include <Bpp/Seq/AlphabetIndex/CompiledAlphabetIndex2.h>
+#include <Bpp/Seq/AlphabetIndex/DefaultNucleotideScore.h>
+#include <Bpp/Seq/AlphabetIndex/GranthamAAChemicalDistance.h>
+#include <Bpp/Seq/Container/SiteContainerTools.h>
+#include <Bpp/Seq/GeneticCode/StandardGeneticCode.h>
+#include <cmath>
+#include <iostream>
+
+using namespace bpp;
+using namespace std;
+
+// Compare a compiled index with the original one, on resolved states:
+size_t check(const AlphabetIndex2& index, const CompiledAlphabetIndex2& compiled)
+{
+  size_t nbErrors = 0;
+  int n = static_cast<int>(index.getAlphabet()->getSize());
+  for (int s1 = 0; s1 < n; ++s1)
+  {
+    for (int s2 = 0; s2 < n; ++s2)
+    {
+      double v = index.getIndex(s1, s2);
+      nbErrors += compiled(s1, s2) != v || compiled.getIndex(s1, s2) != v;
+      nbErrors += compiled.getFloatRow(compiled.getRowIndex(s1))[compiled.getRowIndex(s2)] != static_cast<float>(v);
+    }
+  }
+  return nbErrors;
+}
+
+int main()
+{
+  size_t nbErrors = 0;
+
+  shared_ptr<const Alphabet> protein = AlphabetTools::PROTEIN_ALPHABET;
+  BLOSUM50 blosum;
+  CompiledAlphabetIndex2 compiled(blosum, -8.);
+  nbErrors += check(blosum, compiled);
+  nbErrors += !compiled.hasInt16() || !compiled.hasInt8();
+  int a = protein->charToInt("A");
+  int w = protein->charToInt("W");
+  int x = protein->charToInt("X");
+  int gap = protein->getGapCharacterCode();
+  nbErrors += compiled.getInt8Row(compiled.getRowIndex(w))[compiled.getRowIndex(w)] != 15;
+  nbErrors += compiled(gap, a) != -8. || compiled(a, gap) != -8.;
+  double mean = 0;
+  for (int s = 0; s < 20; ++s)
+  {
+    mean += blosum.getIndex(a, s) / 20.;
+  }
+  nbErrors += abs(compiled(a, x) - mean) > 1e-12;
+  nbErrors += compiled.getStride() % 64 != 0;
+  nbErrors += reinterpret_cast<size_t>(compiled.getFloatRow(1)) % 64 != 0;
+
+  // Query profile:
+  Sequence query("query", "MKWAX-LV", protein);
+  QueryProfile<int16_t> profile;
+  compiled.getQueryProfile(query.getContent(), profile);
+  nbErrors += profile.getLength() != 8 || profile.getStride() % 32 != 0;
+  for (size_t i = 0; i < query.size(); ++i)
+  {
+    nbErrors += profile.row(compiled.getRowIndex(w))[i] != static_cast<int16_t>(lround(compiled(query[i], w)));
+  }
+  nbErrors += reinterpret_cast<size_t>(profile.row(3)) % 64 != 0;
+
+  // Non integer scores:
+  GranthamAAChemicalDistance grantham;
+  CompiledAlphabetIndex2 compiledGrantham(grantham);
+  nbErrors += check(grantham, compiledGrantham);
+
+  // Ambiguities are handled by the nucleotide score itself:
+  shared_ptr<const Alphabet> dna = AlphabetTools::DNA_ALPHABET;
+  DefaultNucleotideScore dns(new DNA()); // Owns its alphabet.
+  CompiledAlphabetIndex2 compiledDns(dns);
+  for (int s1 = 0; s1 <= 14; ++s1)
+  {
+    for (int s2 = 0; s2 <= 14; ++s2)
+    {
+      nbErrors += compiledDns(s1, s2) != dns.getIndex(s1, s2);
+    }
+  }
+
+  // Codon scores, expanded from protein scores:
+  auto gCode = make_shared<StandardGeneticCode>(AlphabetTools::DNA_ALPHABET);
+  shared_ptr<const AlphabetIndex2> blosumPtr = make_shared<BLOSUM50>();
+  CodonFromProteicAlphabetIndex2 codonIndex(gCode, blosumPtr);
+  CompiledAlphabetIndex2 compiledCodon(codonIndex);
+  nbErrors += check(codonIndex, compiledCodon);
+
+  // Alignment with the compiled scores:
+  Sequence seq1("seq1", "ACGTTGCAAGTC", dna);
+  Sequence seq2("seq2", "ACGTGCAAGTC", dna);
+  auto aln = SiteContainerTools::alignNW(seq1, seq2, dns, -5.);
+  nbErrors += aln->getNumberOfSites() != 12;
+  nbErrors += aln->sequence(1).toString().find('-') == string::npos;
+
+  if (nbErrors > 0)
+  {
+    cerr << nbErrors << " errors." << endl;
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
@@ -62,5 +62,21 @@ int main()
   cout << cvs.sequence("seq1").toString() << endl;
   cout << cvs.sequence("seq2").toString() << endl;
 
+  // Parallel execution must give the same results, with blocks of one site:
+  ExecutionContext parallel(4, 1);
+  auto sites2 = make_unique<VectorSiteContainer>(alpha);
+  auto seq3 = make_unique<Sequence>("seq1", "----AUGCCG---GCGU----UUU----G--G-CCGACGUGUUUU--", alpha);
+  auto seq4 = make_unique<Sequence>("seq2", "---GAAGGCG---G-GU----UUU----GC-GACCGACG--UUUU--", alpha);
+  sites2->addSequence(seq3->getName(), seq3);
+  sites2->addSequence(seq4->getName(), seq4);
+  SiteContainerTools::removeGapOnlySites(*sites2, parallel);
+  SiteContainerTools::removeGapSites(*sites2, 0., parallel);
+  if (sites2->sequence("seq1").toString() != sites->sequence("seq1").toString()
+      || sites2->sequence("seq2").toString() != sites->sequence("seq2").toString())
+    throw Exception("Parallel removal of gap sites differs from the sequential one");
+  auto consensus = SiteContainerTools::getConsensus(*sites);
+  if (SiteContainerTools::getConsensus(*sites, "consensus", true, false, parallel)->toString() != consensus->toString())
+    throw Exception("Parallel consensus differs from the sequential one");
+
   return sites->getNumberOfSites() == 24 ? 0 : 1;
 }
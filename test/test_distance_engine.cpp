@@ -0,0 +1,185 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/Container/CompressedVectorSiteContainer.h>
+#include <Bpp/Seq/Container/VectorSiteContainer.h>
+#include <Bpp/Seq/DistanceEngine.h>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+using namespace bpp;
+using namespace std;
+
+// Straightforward distance between two DNA strings, with pairwise deletion.
+double naiveDistance(const string& s1, const string& s2, DistanceEngine::Method method, const vector<double>& pi)
+{
+  double l = 0, diff = 0, p1 = 0, p2 = 0;
+  for (size_t k = 0; k < s1.size(); ++k)
+  {
+    char a = s1[k], b = s2[k];
+    if (string("ACGT").find(a) == string::npos || string("ACGT").find(b) == string::npos)
+      continue;
+    l++;
+    if (a == b)
+      continue;
+    diff++;
+    if ((a == 'A' && b == 'G') || (a == 'G' && b == 'A'))
+      p1++;
+    if ((a == 'C' && b == 'T') || (a == 'T' && b == 'C'))
+      p2++;
+  }
+  double p = diff / l;
+  double q = (diff - p1 - p2) / l;
+  p1 /= l;
+  p2 /= l;
+  switch (method)
+  {
+  case DistanceEngine::P_DISTANCE:
+    return p;
+  case DistanceEngine::JC69:
+    return -0.75 * log(1. - 4. / 3. * p);
+  case DistanceEngine::K80:
+    return -0.5 * log(1. - 2. * (p1 + p2) - q) - 0.25 * log(1. - 2. * q);
+  default:
+  {
+    double piR = pi[0] + pi[2], piY = pi[1] + pi[3];
+    double k1 = 2. * pi[0] * pi[2] / piR;
+    double k2 = 2. * pi[1] * pi[3] / piY;
+    double k3 = 2. * (piR * piY - pi[0] * pi[2] * piY / piR - pi[1] * pi[3] * piR / piY);
+    return -k1 * log(1. - p1 / k1 - q / (2. * piR))
+           - k2 * log(1. - p2 / k2 - q / (2. * piY))
+           - k3 * log(1. - q / (2. * piR * piY));
+  }
+  }
+}
+
+int main()
+{
+  shared_ptr<const Alphabet> alpha = AlphabetTools::DNA_ALPHABET;
+  mt19937 rng(42);
+  string root;
+  for (size_t k = 0; k < 150; ++k)
+  {
+    root += "ACGT"[rng() % 4];
+  }
+  // Repeat the root so that compressed sites have weights larger than 1:
+  root += root.substr(0, 100);
+  vector<string> data;
+  for (size_t i = 0; i < 11; ++i)
+  {
+    string s = root;
+    for (size_t k = 0; k < s.size(); ++k)
+    {
+      unsigned int r = rng() % 100;
+      if (r < 2 * i)
+        s[k] = "ACGT"[rng() % 4];
+      else if (r == 99)
+        s[k] = (rng() % 2) ? '-' : 'N';
+    }
+    data.push_back(s);
+  }
+  VectorSiteContainer sites(alpha);
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    auto seq = make_unique<Sequence>("seq" + to_string(i), data[i], alpha);
+    sites.addSequence(seq->getName(), seq);
+  }
+  CompressedVectorSiteContainer compressed(sites);
+  size_t n = data.size();
+
+  size_t nbErrors = 0;
+  ExecutionContext sequential(1);
+  ExecutionContext parallel(4, 1);
+  DistanceEngine engine;
+  engine.setTileSize(3);
+  vector<double> pi = engine.getStateFrequencies(sites);
+  for (auto method : {DistanceEngine::P_DISTANCE, DistanceEngine::JC69, DistanceEngine::K80, DistanceEngine::TN93, DistanceEngine::LOGDET})
+  {
+    engine.setMethod(method);
+    auto dist = engine.computeDistances(sites, DistanceMatrix::FULL, sequential);
+    auto distParallel = engine.computeDistances(sites, DistanceMatrix::LOWER_TRIANGLE, parallel);
+    auto distCompressed = engine.computeDistances(compressed, DistanceMatrix::FULL, parallel);
+    for (size_t i = 0; i < n; ++i)
+    {
+      nbErrors += dist->get(i, i) != 0;
+      for (size_t j = 0; j < i; ++j)
+      {
+        double d = dist->get(i, j);
+        nbErrors += !std::isfinite(d) || d <= 0;
+        nbErrors += d != dist->get(j, i) || d != distParallel->get(i, j);
+        nbErrors += abs(d - distCompressed->get(i, j)) > 1e-12;
+        if (method != DistanceEngine::LOGDET)
+          nbErrors += abs(d - naiveDistance(data[i], data[j], method, pi)) > 1e-12;
+      }
+    }
+  }
+
+  // LogDet on identical sequences is 0:
+  engine.setMethod(DistanceEngine::LOGDET);
+  nbErrors += abs(engine.computeDistance(engine.getCountMatrix(sites, 0, 0), pi)) > 1e-12;
+
+  // LogDet ignores states present in only one of the two sequences (T in seq1):
+  VectorSiteContainer withT(alpha);
+  VectorSiteContainer withoutT(alpha);
+  for (auto p : { make_pair("AACCGGACGAGCAGT", "AACGGCACGACCAAA"), make_pair("AACCGGACGAGCAG", "AACGGCACGACCAA") })
+  {
+    VectorSiteContainer& target = string(p.first).size() == 15 ? withT : withoutT;
+    auto seq1 = make_unique<Sequence>("seq1", p.first, alpha);
+    auto seq2 = make_unique<Sequence>("seq2", p.second, alpha);
+    target.addSequence("seq1", seq1);
+    target.addSequence("seq2", seq2);
+  }
+  double logDetT = engine.computeDistances(withT)->get(1, 0);
+  double logDetNoT = engine.computeDistances(withoutT)->get(1, 0);
+  nbErrors += !std::isfinite(logDetT) || logDetT <= 0 || abs(logDetT - logDetNoT) > 1e-12;
+
+  // Count matrices are computed from the cached encoding of the last alignment:
+  RowMatrix<double> pairwise01 = engine.getCountMatrix(sites, 0, 1);
+  nbErrors += engine.getCountMatrix(withT, 0, 1)(3, 0) != 1.;
+  nbErrors += engine.getCountMatrix(sites, 0, 1)(0, 0) != pairwise01(0, 0);
+  auto site = make_unique<Site>(vector<int>{ 2, 0 }, alpha);
+  withT.setSite(14, site, false);
+  engine.clearCache();
+  nbErrors += engine.getCountMatrix(withT, 0, 1)(3, 0) != 0. || engine.getCountMatrix(withT, 0, 1)(2, 0) != 2.;
+
+  // Complete deletion compares the same sites for all pairs:
+  engine.setMethod(DistanceEngine::P_DISTANCE);
+  engine.setGapTreatment(DistanceEngine::COMPLETE_DELETION);
+  RowMatrix<double> counts01 = engine.getCountMatrix(sites, 0, 1);
+  RowMatrix<double> counts23 = engine.getCountMatrix(compressed, 2, 3);
+  double total01 = 0, total23 = 0, pairwiseTotal01 = 0;
+  for (size_t a = 0; a < 4; ++a)
+  {
+    for (size_t b = 0; b < 4; ++b)
+    {
+      total01 += counts01(a, b);
+      total23 += counts23(a, b);
+      pairwiseTotal01 += pairwise01(a, b);
+    }
+  }
+  nbErrors += total01 != total23 || total01 == 0 || total01 >= pairwiseTotal01;
+
+  // K80 is not available for proteins:
+  shared_ptr<const Alphabet> protein = AlphabetTools::PROTEIN_ALPHABET;
+  VectorSiteContainer proteins(protein);
+  auto seq = make_unique<Sequence>("prot", "ACDEF", protein);
+  proteins.addSequence(seq->getName(), seq);
+  engine.setMethod(DistanceEngine::K80);
+  try
+  {
+    engine.computeDistances(proteins);
+    nbErrors++;
+  }
+  catch (AlphabetException& e) {}
+
+  if (nbErrors > 0)
+  {
+    cerr << nbErrors << " errors." << endl;
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
@@ -0,0 +1,217 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/DistanceMatrix.h>
+#include <Bpp/Seq/Io/DistanceMatrixFile.h>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace bpp;
+using namespace std;
+
+// Map a corrupted copy of a file, which must be rejected.
+static size_t checkCorrupted(const string& content)
+{
+  {
+    ofstream file("distances_bad.bin", ios::out | ios::binary);
+    file.write(content.data(), static_cast<streamsize>(content.size()));
+  }
+  try
+  {
+    DistanceMatrixFile::map("distances_bad.bin");
+    cerr << "Corrupted file accepted." << endl;
+    return 1;
+  }
+  catch (IOException& e) {}
+  return 0;
+}
+
+static string withDimension(string content, uint64_t n)
+{
+  memcpy(&content[16], &n, 8);
+  return content;
+}
+
+int main()
+{
+  size_t n = 7;
+  vector<string> names;
+  for (size_t i = 0; i < n; ++i)
+  {
+    names.push_back("t" + to_string(i));
+  }
+
+  DistanceMatrix full(names);
+  DistanceMatrix lower(names, DistanceMatrix::LOWER_TRIANGLE);
+  DistanceMatrix lowerFloat(names, DistanceMatrix::LOWER_TRIANGLE_FLOAT);
+  for (size_t i = 0; i < n; ++i)
+  {
+    for (size_t j = 0; j < i; ++j)
+    {
+      double d = 0.1 * static_cast<double>(i * n + j);
+      full(i, j) = full(j, i) = d;
+      lower(i, j) = d;
+      lowerFloat.set(j, i, d);
+    }
+  }
+
+  const DistanceMatrix& constLower = lower;
+  size_t nbErrors = 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    vector<double> row = lower.getRow(i);
+    vector<double> rowFloat = lowerFloat.getRow(i);
+    for (size_t j = 0; j < n; ++j)
+    {
+      nbErrors += lower(i, j) != full(i, j) || lower(j, i) != full(i, j);
+      nbErrors += row[j] != full(i, j);
+      nbErrors += abs(rowFloat[j] - full(i, j)) > 1e-5;
+      nbErrors += constLower.asMatrix()(i, j) != full.asMatrix()(i, j);
+    }
+  }
+  nbErrors += lower("t5", "t2") != full(5, 2);
+  nbErrors += lowerFloat.getNameIndex("t6") != 6;
+
+  // Lazy full matrix is updated after changes, and names are reindexed:
+  lower.set(3, 1, 42.);
+  nbErrors += constLower.asMatrix()(1, 3) != 42.;
+  lower.setName(4, "renamed");
+  nbErrors += lower.getNameIndex("renamed") != 4;
+  try
+  {
+    lower.getNameIndex("t4");
+    nbErrors++;
+  }
+  catch (Exception& e) {}
+  nbErrors += lower.getStorage() != DistanceMatrix::LOWER_TRIANGLE;
+
+  // Conversions:
+  DistanceMatrix copy(full);
+  copy.setStorage(DistanceMatrix::LOWER_TRIANGLE_FLOAT);
+  copy.setStorage(DistanceMatrix::FULL);
+  nbErrors += abs(copy(6, 5) - full(5, 6)) > 1e-5;
+
+  // Reading through a non-const matrix does not modify it, whatever the storage:
+  const Matrix<double>& cached = static_cast<const DistanceMatrix&>(lowerFloat).asMatrix();
+  double d = lowerFloat(4, 2);
+  nbErrors += abs(d - full(4, 2)) > 1e-5 || abs(lowerFloat("t2", "t4") - d) > 1e-5;
+  nbErrors += lowerFloat.getStorage() != DistanceMatrix::LOWER_TRIANGLE_FLOAT;
+  lowerFloat(0, 1) = 3.;
+  lowerFloat("t5", "t6") += 1.;
+  nbErrors += lowerFloat(1, 0) != 3. || abs(lowerFloat(6, 5) - full(6, 5) - 1.) > 1e-5;
+  nbErrors += &static_cast<const DistanceMatrix&>(lowerFloat).asMatrix() != &cached || cached(1, 0) != 3.;
+
+  // The storage is only converted on demand:
+  try
+  {
+    lowerFloat.asMatrix();
+    nbErrors++;
+  }
+  catch (Exception& e) {}
+  nbErrors += lowerFloat.getStorage() != DistanceMatrix::LOWER_TRIANGLE_FLOAT;
+  lowerFloat.setStorage(DistanceMatrix::FULL);
+  lowerFloat.asMatrix()(0, 1) = 4.;
+  nbErrors += lowerFloat(0, 1) != 4. || lowerFloat(1, 0) != 3.;
+
+  // Binary files, mapped or read, in both precisions:
+  full(2, 2) = 1.;
+  DistanceMatrixFile::write(full, "distances.bin");
+  DistanceMatrixFile::write(full, "distances_float.bin", true);
+  auto mapped = DistanceMatrixFile::map("distances.bin");
+  auto mappedFloat = DistanceMatrixFile::map("distances_float.bin");
+  auto loaded = DistanceMatrixFile::read("distances_float.bin");
+  nbErrors += !mapped->isReadOnly() || loaded->isReadOnly();
+  nbErrors += mappedFloat->getStorage() != DistanceMatrix::LOWER_TRIANGLE_FLOAT;
+  nbErrors += mapped->getNames() != full.getNames();
+  for (size_t i = 0; i < n; ++i)
+  {
+    for (size_t j = 0; j < n; ++j)
+    {
+      nbErrors += (*mapped)(i, j) != full(i, j);
+      nbErrors += abs((*mappedFloat)(i, j) - full(i, j)) > 1e-5;
+      nbErrors += abs(loaded->get(i, j) - full(i, j)) > 1e-5;
+    }
+  }
+  DistanceMatrix mappedCopy(*mapped);
+  mapped.reset();
+  try
+  {
+    mappedCopy.set(1, 0, 2.);
+    nbErrors++;
+  }
+  catch (Exception& e) {}
+  nbErrors += mappedCopy.get(6, 3) != full(6, 3); // The copy keeps the file mapped.
+
+  // Tiles, written in any order:
+  {
+    DistanceMatrixFileWriter writer("distances_tiles.bin", names);
+    for (size_t iBegin = 0; iBegin < n; iBegin += 3)
+    {
+      for (size_t jBegin = n - n % 3; jBegin + 3 > 0; jBegin -= 3)
+      {
+        RowMatrix<double> tile(min<size_t>(3, n - iBegin), min<size_t>(3, n - jBegin));
+        for (size_t k = 0; k < tile.getNumberOfRows(); ++k)
+        {
+          for (size_t l = 0; l < tile.getNumberOfColumns(); ++l)
+          {
+            tile(k, l) = full(iBegin + k, jBegin + l);
+          }
+        }
+        writer.writeTile(iBegin, jBegin, tile);
+        if (jBegin == 0)
+          break;
+      }
+    }
+    writer.close();
+    double value = 1.;
+    try
+    {
+      writer.writeRow(1, 0, &value, 1);
+      nbErrors++;
+    }
+    catch (IOException& e) {}
+    try
+    {
+      writer.writeTile(0, 0, RowMatrix<double>(1, 1));
+      nbErrors++;
+    }
+    catch (IOException& e) {}
+  }
+  auto tiled = DistanceMatrixFile::map("distances_tiles.bin");
+  for (size_t i = 0; i < n; ++i)
+  {
+    for (size_t j = 0; j < n; ++j)
+    {
+      nbErrors += (*tiled)(i, j) != full(i, j);
+    }
+  }
+
+  // Headers are checked against the size of the file before allocating names:
+  string content;
+  {
+    ifstream file("distances.bin", ios::in | ios::binary);
+    ostringstream buffer;
+    buffer << file.rdbuf();
+    content = buffer.str();
+  }
+  nbErrors += checkCorrupted(withDimension(content, n + 1));
+  nbErrors += checkCorrupted(withDimension(content, n - 1));
+  nbErrors += checkCorrupted(withDimension(content, static_cast<uint64_t>(1) << 32));
+  nbErrors += checkCorrupted(withDimension(content, static_cast<uint64_t>(-1)));
+  nbErrors += checkCorrupted(content.substr(0, content.size() - 8));
+  nbErrors += checkCorrupted(content + string(8, '\0'));
+  remove("distances_bad.bin");
+
+  remove("distances.bin");
+  remove("distances_float.bin");
+  remove("distances_tiles.bin");
+
+  cout << "Errors: " << nbErrors << endl;
+  return nbErrors == 0 ? 0 : 1;
+}
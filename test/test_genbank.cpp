@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/Container/VectorSequenceContainer.h>
+#include <Bpp/Seq/Io/GenBank.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  size_t nbErrors = 0;
+  shared_ptr<const Alphabet> dna = AlphabetTools::DNA_ALPHABET;
+  const string seq1 = "ATGAAACCGCTGGCGGCGTGGTAA";
+  const string seq2 = "ACGTACGTTGCA";
+  GenBank genbank;
+
+  // Whole file:
+  VectorSequenceContainer sequences(dna);
+  genbank.readSequences("example.gb", sequences);
+  nbErrors += sequences.getNumberOfSequences() != 2;
+  nbErrors += sequences.sequence("TEST0001").toString() != seq1;
+  nbErrors += sequences.sequence("TEST0002").toString() != seq2;
+
+  // Sequence stream, giving the same sequences:
+  {
+    ifstream input("example.gb");
+    Sequence seq(dna);
+    size_t n = 0;
+    while (genbank.nextSequence(input, seq))
+    {
+      nbErrors += n >= 2 || seq.toString() != sequences.sequence(n).toString();
+      nbErrors += n >= 2 || seq.getName() != sequences.sequence(n).getName();
+      ++n;
+    }
+    nbErrors += n != 2;
+  }
+
+  // Records and features:
+  {
+    ifstream input("example.gb");
+    Sequence seq(dna);
+    GenBank::Record record;
+    nbErrors += !genbank.nextRecord(input, seq, record);
+    nbErrors += seq.getName() != "TEST0001" || seq.toString() != seq1;
+    nbErrors += record.getAccession() != "TEST0001";
+    nbErrors += record.getLength() != 24;
+    nbErrors += record.getDefinition() != "Synthetic test sequence, with a definition split over two lines.";
+    nbErrors += record.getLocus().compare(0, 8, "TEST0001") != 0;
+    nbErrors += !record.hasFeatures();
+
+    // The raw features can be read back from the stream:
+    auto range = record.getFeaturesRange();
+    ifstream raw("example.gb");
+    raw.seekg(range.first);
+    string text(static_cast<size_t>(range.second - range.first), ' ');
+    raw.read(&text[0], static_cast<streamsize>(text.size()));
+    nbErrors += text != record.getRawFeatures();
+
+    auto features = record.parseFeatures();
+    nbErrors += features.size() != 3;
+    if (features.size() == 3)
+    {
+      nbErrors += features[0].key != "source" || features[0].location != "1..24";
+      nbErrors += features[0].qualifiers.size() != 2;
+      nbErrors += features[0].qualifiers.size() != 2 || features[0].qualifiers[0].second != "synthetic construct";
+      nbErrors += features[1].key != "CDS" || features[1].location != "join(1..9,13..24)";
+      nbErrors += features[1].qualifiers.size() != 3;
+      if (features[1].qualifiers.size() == 3)
+      {
+        nbErrors += features[1].qualifiers[0] != make_pair(string("gene"), string("tst"));
+        nbErrors += features[1].qualifiers[1].second != "a note split over two lines";
+        nbErrors += features[1].qualifiers[2].second != "MKPLAAAW";
+      }
+      nbErrors += features[2].key != "misc_feature" || features[2].qualifiers.size() != 1;
+      nbErrors += features[2].qualifiers.size() != 1 || features[2].qualifiers[0].first != "pseudo" || !features[2].qualifiers[0].second.empty();
+    }
+
+    nbErrors += !genbank.nextRecord(input, seq, record);
+    nbErrors += seq.getName() != "TEST0002" || seq.toString() != seq2;
+    nbErrors += record.hasFeatures() || record.getLength() != 12;
+    nbErrors += genbank.nextRecord(input, seq, record);
+  }
+
+  // Codons, the sequence length is given in nucleotides:
+  {
+    shared_ptr<const Alphabet> codons = AlphabetTools::DNA_CODON_ALPHABET;
+    ifstream input("example.gb");
+    Sequence first(dna);
+    nbErrors += !genbank.nextSequence(input, first);
+    Sequence seq(codons);
+    nbErrors += !genbank.nextSequence(input, seq);
+    nbErrors += seq.size() != 4 || seq.toString() != seq2;
+  }
+
+  // Index:
+  {
+    GenBank::FileIndex index;
+    index.build("example.gb");
+    nbErrors += index.getNumberOfSequences() != 2;
+    nbErrors += index.getEntry("TEST0002").sequenceLength != 12;
+    Sequence seq(dna);
+    index.getSequence("TEST0002", seq, "example.gb");
+    nbErrors += seq.getName() != "TEST0002" || seq.toString() != seq2;
+  }
+
+  // Invalid records:
+  {
+    istringstream input("LOCUS       X 4 bp\nORIGIN\n        1 acgt\n//\n");
+    Sequence seq(dna);
+    bool thrown = false;
+    try
+    {
+      genbank.nextSequence(input, seq);
+    }
+    catch (Exception& e)
+    {
+      thrown = true;
+    }
+    nbErrors += !thrown; // No accession number.
+  }
+
+  if (nbErrors > 0)
+  {
+    cerr << nbErrors << " errors." << endl;
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
@@ -4,10 +4,18 @@
 
 #include <Bpp/Seq/Alphabet/AlphabetTools.h>
 #include <Bpp/Seq/Io/Fasta.h>
+#include <Bpp/Seq/Io/IngestPolicy.h>
 #include <Bpp/Seq/Io/Mase.h>
 #include <Bpp/Seq/Io/Clustal.h>
+#include <Bpp/Seq/Container/SiteContainerView.h>
+#include <Bpp/Seq/Io/IoSequenceFactory.h>
+#include <Bpp/Seq/Io/NexusIoSequence.h>
 #include <Bpp/Seq/Io/Phylip.h>
+#include <Bpp/Seq/Io/SiteWindowReader.h>
+#include <Bpp/Seq/Io/Stockholm.h>
+#include <cstdio>
 #include <iostream>
+#include <sstream>
 
 using namespace bpp;
 using namespace std;
@@ -34,22 +42,127 @@ int main()
   auto sites4 = phylip.readAlignment("example.ph", alpha);
   Phylip phylip3(true, true);
   auto sites5 = phylip3.readAlignment("example.ph3", alpha);
+  // Stockholm is tested by writing and reading back:
+  Stockholm stockholm;
+  stringstream buffer;
+  stockholm.writeAlignment(buffer, *sites1);
+  auto sites6 = stockholm.readAlignment(buffer, alpha);
 
   cout << "Fasta:    " << sites1->getNumberOfSequences() << "\t" << sites1->getNumberOfSites() << endl;
   cout << "Mase:     " << sites2->getNumberOfSequences() << "\t" << sites2->getNumberOfSites() << endl;
   cout << "Clustal:  " << sites3->getNumberOfSequences() << "\t" << sites3->getNumberOfSites() << endl;
   cout << "Phylip:   " << sites4->getNumberOfSequences() << "\t" << sites4->getNumberOfSites() << endl;
   cout << "Phylip 3: " << sites5->getNumberOfSequences() << "\t" << sites5->getNumberOfSites() << endl;
+  cout << "Stockholm:" << sites6->getNumberOfSequences() << "\t" << sites6->getNumberOfSites() << endl;
 
   // Test:
   bool test = sites1->getNumberOfSequences() == sites2->getNumberOfSequences()
       && sites1->getNumberOfSequences() == sites3->getNumberOfSequences()
       && sites1->getNumberOfSequences() == sites4->getNumberOfSequences()
       && sites1->getNumberOfSequences() == sites5->getNumberOfSequences()
+      && sites1->getNumberOfSequences() == sites6->getNumberOfSequences()
       && sites1->getNumberOfSites()     == sites2->getNumberOfSites()
       && sites1->getNumberOfSites()     == sites3->getNumberOfSites()
       && sites1->getNumberOfSites()     == sites4->getNumberOfSites()
-      && sites1->getNumberOfSites()     == sites5->getNumberOfSites();
+      && sites1->getNumberOfSites()     == sites5->getNumberOfSites()
+      && sites1->getNumberOfSites()     == sites6->getNumberOfSites()
+      && sites1->sequence(0).getContent() == sites3->sequence(0).getContent()
+      && sites1->sequence(0).getContent() == sites4->sequence(0).getContent()
+      && sites1->sequence(0).getContent() == sites6->sequence(0).getContent();
+
+  // Windowed reading:
+  for (auto format : { IoSequenceFactory::FASTA_FORMAT, IoSequenceFactory::PAML_FORMAT_SEQUENTIAL })
+  {
+    SiteWindowReader reader(format == IoSequenceFactory::FASTA_FORMAT ? "example.fasta" : "example.ph3", format, alpha, 500);
+    size_t nbSites = 0;
+    while (reader.hasMoreWindows())
+    {
+      auto window = reader.nextWindow();
+      for (size_t i = 0; i < window->getNumberOfSites(); ++i)
+      {
+        test = test && window->site(i).getContent() == sites1->site(nbSites + i).getContent();
+      }
+      nbSites += window->getNumberOfSites();
+    }
+    cout << "Windows (" << format << "): " << reader.getNumberOfSequences() << "\t" << nbSites << endl;
+    test = test && reader.getNumberOfSequences() == sites1->getNumberOfSequences() && nbSites == sites1->getNumberOfSites();
+  }
+
+  // File index, in memory and saved:
+  Phylip::FileIndex index;
+  index.build("example.ph3");
+  index.write("example.ph3.idx");
+  Phylip::FileIndex savedIndex;
+  savedIndex.open("example.ph3.idx");
+  test = test && index.getNumberOfSequences() == sites5->getNumberOfSequences()
+      && savedIndex.getNumberOfSequences() == sites5->getNumberOfSequences();
+  for (size_t i = 0; i < sites5->getNumberOfSequences(); ++i)
+  {
+    const string& name = sites5->sequence(i).getName();
+    test = test && savedIndex.hasSequence(name)
+        && savedIndex.getSequencePosition(name) == index.getSequencePosition(name)
+        && savedIndex.getEntry(name).sequenceLength == sites5->getNumberOfSites();
+    Sequence indexed(alpha);
+    savedIndex.getSequence(name, indexed, "example.ph3");
+    test = test && indexed.getName() == name && indexed.toString() == sites5->sequence(i).toString();
+  }
+  test = test && !savedIndex.hasSequence("not a sequence");
+  cout << "Index:    " << savedIndex.getNumberOfSequences() << endl;
+  remove("example.ph3.idx");
+
+  // Nexus, with character sets:
+  stringstream nexusStream;
+  nexusStream << "#NEXUS" << endl << "BEGIN DATA;" << endl << "DIMENSIONS NTAX=2 NCHAR=8;" << endl;
+  nexusStream << "FORMAT DATATYPE=PROTEIN INTERLEAVE;" << endl << "MATRIX" << endl;
+  nexusStream << "s1 ACDE" << endl << "s2 ACD-" << endl << endl << "s1 FGHI" << endl << "s2 FGHK" << endl << ";" << endl << "END;" << endl;
+  nexusStream << "BEGIN SETS;" << endl << "CHARSET first = 1-4;" << endl << "CHARSET even = 2-.\\2;" << endl << "END;" << endl;
+  NexusIOSequence nexus;
+  VectorSiteContainer nexusSites(alpha);
+  vector<NexusIOSequence::CharacterSet> charSets;
+  nexus.appendAlignmentFromStream(nexusStream, nexusSites, charSets);
+  SiteContainerView evenSites(nexusSites, charSets[1].getPositions());
+  test = test && nexusSites.getNumberOfSites() == 8 && nexusSites.sequence(1).toString() == "ACD-FGHK"
+      && charSets.size() == 2 && charSets[0].getPositions().size() == 4
+      && evenSites.getNumberOfSites() == 4 && evenSites.site(3).toString() == "IK";
+  cout << "Nexus:    " << nexusSites.getNumberOfSequences() << "\t" << nexusSites.getNumberOfSites() << endl;
+
+  // Permissive reading, with invalid characters reported:
+  auto report = make_shared<IngestReport>();
+  Fasta messyFasta;
+  messyFasta.setIngestPolicy(IngestPolicy(SymbolEncoder::REPLACE_BY_UNKNOWN, report));
+  stringstream messyStream;
+  messyStream << ">s1" << endl << "ACGT" << endl << ">s2" << endl << "AC#T" << endl << "JAB*" << endl;
+  auto messySequences = messyFasta.readSequences(messyStream, AlphabetTools::DNA_ALPHABET);
+  test = test && messySequences->sequence(1).toString() == "ACNTNABN"
+      && report->getNumberOfSequences() == 1 && report->getSequenceName(0) == "s2"
+      && report->getNumberOfInvalidSymbols() == 3 && report->getInvalidSymbols(0)[1].position == 4;
+  cout << "Ingest:   " << report->getNumberOfInvalidSymbols() << " invalid symbols" << endl;
+
+  // Format detection:
+  IoSequenceFactory factory;
+  test = test && factory.detectFormat("example.fasta").format == IoSequenceFactory::FASTA_FORMAT
+      && factory.detectFormat("example.mase").format == IoSequenceFactory::MASE_FORMAT
+      && factory.detectFormat("example.aln").format == IoSequenceFactory::CLUSTAL_FORMAT
+      && factory.detectFormat("example.ph").format == IoSequenceFactory::PAML_FORMAT_INTERLEAVED
+      && factory.detectFormat("example.ph3").format == IoSequenceFactory::PAML_FORMAT_SEQUENTIAL
+      && factory.detectFormat("example.fastq").format == IoSequenceFactory::FASTQ_FORMAT
+      && factory.detectFormat("example.fasta").alphabetType == "Protein"
+      && factory.detectFormat("example.fastq").alphabetType == "DNA";
+
+  // Phylip layouts, where the name column alone is misleading:
+  auto detectPhylip = [&factory](const string& text) {
+    stringstream input(text);
+    return factory.detectFormat(input).format;
+  };
+  test = test && detectPhylip("2 8\nabcdefghijACGTACGT\nklmnopqrstACGTTCGT\n") == IoSequenceFactory::PHYLIP_FORMAT_SEQUENTIAL
+      && detectPhylip("2 8\na  b      ACGTACGT\nc  d      ACGTTCGT\n") == IoSequenceFactory::PHYLIP_FORMAT_SEQUENTIAL
+      && detectPhylip("2 8\nabcdefghijACGT\nklmnopqrstACGA\n\nACGT\nACGA\n") == IoSequenceFactory::PHYLIP_FORMAT_INTERLEAVED
+      && detectPhylip("2 8\nlong_name_one  ACGTACGT\nlong_name_two  ACGTTCGT\n") == IoSequenceFactory::PAML_FORMAT_SEQUENTIAL
+      && detectPhylip("2 4\nabcdefghij  ACGT\nklmnopqrst  ACGA\n") == IoSequenceFactory::PAML_FORMAT_SEQUENTIAL
+      && detectPhylip("2 8\ns1  ACGT\ns2  ACGA\n\nACGT\nACGA\n") == IoSequenceFactory::PAML_FORMAT_INTERLEAVED
+      && detectPhylip("2 8\ns1  ACGT\nACGT\ns2  ACGT\nACGA\n") == IoSequenceFactory::PAML_FORMAT_SEQUENTIAL
+      && detectPhylip("2 8\ns1  ACGTACGTAA\ns2  ACGTACGTAA\n") == ""
+      && detectPhylip("2 8\nshort\nlines\n") == "";
 
   cout << (test ? "Succeeded." : "Failed.") << endl;
   return test ? 0 : 1;
@@ -0,0 +1,174 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/ExecutionContext.h>
+#include <Bpp/Seq/Io/NumberScanner.h>
+#include <Bpp/Seq/Io/Pasta.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace bpp;
+using namespace std;
+
+// Scan a single number, check that it is accepted or not, and compare it to strtod.
+static size_t checkScan(const string& token, bool valid)
+{
+  const char* p = token.data();
+  const char* end = p + token.size();
+  double value = 0;
+  bool ok = NumberScanner::scanDouble(p, end, value);
+  if (ok != valid)
+  {
+    cerr << "Number '" << token << "' should be " << (valid ? "valid." : "invalid.") << endl;
+    return 1;
+  }
+  if (!ok)
+    return 0;
+  string number = token.substr(0, token.find_first_of(" \t\n"));
+  double expected = strtod(number.c_str(), nullptr);
+  if (p != token.data() + number.size() || (value != expected && !(std::isnan(value) && std::isnan(expected))))
+  {
+    cerr << "Number '" << token << "' read as " << value << " instead of " << expected << "." << endl;
+    return 1;
+  }
+  return 0;
+}
+
+static string getError(const Pasta& pasta, const string& text, shared_ptr<const Alphabet> alphabet)
+{
+  istringstream input(text);
+  try
+  {
+    pasta.readAlignment(input, alphabet);
+  }
+  catch (exception& e)
+  {
+    return e.what();
+  }
+  return "";
+}
+
+int main()
+{
+  size_t nbErrors = 0;
+
+  // Number scanner:
+  nbErrors += checkScan("0", true);
+  nbErrors += checkScan("0.25", true);
+  nbErrors += checkScan("-0.5", true);
+  nbErrors += checkScan("+3.75", true);
+  nbErrors += checkScan("1.", true);
+  nbErrors += checkScan(".5", true);
+  nbErrors += checkScan("000123.4500", true);
+  nbErrors += checkScan("1e3", true);
+  nbErrors += checkScan("1E-3", true);
+  nbErrors += checkScan("-2.5e+2", true);
+  nbErrors += checkScan("0.1", true);
+  nbErrors += checkScan("0.123456789012345678901234", true); // More than 19 digits.
+  nbErrors += checkScan("123456789012345678901234567890", true);
+  nbErrors += checkScan("1e300", true);                       // Exponent out of the exact range.
+  nbErrors += checkScan("4.9e-324", true);
+  nbErrors += checkScan("inf", true);
+  nbErrors += checkScan("nan", true);
+  nbErrors += checkScan("0.75 0.25", true);
+  nbErrors += checkScan("0.75\t", true);
+  nbErrors += checkScan("", false);
+  nbErrors += checkScan("-", false);
+  nbErrors += checkScan(".", false);
+  nbErrors += checkScan("e5", false);
+  nbErrors += checkScan("1e", false);
+  nbErrors += checkScan("1e+", false);
+  nbErrors += checkScan("1.5.2", false);
+  nbErrors += checkScan("0x10", false);
+  nbErrors += checkScan("12abc", false);
+  nbErrors += checkScan("--1", false);
+
+  // Parsing with 1 or several threads gives the same alignment:
+  shared_ptr<const Alphabet> dna = AlphabetTools::DNA_ALPHABET;
+  ostringstream text;
+  text << "A C G T" << endl;
+  unsigned int seed = 1;
+  for (size_t i = 0; i < 100; ++i)
+  {
+    text << ">seq" << i << endl;
+    for (size_t j = 0; j < 50; ++j)
+    {
+      seed = seed * 1103515245 + 12345;
+      double a = static_cast<double>(seed % 1000) / 4000.;
+      text << a << " " << 0.25 << " " << 1.5e-1 << " " << 0.6 - a << endl;
+    }
+  }
+
+  Pasta pasta;
+  auto sequential = make_shared<ExecutionContext>(1);
+  auto parallel = make_shared<ExecutionContext>(4);
+  pasta.setExecutionContext(sequential);
+  istringstream input1(text.str());
+  auto sites1 = pasta.readAlignment(input1, dna);
+  pasta.setExecutionContext(parallel);
+  istringstream input2(text.str());
+  auto sites2 = pasta.readAlignment(input2, dna);
+
+  nbErrors += sites1->getNumberOfSequences() != 100 || sites2->getNumberOfSequences() != 100;
+  nbErrors += sites1->getNumberOfSites() != 50 || sites2->getNumberOfSites() != 50;
+  for (size_t i = 0; i < sites1->getNumberOfSequences(); ++i)
+  {
+    nbErrors += sites1->sequence(i).getName() != "seq" + to_string(i);
+    nbErrors += sites2->sequence(i).getName() != sites1->sequence(i).getName();
+    for (size_t j = 0; j < sites1->getNumberOfSites(); ++j)
+    {
+      for (int state = 0; state < 4; ++state)
+      {
+        nbErrors += sites1->sequence(i).getStateValueAt(j, state) != sites2->sequence(i).getStateValueAt(j, state);
+      }
+    }
+  }
+
+  // Records retrieved from a file index:
+  {
+    ofstream file("pasta_test.pa");
+    file << text.str();
+  }
+  Pasta::FileIndex index;
+  index.build("pasta_test.pa");
+  nbErrors += index.getNumberOfSequences() != 100;
+  for (size_t i : { 0, 42, 99 })
+  {
+    ProbabilisticSequence seq(dna);
+    index.getSequence("seq" + to_string(i), seq, "pasta_test.pa");
+    nbErrors += seq.getName() != "seq" + to_string(i) || seq.size() != 50;
+    for (size_t j = 0; j < seq.size() && j < 50; ++j)
+    {
+      for (int state = 0; state < 4; ++state)
+      {
+        nbErrors += seq.getStateValueAt(j, state) != sites1->sequence(i).getStateValueAt(j, state);
+      }
+    }
+  }
+  remove("pasta_test.pa");
+
+  // Malformed records: the error of the first one is reported, whatever the number of threads:
+  string malformed = text.str();
+  malformed.replace(malformed.find(">seq70\n") + 7, 4, "0.x1");
+  malformed.replace(malformed.find(">seq30\n") + 7, 4, "1e+ ");
+  pasta.setExecutionContext(sequential);
+  string error1 = getError(pasta, malformed, dna);
+  pasta.setExecutionContext(parallel);
+  string error2 = getError(pasta, malformed, dna);
+  nbErrors += error1.find("seq30") == string::npos;
+  nbErrors += error1 != error2;
+
+  if (nbErrors > 0)
+  {
+    cerr << nbErrors << " errors." << endl;
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/ExecutionContext.h>
+#include <Bpp/Seq/Io/PhredBatchReader.h>
+#include <Bpp/Seq/Io/PhredPoly.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+using namespace bpp;
+using namespace std;
+
+static const string BASES = "ACGT";
+
+static void writePhd(const string& path, const string& name, size_t length, const string& badQuality = "")
+{
+  ofstream file(path.c_str());
+  if (!name.empty())
+    file << "BEGIN_SEQUENCE " << name << endl;
+  file << "BEGIN_COMMENT" << endl << "CHROMAT_FILE: " << name << endl << "END_COMMENT" << endl;
+  file << "BEGIN_DNA" << endl;
+  for (size_t i = 0; i < length; ++i)
+  {
+    file << static_cast<char>(tolower(BASES[(i * 7 + length) % 4])) << " ";
+    if (i == 2 && !badQuality.empty())
+      file << badQuality;
+    else
+      file << (i * 13 + length) % 60;
+    file << " " << i * 10 << endl;
+  }
+  file << "END_DNA" << endl << "END_SEQUENCE" << endl;
+}
+
+static void writePoly(const string& path, const string& name, size_t length)
+{
+  ofstream file(path.c_str());
+  file << name << " 1.0 1.0 1.0 1.0" << endl;
+  for (size_t i = 0; i < length; ++i)
+  {
+    // The second peak is high enough for an ambiguous call every 5 positions:
+    double second = i % 5 == 0 ? 90. : 10.;
+    file << BASES[i % 4] << " " << i * 10 << " 100 100 " << BASES[(i + 1) % 4] << " " << i * 10 << " 100 " << second << " 1 2 3 4" << endl;
+  }
+}
+
+int main()
+{
+  size_t nbErrors = 0;
+  shared_ptr<const Alphabet> dna = AlphabetTools::DNA_ALPHABET;
+  PhredBatchReader reader;
+
+  // A batch of phd files, with a missing file, a bad quality score and a sequence without name:
+  vector<string> paths;
+  for (size_t i = 0; i < 40; ++i)
+  {
+    string path = "phred_batch_" + to_string(i) + ".phd.1";
+    paths.push_back(path);
+    if (i == 7)
+      continue;
+    else if (i == 12)
+      writePhd(path, "read12", 10, "x1");
+    else if (i == 25)
+      writePhd(path, "", 10);
+    else
+      writePhd(path, "read" + to_string(i), 5 + i);
+  }
+
+  ExecutionContext sequential(1);
+  ExecutionContext parallel(4);
+  vector<PhredBatchReader::Error> errors1, errors2, errors3;
+  auto reads1 = reader.readPhdFiles(paths, dna, errors1, sequential);
+  auto reads2 = reader.readPhdFiles(paths, dna, errors2, parallel);
+  auto records = reader.readPhdRecords(paths, errors3, parallel);
+
+  // Errors are reported in the order of the file list:
+  nbErrors += errors1.size() != 3;
+  if (errors1.size() == 3)
+  {
+    nbErrors += errors1[0].path != paths[7] || errors1[0].message.find("Can't open") == string::npos;
+    nbErrors += errors1[1].path != paths[12] || errors1[1].message.find("Invalid quality") == string::npos;
+    nbErrors += errors1[2].path != paths[25] || errors1[2].message.find("without name") == string::npos;
+  }
+  nbErrors += errors2.size() != errors1.size() || errors3.size() != errors1.size();
+  for (size_t i = 0; i < errors1.size() && i < errors2.size() && i < errors3.size(); ++i)
+  {
+    nbErrors += errors2[i].path != errors1[i].path || errors2[i].message != errors1[i].message;
+    nbErrors += errors3[i].path != errors1[i].path || errors3[i].message != errors1[i].message;
+  }
+
+  // Sequences are in the order of the file list, whatever the number of threads:
+  nbErrors += reads1->getNumberOfSequences() != 37 || reads2->getNumberOfSequences() != 37 || records.size() != 37;
+  size_t k = 0;
+  for (size_t i = 0; i < 40 && k < 37; ++i)
+  {
+    if (i == 7 || i == 12 || i == 25)
+      continue;
+    const SequenceWithQuality& read1 = reads1->sequence(k);
+    const SequenceWithQuality& read2 = reads2->sequence(k);
+    const PhredBatchReader::PhdRecord& record = records[k];
+    size_t length = 5 + i;
+    nbErrors += read1.getName() != "read" + to_string(i) || read1.size() != length;
+    nbErrors += read2.getName() != read1.getName() || read2.toString() != read1.toString();
+    nbErrors += record.name != read1.getName() || record.sequence != read1.toString() || record.quality.size() != length;
+    for (size_t j = 0; j < read1.size() && j < length; ++j)
+    {
+      int quality = static_cast<int>((j * 13 + length) % 60);
+      nbErrors += read1.getQuality(j) != quality || read2.getQuality(j) != quality;
+      nbErrors += record.quality[j] != quality;
+    }
+    ++k;
+  }
+
+  // Poly files:
+  vector<string> polyPaths;
+  for (size_t i = 0; i < 20; ++i)
+  {
+    string path = "phred_batch_" + to_string(i) + ".poly";
+    polyPaths.push_back(path);
+    writePoly(path, "poly" + to_string(i), 10 + i);
+  }
+  vector<PhredBatchReader::Error> polyErrors1, polyErrors2;
+  auto poly1 = reader.readPolyFiles(polyPaths, dna, polyErrors1, sequential);
+  auto poly2 = reader.readPolyFiles(polyPaths, dna, polyErrors2, parallel);
+  nbErrors += !polyErrors1.empty() || !polyErrors2.empty();
+  nbErrors += poly1->getNumberOfSequences() != 20 || poly2->getNumberOfSequences() != 20;
+  for (size_t i = 0; i < poly1->getNumberOfSequences() && i < poly2->getNumberOfSequences(); ++i)
+  {
+    nbErrors += poly1->sequence(i).getName() != "poly" + to_string(i) || poly1->sequence(i).size() != 10 + i;
+    nbErrors += poly2->sequence(i).toString() != poly1->sequence(i).toString();
+    // Same sequence as the single file reader:
+    Sequence expected(dna);
+    ifstream input(polyPaths[i].c_str());
+    PhredPoly().nextSequence(input, expected);
+    nbErrors += poly1->sequence(i).toString() != expected.toString();
+  }
+
+  for (const string& path : paths)
+  {
+    remove(path.c_str());
+  }
+  for (const string& path : polyPaths)
+  {
+    remove(path.c_str());
+  }
+
+  if (nbErrors > 0)
+  {
+    cerr << nbErrors << " errors." << endl;
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/App/SequenceApplicationTools.h>
+#include <Bpp/Seq/Container/SiteContainerTools.h>
+#include <Bpp/Seq/Io/Clustal.h>
+#include <Bpp/Seq/Io/Pasta.h>
+#include <Bpp/Seq/Profiler.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  size_t nbErrors = 0;
+  shared_ptr<const Alphabet> dna = AlphabetTools::DNA_ALPHABET;
+  string content = ">seq1\nACGT-ACGTNACGT\n>seq2\nACGTTACG-RACGA\n>seq3\nTCGTTACGTAACGA\n";
+  {
+    ofstream file("profiler_test.fasta");
+    file << content;
+  }
+  map<string, string> params;
+  params["input.sequence.file"] = "profiler_test.fasta";
+  params["input.sequence.format"] = "Fasta";
+
+  // Nothing is recorded when the profiler is disabled:
+  Profiler& profiler = Profiler::global();
+  auto sites = SequenceApplicationTools::getSiteContainer(dna, params, "", true, false);
+  nbErrors += !profiler.getTimers().empty() || !profiler.getCounters().empty();
+
+  profiler.setEnabled(true);
+  sites = SequenceApplicationTools::getSiteContainer(dna, params, "", true, false);
+  auto complete = SiteContainerTools::getCompleteSites(*sites);
+  {
+    ScopedTimer timer("test.timer");
+    profiler.count("test.counter", 2);
+    profiler.count("test.counter");
+  }
+  profiler.setEnabled(false);
+  profiler.count("test.counter");
+
+  auto timers = profiler.getTimers();
+  auto counters = profiler.getCounters();
+  nbErrors += timers["app.get_site_container"].calls != 1;
+  nbErrors += timers["app.process_alignment"].calls != 1;
+  nbErrors += timers["sites.select"].calls != 1;
+  nbErrors += timers["test.timer"].calls != 1 || timers["test.timer"].seconds < 0;
+  nbErrors += counters["io.bytes_parsed"] != content.size();
+  nbErrors += counters["io.sequences_read"] != 3;
+  nbErrors += counters["sites.scanned"] != 14;
+  nbErrors += counters["sites.selected"] != complete->getNumberOfSites();
+  nbErrors += counters["test.counter"] != 3;
+  nbErrors += timers["io.encode_symbols"].calls != 3;
+
+  ostringstream json;
+  profiler.writeJson(json);
+  nbErrors += json.str().find("\"io.bytes_parsed\": " + to_string(content.size())) == string::npos;
+  nbErrors += json.str().find("\"test.timer\": { \"calls\": 1") == string::npos;
+  ostringstream text;
+  profiler.print(text);
+  nbErrors += text.str().find("app.get_site_container") == string::npos;
+
+  profiler.reset();
+  nbErrors += !profiler.getTimers().empty() || !profiler.getCounters().empty();
+
+  // Probabilistic files are profiled too:
+  string pastaContent = "A C G T\n>seq1\n0.1 0.2 0.3 0.4\n0.4 0.3 0.2 0.1\n>seq2\n0.25 0.25 0.25 0.25\n1 0 0 0\n";
+  {
+    ofstream file("profiler_test.pasta");
+    file << pastaContent;
+  }
+  profiler.setEnabled(true);
+  auto probSites = Pasta().readAlignment("profiler_test.pasta", dna);
+  profiler.setEnabled(false);
+  nbErrors += probSites->getNumberOfSequences() != 2;
+  nbErrors += profiler.getTimers()["io.parse_alignment_file"].calls != 1;
+  nbErrors += profiler.getCounters()["io.bytes_parsed"] != pastaContent.size();
+  nbErrors += profiler.getCounters()["io.sequences_read"] != 2;
+  profiler.reset();
+  remove("profiler_test.pasta");
+
+  // Lines of interleaved files are encoded one by one, but reported as a single call:
+  istringstream clustalInput("CLUSTAL W\n\nseq1      ACGTACGTAC\nseq2      ACGTTCGTAC\n\nseq1      ACG\nseq2      ACC\n");
+  profiler.setEnabled(true);
+  auto clustalSites = Clustal().readAlignment(clustalInput, dna);
+  profiler.setEnabled(false);
+  nbErrors += clustalSites->getNumberOfSites() != 13;
+  nbErrors += profiler.getTimers()["io.encode_symbols"].calls != 1;
+  profiler.reset();
+
+  remove("profiler_test.fasta");
+
+  if (nbErrors > 0)
+  {
+    cerr << nbErrors << " errors." << endl;
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/PhredScores.h>
+#include <Bpp/Seq/SequenceWithQualityTools.h>
+#include <cmath>
+#include <iostream>
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  size_t nbErrors = 0;
+
+  // Compact scores from a FASTQ quality line:
+  string bases = "ACGTACGTACGTACGTACGT";
+  string line  = "##+5IIIIII#IIIII5+##";
+  PhredScores scores;
+  scores.assignFastq(line);
+  nbErrors += scores.size() != 20 || scores[0] != 2 || scores[3] != 20 || scores[4] != 40;
+  nbErrors += scores.toFastq() != line;
+  try
+  {
+    scores.assignFastq("II I");
+    nbErrors++;
+  }
+  catch (Exception& e) {}
+  scores.assignFastq(line);
+
+  shared_ptr<const Alphabet> dna = AlphabetTools::DNA_ALPHABET;
+  SequenceWithQuality read("read", bases, scores.toVector(), dna);
+  nbErrors += PhredScores(read.getQualities()).getScores() != scores.getScores();
+  nbErrors += SequenceWithQualityTools::getMinQuality(read) != 2 || SequenceWithQualityTools::getMinQuality(scores) != 2;
+  double mean = 0;
+  for (size_t i = 0; i < line.size(); ++i)
+  {
+    mean += line[i] - 33;
+  }
+  mean /= static_cast<double>(line.size());
+  nbErrors += abs(SequenceWithQualityTools::getMeanQuality(read) - mean) > 1e-12;
+  nbErrors += abs(SequenceWithQualityTools::getMeanQuality(scores) - mean) > 1e-12;
+  nbErrors += !std::isnan(SequenceWithQualityTools::getMeanQuality(PhredScores()));
+
+  // Sliding window trimming, with a window of 4 and a mean of 20 at least:
+  size_t begin, end;
+  SequenceWithQualityTools::getQualityTrimmingBounds(scores, 20, 4, begin, end);
+  nbErrors += begin != 2 || end != 18;
+  SequenceWithQualityTools::getQualityTrimmingBounds(read, 41, 4, begin, end);
+  nbErrors += begin != 0 || end != 0;
+  SequenceWithQualityTools::getQualityTrimmingBounds(scores, 10, 100, begin, end);
+  nbErrors += begin != 0 || end != 20;
+
+  SequenceWithQuality trimmed(read);
+  nbErrors += SequenceWithQualityTools::trimLowQuality(trimmed, 20, 4) != 16;
+  nbErrors += trimmed.toString() != bases.substr(2, 16);
+  nbErrors += trimmed.getQualities().size() != 16 || trimmed.getQuality(0) != 10 || trimmed.getQuality(15) != 10;
+  SequenceWithQualityTools::trim(trimmed, 1, 3);
+  nbErrors += trimmed.toString() != "TA" || trimmed.getQuality(0) != 20 || trimmed.getQuality(1) != 40;
+
+  string trimmedBases = bases;
+  PhredScores trimmedScores = scores;
+  nbErrors += SequenceWithQualityTools::trimLowQuality(trimmedBases, trimmedScores, 20, 4) != 16;
+  nbErrors += trimmedBases != bases.substr(2, 16) || trimmedScores.toFastq() != line.substr(2, 16);
+
+  // Masking:
+  SequenceWithQuality masked(read);
+  nbErrors += masked.maskLowQuality(20) != 7;
+  nbErrors += masked.toString() != "NNNTACGTACNTACGTANNN";
+  nbErrors += masked.getQualities() != read.getQualities();
+  string maskedBases = bases;
+  nbErrors += SequenceWithQualityTools::maskLowQuality(maskedBases, scores, 20) != 7;
+  nbErrors += maskedBases != masked.toString();
+  nbErrors += SequenceWithQualityTools::maskLowQuality(maskedBases, scores, 0) != 0;
+
+  if (nbErrors > 0)
+  {
+    cerr << nbErrors << " errors." << endl;
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
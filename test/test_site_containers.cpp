@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/App/ApplicationTools.h>
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/App/SequenceApplicationTools.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+using namespace bpp;
+using namespace std;
+
+static size_t compare(
+    const map<size_t, unique_ptr<VectorSiteContainer>>& m1,
+    const map<size_t, unique_ptr<VectorSiteContainer>>& m2)
+{
+  size_t nbErrors = 0;
+  if (m1.size() != m2.size())
+    return 1;
+  for (auto it1 = m1.begin(), it2 = m2.begin(); it1 != m1.end(); ++it1, ++it2)
+  {
+    nbErrors += it1->first != it2->first;
+    const VectorSiteContainer& sites1 = *it1->second;
+    const VectorSiteContainer& sites2 = *it2->second;
+    nbErrors += sites1.getSequenceNames() != sites2.getSequenceNames();
+    if (sites1.getNumberOfSites() != sites2.getNumberOfSites())
+    {
+      nbErrors++;
+      continue;
+    }
+    for (size_t i = 0; i < sites1.getNumberOfSites(); ++i)
+    {
+      nbErrors += sites1.site(i).getContent() != sites2.site(i).getContent();
+    }
+  }
+  return nbErrors;
+}
+
+static string getError(shared_ptr<const Alphabet> alpha, const map<string, string>& params, const ExecutionContext& context)
+{
+  try
+  {
+    SequenceApplicationTools::getSiteContainers(alpha, params, "input.", "", true, false, 1, context);
+  }
+  catch (exception& e)
+  {
+    return e.what();
+  }
+  return "";
+}
+
+int main()
+{
+  // Messages of the loader are not needed:
+  ApplicationTools::message.reset();
+  ApplicationTools::warning.reset();
+
+  size_t nbErrors = 0;
+  shared_ptr<const Alphabet> dna = AlphabetTools::DNA_ALPHABET;
+  string bases = "ACGT";
+  map<string, string> params;
+  vector<string> paths;
+  for (size_t num = 1; num <= 7; ++num)
+  {
+    string path = "site_containers_" + to_string(num) + ".fasta";
+    paths.push_back(path);
+    {
+      ofstream file(path.c_str());
+      for (size_t s = 0; s < 3 + num; ++s)
+      {
+        file << ">seq" << s << endl;
+        for (size_t k = 0; k < 10 + 2 * num; ++k)
+        {
+          file << bases[(k * (s + 1) + num) % 4];
+        }
+        file << endl;
+      }
+    }
+    string description = "alignment(file=" + path + ", format=Fasta";
+    if (num % 2 == 0)
+      description += ", selection=(2:" + to_string(5 + num) + ")";
+    params["input.data" + to_string(num)] = description + ")";
+  }
+
+  // Same alignments, in the same map, whatever the number of threads:
+  ExecutionContext sequential(1);
+  ExecutionContext parallel(4);
+  auto m1 = SequenceApplicationTools::getSiteContainers(dna, params, "input.", "", true, false, 1, sequential);
+  auto m2 = SequenceApplicationTools::getSiteContainers(dna, params, "input.", "", true, false, 1, parallel);
+  nbErrors += m1.size() != 7;
+  for (auto& entry : m1)
+  {
+    size_t num = entry.first;
+    nbErrors += entry.second->getNumberOfSequences() != 3 + num;
+    nbErrors += entry.second->getNumberOfSites() != (num % 2 == 0 ? 4 + num : 10 + 2 * num);
+  }
+  nbErrors += compare(m1, m2);
+
+  // The error of the first alignment in the order of the options is reported:
+  map<string, string> badParams = params;
+  badParams["input.data3"] = "alignment(file=site_containers_missing.fasta, format=Fasta)";
+  {
+    ofstream file(paths[4].c_str());
+    file << ">seq0" << endl << "ACGT" << endl << ">seq1" << endl << "AC" << endl;
+  }
+  string error1 = getError(dna, badParams, sequential);
+  string error2 = getError(dna, badParams, parallel);
+  nbErrors += error1.find("site_containers_missing.fasta") == string::npos;
+  nbErrors += error1 != error2;
+  badParams.erase("input.data3");
+  string error3 = getError(dna, badParams, parallel);
+  nbErrors += error3.empty() || error3 == error1 || error3 != getError(dna, badParams, sequential);
+
+  for (const string& path : paths)
+  {
+    remove(path.c_str());
+  }
+
+  if (nbErrors > 0)
+  {
+    cerr << nbErrors << " errors." << endl;
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
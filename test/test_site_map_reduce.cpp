@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/Container/CompressedVectorSiteContainer.h>
+#include <Bpp/Seq/Container/SiteMapReduce.h>
+#include <Bpp/Seq/Container/VectorSiteContainer.h>
+#include <Bpp/Seq/SiteTools.h>
+#include <iostream>
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  shared_ptr<const Alphabet> alpha = AlphabetTools::DNA_ALPHABET;
+  VectorSiteContainer sites(alpha);
+  vector<string> data = {
+    "ACGT-ACGTTACGT-ACGTAAACCCGGG-TT",
+    "ACGTTACGTTACGT-ACG-AAACCCGGGATT",
+    "ACCTTACGTTACGT-ACGTAAACCNGGGATT"
+  };
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    auto seq = make_unique<Sequence>("seq" + to_string(i), data[i], alpha);
+    sites.addSequence(seq->getName(), seq);
+  }
+  CompressedVectorSiteContainer compressed(sites);
+  ProbabilisticVectorSiteContainer probabilistic(alpha);
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    vector< vector<double>> probs;
+    for (int state : sites.sequence(i).getContent())
+    {
+      vector<double> p(4, state == alpha->getUnknownCharacterCode() ? 0.25 : 0.);
+      if (state >= 0 && state < 4)
+        p[static_cast<size_t>(state)] = 1.;
+      probs.push_back(p);
+    }
+    auto seq = make_unique<ProbabilisticSequence>(sites.sequence(i).getName(), probs, alpha);
+    probabilistic.addSequence(seq->getName(), seq);
+  }
+
+  auto countGaps = [](const Site& site, size_t weight) { return SiteTools::hasGap(site) ? weight : 0; };
+  auto countA = [](const SiteBlock<Site>& block)
+  {
+    size_t n = 0;
+    for (size_t i = 0; i < block.size(); ++i)
+    {
+      for (int state : block.column(i))
+      {
+        if (state == 0)
+          n += block.weight(i);
+      }
+    }
+    return n;
+  };
+  auto sum = [](size_t a, size_t b) { return a + b; };
+
+  ExecutionContext sequential(1);
+  ExecutionContext parallel(4);
+  size_t nbErrors = 0;
+  for (size_t grain : {0, 1, 7})
+  {
+    for (auto context : {&sequential, &parallel})
+    {
+      nbErrors += SiteMapReduce::mapReduceSites(sites, size_t(0), countGaps, sum, *context, grain) != 4;
+      nbErrors += SiteMapReduce::mapReduceSites(compressed, size_t(0), countGaps, sum, *context, grain) != 4;
+      nbErrors += SiteMapReduce::mapReduceBlocks(sites, size_t(0), countA, sum, *context, grain) != 23;
+      nbErrors += SiteMapReduce::mapReduceBlocks(compressed, size_t(0), countA, sum, *context, grain) != 23;
+      double pA = SiteMapReduce::mapReduceSites(probabilistic, 0.,
+          [](const ProbabilisticSite& site, size_t weight)
+          {
+            double p = 0;
+            for (const auto& probs : site.getContent())
+            {
+              p += probs[0] * static_cast<double>(weight);
+            }
+            return p;
+          },
+          [](double a, double b) { return a + b; }, *context, grain);
+      nbErrors += pA < 23.25 - 1e-9 || pA > 23.25 + 1e-9; // 23 A + 1/4 for N
+    }
+  }
+  // Sites in order:
+  auto positions = SiteMapReduce::mapReduceSites(sites, vector<size_t>(),
+      [](const Site& site, size_t weight) { return vector<size_t>(1, static_cast<size_t>(site[0])); },
+      [](vector<size_t> a, const vector<size_t>& b)
+      {
+        a.insert(a.end(), b.begin(), b.end());
+        return a;
+      }, parallel, 3);
+  nbErrors += sites.sequence(0).getContent() != vector<int>(positions.begin(), positions.end());
+
+  cout << "Errors: " << nbErrors << endl;
+  return nbErrors == 0 ? 0 : 1;
+}